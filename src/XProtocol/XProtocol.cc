@@ -74,7 +74,8 @@ const char *reqNames[kXR_REQFENCE-kXR_auth] =
               "sync",        "stat",        "set",         "write",
               "admin",       "prepare",     "statx",       "endsess",
               "bind",        "readv",       "verifyw",     "locate",
-              "truncate",    "sigver",      "decrypt"
+              "truncate",    "sigver",      "decrypt",     "writev",
+              "pgread",      "pgwrite"
              };
 
 // Following value is used to determine if the error or request code is
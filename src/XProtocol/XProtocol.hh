@@ -117,6 +117,9 @@ enum XRequestTypes {
    kXR_truncate,// 3028
    kXR_sigver,  // 3029
    kXR_decrypt, // 3030
+   kXR_writev,  // 3031
+   kXR_pgread,  // 3032
+   kXR_pgwrite, // 3033
    kXR_REQFENCE // Always last valid request code +1
 };
 
@@ -230,6 +233,24 @@ enum XVerifyType {
    kXR_crc32  = 1
 };
 
+enum XWriteVOptions {
+   kXR_wvsync = 1           // Sync all files written once the data is written
+};
+
+// kXR_pgread and kXR_pgwrite move data as a sequence of units, each being a
+// page of data followed by the CRC32C of the page in network byte order. Pages
+// are aligned on kXR_pgPageSZ file offsets so that the first and last pages of
+// a transfer may be short. The kXR_pgwrite response lists the file offsets of
+// the pages whose checksum did not match (these are not written) as kXR_int64
+// values; an empty response means that all of the pages were written.
+//
+enum XPageSize {
+   kXR_pgPageSZ = 4096,     // Size of a page
+   kXR_pgPageBL = 12,       // log2(kXR_pgPageSZ)
+   kXR_pgUnitSZ = kXR_pgPageSZ + 4, // Size of a page plus its checksum
+   kXR_pgMaxEpr = 128       // Max bad pages before kXR_pgwrite fails outright
+};
+
 enum XLogonType {
    kXR_useruser  = 0,
    kXR_useradmin = 1
@@ -496,6 +517,23 @@ struct ClientReadRequest {
    kXR_int32 rlen;
    kXR_int32  dlen;
 };
+struct ClientPgReadRequest {
+   kXR_char  streamid[2];
+   kXR_unt16 requestid;
+   kXR_char  fhandle[4];
+   kXR_int64 offset;
+   kXR_int32 rlen;          // Amount of data wanted, excluding the checksums
+   kXR_int32 dlen;
+};
+struct ClientPgWriteRequest {
+   kXR_char  streamid[2];
+   kXR_unt16 requestid;
+   kXR_char  fhandle[4];
+   kXR_int64 offset;
+   kXR_char  pathid;
+   kXR_char  reserved[3];
+   kXR_int32 dlen;          // Amount of data sent, including the checksums
+};
 struct ClientReadVRequest {
    kXR_char  streamid[2];
    kXR_unt16 requestid;
@@ -565,6 +603,13 @@ struct ClientWriteRequest {
    kXR_char reserved[3];
    kXR_int32  dlen;
 };
+struct ClientWriteVRequest {
+   kXR_char  streamid[2];
+   kXR_unt16 requestid;
+   kXR_char  options;       // One or more of XWriteVOptions
+   kXR_char  reserved[15];
+   kXR_int32 dlen;          // Length of the write_list that follows
+};
 struct ClientVerifywRequest {
    kXR_char  streamid[2];
    kXR_unt16 requestid;
@@ -599,6 +644,8 @@ typedef union {
    struct ClientMkdirRequest mkdir;
    struct ClientMvRequest mv;
    struct ClientOpenRequest open;
+   struct ClientPgReadRequest pgread;
+   struct ClientPgWriteRequest pgwrite;
    struct ClientPingRequest ping;
    struct ClientPrepareRequest prepare;
    struct ClientProtocolRequest protocol;
@@ -614,6 +661,7 @@ typedef union {
    struct ClientSyncRequest sync;
    struct ClientTruncateRequest truncate;
    struct ClientWriteRequest write;
+   struct ClientWriteVRequest writev;
 } ClientRequest;
 
 typedef union {
@@ -628,6 +676,15 @@ struct readahead_list {
    kXR_int64 offset;
 };
 
+// The kXR_writev request argument is an array of write_list elements. The data
+// for each element, in list order, immediately follows the argument.
+//
+struct write_list {
+   kXR_char fhandle[4];
+   kXR_int32 wlen;
+   kXR_int64 offset;
+};
+
 struct read_args {
    kXR_char       pathid;
    kXR_char       reserved[7];
@@ -88,6 +88,7 @@ enum CmsReqCode            // Request Codes
      kYR_update  = 25,
      kYR_usage   = 26,
      kYR_xauth   = 27,
+     kYR_summary = 28,
      kYR_MaxReq            // Count of request numbers (highest + 1)
 };
 
@@ -568,6 +569,31 @@ enum  {kYR_Stage  = 0x01, kYR_noStage = 0x02,  // Modifier
       };
 };
 
+/******************************************************************************/
+/*                       s u m m a r y   R e q u e s t                        */
+/******************************************************************************/
+
+// Request: summary <gen> <nbits> <offset> <nhash> <bits>
+// Respond: n/a
+//
+// Sent by a server to its managers to describe the files it has cached as two
+// Bloom filters of nbits bits each, one for all files and one for completely
+// cached files. The concatenated bit vectors are sent in consecutive parts of
+// at most MaxPart bytes; offset is where this part starts. A part with a new
+// generation number and offset zero starts a new summary.
+//
+struct CmsSummaryRequest
+{      CmsRRHdr      Hdr;    // Modifier always has kYR_raw set
+       kXR_unt32     Gen;    // Summary generation number
+       kXR_unt32     nBits;  // Bits per filter, a power of two
+       kXR_unt32     Offset; // Offset of this part in the bit vectors
+       kXR_unt16     nHash;  // Hash functions per filter
+       kXR_unt16     Rsvd;
+//     kXR_char      Bits[Hdr.datalen-16];
+
+enum  {MaxPart = 8192};
+};
+
 /******************************************************************************/
 /*                         t r u n c   R e q u e s t                          */
 /******************************************************************************/
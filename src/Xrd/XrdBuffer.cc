@@ -34,9 +34,11 @@
 #endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 
 #include "XrdOuc/XrdOucUtils.hh"
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysTimer.hh"
@@ -46,6 +48,46 @@
 #define XRD_TRACE XrdTrace->
 #include "Xrd/XrdTrace.hh"
 
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+// A thread cache holds buffers released by its owning thread. Only the owner
+// adds or removes buffers, so its lock is uncontended except when the pool is
+// reshaped or statistics are gathered. Lock order is Reshaper, tcMutex, tcLock.
+//
+class XrdBuffCache
+{
+public:
+
+XrdBuffManager *bMgr;
+XrdBuffCache   *next;
+XrdBuffCache   *prev;
+XrdSysMutex     tcLock;
+
+struct {XrdBuffer *bnext;
+        int         numbuf;
+        int         numreq;
+       } bucket[XRD_BUCKETS];
+
+int             totreq;
+int             tcBytes;
+long long       numHits;
+long long       numSteal;
+
+void            Flush();
+
+static void     Retire(void *carg);
+
+                XrdBuffCache(XrdBuffManager *bmP) : bMgr(bmP), next(0),
+                             prev(0), totreq(0), tcBytes(0), numHits(0),
+                             numSteal(0)
+                            {memset(static_cast<void *>(bucket), 0,
+                                    sizeof(bucket));
+                            }
+               ~XrdBuffCache() {}
+};
+
 /******************************************************************************/
 /*                     E x t e r n a l   L i n k a g e s                      */
 /******************************************************************************/
@@ -66,6 +108,7 @@ const char *XrdBuffManager::TraceID = "BuffManager";
 namespace
 {
 static const int minBuffSz = 1 << XRD_BUSHIFT;
+static const int hugeBuffSz= 1 << 21;  // Transparent huge page size (2MB)
 }
 
 namespace XrdGlobal
@@ -104,6 +147,18 @@ XrdBuffManager::XrdBuffManager(XrdSysError *lP, XrdOucTrace *tP, int minrst) :
    rsinprog = 0;
    minrsw   = minrst;
    memset(static_cast<void *>(bucket), 0, sizeof(bucket));
+
+// Thread caches are on by default and may hold two of the largest buffers
+//
+   tcHits   = 0;
+   tcMiss   = 0;
+   tcSteal  = 0;
+   tcMax    = maxsz*2;
+   tcTotal  = 0;
+   tcLimit  = maxalo/8;
+   hugePages= 0;
+   tcFirst  = 0;
+   if (pthread_key_create(&tcKey, XrdBuffCache::Retire)) tcMax = -1;
 }
 
 /******************************************************************************/
@@ -112,8 +167,22 @@ XrdBuffManager::XrdBuffManager(XrdSysError *lP, XrdOucTrace *tP, int minrst) :
   
 XrdBuffManager::~XrdBuffManager()
 {
+   XrdBuffCache *tcP;
    XrdBuffer *bP;
 
+// Return all buffers held by thread caches (no thread may use us anymore)
+//
+   if (tcMax >= 0) pthread_key_delete(tcKey);
+   tcMutex.Lock();
+   while((tcP = tcFirst))
+        {tcFirst = tcP->next;
+         tcP->Flush();
+         delete tcP;
+        }
+   tcMutex.UnLock();
+
+// Now free all of the buffers
+//
    for (int i = 0; i < XRD_BUCKETS; i++)
        {while((bP = bucket[i].bnext))
              {bucket[i].bnext = bP->next;
@@ -145,9 +214,9 @@ void XrdBuffManager::Init()
   
 XrdBuffer *XrdBuffManager::Obtain(int sz)
 {
+   XrdBuffCache *tcP;
    XrdBuffer *bp;
-   char *memp;
-   int mk, pk, bindex;
+   int mk, bindex;
 
 // Make sure the request is within our limits
 //
@@ -162,36 +231,40 @@ XrdBuffer *XrdBuffManager::Obtain(int sz)
    if (mk < sz) {bindex++; mk = mk << 1;}
    if (bindex >= slots) return 0;    // Should never happen!
 
+// Try to satisfy the request from this thread's cache
+//
+   if (tcMax > 0 && (tcP = getCache()))
+      {tcP->tcLock.Lock();
+       tcP->totreq++;
+       tcP->bucket[bindex].numreq++;
+       if ((bp = tcP->bucket[bindex].bnext))
+          {tcP->bucket[bindex].bnext = bp->next;
+           tcP->bucket[bindex].numbuf--;
+           tcP->tcBytes -= mk;
+           tcP->numHits++;
+           AtomicBeg(tcTMutex); AtomicSub(tcTotal, mk); AtomicEnd(tcTMutex);
+          }
+       tcP->tcLock.UnLock();
+       if (bp) return bp;
+      } else tcP = 0;
+
 // Obtain a lock on the bucket array and try to give away an existing buffer
 //
     Reshaper.Lock();
-    totreq++;
-    bucket[bindex].numreq++;
+    if (!tcP) {totreq++; bucket[bindex].numreq++;}
     if ((bp = bucket[bindex].bnext))
-       {bucket[bindex].bnext = bp->next; bucket[bindex].numbuf--;}
+       {bucket[bindex].bnext = bp->next; bucket[bindex].numbuf--;
+        if (tcP) tcP->numSteal++;
+       }
     Reshaper.UnLock();
 
 // Check if we really allocated a buffer
 //
    if (bp) return bp;
 
-// Allocate a chunk of aligned memory
+// Allocate a new buffer
 //
-   pk = (mk < pagsz ? mk : pagsz);
-   if (!(memp = static_cast<char *>(memalign(pk, mk)))) return 0;
-
-// Wrap the memory with a buffer object
-//
-   if (!(bp = new XrdBuffer(memp, mk, bindex))) {free(memp); return 0;}
-
-// Update statistics
-//
-    Reshaper.Lock();
-    totbuf++;
-    if ((totalo += mk) > maxalo && !rsinprog)
-       {rsinprog = 1; Reshaper.Signal();}
-    Reshaper.UnLock();
-    return bp;
+   return newBuff(mk, bindex);
 }
  
 /******************************************************************************/
@@ -226,12 +299,30 @@ int XrdBuffManager::Recalc(int sz)
   
 void XrdBuffManager::Release(XrdBuffer *bp)
 {
+   XrdBuffCache *tcP;
    int bindex = bp->bindex;
 
 // Check if we should release this via the big buffer object
 //
    if (bindex >= slots) {xlBuff.Release(bp); return;}
 
+// Keep the buffer in this thread's cache if there is room for it there and
+// the thread caches together do not exceed their share of the memory limit.
+// The latter is checked without a lock, so the share may be slightly exceeded.
+//
+   if (tcMax > 0 && (tcP = getCache()))
+      {tcP->tcLock.Lock();
+       if (tcP->tcBytes + bp->bsize <= tcMax && tcAdd(bp->bsize))
+          {bp->next = tcP->bucket[bindex].bnext;
+           tcP->bucket[bindex].bnext = bp;
+           tcP->bucket[bindex].numbuf++;
+           tcP->tcBytes += bp->bsize;
+           tcP->tcLock.UnLock();
+           return;
+          }
+       tcP->tcLock.UnLock();
+      }
+
 // Obtain a lock on the bucket array and reclaim the buffer
 //
     Reshaper.Lock();
@@ -266,8 +357,10 @@ while(1)
           Reshaper.Lock();
          }
 
-      // We have the lock so compute the request profile
+      // We have the lock so pull back whatever the threads are holding on to
+      // and compute the request profile
       //
+      Drain();
       if (totreq > slots)
          {requests = (float)totreq;
           buffers  = (float)totbuf;
@@ -316,11 +409,27 @@ void XrdBuffManager::Set(int maxmem, int minw)
 // Obtain a lock and set the values
 //
    Reshaper.Lock();
-   if (maxmem > 0) maxalo = (long long)maxmem;
+   if (maxmem > 0) {maxalo = (long long)maxmem; tcLimit = maxalo/8;}
    if (minw   > 0) minrsw = minw;
    Reshaper.UnLock();
 }
  
+/******************************************************************************/
+/*                              S e t C a c h e                               */
+/******************************************************************************/
+  
+void XrdBuffManager::SetCache(int maxtc, int hugep)
+{
+
+// Obtain a lock and set the values. A zero cache size turns off caching;
+// whatever the threads hold is returned at the next reshape.
+//
+   Reshaper.Lock();
+   if (maxtc >= 0 && tcMax >= 0) tcMax = maxtc;
+   if (hugep >= 0) hugePages = hugep;
+   Reshaper.UnLock();
+}
+
 /******************************************************************************/
 /*                                 S t a t s                                  */
 /******************************************************************************/
@@ -328,19 +437,195 @@ void XrdBuffManager::Set(int maxmem, int minw)
 int XrdBuffManager::Stats(char *buff, int blen, int do_sync)
 {
     static char statfmt[] = "<stats id=\"buff\"><reqs>%d</reqs>"
-                "<mem>%lld</mem><buffs>%d</buffs><adj>%d</adj>%s</stats>";
+                "<mem>%lld</mem><buffs>%d</buffs><adj>%d</adj>"
+                "<tchit>%lld</tchit><tcmiss>%lld</tcmiss>"
+                "<tcsteal>%lld</tcsteal>%s</stats>";
+    XrdBuffCache *tcP;
     char xlStats[1024];
-    int nlen;
+    long long numHits, numSteal;
+    int nlen, numReqs;
 
 // If only size wanted, return it
 //
-   if (!buff) return sizeof(statfmt) + 16*4 + xlBuff.Stats(0,0);
+   if (!buff) return sizeof(statfmt) + 16*7 + xlBuff.Stats(0,0);
 
-// Return formatted stats
+// Add up the thread cache counters
 //
    if (do_sync) Reshaper.Lock();
+   tcMutex.Lock();
+   numReqs = totreq; numHits = tcHits; numSteal = tcSteal;
+   for (tcP = tcFirst; tcP; tcP = tcP->next)
+       {tcP->tcLock.Lock();
+        numReqs  += tcP->totreq;
+        numHits  += tcP->numHits;
+        numSteal += tcP->numSteal;
+        tcP->tcLock.UnLock();
+       }
+   tcMutex.UnLock();
+
+// Return formatted stats
+//
    xlBuff.Stats(xlStats, sizeof(xlStats), do_sync);
-   nlen = snprintf(buff,blen,statfmt,totreq,totalo,totbuf,totadj,xlStats);
+   nlen = snprintf(buff,blen,statfmt,numReqs,totalo,totbuf,totadj,
+                   numHits,tcMiss,numSteal,xlStats);
    if (do_sync) Reshaper.UnLock();
    return nlen;
 }
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 D r a i n                                  */
+/******************************************************************************/
+
+// The caller must hold the Reshaper lock!
+//
+void XrdBuffManager::Drain()
+{
+   XrdBuffCache *tcP;
+
+   tcMutex.Lock();
+   for (tcP = tcFirst; tcP; tcP = tcP->next)
+       {tcP->tcLock.Lock();
+        tcP->Flush();
+        tcP->tcLock.UnLock();
+       }
+   tcMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                              g e t C a c h e                               */
+/******************************************************************************/
+  
+XrdBuffCache *XrdBuffManager::getCache()
+{
+   XrdBuffCache *tcP;
+
+// Return the cache for this thread, creating one if need be
+//
+   if (!(tcP = static_cast<XrdBuffCache *>(pthread_getspecific(tcKey))))
+      {tcP = new XrdBuffCache(this);
+       if (pthread_setspecific(tcKey, tcP)) {delete tcP; return 0;}
+       tcMutex.Lock();
+       if ((tcP->next = tcFirst)) tcFirst->prev = tcP;
+       tcFirst = tcP;
+       tcMutex.UnLock();
+      }
+   return tcP;
+}
+
+/******************************************************************************/
+/*                               n e w B u f f                                */
+/******************************************************************************/
+  
+XrdBuffer *XrdBuffManager::newBuff(int mk, int bindex)
+{
+   XrdBuffer *bp;
+   char *memp;
+   int pk;
+
+// Allocate a chunk of aligned memory. The largest buffers may be backed by
+// huge pages, if so wanted.
+//
+   pk = (mk < pagsz ? mk : pagsz);
+   if (hugePages && mk >= hugeBuffSz) pk = hugeBuffSz;
+   if (!(memp = static_cast<char *>(memalign(pk, mk)))) return 0;
+#ifdef MADV_HUGEPAGE
+   if (hugePages && mk >= hugeBuffSz) madvise(memp, mk, MADV_HUGEPAGE);
+#endif
+
+// Wrap the memory with a buffer object
+//
+   if (!(bp = new XrdBuffer(memp, mk, bindex))) {free(memp); return 0;}
+
+// Update statistics
+//
+    Reshaper.Lock();
+    totbuf++;
+    tcMiss++;
+    if ((totalo += mk) > maxalo && !rsinprog)
+       {rsinprog = 1; Reshaper.Signal();}
+    Reshaper.UnLock();
+    return bp;
+}
+
+/******************************************************************************/
+/*                                 t c A d d                                  */
+/******************************************************************************/
+
+// Account for bytes entering a thread cache. Returns false, accounting for
+// nothing, if the thread caches would then hold more than their share.
+//
+bool XrdBuffManager::tcAdd(int bytes)
+{
+   long long tcNow;
+
+   AtomicBeg(tcTMutex);
+   AtomicFAdd(tcNow, tcTotal, bytes);
+   if (tcNow + bytes > tcLimit)
+      {AtomicSub(tcTotal, bytes);
+       AtomicEnd(tcTMutex);
+       return false;
+      }
+   AtomicEnd(tcTMutex);
+   return true;
+}
+
+/******************************************************************************/
+/*                X r d B u f f C a c h e   M e t h o d s                     */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 F l u s h                                  */
+/******************************************************************************/
+
+// The caller must hold the Reshaper lock and the cache lock, if need be.
+//
+void XrdBuffCache::Flush()
+{
+   XrdBuffer *bP;
+
+// Move all of our buffers and request counts to the shared buckets
+//
+   for (int i = 0; i < XRD_BUCKETS; i++)
+       {while((bP = bucket[i].bnext))
+             {bucket[i].bnext = bP->next;
+              bP->next = bMgr->bucket[i].bnext;
+              bMgr->bucket[i].bnext = bP;
+              bMgr->bucket[i].numbuf++;
+             }
+        bMgr->bucket[i].numreq += bucket[i].numreq;
+        bucket[i].numbuf = 0;
+        bucket[i].numreq = 0;
+       }
+   bMgr->totreq += totreq;
+   AtomicBeg(bMgr->tcTMutex);
+   AtomicSub(bMgr->tcTotal, tcBytes);
+   AtomicEnd(bMgr->tcTMutex);
+   totreq  = 0;
+   tcBytes = 0;
+}
+
+/******************************************************************************/
+/*                                R e t i r e                                 */
+/******************************************************************************/
+
+void XrdBuffCache::Retire(void *carg)
+{
+   XrdBuffCache   *tcP  = static_cast<XrdBuffCache *>(carg);
+   XrdBuffManager *bmP  = tcP->bMgr;
+
+// The owning thread is exiting. Give everything back to the buffer manager.
+//
+   bmP->Reshaper.Lock();
+   bmP->tcMutex.Lock();
+   if (tcP->prev) tcP->prev->next = tcP->next;
+      else bmP->tcFirst = tcP->next;
+   if (tcP->next) tcP->next->prev = tcP->prev;
+   tcP->Flush();
+   bmP->tcHits  += tcP->numHits;
+   bmP->tcSteal += tcP->numSteal;
+   bmP->tcMutex.UnLock();
+   bmP->Reshaper.UnLock();
+   delete tcP;
+}
@@ -29,6 +29,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <pthread.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -50,6 +51,7 @@ int      bsize;    // size of this buffer
 
         ~XrdBuffer() {if (buff) free(buff);}
 
+         friend class XrdBuffCache;
          friend class XrdBuffManager;
          friend class XrdBuffXL;
 private:
@@ -66,13 +68,18 @@ static int pagesz;
 #define XRD_BUCKETS 12
 #define XRD_BUSHIFT 10
 
-// There should be only one instance of this class per buffer pool.
+// There should be only one instance of this class per buffer pool. Each
+// thread keeps a small cache of released buffers per bucket so that most
+// Obtain/Release calls do not touch the shared buckets (see SetCache()). All
+// of the thread caches together hold at most an eighth of the memory limit.
 //
+class XrdBuffCache;
 class XrdOucTrace;
 class XrdSysError;
   
 class XrdBuffManager
 {
+friend class XrdBuffCache;
 public:
 
 void        Init();
@@ -89,6 +96,8 @@ void        Reshape();
 
 void        Set(int maxmem=-1, int minw=-1);
 
+void        SetCache(int maxtc=-1, int hugep=-1);
+
 int         Stats(char *buff, int blen, int do_sync=0);
 
             XrdBuffManager(XrdSysError *lP, XrdOucTrace *tP, int minrst=20*60);
@@ -118,6 +127,23 @@ int       minrsw;
 int       rsinprog;
 int       totadj;
 
+long long     tcHits;    // Served from a thread cache      (retired threads)
+long long     tcMiss;    // Served by allocating new memory
+long long     tcSteal;   // Served from the shared buckets  (retired threads)
+int           tcMax;     // Maximum bytes cached per thread (0 -> no cache)
+long long     tcTotal;   // Bytes held by all thread caches
+long long     tcLimit;   // Maximum for the above (1/8 of maxalo)
+int           hugePages; // Use transparent huge pages for the largest class
+pthread_key_t tcKey;
+XrdBuffCache *tcFirst;   // All active thread caches
+XrdSysMutex   tcMutex;   // Protects the above list
+XrdSysMutex   tcTMutex;  // Protects tcTotal when there are no atomics
+
+void          Drain();
+XrdBuffCache *getCache();
+XrdBuffer    *newBuff(int mk, int bindex);
+bool          tcAdd(int bytes);
+
 XrdSysCondVar      Reshaper;
 static const char *TraceID;
 };
@@ -1170,11 +1170,18 @@ int XrdConfig::xallow(XrdSysError *eDest, XrdOucStream &Config)
 
 /* Function: xbuf
 
-   Purpose:  To parse the directive: buffers [maxbsz <bsz>] <memsz> [<rint>]
+   Purpose:  To parse the directive: buffers [maxbsz <bsz>] [tcache <tcsz>]
+                                             [hugepages] <memsz> [<rint>]
 
              <bsz>      maximum size of an individualbuffer. The default is 2m.
                         Specify any value 2m < bsz <= 1g; if specified, it must
                         appear before the <memsz> and <memsz> becomes optional.
+             <tcsz>     maximum amount of buffer memory each thread may keep
+                        for itself. Specify 0 to disable per-thread caching.
+                        The default is 4m. All threads together keep at most
+                        1/8 of <memsz>. If specified, <memsz> is optional.
+             hugepages  back the largest buffers by transparent huge pages.
+                        If specified, <memsz> is optional.
              <memsz>    maximum amount of memory devoted to buffers
              <rint>     minimum buffer reshape interval in seconds
 
@@ -1184,6 +1191,7 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
 {
     static const long long minBSZ = 1024*1024*2+1;  // 2mb
     static const long long maxBSZ = 1024*1024*1024; // 1gb
+    static const long long maxTCSZ= 1024*1024*1024; // 1gb
     int bint = -1;
     long long blim;
     char *val;
@@ -1191,14 +1199,29 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
     if (!(val = Config.GetWord()))
        {eDest->Emsg("Config", "buffer memory limit not specified"); return 1;}
 
-    if (!strcmp("maxbsz", val))
-       {if (!(val = Config.GetWord()))
-           {eDest->Emsg("Config", "max buffer size not specified"); return 1;}
-        if (XrdOuca2x::a2sz(*eDest,"maxbz value",val,&blim,minBSZ,maxBSZ))
-           return 1;
-        XrdGlobal::xlBuff.Init(blim);
-        if (!(val = Config.GetWord())) return 0;
-       }
+    while(val)
+         {     if (!strcmp("maxbsz", val))
+                  {if (!(val = Config.GetWord()))
+                      {eDest->Emsg("Config", "max buffer size not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2sz(*eDest,"maxbz value",val,&blim,
+                                       minBSZ,maxBSZ)) return 1;
+                   XrdGlobal::xlBuff.Init(blim);
+                  }
+          else if (!strcmp("tcache", val))
+                  {if (!(val = Config.GetWord()))
+                      {eDest->Emsg("Config", "thread cache size not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2sz(*eDest,"tcache value",val,&blim,
+                                       0,maxTCSZ)) return 1;
+                   BuffPool.SetCache((int)blim);
+                  }
+          else if (!strcmp("hugepages", val)) BuffPool.SetCache(-1, 1);
+          else break;
+          if (!(val = Config.GetWord())) return 0;
+         }
 
     if (XrdOuca2x::a2sz(*eDest,"buffer limit value",val,&blim,
                        (long long)1024*1024)) return 1;
@@ -1220,9 +1243,11 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
    Purpose:  To parse directive: network [wan] [[no]keepalive] [buffsz <blen>]
                                          [kaparms parms] [cache <ct>] [[no]dnr]
                                          [routes <rtype> [use <ifn1>,<ifn2>]]
-                                         [[no]rpipa]
+                                         [[no]rpipa] [poller <ptype>]
+                                         [zerocopy <zcsz>]
 
              <rtype>: split | common | local
+             <ptype>: native | uring | uringsq
 
              wan       parameters apply only to the wan port
              keepalive do [not] set the socket keepalive option.
@@ -1232,6 +1257,15 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
              [no]dnr   do [not] perform a reverse DNS lookup if not needed.
              routes    specifies the network configuration (see reference)
              [no]rpipa do [not] resolve private IP addresses.
+             poller    the poller to use: native (the default), uring (Linux
+                       io_uring), or uringsq (io_uring with a kernel
+                       submission thread). The io_uring pollers only wait
+                       for links to become ready; links are still read and
+                       written by the server threads. The native poller is
+                       used when io_uring is not available.
+             zerocopy  send file data that was read into memory using
+                       MSG_ZEROCOPY when there are at least <zcsz> bytes. A
+                       value of 0 (the default) turns zero-copy sends off.
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1240,7 +1274,7 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
 {
     char *val;
     int  i, n, V_keep = -1, V_nodnr = 0, V_iswan = 0, V_blen = -1, V_ct = -1, V_assumev4;
-    int  v_rpip = -1;
+    int  v_rpip = -1, V_zcsz = -1;
     long long llp;
     struct netopts {const char *opname; int hasarg; int opval;
                            int *oploc;  const char *etxt;}
@@ -1257,7 +1291,9 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
         {"routes",     3, 1, 0,         "routes"},
         {"rpipa",      0, 1, &v_rpip,   "rpipa"},
         {"norpipa",    0, 0, &v_rpip,   "norpipa"},
-        {"wan",        0, 1, &V_iswan,  "option"}
+        {"poller",     5, 0, 0,         "poller"},
+        {"wan",        0, 1, &V_iswan,  "option"},
+        {"zerocopy",   1, 0, &V_zcsz,   "zerocopy size"}
        };
     int numopts = sizeof(ntopts)/sizeof(struct netopts);
 
@@ -1277,6 +1313,18 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
                          {if (xnkap(eDest, val)) return 1;
                           break;
                          }
+                      if (ntopts[i].hasarg == 5)
+                         {     if (!strcmp(val, "native"))
+                                  XrdPoll::PollMode(XrdPoll::pollNative);
+                          else if (!strcmp(val, "uring"))
+                                  XrdPoll::PollMode(XrdPoll::pollURing);
+                          else if (!strcmp(val, "uringsq"))
+                                  XrdPoll::PollMode(XrdPoll::pollURingSQ);
+                          else {eDest->Emsg("Config","Invalid poller type -",val);
+                                return 1;
+                               }
+                          break;
+                         }
                       if (ntopts[i].hasarg == 3)
                          {     if (!strcmp(val, "split"))
                                   XrdNetIF::Routing(XrdNetIF::netSplit);
@@ -1330,6 +1378,9 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
      if (V_ct >= 0) XrdNetAddr::SetCache(V_ct);
      if (v_rpip >= 0) XrdInet::netIF.SetRPIPA(v_rpip != 0);
      if (V_assumev4 >= 0) XrdInet::SetAssumeV4(true);
+     if (V_zcsz >= 0 && !XrdLink::setZC(V_zcsz, &BuffPool))
+        eDest->Say("Config warning: zero-copy sends are not supported on this "
+                   "platform; zerocopy option ignored.");
      return 0;
 }
 
@@ -1635,6 +1686,7 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
 
    Purpose:  To parse directive: sched [mint <mint>] [maxt <maxt>] [avlt <at>]
                                        [idle <idle>] [stksz <qnt>] [core <cv>]
+                                       [queues {<qn> | cpu}]
 
              <mint>   is the minimum number of threads that we need. Once
                       this number of threads is created, it does not decrease.
@@ -1651,6 +1703,10 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
              <idle>   The time (in time spec) between checks for underused
                       threads. Those found will be terminated. Default is 780.
              <qnt>    The thread stack size in bytes or K, M, or G.
+             <qn>     The number of run queues. With more than one queue each
+                      worker prefers its own queue and steals work from the
+                      others when it is empty. Specify cpu to have one queue
+                      per online cpu. The default is 1 (a single shared queue).
 
    Output: 0 upon success or 1 upon failure.
 */
@@ -1660,7 +1716,7 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
     char *val;
     long long lpp;
     int  i, ppp = 0;
-    int  V_mint = -1, V_maxt = -1, V_idle = -1, V_avlt = -1;
+    int  V_mint = -1, V_maxt = -1, V_idle = -1, V_avlt = -1, V_qnum = -1;
     struct schedopts {const char *opname; int minv; int *oploc;
                       const char *opmsg;} scopts[] =
        {
@@ -1669,7 +1725,8 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
         {"maxt",       1, &V_maxt, "sched maxt"},
         {"avlt",       1, &V_avlt, "sched avlt"},
         {"core",       1,       0, "sched core"},
-        {"idle",       0, &V_idle, "sched idle"}
+        {"idle",       0, &V_idle, "sched idle"},
+        {"queues",     1, &V_qnum, "sched queues"}
        };
     int numopts = sizeof(scopts)/sizeof(struct schedopts);
 
@@ -1702,6 +1759,8 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
                             XrdSysThread::setStackSize((size_t)lpp);
                             break;
                            }
+                   else if (*scopts[i].opname == 'q' && !strcmp("cpu", val))
+                           ppp = 0;
                    else if (XrdOuca2x::a2i(*eDest, scopts[i].opmsg, val,
                                      &ppp,scopts[i].minv)) return 1;
                    *scopts[i].oploc = ppp;
@@ -1728,6 +1787,7 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
 // Establish scheduler options
 //
    Sched.setParms(V_mint, V_maxt, V_avlt, V_idle);
+   if (V_qnum >= 0) Sched.setQueues(V_qnum);
    return 0;
 }
 
@@ -39,6 +39,11 @@
 #if !defined(TCP_CORK)
 #undef HAVE_SENDFILE
 #endif
+#include <linux/errqueue.h>
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) \
+ && defined(SO_EE_ORIGIN_ZEROCOPY) && defined(HAVE_SENDFILE)
+#define XRDLINK_ZEROCOPY 1
+#endif
 #endif
 
 #ifdef HAVE_SENDFILE
@@ -96,6 +101,62 @@ int                idleTicks;
 
 static const char *TraceID;
 };
+
+/******************************************************************************/
+/*                    C l a s s   X r d L i n k Z C P i n                     */
+/******************************************************************************/
+
+// A buffer handed over to Send() stays pinned until the kernel has completed
+// every zero-copy send that covers it. Sends are numbered by the kernel, the
+// ones for a pin are consecutive as they are all issued under the wrMutex.
+//
+class XrdLinkZCPin
+{
+public:
+
+XrdLinkZCPin *next;
+XrdBuffer    *bP;
+unsigned int  first;    // Number of the first zero-copy send
+unsigned int  last;     // Number of the last  zero-copy send
+int           left;     // Sends still not completed
+bool          done;     // Sender has finished with the buffer
+
+              XrdLinkZCPin(XrdBuffer *bp) : next(0), bP(bp), first(0), last(0),
+                                            left(0), done(false) {}
+             ~XrdLinkZCPin() {}
+};
+
+/******************************************************************************/
+/*                 C l a s s   X r d L i n k Z C L i n g e r                  */
+/******************************************************************************/
+
+// A link closed while the kernel still references buffers it sends from hands
+// a duplicate of its socket over to be lingered on. The socket is shut down,
+// so the peer sees the end of the connection right after the data, but stays
+// open so that the completions can still be reaped. Once they all are, the
+// buffers are released and the socket closed. Should the peer not acknowledge
+// the data in time, the socket is reset which makes the kernel let go.
+//
+class XrdLinkZCLinger : public XrdJob
+{
+public:
+
+static void Add(int fd, XrdLinkZCPin *pins);
+
+       void DoIt();
+
+            XrdLinkZCLinger() : XrdJob("zero-copy linger") {}
+           ~XrdLinkZCLinger() {}
+
+private:
+
+struct lgSock {lgSock *next; XrdLinkZCPin *pins; time_t deadline; int fd;};
+
+static const int       maxWait = 30;  // Seconds the peer has to acknowledge
+static XrdSysMutex     lgMutex;
+static lgSock         *lgFirst;
+static XrdLinkZCLinger lgJob;
+};
   
 /******************************************************************************/
 /*                               S t a t i c s                                */
@@ -129,6 +190,13 @@ static const char *TraceID;
        int             XrdLink::LinkTimeOuts  = 0;
        int             XrdLink::LinkStalls    = 0;
        int             XrdLink::LinkSfIntr    = 0;
+       long long       XrdLink::LinkZCBytes   = 0;
+       int             XrdLink::zcMinSz       = 0;
+       XrdBuffManager *XrdLink::zcPool        = 0;
+
+       XrdSysMutex      XrdLinkZCLinger::lgMutex;
+       XrdLinkZCLinger::lgSock *XrdLinkZCLinger::lgFirst = 0;
+       XrdLinkZCLinger  XrdLinkZCLinger::lgJob;
        XrdSysMutex     XrdLink::statsMutex;
 
        const char     *XrdLinkScan::TraceID = "LinkScan";
@@ -188,6 +256,9 @@ void XrdLink::Reset()
   Instance = 0;
   KillcvP  = 0;
   KillCnt  = 0;
+  zcState  = 0;
+  zcNext   = 0;
+  zcPins   = 0;
 }
 
 /******************************************************************************/
@@ -389,6 +460,7 @@ int XrdLink::Close(int defer)
    fd = (FD < 0 ? -FD : FD);
    if (FD != -1)
       {if (Poller) {XrdPoll::Detach(this); Poller = 0;}
+       if (zcPins) zcLinger();
        FD = -1;
        opHelper.UnLock();
        LTMutex.Lock();
@@ -403,6 +475,7 @@ int XrdLink::Close(int defer)
    if (fd >= 2) {if (KeepFD) rc = 0;
                     else rc = (close(fd) < 0 ? errno : 0);
                 }
+   if (zcPins) zcFree();
    if (rc) XrdLog->Emsg("Link", rc, "close", ID);
    return rc;
 }
@@ -547,7 +620,8 @@ int XrdLink::Peek(char *Buff, int Blen, int timeout)
 // Wait until we can actually read something
 //
    isIdle = 0;
-   do {retc = poll(&polltab, 1, timeout);} while(retc < 0 && errno == EINTR);
+   do {retc = poll(&polltab, 1, timeout);}
+      while((retc < 0 && errno == EINTR) || (retc == 1 && zcRetry(polltab)));
    if (retc != 1)
       {if (retc == 0) return 0;
        return XrdLog->Emsg("Link", -errno, "poll", ID);
@@ -612,7 +686,8 @@ int XrdLink::Recv(char *Buff, int Blen, int timeout)
 //
    isIdle = 0;
    while(Blen > 0)
-        {do {retc = poll(&polltab,1,timeout);} while(retc < 0 && errno == EINTR);
+        {do {retc = poll(&polltab,1,timeout);}
+            while((retc < 0 && errno == EINTR) || (retc == 1 && zcRetry(polltab)));
          if (retc != 1)
             {if (retc == 0)
                 {tardyCnt++;
@@ -663,7 +738,8 @@ int XrdLink::RecvAll(char *Buff, int Blen, int timeout)
 // for some data. We will wait forever for all the data. Yeah, it's weird.
 //
    if (timeout >= 0)
-      {do {retc = poll(&polltab,1,timeout);} while(retc < 0 && errno == EINTR);
+      {do {retc = poll(&polltab,1,timeout);}
+          while((retc < 0 && errno == EINTR) || (retc == 1 && zcRetry(polltab)));
        if (retc != 1)
           {if (!retc) return -ETIMEDOUT;
            XrdLog->Emsg("Link",errno,"poll",ID);
@@ -789,7 +865,15 @@ int XrdLink::Send(const struct iovec *iov, int iocnt, int bytes)
 }
  
 /******************************************************************************/
+
 int XrdLink::Send(const sfVec *sfP, int sfN)
+{
+   return Send(sfP, sfN, 0);
+}
+
+/******************************************************************************/
+
+int XrdLink::Send(const sfVec *sfP, int sfN, XrdBuffer *bP)
 {
 #if !defined(HAVE_SENDFILE) || defined(__APPLE__)
    return -1;
@@ -798,6 +882,7 @@ int XrdLink::Send(const sfVec *sfP, int sfN)
 //
    if (sfN < 1 || sfN > XrdOucSFVec::sfMax)
       {XrdLog->Emsg("Link", EINVAL, "send file to", ID);
+       if (bP) zcPool->Release(bP);
        return -1;
       }
 
@@ -865,10 +950,23 @@ do{retc = sendfilev(FD, vecSFP, sfN, &xframt);
 #elif defined(__linux__)
 
    static const int setON = 1, setOFF = 0;
+   XrdLinkZCPin *pinP = 0;
    ssize_t retc = 0, bytesleft;
    off_t myOffset;
    int i, xfrbytes = 0, uncork = 1, xIntr = 0;
 
+// If we were handed the buffer, pin it for the duration of any zero-copy send
+// of data that lies in it. We also reap whatever completed in the meantime as
+// a busy link is not being polled.
+//
+#ifdef XRDLINK_ZEROCOPY
+   if (bP)
+      {pinP = new XrdLinkZCPin(bP);
+       zcMutex.Lock(); pinP->next = zcPins; zcPins = pinP; zcMutex.UnLock();
+       zcReap();
+      }
+#endif
+
 // lock the link
 //
    wrMutex.Lock();
@@ -885,11 +983,16 @@ do{retc = sendfilev(FD, vecSFP, sfN, &xframt);
 // Send the header first
 //
    for (i = 0; i < sfN; sfP++, i++)
-       {if (sfP->fdnum < 0) retc = sendData(sfP->buffer, sfP->sendsz);
+       {if (sfP->fdnum < 0)
+           {if (pinP && useZC(sfP->sendsz) && sfP->buffer >= bP->buff
+            &&  sfP->buffer + sfP->sendsz <= bP->buff + bP->bsize)
+               retc = sendZC(sfP->buffer, sfP->sendsz, pinP);
+               else retc = sendData(sfP->buffer, sfP->sendsz);
+           }
            else {myOffset = sfP->offset; bytesleft = sfP->sendsz;
                  while(bytesleft
                     && (retc=sendfile(FD,sfP->fdnum,&myOffset,bytesleft)) > 0)
-                      {myOffset += retc; bytesleft -= retc; xIntr++;}
+                      {bytesleft -= retc; xIntr++;}
                 }
         if (retc <  0 && errno == EINTR) continue;
         if (retc <= 0) break;
@@ -902,6 +1005,7 @@ do{retc = sendfilev(FD, vecSFP, sfN, &xframt);
       {if (retc == 0) errno = ECANCELED;
        wrMutex.UnLock();
        XrdLog->Emsg("Link", errno, "send file to", ID);
+       if (pinP) zcUnpin(pinP);
        return -1;
       }
 
@@ -910,11 +1014,12 @@ do{retc = sendfilev(FD, vecSFP, sfN, &xframt);
    if (uncork && setsockopt(FD, SOL_TCP, TCP_CORK, &setOFF, sizeof(setOFF)) < 0)
       XrdLog->Emsg("Link", errno, "uncork socket for", ID);
 
-// All done
+// All done. The buffer is released once the kernel is done with it.
 //
    if (xIntr > sfN) SfIntr += (xIntr - sfN);
    AtomicAdd(BytesOut, xfrbytes);
    wrMutex.UnLock();
+   if (pinP) zcUnpin(pinP);
    return xfrbytes;
 #endif
 #endif
@@ -943,6 +1048,72 @@ int XrdLink::sendData(const char *Buff, int Blen)
    return retc;
 }
 
+/******************************************************************************/
+/* private                        s e n d Z C                                 */
+/******************************************************************************/
+
+int XrdLink::sendZC(const char *Buff, int Blen, XrdLinkZCPin *pinP)
+{
+#ifndef XRDLINK_ZEROCOPY
+   return sendData(Buff, Blen);
+#else
+   static const int setON = 1;
+   ssize_t retc = 0, bytesleft = Blen;
+
+// Enable zero-copy on the socket the first time around. Should this fail we
+// never try it again for this link.
+//
+   if (!zcState)
+      {if (setsockopt(FD, SOL_SOCKET, SO_ZEROCOPY, &setON, sizeof(setON)))
+          {zcState = -1; return sendData(Buff, Blen);}
+       zcState = 1;
+      }
+
+// Write the data out. Each successful send() is given the next number by the
+// kernel and generates one completion. We account for the send in the pin
+// before issuing it since the completion may be reaped by another thread
+// before send() returns; a failed send() does not use up a number. Should we
+// run out of option memory we simply copy the rest of the data.
+//
+   while(bytesleft)
+        {zcMutex.Lock();
+         if (!pinP->left) pinP->first = zcNext;
+         pinP->last = zcNext++; pinP->left++;
+         zcMutex.UnLock();
+         retc = send(FD, Buff, bytesleft, MSG_ZEROCOPY);
+         if (retc < 0)
+            {zcMutex.Lock(); zcNext--; pinP->last--; pinP->left--;
+             zcMutex.UnLock();
+             if (errno == EINTR) continue;
+             if (errno == ENOBUFS) return sendData(Buff, bytesleft);
+             break;
+            }
+         bytesleft -= retc; Buff += retc;
+        }
+
+// All done
+//
+   if (retc >= 0) AtomicAdd(LinkZCBytes, Blen);
+   return retc;
+#endif
+}
+
+/******************************************************************************/
+/*                                 s e t Z C                                  */
+/******************************************************************************/
+
+bool XrdLink::setZC(int minsz, XrdBuffManager *bpool)
+{
+#ifdef XRDLINK_ZEROCOPY
+   zcMinSz = (minsz > 0 ? minsz : 0);
+   zcPool  = bpool;
+   return true;
+#else
+   zcMinSz = 0;
+   return minsz <= 0;
+#endif
+}
+
 /******************************************************************************/
 /*                              s e t E t e x t                               */
 /******************************************************************************/
@@ -1167,12 +1338,12 @@ int XrdLink::Stats(char *buff, int blen, int do_sync)
    static const char statfmt[] = "<stats id=\"link\"><num>%d</num>"
           "<maxn>%d</maxn><tot>%lld</tot><in>%lld</in><out>%lld</out>"
           "<ctime>%lld</ctime><tmo>%d</tmo><stall>%d</stall>"
-          "<sfps>%d</sfps></stats>";
+          "<sfps>%d</sfps><zc>%lld</zc></stats>";
    int i, myLTLast;
 
 // Check if actual length wanted
 //
-   if (!buff) return sizeof(statfmt)+17*6;
+   if (!buff) return sizeof(statfmt)+17*7;
 
 // We must synchronize the statistical counters
 //
@@ -1194,7 +1365,8 @@ int XrdLink::Stats(char *buff, int blen, int do_sync)
                                      AtomicGet(LinkConTime),
                                      AtomicGet(LinkTimeOuts),
                                      AtomicGet(LinkStalls),
-                                     AtomicGet(LinkSfIntr));
+                                     AtomicGet(LinkSfIntr),
+                                     AtomicGet(LinkZCBytes));
    AtomicEnd(statsMutex);
    return i;
 }
@@ -1349,6 +1521,303 @@ int XrdLink::Terminate(const XrdLink *owner, int fdnum, unsigned int inst)
    return wTime;
 }
 
+/******************************************************************************/
+/* private                     z c C o l l e c t                              */
+/******************************************************************************/
+
+int XrdLink::zcCollect(int fd, XrdLinkZCPin *pins, bool &copied)
+{
+#ifndef XRDLINK_ZEROCOPY
+   return 0;
+#else
+   struct sock_extended_err *serr;
+   struct cmsghdr *cmP;
+   struct msghdr   msg;
+   XrdLinkZCPin   *pinP;
+   char cbuff[CMSG_SPACE(sizeof(struct sock_extended_err))
+            + CMSG_SPACE(sizeof(struct sockaddr_in6))];
+   int b, e, rc = 0, numReaped = 0;
+
+// Completions are posted to the socket error queue as a range of send numbers.
+// Reading the error queue never blocks, so we take whatever is there and
+// charge each range against the pins it covers. The caller holds the lock
+// protecting the pins.
+//
+   do {memset(&msg, 0, sizeof(msg));
+       msg.msg_control    = cbuff;
+       msg.msg_controllen = sizeof(cbuff);
+       if (recvmsg(fd, &msg, MSG_ERRQUEUE) < 0)
+          {if (errno == EINTR) continue;
+           if (errno != EAGAIN && errno != EWOULDBLOCK) rc = -1;
+           break;
+          }
+       for (cmP = CMSG_FIRSTHDR(&msg); cmP; cmP = CMSG_NXTHDR(&msg, cmP))
+           {if (!(cmP->cmsg_level == SOL_IP   && cmP->cmsg_type == IP_RECVERR)
+            &&  !(cmP->cmsg_level == SOL_IPV6 && cmP->cmsg_type == IPV6_RECVERR))
+               continue;
+            serr = (struct sock_extended_err *)CMSG_DATA(cmP);
+            if (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+               {if (serr->ee_errno) {errno = serr->ee_errno; rc = -1;}
+                continue;
+               }
+            numReaped++;
+            for (pinP = pins; pinP; pinP = pinP->next)
+                {if (!(pinP->left)) continue;
+                 b = (int)(serr->ee_info - pinP->first);
+                 e = (int)(serr->ee_data - pinP->first);
+                 if (b < 0) b = 0;
+                 if (e > (int)(pinP->last - pinP->first))
+                    e = (int)(pinP->last - pinP->first);
+                 if (e >= b) pinP->left -= e - b + 1;
+                }
+            if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) copied = true;
+           }
+      } while(!rc);
+
+   return (rc ? -1 : numReaped);
+#endif
+}
+
+/******************************************************************************/
+/* private                       z c E v e n t                                */
+/******************************************************************************/
+
+bool XrdLink::zcEvent()
+{
+#ifndef XRDLINK_ZEROCOPY
+   return false;
+#else
+   int eNum = 0;
+   socklen_t eLen = sizeof(eNum);
+
+// Zero-copy completions are queued on the socket error queue which causes the
+// socket to poll with an error even though nothing is wrong with it. Pollers
+// use this to tell the two apart. The completions are reaped here, which
+// clears the condition, so that re-enabling the link does not report the
+// same event again. Note that a real pending error is consumed here but the
+// caller will then treat the link as being in error anyway.
+//
+   if (!zcState) return false;
+   if (getsockopt(FD, SOL_SOCKET, SO_ERROR, &eNum, &eLen) || eNum) return false;
+   return zcReap() >= 0;
+#endif
+}
+
+/******************************************************************************/
+/* private                        z c F r e e                                 */
+/******************************************************************************/
+
+void XrdLink::zcFree()
+{
+   XrdLinkZCPin *pinP;
+
+// The socket is closed so any pinned buffer may be given back
+//
+   zcMutex.Lock();
+   pinP = zcPins; zcPins = 0;
+   zcMutex.UnLock();
+   zcRelease(pinP);
+}
+
+/******************************************************************************/
+/* private                      z c L i n g e r                               */
+/******************************************************************************/
+
+void XrdLink::zcLinger()
+{
+#ifdef XRDLINK_ZEROCOPY
+   static const struct linger noLinger = {1, 0};
+   XrdLinkZCPin *pinP;
+   int fd = (FD < 0 ? -FD : FD), lfd;
+
+// The link is about to be closed. Reap whatever the peer acknowledged so far.
+// Should sends still be outstanding, their buffers go with a duplicate of the
+// socket to be released once the kernel is done with them. Resetting the
+// socket instead would throw away the tail of what was already sent. We only
+// do so when the socket can't be kept.
+//
+   zcReap();
+   if (KeepFD) return;
+   zcMutex.Lock();
+   if (!(pinP = zcPins)) {zcMutex.UnLock(); return;}
+   if ((lfd = XrdSysFD_Dup(fd)) >= 0)
+      {zcPins = 0;
+       zcMutex.UnLock();
+       shutdown(lfd, SHUT_WR);
+       XrdLinkZCLinger::Add(lfd, pinP);
+       return;
+      }
+   zcMutex.UnLock();
+
+   XrdLog->Emsg("Link", errno, "keep zero-copy sends to", ID);
+   if (setsockopt(fd, SOL_SOCKET, SO_LINGER, &noLinger, sizeof(noLinger)))
+      XrdLog->Emsg("Link", errno, "abort zero-copy sends to", ID);
+#endif
+}
+
+/******************************************************************************/
+/* private                        z c R e a p                                 */
+/******************************************************************************/
+
+int XrdLink::zcReap()
+{
+#ifndef XRDLINK_ZEROCOPY
+   return 0;
+#else
+   XrdLinkZCPin *freeP;
+   bool copied = false;
+   int rc;
+
+// Take whatever completed and give back the buffers the kernel is done with
+// once we dropped the lock. If the kernel had to copy the data anyway (e.g.
+// loopback or a device without scatter-gather) zero-copy only adds overhead,
+// so stop using it.
+//
+   zcMutex.Lock();
+   rc = zcCollect((FD < 0 ? -FD : FD), zcPins, copied);
+   if (copied) zcState = -1;
+   freeP = zcUnlink(&zcPins);
+   zcMutex.UnLock();
+
+   zcRelease(freeP);
+   return rc;
+#endif
+}
+
+/******************************************************************************/
+/* private                     z c R e l e a s e                              */
+/******************************************************************************/
+
+void XrdLink::zcRelease(XrdLinkZCPin *pinP)
+{
+   XrdLinkZCPin *nextP;
+
+// Give the buffers in the list back to the pool
+//
+   while(pinP)
+        {nextP = pinP->next;
+         zcPool->Release(pinP->bP);
+         delete pinP;
+         pinP = nextP;
+        }
+}
+
+/******************************************************************************/
+/* private                       z c R e t r y                                */
+/******************************************************************************/
+
+bool XrdLink::zcRetry(struct pollfd &pfd)
+{
+
+// A reader polling the socket sees POLLERR when zero-copy completions are
+// queued. We reap them, which clears the condition, and poll again.
+//
+   if (pfd.revents != POLLERR || !zcEvent()) return false;
+   pfd.revents = 0;
+   return true;
+}
+
+/******************************************************************************/
+/* private                       z c U n p i n                                */
+/******************************************************************************/
+
+void XrdLink::zcUnpin(XrdLinkZCPin *pinP)
+{
+   XrdLinkZCPin **pinPP;
+
+// The sender is done with the buffer. Should the kernel be done with it as
+// well, give it back right away. Otherwise, the reaper will do so.
+//
+   zcMutex.Lock();
+   pinP->done = true;
+   if (pinP->left) pinP = 0;
+      else {pinPP = &zcPins;
+            while(*pinPP != pinP) pinPP = &((*pinPP)->next);
+            *pinPP = pinP->next;
+           }
+   zcMutex.UnLock();
+
+   if (pinP) {zcPool->Release(pinP->bP); delete pinP;}
+}
+
+/******************************************************************************/
+/* private                      z c U n l i n k                               */
+/******************************************************************************/
+
+XrdLinkZCPin *XrdLink::zcUnlink(XrdLinkZCPin **pinPP)
+{
+   XrdLinkZCPin *pinP, *freeP = 0;
+
+// Unlink the buffers that neither the sender nor the kernel references any
+// more and return them as a list. The caller holds the lock on the pins.
+//
+   while((pinP = *pinPP))
+        {if (pinP->done && !(pinP->left))
+            {*pinPP = pinP->next; pinP->next = freeP; freeP = pinP;}
+            else pinPP = &(pinP->next);
+        }
+   return freeP;
+}
+
+/******************************************************************************/
+/*                 X r d L i n k Z C L i n g e r : : A d d                    */
+/******************************************************************************/
+
+void XrdLinkZCLinger::Add(int fd, XrdLinkZCPin *pins)
+{
+   lgSock *sP = new lgSock;
+   XrdLinkZCPin *pinP;
+   bool isIdle;
+
+// The link is gone, so nobody will send from these buffers any more
+//
+   for (pinP = pins; pinP; pinP = pinP->next) pinP->done = true;
+   sP->pins     = pins;
+   sP->deadline = time(0) + maxWait;
+   sP->fd       = fd;
+
+// Add the socket to the list and start looking at the list if need be
+//
+   lgMutex.Lock();
+   isIdle  = (lgFirst == 0);
+   sP->next = lgFirst; lgFirst = sP;
+   if (isIdle) XrdLink::XrdSched->Schedule((XrdJob *)&lgJob, time(0)+1);
+   lgMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                X r d L i n k Z C L i n g e r : : D o I t                   */
+/******************************************************************************/
+
+void XrdLinkZCLinger::DoIt()
+{
+#ifdef XRDLINK_ZEROCOPY
+   static const struct linger noLinger = {1, 0};
+   lgSock *sP, **sPP;
+   time_t now = time(0);
+   bool copied;
+
+// Reap the completions for each socket. A socket is closed once the kernel is
+// done with all of its buffers, or reset when the peer took too long.
+//
+   lgMutex.Lock();
+   sPP = &lgFirst;
+   while((sP = *sPP))
+        {XrdLink::zcCollect(sP->fd, sP->pins, copied);
+         XrdLink::zcRelease(XrdLink::zcUnlink(&(sP->pins)));
+         if (sP->pins && now < sP->deadline) {sPP = &(sP->next); continue;}
+         if (sP->pins)
+            setsockopt(sP->fd, SOL_SOCKET, SO_LINGER, &noLinger, sizeof(noLinger));
+         close(sP->fd);
+         XrdLink::zcRelease(sP->pins);
+         *sPP = sP->next;
+         delete sP;
+        }
+   if (lgFirst) XrdLink::XrdSched->Schedule((XrdJob *)this, now+1);
+   lgMutex.UnLock();
+#endif
+}
+
 /******************************************************************************/
 /*                              i d l e S c a n                               */
 /******************************************************************************/
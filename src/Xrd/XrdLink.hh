@@ -52,7 +52,10 @@
 /*                      C l a s s   D e f i n i t i o n                       */
 /******************************************************************************/
   
+class XrdBuffer;
+class XrdBuffManager;
 class XrdInet;
+class XrdLinkZCPin;
 class XrdNetAddr;
 class XrdPoll;
 class XrdOucTrace;
@@ -64,10 +67,12 @@ class XrdLink : XrdJob
 {
 public:
 friend class XrdLinkScan;
+friend class XrdLinkZCLinger;
 friend class XrdPoll;
 friend class XrdPollPoll;
 friend class XrdPollDev;
 friend class XrdPollE;
+friend class XrdPollU;
 
 //-----------------------------------------------------------------------------
 //! Obtain the address information for this link.
@@ -216,6 +221,22 @@ typedef XrdOucSFVec sfVec;
 
 int           Send(const sfVec *sdP, int sdn); // Iff sfOK > 0
 
+// Large memory segments passed to Send(sfVec) may be sent using MSG_ZEROCOPY
+// when they lie in a buffer that the caller hands over to the link. The link
+// then owns the buffer, whatever the outcome, and returns it to the buffer
+// pool once the kernel no longer references it. Completions are reaped as
+// they show up so the caller never waits for them. setZC() sets the minimum
+// segment size (0 turns it off) and the pool, and returns false if zero-copy
+// sends are not supported. useZC() tells the caller whether a segment of the
+// given size would be sent that way; only then may a buffer be passed.
+//
+int           Send(const sfVec *sdP, int sdn, XrdBuffer *bP);
+
+static bool   setZC(int minsz, XrdBuffManager *bpool);
+
+bool          useZC(int dlen) {return zcMinSz > 0 && dlen >= zcMinSz
+                                   && zcState >= 0 && !sendQ;}
+
 void          Serialize();                              // ASYNC Mode
 
 int           setEtext(const char *text);
@@ -256,6 +277,19 @@ private:
 
 void   Reset();
 int    sendData(const char *Buff, int Blen);
+int    sendZC(const char *Buff, int Blen, XrdLinkZCPin *pinP);
+static
+int    zcCollect(int fd, XrdLinkZCPin *pins, bool &copied);
+bool   zcEvent();   // Used by pollers
+void   zcFree();
+void   zcLinger();
+int    zcReap();
+static
+void   zcRelease(XrdLinkZCPin *pinP);
+bool   zcRetry(struct pollfd &pfd);
+void   zcUnpin(XrdLinkZCPin *pinP);
+static
+XrdLinkZCPin *zcUnlink(XrdLinkZCPin **pinPP);
 
 static XrdSysError  *XrdLog;
 static XrdOucTrace  *XrdTrace;
@@ -283,6 +317,9 @@ static int          LinkCountMax;
 static int          LinkTimeOuts;
 static int          LinkStalls;
 static int          LinkSfIntr;
+static long long    LinkZCBytes;
+static int          zcMinSz;
+static XrdBuffManager *zcPool;
        long long        BytesIn;
        long long        BytesInTot;
        long long        BytesOut;
@@ -329,6 +366,10 @@ char                isIdle;
 char                inQ;    // Only used by PollPoll.icc
 char                isBridged;
 char                KillCnt;        // Protected by opMutex!
+char                zcState;        // <0 off, >0 on (reaper only turns it off)
+unsigned int        zcNext;         // Protected by wrMutex && zcMutex
+XrdLinkZCPin       *zcPins;         // Protected by zcMutex
+XrdSysMutex         zcMutex;
 static const char   KillMax =   60;
 static const char   KillMsk = 0x7f;
 static const char   KillXwt = 0x80;
@@ -46,6 +46,9 @@
 #include "Xrd/XrdPollDev.hh"
 #elif defined( __linux__ )
 #include "Xrd/XrdPollE.hh"
+#ifdef HAVE_IO_URING
+#include "Xrd/XrdPollU.hh"
+#endif
 #else
 #include "Xrd/XrdPollPoll.hh"
 #endif
@@ -86,6 +89,8 @@ int           Stats(char *buff, int blen, int do_sync=0) {return 0;}
        XrdSysError  *XrdPoll::XrdLog   = 0;
        XrdScheduler *XrdPoll::XrdSched = 0;
 
+       XrdPoll::pollType XrdPoll::pollMode = XrdPoll::pollNative;
+
 /******************************************************************************/
 /*              T h r e a d   S t a r t u p   I n t e r f a c e               */
 /******************************************************************************/
@@ -362,6 +367,9 @@ int XrdPoll::Stats(char *buff, int blen, int do_sync)
 #include "Xrd/XrdPollDev.icc"
 #elif defined( __linux__ )
 #include "Xrd/XrdPollE.icc"
+#ifdef HAVE_IO_URING
+#include "Xrd/XrdPollU.icc"
+#endif
 #else
 #include "Xrd/XrdPollPoll.icc"
 #endif
@@ -69,6 +69,14 @@ static  int   Finish(XrdLink *lp, const char *etxt=0); //Implementation supplied
 static  void  Init(XrdSysError *eP, XrdOucTrace *tP, XrdScheduler *sP)
                   {XrdLog = eP; XrdTrace = tP; XrdSched = sP;}
 
+// PollMode() selects the poller implementation; it must be called before
+//            Setup(). The native poller is used if the selected one is
+//            not available on this platform.
+//
+enum    pollType {pollNative = 0, pollURing, pollURingSQ};
+
+static  void  PollMode(pollType ptype) {pollMode = ptype;}
+
 // Poll2Text() converts bits in an revents item to text
 //
 static  char *Poll2Text(short events); // Implementation supplied
@@ -103,6 +111,7 @@ static     const char   *TraceID;                  // For tracing
 static     XrdOucTrace  *XrdTrace;
 static     XrdSysError  *XrdLog;
 static     XrdScheduler *XrdSched;
+static     pollType      pollMode;
 
 // Gets the next request on the poll pipe. This is common to all implentations.
 //
@@ -0,0 +1,113 @@
+#ifndef __XRD_POLLU_H__
+#define __XRD_POLLU_H__
+/******************************************************************************/
+/*                                                                            */
+/*                           X r d P o l l U . h h                            */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <linux/io_uring.h>
+
+#include "Xrd/XrdPoll.hh"
+
+// The io_uring poller is a readiness notifier like the epoll poller it can
+// replace. It arms a one-shot poll request for each enabled link and the link
+// is scheduled when its poll completes, exactly as with the native pollers;
+// reading and writing the link is still done by XrdLink::Recv()/Send(). What
+// io_uring saves is the poller's own system calls. Completions are reaped
+// from the shared completion ring so that dispatching a batch of ready links
+// costs at most one system call. Requests made while the poller is busy are
+// queued and go to the kernel along with the poller's next io_uring_enter();
+// only when the poller is waiting do we submit right away. When the ring is
+// created with a kernel submission thread (sqpoll) enabling a link does not
+// need a system call at all.
+//
+// Each armed poll is tagged with the socket and an arm number so that a
+// completion for a poll that has since been disarmed (or for a connection
+// that reused the socket) is recognized and dropped. Multishot polls are not
+// used as a link must not see events while it is being serviced and events
+// occurring while it is disabled would be lost upon re-enabling it.
+//
+class XrdPollU : public XrdPoll
+{
+public:
+
+       void Disable(XrdLink *lp, const char *etxt=0);
+
+       int  Enable(XrdLink *lp);
+
+       void Start(XrdSysSemaphore *syncp, int &rc);
+
+static XrdPoll *newPoller(int pollid, int numfd, bool sqpoll);
+
+            XrdPollU(int rfd, struct io_uring_params &parms,
+                     void *sqmem, size_t sqsz, void *cqmem, size_t cqsz,
+                     struct io_uring_sqe *sqes, size_t sqesz, int numfd);
+           ~XrdPollU();
+
+protected:
+       void  Exclude(XrdLink *lp);
+       int   Include(XrdLink *lp);
+const  char *x2Text(unsigned int evf, char *buff);
+
+private:
+       int  Arm(XrdLink *lp);
+       bool armGrow(int fd);
+       void Disarm(XrdLink *lp);
+       int  Flush();
+       void Queue(int opc, int fd, unsigned long long udata,
+                  unsigned long long addr=0);
+       void Wake();
+
+static const int uPollEvents = POLLIN | POLLPRI | POLLRDHUP;
+
+XrdSysMutex          sqMutex;    // Serializes use of the submission ring
+XrdSysCondVar        sqCV;       // Waiting for room in the submission ring
+int                  ringFD;
+bool                 sqPoll;
+bool                 pollWait;   // Poller is waiting in the kernel
+unsigned int         sqPend;     // Queued requests not yet submitted
+int                  sqWait;     // Threads waiting on sqCV
+
+unsigned int        *armTab;     // Arm number of the armed poll by socket
+int                  armMax;     // Number of entries in armTab
+unsigned int         armSeq;     // Last arm number handed out
+
+unsigned int        *sqHead;     // Submission ring (shared with the kernel)
+unsigned int        *sqTail;
+unsigned int        *sqMask;
+unsigned int        *sqFlags;
+unsigned int        *sqArray;
+struct io_uring_sqe *sqEnts;
+
+unsigned int        *cqHead;     // Completion ring (shared with the kernel)
+unsigned int        *cqTail;
+unsigned int        *cqMask;
+struct io_uring_cqe *cqEnts;
+
+void                *sqMem;
+size_t               sqLen;
+void                *cqMem;
+size_t               cqLen;
+size_t               sqeLen;
+};
+#endif
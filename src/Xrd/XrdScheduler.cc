@@ -41,6 +41,7 @@
 
 #include "Xrd/XrdJob.hh"
 #include "Xrd/XrdScheduler.hh"
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 
 #define XRD_TRACE XrdTrace->
@@ -65,6 +66,21 @@ class XrdSchedulerPID
                         {next = prev; pid = newpid;}
      ~XrdSchedulerPID() {}
      };
+
+// Each run queue has its own lock. When more than one queue exists, a worker
+// takes jobs from its home queue and steals from the other queues when its own
+// queue is empty. The padding keeps queues out of each other's cache lines.
+//
+class XrdSchedulerQueue
+     {public:
+      XrdSysMutex      qMutex;
+      XrdJob          *First;
+      XrdJob          *Last;
+      char             Pad[64];
+
+      XrdSchedulerQueue() : First(0), Last(0) {}
+     ~XrdSchedulerQueue() {}
+     };
   
 /******************************************************************************/
 /*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
@@ -115,7 +131,11 @@ XrdScheduler::XrdScheduler(XrdSysError *eP, XrdOucTrace *tP,
     num_Layoffs =  0;
     num_Limited =  0;
     firstPID    =  0;
-    WorkFirst = WorkLast = TimerQueue = 0;
+    TimerQueue  =  0;
+    WorkQ       =  new XrdSchedulerQueue[1];
+    num_WorkQ   =  1;
+    nxt_WorkQ   =  0;
+    nxt_HomeQ   =  0;
 
 // Make sure we are using the maximum number of threads allowed (Linux only)
 //
@@ -320,21 +340,23 @@ void *XrdScheduler::Reaper()
   
 void XrdScheduler::Run()
 {
-   int waiting;
+   int waiting, homeQ;
    XrdJob *jp;
 
+// Pick the run queue that this worker prefers to take work from
+//
+   AtomicBeg(SchedMutex);
+   homeQ = AtomicInc(nxt_HomeQ);
+   AtomicEnd(SchedMutex);
+   homeQ = (homeQ & 0x7fffffff) % num_WorkQ;
+
 // Wait for work then do it (an endless task for a worker thread)
 //
    do {do {DispatchMutex.Lock();          idl_Workers++;DispatchMutex.UnLock();
            WorkAvail.Wait();
            DispatchMutex.Lock();waiting = --idl_Workers;DispatchMutex.UnLock();
-           SchedMutex.Lock();
-           if ((jp = WorkFirst))
-              {if (!(WorkFirst = jp->NextJob)) WorkLast = 0;
-               if (num_JobsinQ) num_JobsinQ--;
-                  else XrdLog->Emsg("Scheduler","Job queue count underflow!");
-              } else {
-               num_JobsinQ = 0;
+           if (!(jp = getJob(homeQ)))
+              {SchedMutex.Lock();
                if (num_Layoffs > 0)
                   {num_Layoffs--;
                    if (waiting)
@@ -344,8 +366,8 @@ void XrdScheduler::Run()
                        return;
                       }
                   }
+               SchedMutex.UnLock();
               }
-           SchedMutex.UnLock();
           } while(!jp);
 
     // Check if we should hire a new worker (we always want 1 idle thread)
@@ -364,66 +386,18 @@ void XrdScheduler::Run()
   
 void XrdScheduler::Schedule(XrdJob *jp)
 {
-// Lock down our data area
+// Place the request on a queue and broadcast it
 //
-   SchedMutex.Lock();
-
-// Place the request on the queue and broadcast it
-//
-   jp->NextJob  = 0;
-   if (WorkFirst)
-      {WorkLast->NextJob = jp;
-       WorkLast = jp;
-      } else {
-       WorkFirst = jp;
-       WorkLast  = jp;
-      }
-   WorkAvail.Post();
-
-// Calculate statistics
-//
-   num_Jobs++;
-   num_JobsinQ++;
-   if (num_JobsinQ > max_QLength) max_QLength = num_JobsinQ;
-
-// Unlock the data area and return
-//
-   SchedMutex.UnLock();
+   putJob(1, jp, jp);
 }
 
 /******************************************************************************/
   
 void XrdScheduler::Schedule(int numjobs, XrdJob *jfirst, XrdJob *jlast)
 {
-
-// Lock down our data area
+// Place the request list on a queue and broadcast it
 //
-   SchedMutex.Lock();
-
-// Place the request list on the queue
-//
-   jlast->NextJob = 0;
-   if (WorkFirst)
-      {WorkLast->NextJob = jfirst;
-       WorkLast = jlast;
-      } else {
-       WorkFirst = jfirst;
-       WorkLast  = jlast;
-      }
-
-// Calculate statistics
-//
-   num_Jobs    += numjobs;
-   num_JobsinQ += numjobs;
-   if (num_JobsinQ > max_QLength) max_QLength = num_JobsinQ;
-
-// Indicate number of jobs to work on
-//
-   while(numjobs--) WorkAvail.Post();
-
-// Unlock the data area and return
-//
-   SchedMutex.UnLock();
+   putJob(numjobs, jfirst, jlast);
 }
 
 /******************************************************************************/
@@ -505,6 +479,41 @@ void XrdScheduler::setParms(int minw, int maxw, int avlw, int maxi, int once)
    TRACE(SCHED,"Set stk_Workers=" <<stk_Workers <<" max_Workidl=" <<max_Workidl);
 }
 
+/******************************************************************************/
+/*                             s e t Q u e u e s                              */
+/******************************************************************************/
+  
+void XrdScheduler::setQueues(int numq) // Must be called prior to Start()!
+{
+   static const int maxQ = 1024;
+
+// Establish a reasonable number of run queues. Zero means one per cpu.
+//
+   if (numq <= 0)
+      {numq = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+       if (numq <= 0) numq = 1;
+      }
+   if (numq > maxQ) numq = maxQ;
+
+// Replace the existing queues. Since no worker is running yet, the only
+// pending work can be in the first queue; carry it over.
+//
+   SchedMutex.Lock();
+   if (numq != num_WorkQ)
+      {XrdSchedulerQueue *newQ = new XrdSchedulerQueue[numq];
+       newQ[0].First = WorkQ[0].First;
+       newQ[0].Last  = WorkQ[0].Last;
+       delete [] WorkQ;
+       WorkQ     = newQ;
+       num_WorkQ = numq;
+      }
+   SchedMutex.UnLock();
+
+// Debug the info
+//
+   TRACE(SCHED,"Set run queues=" <<num_WorkQ);
+}
+
 /******************************************************************************/
 /*                                 S t a r t                                  */
 /******************************************************************************/
@@ -606,6 +615,48 @@ void XrdScheduler::TimeSched()
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
+/******************************************************************************/
+/*                                g e t J o b                                 */
+/******************************************************************************/
+  
+XrdJob *XrdScheduler::getJob(int homeQ)
+{
+   XrdSchedulerQueue *qP;
+   XrdJob *jp;
+   int i, inQ;
+
+// Look in our home queue first and then try to steal work from the other
+// queues. Every job posted the semaphore once, yet the job we were woken for
+// may have been taken by a worker woken for a job placed on a queue we had
+// already looked at. Should jobs remain after one pass we pass the wake-up on
+// instead of looking again, so that no job is left without a worker.
+//
+   for (i = 0; i < num_WorkQ; i++)
+       {qP = &WorkQ[(homeQ + i) % num_WorkQ];
+        qP->qMutex.Lock();
+        if ((jp = qP->First))
+           {if (!(qP->First = jp->NextJob)) qP->Last = 0;
+            AtomicBeg(SchedMutex);
+            AtomicDec(num_JobsinQ);
+            AtomicEnd(SchedMutex);
+            qP->qMutex.UnLock();
+            return jp;
+           }
+        qP->qMutex.UnLock();
+       }
+
+   if (num_WorkQ > 1)
+      {AtomicBeg(SchedMutex);
+       inQ = AtomicGet(num_JobsinQ);
+       AtomicEnd(SchedMutex);
+       if (inQ > 0) WorkAvail.Post();
+      }
+
+// There is nothing to do
+//
+   return 0;
+}
+
 /******************************************************************************/
 /*                           h i r e   W o r k e r                            */
 /******************************************************************************/
@@ -648,6 +699,53 @@ void XrdScheduler::hireWorker(int dotrace)
       } else if (dotrace) TRACE(SCHED, "Now have " <<num_Workers <<" workers" );
 }
  
+/******************************************************************************/
+/*                                p u t J o b                                 */
+/******************************************************************************/
+  
+void XrdScheduler::putJob(int numjobs, XrdJob *jfirst, XrdJob *jlast)
+{
+   XrdSchedulerQueue *qP;
+   int qNum, inQ;
+
+// Select the queue. With a single queue this is the classic FIFO behaviour.
+// Otherwise, spread the work round-robin; idle workers will steal it.
+//
+   if (num_WorkQ == 1) qP = WorkQ;
+      else {AtomicBeg(SchedMutex);
+            qNum = AtomicInc(nxt_WorkQ);
+            AtomicEnd(SchedMutex);
+            qP = &WorkQ[(qNum & 0x7fffffff) % num_WorkQ];
+           }
+
+// Place the request list on the queue. The queue count must be adjusted while
+// we hold the queue lock so that it never goes negative.
+//
+   qP->qMutex.Lock();
+   jlast->NextJob = 0;
+   if (qP->First)
+      {qP->Last->NextJob = jfirst;
+       qP->Last = jlast;
+      } else {
+       qP->First = jfirst;
+       qP->Last  = jlast;
+      }
+   AtomicBeg(SchedMutex);
+   AtomicAdd(num_Jobs, numjobs);
+   AtomicFAdd(inQ, num_JobsinQ, numjobs);
+   AtomicEnd(SchedMutex);
+   qP->qMutex.UnLock();
+
+// Calculate statistics (the maximum is advisory so no lock is needed)
+//
+   inQ += numjobs;
+   if (inQ > max_QLength) max_QLength = inQ;
+
+// Indicate number of jobs to work on
+//
+   while(numjobs--) WorkAvail.Post();
+}
+
 /******************************************************************************/
 /*                             t r a c e E x i t                              */
 /******************************************************************************/
@@ -37,6 +37,7 @@
 
 class XrdOucTrace;
 class XrdSchedulerPID;
+class XrdSchedulerQueue;
 class XrdSysError;
 
 #define MAX_SCHED_PROCS 30000
@@ -66,6 +67,8 @@ void          Schedule(XrdJob *jp, time_t atime);
 
 void          setParms(int minw, int maxw, int avlt, int maxi, int once=0);
 
+void          setQueues(int numq);
+
 void          Start();
 
 int           Stats(char *buff, int blen, int do_sync=0);
@@ -102,8 +105,10 @@ int        stk_Workers;   // Sched: Number of sticky workers we can have
 int        num_JobsinQ;   // Sched: Number of outstanding jobs in the queue
 int        num_Layoffs;   // Sched: Number of threads to terminate
 
-XrdJob                *WorkFirst;  // Pending work
-XrdJob                *WorkLast;
+XrdSchedulerQueue     *WorkQ;      // Pending work (one or more run queues)
+int                    num_WorkQ;  // Number of run queues
+int                    nxt_WorkQ;  // Next queue for a non-worker Schedule()
+int                    nxt_HomeQ;  // Next home queue for a new worker
 XrdSysSemaphore        WorkAvail;
 XrdSysMutex            SchedMutex; // Protects private area
 
@@ -114,7 +119,9 @@ XrdSysMutex            TimerMutex; // Protects scheduler area
 XrdSchedulerPID       *firstPID;
 XrdSysMutex            ReaperMutex;
 
+XrdJob *getJob(int homeQ);
 void hireWorker(int dotrace=1);
+void putJob(int num, XrdJob *jfirst, XrdJob *jlast);
 void Monitor();
 void traceExit(pid_t pid, int status);
 static const char *TraceID;
@@ -76,6 +76,67 @@ target_link_libraries(
   XrdServer
   XrdUtils )
 
+#-------------------------------------------------------------------------------
+# xrdschedbench (not installed)
+#-------------------------------------------------------------------------------
+add_executable(
+  xrdschedbench
+  XrdApps/XrdSchedBench.cc )
+
+target_link_libraries(
+  xrdschedbench
+  XrdUtils
+  pthread )
+
+#-------------------------------------------------------------------------------
+# xrdcksbench (not installed)
+#-------------------------------------------------------------------------------
+add_executable(
+  xrdcksbench
+  XrdApps/XrdCksBench.cc )
+
+target_link_libraries(
+  xrdcksbench
+  XrdUtils )
+
+#-------------------------------------------------------------------------------
+# xrdpfcreadvbench (not installed)
+#-------------------------------------------------------------------------------
+add_executable(
+  xrdpfcreadvbench
+  XrdApps/XrdPfcReadVBench.cc )
+
+target_link_libraries(
+  xrdpfcreadvbench
+  XrdCl
+  XrdUtils
+  pthread )
+
+#-------------------------------------------------------------------------------
+# xrdclreadbench (not installed)
+#-------------------------------------------------------------------------------
+add_executable(
+  xrdclreadbench
+  XrdApps/XrdClReadBench.cc )
+
+target_link_libraries(
+  xrdclreadbench
+  XrdCl
+  XrdUtils )
+
+#-------------------------------------------------------------------------------
+# xrdclasyncbench (not installed)
+#-------------------------------------------------------------------------------
+add_executable(
+  xrdclasyncbench
+  XrdApps/XrdClAsyncBench.cc )
+
+target_link_libraries(
+  xrdclasyncbench
+  XrdCl
+  XrdUtils
+  pthread )
+
 #-------------------------------------------------------------------------------
 # xrdmapc
 #-------------------------------------------------------------------------------
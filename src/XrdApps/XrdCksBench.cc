@@ -0,0 +1,263 @@
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d C k s B e n c h . c c                          */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/* This utility measures the throughput of the native checksum calculators
+   and compares them to the simple byte at a time loops they replaced. Each
+   result is also verified against the reference loop. The syntax is:
+
+   xrdcksbench [-b <bsize>] [-n <mbytes>]
+
+   <bsize>     the buffer size passed to each Update() call (default 1m).
+   <mbytes>    the number of megabytes to checksum per run (default 2048).
+*/
+
+/******************************************************************************/
+/*                         i n c l u d e   f i l e s                          */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/time.h>
+
+#include "XrdCks/XrdCksCalc.hh"
+#include "XrdCks/XrdCksCalcadler32.hh"
+#include "XrdCks/XrdCksCalccrc32.hh"
+#include "XrdCks/XrdCksCalccrc32C.hh"
+#include "XrdCks/XrdCksCalcmd5.hh"
+#include "XrdOuc/XrdOucCRC.hh"
+
+/******************************************************************************/
+/*                       R e f e r e n c e   L o o p s                        */
+/******************************************************************************/
+
+namespace
+{
+unsigned int msbTab[256], lsbTab[256], castTab[256];
+
+void MakeTables()
+{
+   unsigned int c;
+
+   for (unsigned int i = 0; i < 256; i++)
+       {c = i << 24;
+        for (int k = 0; k < 8; k++) c = (c & 0x80000000 ? (c << 1)^0x04C11DB7
+                                                         : c << 1);
+        msbTab[i] = c;
+        c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1 ? (c >> 1)^0xEDB88320 : c >> 1);
+        lsbTab[i] = c;
+        c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1 ? (c >> 1)^0x82F63B78 : c >> 1);
+        castTab[i] = c;
+       }
+}
+
+// The POSIX cksum crc as previously computed by XrdCksCalccrc32
+//
+unsigned int RefCRC32(const unsigned char *p, long long n)
+{
+   unsigned int c = 0;
+   long long len = n;
+
+   while(n--) c = (c << 8) ^ msbTab[(c >> 24) ^ *p++];
+   while(len) {c = (c << 8) ^ msbTab[(c >> 24) ^ (len & 0xff)]; len >>= 8;}
+   return ~c;
+}
+
+// The zlib adler32 without unrolling as previously used by XrdCksCalcadler32
+//
+unsigned int RefAdler(const unsigned char *p, long long n)
+{
+   unsigned int s1 = 1, s2 = 0;
+   int k;
+
+   while(n > 0)
+        {k = (n < 5552 ? n : 5552); n -= k;
+         while(k--) {s1 += *p++; s2 += s1;}
+         s1 %= 65521; s2 %= 65521;
+        }
+   return (s2 << 16) | s1;
+}
+
+// The reflected crc32 as previously computed by XrdOucCRC::CRC32
+//
+unsigned int RefOucCRC(const unsigned char *p, long long n)
+{
+   unsigned int c = 0xffffffff;
+
+   while(n--) c = (c >> 8) ^ lsbTab[(c ^ *p++) & 0xff];
+   return c ^ 0xffffffff;
+}
+
+// The crc32c computed a byte at a time
+//
+unsigned int RefCRC32C(const unsigned char *p, long long n)
+{
+   unsigned int c = 0xffffffff;
+
+   while(n--) c = (c >> 8) ^ castTab[(c ^ *p++) & 0xff];
+   return c ^ 0xffffffff;
+}
+
+/******************************************************************************/
+/*                                T i m i n g                                 */
+/******************************************************************************/
+
+double Now()
+{
+   struct timeval tv;
+   gettimeofday(&tv, 0);
+   return tv.tv_sec + tv.tv_usec/1e6;
+}
+
+char     *Buff;
+int       bSize;
+long long totSZ;
+
+// Time a reference loop over the whole run returning GB/s
+//
+double RunRef(unsigned int (*func)(const unsigned char *, long long),
+              unsigned int &result)
+{
+   long long done = 0;
+   double tBeg = Now();
+
+   while(done < totSZ)
+        {result = func((const unsigned char *)Buff, bSize); done += bSize;}
+   return totSZ/(Now() - tBeg)/1e9;
+}
+
+// Time a calculator over the whole run returning GB/s. Each buffer is a
+// separate checksum so that the result can be compared with the reference.
+//
+double RunCks(XrdCksCalc *csP, unsigned int &result)
+{
+   long long done = 0;
+   double tBeg = Now();
+
+   while(done < totSZ)
+        {csP->Init(); csP->Update(Buff, bSize); done += bSize;
+         memcpy(&result, csP->Final(), sizeof(result));
+        }
+   result = ntohl(result);
+   return totSZ/(Now() - tBeg)/1e9;
+}
+
+// Time XrdOucCRC::CRC32 over the whole run returning GB/s
+//
+double RunOuc(unsigned int &result)
+{
+   long long done = 0;
+   double tBeg = Now();
+
+   while(done < totSZ)
+        {result = XrdOucCRC::CRC32((const unsigned char *)Buff, bSize);
+         done += bSize;
+        }
+   return totSZ/(Now() - tBeg)/1e9;
+}
+
+void Report(const char *name, double oldR, unsigned int oldV,
+                              double newR, unsigned int newV)
+{
+   printf("%-8s %8.2f GB/s %8.2f GB/s %6.2fx %s\n", name, oldR, newR,
+          newR/oldR, (oldV == newV ? "" : "MISMATCH!"));
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+   XrdCksCalcadler32 csAdler;
+   XrdCksCalccrc32   csCRC32;
+   XrdCksCalccrc32C  csCRC32C;
+   XrdCksCalcmd5     csMD5;
+   unsigned int oldV, newV;
+   double oldR, newR;
+   long long mBytes = 2048;
+   char *eP;
+   int c;
+
+// Process the options
+//
+   bSize = 1024*1024;
+   while((c = getopt(argc, argv, "b:n:")) != -1)
+        {switch(c)
+               {case 'b': bSize = strtol(optarg, &eP, 10);
+                          if (*eP == 'k' || *eP == 'K') bSize *= 1024;
+                             else if (*eP == 'm' || *eP == 'M')
+                                     bSize *= 1024*1024;
+                          break;
+                case 'n': mBytes = atoll(optarg); break;
+                default:  fprintf(stderr, "Usage: xrdcksbench [-b <bsize>] "
+                                  "[-n <mbytes>]\n");
+                          return 1;
+               }
+        }
+   if (bSize <= 0 || mBytes <= 0)
+      {fprintf(stderr, "xrdcksbench: invalid option value\n"); return 1;}
+   totSZ = mBytes*1024*1024;
+
+// Fill the buffer with something other than zeroes
+//
+   Buff = (char *)malloc(bSize);
+   srand(1);
+   for (int i = 0; i < bSize; i++) Buff[i] = rand();
+   MakeTables();
+
+// Run each pair reporting the old and the new rate
+//
+   printf("%-8s %13s %13s %7s   (%d byte buffers, crc32c %s)\n", "digest",
+          "old", "new", "speedup", bSize,
+          (XrdOucCRC::HW32C() ? "hardware" : "software"));
+
+   oldR = RunRef(RefAdler, oldV);
+   newR = RunCks(&csAdler, newV);
+   Report("adler32", oldR, oldV, newR, newV);
+
+   oldR = RunRef(RefCRC32, oldV);
+   newR = RunCks(&csCRC32, newV);
+   Report("crc32", oldR, oldV, newR, newV);
+
+   oldR = RunRef(RefCRC32C, oldV);
+   newR = RunCks(&csCRC32C, newV);
+   Report("crc32c", oldR, oldV, newR, newV);
+
+   oldR = RunRef(RefOucCRC, oldV);
+   newR = RunOuc(newV);
+   Report("ouccrc", oldR, oldV, newR, newV);
+
+   newR = RunCks(&csMD5, newV);
+   printf("%-8s %13s %8.2f GB/s\n", "md5", "", newR);
+
+   free(Buff);
+   return 0;
+}
@@ -0,0 +1,272 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d C l A s y n c B e n c h . c c                    */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/* This utility measures how fast XrdCl dispatches many concurrent small
+   asynchronous reads on one channel. The syntax is:
+
+   xrdclasyncbench [-n <reads>] [-s <rsize>] [-w <window>] <url>
+
+   <reads>     the total number of reads (default 1000000).
+   <rsize>     the size of each read (default 64).
+   <window>    the number of reads kept outstanding (default 4096, at most
+               60000 as each one holds a stream id).
+
+   Every completed read immediately issues the next one at the following
+   offset, so the client keeps <window> requests in flight until all reads
+   are done. The data is checked against the first pass over the file. A
+   data server on the loopback interface, e.g. one with xrd.port 21094 and
+   all.export /data, serves as the other end so that the client side
+   dominates the result.
+*/
+
+/******************************************************************************/
+/*                         i n c l u d e   f i l e s                          */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <vector>
+
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                         L o c a l   O b j e c t s                          */
+/******************************************************************************/
+
+namespace
+{
+double Now()
+{
+   struct timeval tv;
+   gettimeofday(&tv, 0);
+   return tv.tv_sec + tv.tv_usec/1e6;
+}
+
+long long Size(const char *arg)
+{
+   char *eP;
+   long long n = strtoll(arg, &eP, 10);
+
+   if (*eP == 'k' || *eP == 'K') n <<= 10;
+      else if (*eP == 'm' || *eP == 'M') n <<= 20;
+   return n;
+}
+
+/******************************************************************************/
+/*                                 R u n n e r                                */
+/******************************************************************************/
+
+// Hands out the reads and collects the results of all the slots.
+//
+class Runner
+{
+public:
+
+bool   Next(long long &num)   // Called with the mutex held
+          {if (nNext >= nRead) return false;
+           num = nNext++;
+           return true;
+          }
+
+void   Done(bool ok, bool same, uint32_t got)
+          {Cond.Lock();
+           if (!ok) nFail++;
+              else if (!same) nBad++;
+           bytes += got;
+           nDone++;
+           Cond.UnLock();
+          }
+
+void   Retire()
+          {Cond.Lock();
+           if (!--nActive) Cond.Signal();
+           Cond.UnLock();
+          }
+
+XrdCl::File    File;
+XrdSysCondVar  Cond;
+const char    *Data;
+long long      nRead, nNext, nDone, nFail, nBad, bytes, nActive;
+uint64_t       fSize;
+uint32_t       rSize;
+
+               Runner() : Cond(0), Data(0), nRead(0), nNext(0), nDone(0),
+                          nFail(0), nBad(0), bytes(0), nActive(0),
+                          fSize(0), rSize(0) {}
+};
+
+/******************************************************************************/
+/*                                   S l o t                                  */
+/******************************************************************************/
+
+// One outstanding read. On completion the slot checks the data and issues
+// the next read itself, from the thread that handled the response. A failed
+// read retires the slot as the file may still be locked while a fatal error
+// is being reported.
+//
+class Slot : public XrdCl::ResponseHandler
+{
+public:
+
+bool Issue()
+        {long long num;
+         XrdCl::XRootDStatus st;
+
+         while(1)
+              {RP->Cond.Lock();
+               bool more = RP->Next(num);
+               RP->Cond.UnLock();
+               if (!more) return false;
+               Offset = (uint64_t)num * RP->rSize % (RP->fSize - RP->rSize + 1);
+               st = RP->File.Read(Offset, RP->rSize, &Buff[0], this);
+               if (st.IsOK()) return true;
+               RP->Done(false, false, 0);
+              }
+        }
+
+void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response)
+        {XrdCl::ChunkInfo *chunk = 0;
+         bool ok = status->IsOK(), same = false;
+         uint32_t got = 0;
+
+         if (ok && response)
+            {response->Get(chunk);
+             got  = chunk->length;
+             same = (got == RP->rSize
+                  && !memcmp(&Buff[0], RP->Data + Offset, got));
+            }
+         delete status;
+         delete response;
+         RP->Done(ok, same, got);
+
+// The slot may be deleted as soon as it retires so it must be the last
+// thing it does.
+//
+         if (!ok || !Issue()) RP->Retire();
+        }
+
+     Slot(Runner *rp) : RP(rp), Offset(0), Buff(rp->rSize) {}
+    ~Slot() {}
+
+private:
+Runner            *RP;
+uint64_t           Offset;
+std::vector<char>  Buff;
+};
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+   Runner rn;
+   long long nRead = 1000000, rSize = 64, nWin = 4096;
+   int c;
+
+// Process the options
+//
+   while((c = getopt(argc, argv, "n:s:w:")) != -1)
+        {switch(c)
+               {case 'n': nRead = Size(optarg); break;
+                case 's': rSize = Size(optarg); break;
+                case 'w': nWin  = Size(optarg); break;
+                default:  optind = argc + 1;    break;
+               }
+        }
+
+   if (optind + 1 != argc || nRead <= 0 || rSize <= 0 || rSize > (1 << 20)
+   ||  nWin <= 0 || nWin > 60000)
+      {fprintf(stderr, "Usage: xrdclasyncbench [-n <reads>] [-s <rsize>] "
+               "[-w <window>] <url>\n");
+       return 1;
+      }
+   if (nWin > nRead) nWin = nRead;
+
+// Open the file and read all of it synchronously as the reference
+//
+   XrdCl::XRootDStatus st;
+   XrdCl::StatInfo *sInfo = 0;
+   std::vector<char> data;
+   uint32_t got;
+
+   st = rn.File.Open(argv[optind], XrdCl::OpenFlags::Read);
+   if (st.IsOK()) st = rn.File.Stat(false, sInfo);
+   if (!st.IsOK() || !sInfo || sInfo->GetSize() < (uint64_t)rSize
+   ||  sInfo->GetSize() > (1 << 30))
+      {fprintf(stderr, "xrdclasyncbench: file unusable; %s\n",
+               (st.IsOK() ? "its size must be between the read size and 1g"
+                          : st.ToString().c_str()));
+       delete sInfo;
+       return 1;
+      }
+   rn.fSize = sInfo->GetSize();
+   delete sInfo;
+
+   data.resize(rn.fSize);
+   for (uint64_t off = 0; off < rn.fSize; off += got)
+       {st = rn.File.Read(off, rn.fSize - off, &data[off], got);
+        if (!st.IsOK() || !got)
+           {fprintf(stderr, "xrdclasyncbench: read failed; %s\n",
+                    st.ToString().c_str());
+            return 1;
+           }
+       }
+   rn.Data  = &data[0];
+   rn.nRead = nRead;
+   rn.rSize = (uint32_t)rSize;
+
+// Start the window of reads and wait for all of them to complete
+//
+   std::vector<Slot*> slots;
+   double tBeg = Now(), tRun;
+
+   rn.nActive = nWin;
+   for (long long i = 0; i < nWin; i++) slots.push_back(new Slot(&rn));
+   for (long long i = 0; i < nWin; i++) if (!slots[i]->Issue()) rn.Retire();
+
+   rn.Cond.Lock();
+   while(rn.nActive) rn.Cond.Wait();
+   rn.Cond.UnLock();
+   tRun = Now() - tBeg;
+
+   st = rn.File.Close();
+   for (long long i = 0; i < nWin; i++) delete slots[i];
+
+// Report what happened
+//
+   printf("%9s %7s %9s %10s %9s %7s %7s\n", "reads", "window", "MB",
+          "reads/s", "us/read", "failed", "bad");
+   printf("%9lld %7lld %9.1f %10.0f %9.2f %7lld %7lld\n", rn.nDone, nWin,
+          rn.bytes/1e6, rn.nDone/tRun, tRun/rn.nDone*1e6, rn.nFail, rn.nBad);
+   return (rn.nFail || rn.nBad || rn.nDone != nRead ? 1 : 0);
+}
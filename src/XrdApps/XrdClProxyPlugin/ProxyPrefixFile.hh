@@ -130,6 +130,41 @@ public:
     return pFile->VectorRead(chunks, buffer, handler, timeout);
   }
 
+  //----------------------------------------------------------------------------
+  //! VectorWrite
+  //----------------------------------------------------------------------------
+  virtual XRootDStatus VectorWrite(const ChunkList& chunks,
+                                   ResponseHandler* handler,
+                                   uint16_t         timeout)
+  {
+    return pFile->VectorWrite(chunks, handler, timeout);
+  }
+
+  //----------------------------------------------------------------------------
+  //! PgRead
+  //----------------------------------------------------------------------------
+  virtual XRootDStatus PgRead(uint64_t         offset,
+                              uint32_t         size,
+                              void*            buffer,
+                              ResponseHandler* handler,
+                              uint16_t         timeout)
+  {
+    return pFile->PgRead(offset, size, buffer, handler, timeout);
+  }
+
+  //----------------------------------------------------------------------------
+  //! PgWrite
+  //----------------------------------------------------------------------------
+  virtual XRootDStatus PgWrite(uint64_t                     offset,
+                               uint32_t                     size,
+                               const void*                  buffer,
+                               const std::vector<uint32_t>& cksums,
+                               ResponseHandler*             handler,
+                               uint16_t                     timeout)
+  {
+    return pFile->PgWrite(offset, size, buffer, cksums, handler, timeout);
+  }
+
   //----------------------------------------------------------------------------
   //! Fcntl
   //----------------------------------------------------------------------------
@@ -0,0 +1,193 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d C l R e a d B e n c h . c c                      */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/* This utility measures the throughput of small synchronous reads through
+   XrdCl::File, once with the client read cache off and once with it on. The
+   syntax is:
+
+   xrdclreadbench [-c <csize>] [-b <bsize>] [-n <reads>] [-r] [-s <rsize>] <url>
+
+   <csize>     the read cache size for the second pass (default 16m).
+   <bsize>     the read cache block size (default is the environment's).
+   <reads>     the number of reads per pass (default 20000).
+   -r          read at random aligned offsets instead of sequentially.
+   <rsize>     the size of each read (default 4096).
+
+   Sizes may be suffixed with k or m. The data of both passes is compared
+   so that the cache is checked as well as timed. A plain data server, e.g.
+   one with xrd.port 21094 and all.export /data, serves as the other end.
+*/
+
+/******************************************************************************/
+/*                         i n c l u d e   f i l e s                          */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <vector>
+
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+
+/******************************************************************************/
+/*                         L o c a l   O b j e c t s                          */
+/******************************************************************************/
+
+namespace
+{
+double Now()
+{
+   struct timeval tv;
+   gettimeofday(&tv, 0);
+   return tv.tv_sec + tv.tv_usec/1e6;
+}
+
+long long Size(const char *arg)
+{
+   char *eP;
+   long long n = strtoll(arg, &eP, 10);
+
+   if (*eP == 'k' || *eP == 'K') n <<= 10;
+      else if (*eP == 'm' || *eP == 'M') n <<= 20;
+   return n;
+}
+
+/******************************************************************************/
+/*                                  P a s s                                   */
+/******************************************************************************/
+
+// Read the file and keep a checksum of every read for the comparison.
+//
+bool Pass(const char *url, const char *what, int cSize, int rSize, int nRead,
+          bool rand, std::vector<unsigned int> &sums)
+{
+   XrdCl::DefaultEnv::GetEnv()->PutInt("ReadCacheSize", cSize);
+
+   XrdCl::File file;
+   XrdCl::XRootDStatus st;
+   XrdCl::StatInfo *sInfo = 0;
+   std::vector<char> buff(rSize);
+   unsigned long long fSize, nSlot, off = 0, bytes = 0;
+   uint32_t got;
+   double tBeg, tRun;
+
+   st = file.Open(url, XrdCl::OpenFlags::Read);
+   if (!st.IsOK())
+      {fprintf(stderr, "xrdclreadbench: open failed; %s\n",
+               st.ToString().c_str());
+       return false;
+      }
+   st = file.Stat(false, sInfo);
+   if (!st.IsOK() || !sInfo || sInfo->GetSize() < (uint64_t)rSize)
+      {fprintf(stderr, "xrdclreadbench: file too small or stat failed\n");
+       delete sInfo;
+       return false;
+      }
+   fSize = sInfo->GetSize();
+   nSlot = fSize / rSize;
+   delete sInfo;
+
+   srand(1);
+   sums.resize(nRead);
+   tBeg = Now();
+   for (int i = 0; i < nRead; i++)
+       {if (rand) off = ((unsigned long long)::rand() * 65536 + ::rand())
+                        % nSlot * rSize;
+           else if (off >= fSize) off = 0;
+        st = file.Read(off, rSize, &buff[0], got);
+        if (!st.IsOK())
+           {fprintf(stderr, "xrdclreadbench: read failed; %s\n",
+                    st.ToString().c_str());
+            return false;
+           }
+        unsigned int sum = got;
+        for (uint32_t k = 0; k < got; k++) sum = sum * 31 + buff[k];
+        sums[i] = sum;
+        bytes += got;
+        off   += rSize;
+       }
+   tRun = Now() - tBeg;
+   st = file.Close();
+
+   printf("%-6s %9d %9.1f %9.1f %10.0f %9.1f\n", what, nRead, bytes/1e6,
+          bytes/tRun/1e6, nRead/tRun, tRun/nRead*1e6);
+   return true;
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+   long long cSize = 16 << 20, bSize = 0, rSize = 4096;
+   int nRead = 20000, c;
+   bool rand = false;
+
+// Process the options
+//
+   while((c = getopt(argc, argv, "b:c:n:rs:")) != -1)
+        {switch(c)
+               {case 'b': bSize = Size(optarg); break;
+                case 'c': cSize = Size(optarg); break;
+                case 'n': nRead = atoi(optarg); break;
+                case 'r': rand  = true;         break;
+                case 's': rSize = Size(optarg); break;
+                default:  optind = argc + 1;    break;
+               }
+        }
+
+   if (optind + 1 != argc || nRead <= 0 || rSize <= 0 || cSize <= 0
+   ||  cSize > 0x7fffffff || rSize > (1 << 30))
+      {fprintf(stderr, "Usage: xrdclreadbench [-c <csize>] [-b <bsize>] "
+               "[-n <reads>] [-r] [-s <rsize>] <url>\n");
+       return 1;
+      }
+   if (bSize > 0) XrdCl::DefaultEnv::GetEnv()->PutInt("ReadCacheBlockSize",
+                                                      (int)bSize);
+
+// Run the pass without and with the cache and compare what they read
+//
+   std::vector<unsigned int> sOff, sOn;
+
+   printf("%s reads of %lld bytes\n", rand ? "random" : "sequential", rSize);
+   printf("%-6s %9s %9s %9s %10s %9s\n", "cache", "reads", "MB", "MB/s",
+          "reads/s", "us/read");
+   if (!Pass(argv[optind], "off", 0, rSize, nRead, rand, sOff)
+   ||  !Pass(argv[optind], "on", (int)cSize, rSize, nRead, rand, sOn))
+      return 1;
+
+   if (sOff != sOn)
+      {fprintf(stderr, "xrdclreadbench: data read with the cache differs\n");
+       return 1;
+      }
+   return 0;
+}
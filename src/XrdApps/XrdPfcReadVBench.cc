@@ -0,0 +1,324 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d P f c R e a d V B e n c h . c c                    */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/* This utility replays a recorded readv trace, as issued by ROOT's TTreeCache,
+   against a file and reports the latency and throughput of each pass. It is
+   meant to measure the proxy file cache: the first pass runs against a cold
+   cache, later passes against a partially or fully cached file. The syntax is:
+
+   xrdpfcreadvbench [-c <local>] [-j <jobs>] [-p <passes>] <url> <trace>
+   xrdpfcreadvbench -g <readvs> [-b <branches>] -s <fsize>
+
+   <local>     a local copy of the file; every segment read is compared to it.
+   <jobs>      the number of clients replaying the trace at once (default 1).
+   <passes>    the number of times the trace is replayed (default 2).
+   <url>       the file to read, normally through a caching proxy.
+   <trace>     the trace file, one readv per line as <offset>:<length> pairs
+               separated by blanks. Lines starting with '#' are ignored.
+
+   The second form writes a synthetic trace to stdout: <readvs> readvs over a
+   file of <fsize> bytes, each reading one basket of every one of <branches>
+   branches (default 40), as a tree with clustered baskets would.
+
+   A local stand-in for the origin is a plain data server, for example
+
+      xrd.port 21094
+      all.export /data
+
+   and the proxy under test points at it with pss.origin localhost:21094 and
+   loads the cache with pss.cachelib libXrdFileCache.so.
+*/
+
+/******************************************************************************/
+/*                         i n c l u d e   f i l e s                          */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                         L o c a l   O b j e c t s                          */
+/******************************************************************************/
+
+namespace
+{
+typedef std::vector<XrdCl::ChunkInfo> ReadV_t;
+
+std::vector<ReadV_t> Trace;
+std::vector<char>    Local;
+const char          *Url;
+int                  Errors = 0;
+XrdSysMutex          ErrMutex;
+
+double Now()
+{
+   struct timeval tv;
+   gettimeofday(&tv, 0);
+   return tv.tv_sec + tv.tv_usec/1e6;
+}
+
+void Error(const char *what, const std::string &why)
+{
+   XrdSysMutexHelper mHelp(ErrMutex);
+   if (Errors++ < 10) fprintf(stderr, "xrdpfcreadvbench: %s; %s\n", what,
+                              why.c_str());
+}
+
+/******************************************************************************/
+/*                                L o a d i n g                               */
+/******************************************************************************/
+
+bool LoadTrace(const char *fn)
+{
+   FILE *fp = fopen(fn, "r");
+   char line[65536], *lP, *eP;
+   long long off, len;
+
+   if (!fp) {perror(fn); return false;}
+
+   while(fgets(line, sizeof(line), fp))
+        {if (*line == '#') continue;
+         ReadV_t rv;
+         lP = line;
+         while(1)
+              {off = strtoll(lP, &eP, 10);
+               if (eP == lP || *eP != ':') break;
+               len = strtoll(eP+1, &lP, 10);
+               if (len <= 0) break;
+               rv.push_back(XrdCl::ChunkInfo(off, len, 0));
+              }
+         if (!rv.empty()) Trace.push_back(rv);
+        }
+   fclose(fp);
+
+   if (Trace.empty()) {fprintf(stderr, "%s: no readvs in trace\n", fn);
+                       return false;
+                      }
+   return true;
+}
+
+bool LoadLocal(const char *fn)
+{
+   FILE *fp = fopen(fn, "r");
+   char buff[1<<20];
+   size_t n;
+
+   if (!fp) {perror(fn); return false;}
+   while((n = fread(buff, 1, sizeof(buff), fp)) > 0)
+        Local.insert(Local.end(), buff, buff+n);
+   fclose(fp);
+   return true;
+}
+
+/******************************************************************************/
+/*                              G e n e r a t e                               */
+/******************************************************************************/
+
+// Each branch has baskets of its own typical size; a cluster holds one basket
+// of every branch and clusters follow each other in the file.
+//
+int Generate(int nReadV, int nBranch, long long fSize)
+{
+   std::vector<int> bSize(nBranch);
+   long long off = 0, cSize = 0;
+
+   srand(1);
+   for (int b = 0; b < nBranch; b++)
+       {bSize[b] = 2048 + rand() % (b % 4 ? 16384 : 131072);
+        cSize += bSize[b] + bSize[b]/8;
+       }
+   if (cSize > fSize)
+      {fprintf(stderr, "xrdpfcreadvbench: file too small for one cluster\n");
+       return 1;
+      }
+
+   printf("# %d readvs of %d branches over %lld bytes\n", nReadV,nBranch,fSize);
+   for (int i = 0; i < nReadV; i++)
+       {if (off + cSize > fSize) off = 0;
+        for (int b = 0; b < nBranch; b++)
+            {int len = bSize[b] - bSize[b]/8 + rand() % (bSize[b]/4 + 1);
+             printf("%lld:%d ", off, len);
+             off += len;
+            }
+        printf("\n");
+       }
+   return 0;
+}
+
+/******************************************************************************/
+/*                                R e p l a y                                 */
+/******************************************************************************/
+
+struct Replay
+{
+   pthread_t           tid;
+   std::vector<double> lat;
+   long long           bytes;
+
+   Replay() : tid(0), bytes(0) {}
+};
+
+void *Run(void *carg)
+{
+   Replay *rP = (Replay *)carg;
+   XrdCl::File file;
+   XrdCl::XRootDStatus st;
+   XrdCl::VectorReadInfo *vrInfo;
+   std::vector<char> buff;
+   double tBeg;
+
+   st = file.Open(Url, XrdCl::OpenFlags::Read);
+   if (!st.IsOK()) {Error("open failed", st.ToString()); return 0;}
+
+   for (size_t i = 0; i < Trace.size(); i++)
+       {ReadV_t rv = Trace[i];
+        size_t tot = 0;
+        for (size_t k = 0; k < rv.size(); k++) tot += rv[k].length;
+        if (buff.size() < tot) buff.resize(tot);
+        tot = 0;
+        for (size_t k = 0; k < rv.size(); k++)
+            {rv[k].buffer = &buff[tot]; tot += rv[k].length;}
+
+        vrInfo = 0;
+        tBeg = Now();
+        st = file.VectorRead(rv, 0, vrInfo);
+        rP->lat.push_back(Now() - tBeg);
+        delete vrInfo;
+        if (!st.IsOK()) {Error("readv failed", st.ToString()); break;}
+        rP->bytes += tot;
+
+        if (!Local.empty())
+           for (size_t k = 0; k < rv.size(); k++)
+               if (rv[k].offset + rv[k].length > Local.size()
+               ||  memcmp(rv[k].buffer, &Local[rv[k].offset], rv[k].length))
+                  {char what[64];
+                   snprintf(what, sizeof(what), "readv %zu", i);
+                   Error("data mismatch", what);
+                   break;
+                  }
+       }
+
+   st = file.Close();
+   return 0;
+}
+
+void RunPass(int pass, int nJobs)
+{
+   std::vector<Replay> jobs(nJobs);
+   std::vector<double> lat;
+   long long bytes = 0;
+   double tBeg, tRun, sum = 0;
+
+   tBeg = Now();
+   for (int j = 0; j < nJobs; j++)
+       if (pthread_create(&jobs[j].tid, 0, Run, &jobs[j]))
+          {perror("pthread_create"); jobs[j].tid = 0;}
+   for (int j = 0; j < nJobs; j++)
+       if (jobs[j].tid) pthread_join(jobs[j].tid, 0);
+   tRun = Now() - tBeg;
+
+   for (int j = 0; j < nJobs; j++)
+       {lat.insert(lat.end(), jobs[j].lat.begin(), jobs[j].lat.end());
+        bytes += jobs[j].bytes;
+       }
+   if (lat.empty()) {printf("%4d  no readvs completed\n", pass); return;}
+
+   std::sort(lat.begin(), lat.end());
+   for (size_t i = 0; i < lat.size(); i++) sum += lat[i];
+   printf("%4d %8zu %9.1f %8.1f %9.3f %9.3f %9.3f %9.3f\n", pass, lat.size(),
+          bytes/1e6, bytes/tRun/1e6, sum/lat.size()*1e3,
+          lat[lat.size()/2]*1e3, lat[lat.size()*99/100]*1e3, lat.back()*1e3);
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+   const char *local = 0;
+   long long fSize = 0;
+   int nJobs = 1, nPass = 2, nGen = 0, nBranch = 40;
+   size_t nSeg = 0;
+   int c;
+
+// Process the options
+//
+   while((c = getopt(argc, argv, "b:c:g:j:p:s:")) != -1)
+        {switch(c)
+               {case 'b': nBranch = atoi(optarg); break;
+                case 'c': local   = optarg;       break;
+                case 'g': nGen    = atoi(optarg); break;
+                case 'j': nJobs   = atoi(optarg); break;
+                case 'p': nPass   = atoi(optarg); break;
+                case 's': fSize   = atoll(optarg);break;
+                default:  optind = argc + 1;      break;
+               }
+        }
+
+// Generate a trace if so wanted
+//
+   if (nGen > 0 && nBranch > 0 && fSize > 0 && optind == argc)
+      return Generate(nGen, nBranch, fSize);
+
+   if (optind + 2 != argc || nJobs <= 0 || nPass <= 0)
+      {fprintf(stderr, "Usage: xrdpfcreadvbench [-c <local>] [-j <jobs>] "
+               "[-p <passes>] <url> <trace>\n"
+               "       xrdpfcreadvbench -g <readvs> [-b <branches>] "
+               "-s <fsize>\n");
+       return 1;
+      }
+   Url = argv[optind];
+
+// Load the trace and, if need be, the reference copy
+//
+   if (!LoadTrace(argv[optind+1]) || (local && !LoadLocal(local))) return 1;
+   for (size_t i = 0; i < Trace.size(); i++) nSeg += Trace[i].size();
+
+// Replay the trace as often as wanted
+//
+   printf("%zu readvs with %zu segments, %d job(s)\n", Trace.size(), nSeg,
+          nJobs);
+   printf("%4s %8s %9s %8s %9s %9s %9s %9s\n", "pass", "readvs", "MB",
+          "MB/s", "mean ms", "p50 ms", "p99 ms", "max ms");
+   for (int p = 1; p <= nPass; p++) RunPass(p, nJobs);
+
+   if (Errors) {fprintf(stderr, "xrdpfcreadvbench: %d error(s)\n", Errors);
+                return 1;
+               }
+   return 0;
+}
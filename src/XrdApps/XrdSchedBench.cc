@@ -0,0 +1,194 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d S c h e d B e n c h . c c                        */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/* This utility measures the dispatch throughput of the XrdScheduler using a
+   single shared run queue and using multiple work-stealing run queues. The
+   syntax is:
+
+   xrdschedbench [-j <jobs>] [-p <producers>] [-q <queues>] [-t <threads>]
+
+   <jobs>      the number of jobs to dispatch per run (default 1000000).
+   <producers> the number of threads scheduling jobs (default 4).
+   <queues>    the number of run queues for the second run (default one per
+               cpu).
+   <threads>   the number of worker threads (default 16).
+*/
+
+/******************************************************************************/
+/*                         i n c l u d e   f i l e s                          */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "Xrd/XrdJob.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdOuc/XrdOucTrace.hh"
+#include "XrdSys/XrdSysAtomics.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+class XrdSBJob : public XrdJob
+{
+public:
+
+void DoIt() {int done;
+             AtomicBeg(cntMutex);
+             done = AtomicInc(numDone) + 1;
+             AtomicEnd(cntMutex);
+             if (done == numJobs) allDone->Post();
+            }
+
+     XrdSBJob() : XrdJob(".bench") {}
+    ~XrdSBJob() {}
+
+static XrdSysMutex      cntMutex;
+static XrdSysSemaphore *allDone;
+static int              numDone;
+static int              numJobs;
+};
+
+XrdSysMutex      XrdSBJob::cntMutex;
+XrdSysSemaphore *XrdSBJob::allDone  = 0;
+int              XrdSBJob::numDone  = 0;
+int              XrdSBJob::numJobs  = 0;
+
+struct XrdSBParms
+      {XrdScheduler *Sched;
+       XrdSBJob     *Jobs;
+       int           numJobs;
+      };
+
+/******************************************************************************/
+/*                             P r o d u c e r                                */
+/******************************************************************************/
+
+void *XrdSBProducer(void *carg)
+{
+   XrdSBParms *pP = (XrdSBParms *)carg;
+
+   for (int i = 0; i < pP->numJobs; i++) pP->Sched->Schedule(&(pP->Jobs[i]));
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                                 R u n O n e                                */
+/******************************************************************************/
+
+double RunOne(XrdSysError &eDest, XrdOucTrace &Trace,
+              int numQ, int numJobs, int numProd, int numThr)
+{
+   XrdScheduler *Sched = new XrdScheduler(&eDest, &Trace, numThr, numThr, 0);
+   XrdSBJob     *Jobs  = new XrdSBJob[numJobs];
+   XrdSBParms   *Parms = new XrdSBParms[numProd];
+   pthread_t    *tids  = new pthread_t[numProd];
+   XrdSysSemaphore allDone(0);
+   struct timeval tBeg, tEnd;
+   int perProd = numJobs/numProd;
+
+// Setup the completion counters
+//
+   XrdSBJob::allDone  = &allDone;
+   XrdSBJob::numDone  = 0;
+   XrdSBJob::numJobs  = perProd*numProd;
+
+// Start the scheduler with a fixed number of workers and the requested number
+// of queues
+//
+   Sched->setParms(numThr, numThr, numThr, 0);
+   Sched->setQueues(numQ);
+   Sched->Start();
+   sleep(1);
+
+// Start all of the producers and wait for all the jobs to complete
+//
+   gettimeofday(&tBeg, 0);
+   for (int i = 0; i < numProd; i++)
+       {Parms[i].Sched   = Sched;
+        Parms[i].Jobs    = &Jobs[i*perProd];
+        Parms[i].numJobs = perProd;
+        XrdSysThread::Run(&tids[i], XrdSBProducer, (void *)&Parms[i],
+                          XRDSYSTHREAD_HOLD, "Producer");
+       }
+   for (int i = 0; i < numProd; i++) XrdSysThread::Join(tids[i], 0);
+   allDone.Wait();
+   gettimeofday(&tEnd, 0);
+
+// The scheduler is never deleted and its workers keep a reference to the
+// jobs, so we leave those alone.
+//
+   delete [] Parms;
+   delete [] tids;
+   return (tEnd.tv_sec  - tBeg.tv_sec) + (tEnd.tv_usec - tBeg.tv_usec)/1e6;
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+   XrdSysLogger Logger;
+   XrdSysError  eDest(&Logger, "schedbench");
+   XrdOucTrace  Trace(&eDest);
+   int c, numJobs = 1000000, numProd = 4, numQ = 0, numThr = 16;
+   double tOne, tMany;
+
+// Process the options
+//
+   while((c = getopt(argc, argv, "j:p:q:t:")) != -1)
+        {switch(c)
+               {case 'j': numJobs = atoi(optarg); break;
+                case 'p': numProd = atoi(optarg); break;
+                case 'q': numQ    = atoi(optarg); break;
+                case 't': numThr  = atoi(optarg); break;
+                default:  fprintf(stderr, "Usage: xrdschedbench [-j <jobs>] "
+                                  "[-p <producers>] [-q <queues>] "
+                                  "[-t <threads>]\n");
+                          return 1;
+               }
+        }
+   if (numJobs <= 0 || numProd <= 0 || numThr <= 0 || numJobs < numProd)
+      {fprintf(stderr, "xrdschedbench: invalid option value\n"); return 1;}
+
+// Run the classic single queue and then the work-stealing queues
+//
+   tOne  = RunOne(eDest, Trace, 1,    numJobs, numProd, numThr);
+   tMany = RunOne(eDest, Trace, numQ, numJobs, numProd, numThr);
+
+// Report the results
+//
+   numJobs = numJobs/numProd*numProd;
+   printf("single queue:   %10.0f jobs/s\n", numJobs/tOne);
+   printf("multiple queues:%10.0f jobs/s (%.2fx)\n", numJobs/tMany, tOne/tMany);
+   return 0;
+}
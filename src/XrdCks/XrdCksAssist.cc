@@ -48,6 +48,7 @@ namespace
 struct csTable {const char *csName; int csLenC; int csLenB;} csTab[]
                = {{"adler32",   8,   4},
                   {"crc32",     8,   4},
+                  {"crc32c",    8,   4},
                   {"crc64",    16,   8},
                   {"md5",      32,  16},
                   {"sha1",     40,  20},
@@ -0,0 +1,204 @@
+/******************************************************************************/
+/*                                                                            */
+/*                  X r d C k s C a l c a d l e r 3 2 . c c                   */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdCks/XrdCksCalcadler32.hh"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+/* The following implementation of adler32 was derived from zlib and is
+                   * Copyright (C) 1995-1998 Mark Adler
+   Below are the zlib license terms for this implementation.
+*/
+  
+/* zlib.h -- interface of the 'zlib' general purpose compression library
+  version 1.1.4, March 11th, 2002
+
+  Copyright (C) 1995-2002 Jean-loup Gailly and Mark Adler
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Jean-loup Gailly        Mark Adler
+  jloup@gzip.org          madler@alumni.caltech.edu
+
+
+  The data format used by the zlib library is described by RFCs (Request for
+  Comments) 1950 to 1952 in the files ftp://ds.internic.net/rfc/rfc1950.txt
+  (zlib format), rfc1951.txt (deflate format) and rfc1952.txt (gzip format).
+*/
+
+#define DO1(buf)  {unSum1 += *buf++; unSum2 += unSum1;}
+#define DO2(buf)  DO1(buf); DO1(buf);
+#define DO4(buf)  DO2(buf); DO2(buf);
+#define DO8(buf)  DO4(buf); DO4(buf);
+#define DO16(buf) DO8(buf); DO8(buf);
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+const unsigned int AdlerBase = 0xFFF1;
+const          int AdlerNMax = 5552;
+
+/* NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
+
+typedef void (*adlerFunc)(unsigned int &, unsigned int &,
+                          const unsigned char *, int);
+
+void swAdler(unsigned int &unSum1, unsigned int &unSum2,
+             const unsigned char *buff, int BLen)
+{
+   int k;
+
+   while(BLen > 0)
+        {k = (BLen < AdlerNMax ? BLen : AdlerNMax);
+         BLen -= k;
+         while(k >= 16) {DO16(buff); k -= 16;}
+         if (k != 0) do {DO1(buff);} while (--k);
+         unSum1 %= AdlerBase; unSum2 %= AdlerBase;
+        }
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+
+__attribute__((target("avx2")))
+unsigned int avxSum(__m256i v)
+{
+   __m128i x = _mm_add_epi32(_mm256_castsi256_si128(v),
+                             _mm256_extracti128_si256(v, 1));
+   x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1,0,3,2)));
+   x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2,3,0,1)));
+   return static_cast<unsigned int>(_mm_cvtsi128_si32(x));
+}
+
+// Each 32 byte block adds 32*sum1 plus the bytes weighted 32..1 to sum2 and
+// the plain sum of the bytes to sum1. The weighted sums are done with
+// maddubs/madd and the byte sums with sad. The contribution of sum1 to sum2
+// is accumulated in vPS and multiplied by 32 once per run of blocks. A run is
+// never longer than NMAX bytes so that nothing can overflow.
+//
+__attribute__((target("avx2")))
+void avxAdler(unsigned int &unSum1, unsigned int &unSum2,
+              const unsigned char *buff, int BLen)
+{
+   const __m256i tap  = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                         24, 23, 22, 21, 20, 19, 18, 17,
+                                         16, 15, 14, 13, 12, 11, 10,  9,
+                                          8,  7,  6,  5,  4,  3,  2,  1);
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i ones = _mm256_set1_epi16(1);
+   __m256i bytes, vPS, vS1, vS2;
+   unsigned int s1 = unSum1, s2 = unSum2;
+   int n, blocks = BLen / 32;
+
+   BLen -= blocks * 32;
+   while(blocks)
+        {n = AdlerNMax / 32;
+         if (n > blocks) n = blocks;
+         blocks -= n;
+         vPS = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, s1 * n);
+         vS2 = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, s2);
+         vS1 = zero;
+         do {bytes = _mm256_loadu_si256((const __m256i *)buff);
+             vPS   = _mm256_add_epi32(vPS, vS1);
+             vS1   = _mm256_add_epi32(vS1, _mm256_sad_epu8(bytes, zero));
+             vS2   = _mm256_add_epi32(vS2, _mm256_madd_epi16(
+                                       _mm256_maddubs_epi16(bytes, tap), ones));
+             buff += 32;
+            } while(--n);
+         vS2 = _mm256_add_epi32(vS2, _mm256_slli_epi32(vPS, 5));
+         s1 = (s1 + avxSum(vS1)) % AdlerBase;
+         s2 = avxSum(vS2) % AdlerBase;
+        }
+
+// Do whatever is left over the normal way
+//
+   unSum1 = s1; unSum2 = s2;
+   if (BLen) swAdler(unSum1, unSum2, buff, BLen);
+}
+#endif
+
+// Select the best implementation the processor supports
+//
+adlerFunc SelectAdler()
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2")) return avxAdler;
+#endif
+   return swAdler;
+}
+}
+
+/******************************************************************************/
+/*                                U p d a t e                                 */
+/******************************************************************************/
+  
+void XrdCksCalcadler32::Update(const char *Buff, int BLen)
+{
+   static adlerFunc adlerCalc = SelectAdler();
+
+   adlerCalc(unSum1, unSum2, (const unsigned char *)Buff, BLen);
+}
+
+/******************************************************************************/
+/*                               C o m b i n e                                */
+/******************************************************************************/
+
+void XrdCksCalcadler32::Combine(XrdCksCalcadler32 &next, long long nextLen)
+{
+   unsigned int rem, sum1, sum2;
+
+// This is zlib's adler32_combine() applied to the running sums
+//
+   if (nextLen <= 0) return;
+   rem  = static_cast<unsigned int>(nextLen % AdlerBase);
+   sum1 = unSum1;
+   sum2 = (rem * sum1) % AdlerBase;
+   sum1 += next.unSum1 + AdlerBase - 1;
+   sum2 += unSum2 + next.unSum2 + AdlerBase - rem;
+   if (sum1 >= AdlerBase) sum1 -= AdlerBase;
+   if (sum1 >= AdlerBase) sum1 -= AdlerBase;
+   if (sum2 >= (AdlerBase << 1)) sum2 -= (AdlerBase << 1);
+   if (sum2 >= AdlerBase) sum2 -= AdlerBase;
+   unSum1 = sum1; unSum2 = sum2;
+}
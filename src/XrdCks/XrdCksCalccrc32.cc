@@ -141,6 +141,32 @@ unsigned int XrdCksCalccrc32::crctable[256] =
 /*                   End of CRC Lookup Table                     */
 /*****************************************************************/
 
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+// The lookup table sliced eight ways so that eight bytes can be processed per
+// step. Slice zero is the table above, slice k handles the byte that is k
+// positions away from the end of the eight byte group.
+//
+class crcSlices
+{
+public:
+
+unsigned int T[8][256];
+
+             crcSlices(const unsigned int *tab0)
+                      {for (int i = 0; i < 256; i++) T[0][i] = tab0[i];
+                       for (int i = 0; i < 256; i++)
+                           for (int k = 1; k < 8; k++)
+                               T[k][i] = (T[k-1][i] << 8)
+                                       ^  T[0][T[k-1][i] >> 24];
+                      }
+};
+}
+
 /* Calculate CRC-32 Checksum for NAACCR Record,
    skipping area of record containing checksum field.
 
@@ -165,14 +191,83 @@ unsigned int XrdCksCalccrc32::crctable[256] =
      Use unsigned int instead of long to insure 32 bit values.
      Include length bits at the end to correspond to the Posix 1003.2 spec.
      Make this a C++ class.
+     Process eight bytes per step using sliced tables.
 */
 void XrdCksCalccrc32::Update(const char *p, int reclen)
 {
+   static crcSlices crcSlice(crctable);
+   const unsigned int (*T)[256] = crcSlice.T;
+   const unsigned char *up = (const unsigned char *)p;
+   unsigned int crc = C32Result, hi, lo;
 
-// Process each byte
+// Process eight bytes at a time, the bytes are taken most significant first
 //
    TotLen += reclen;
+   while(reclen >= 8)
+        {hi = ((unsigned int)up[0] << 24 | (unsigned int)up[1] << 16
+            |  (unsigned int)up[2] <<  8 | (unsigned int)up[3]) ^ crc;
+         lo =  (unsigned int)up[4] << 24 | (unsigned int)up[5] << 16
+            |  (unsigned int)up[6] <<  8 | (unsigned int)up[7];
+         crc = T[7][hi >> 24] ^ T[6][(hi >> 16) & 0xff]
+             ^ T[5][(hi >> 8) & 0xff] ^ T[4][hi & 0xff]
+             ^ T[3][lo >> 24] ^ T[2][(lo >> 16) & 0xff]
+             ^ T[1][(lo >> 8) & 0xff] ^ T[0][lo & 0xff];
+         up += 8; reclen -= 8;
+        }
+
+// Process each remaining byte
+//
    while(reclen-- > 0)
-        C32Result = (C32Result<<8) 
-                  ^ crctable[(unsigned char)((C32Result>>24)^*p++)];
+        crc = (crc<<8) ^ T[0][(unsigned char)((crc>>24)^*up++)];
+   C32Result = crc;
+}
+
+/******************************************************************************/
+/*                               C o m b i n e                                */
+/******************************************************************************/
+
+namespace
+{
+// Multiply a and b modulo the crc polynomial (non-reflected bit order)
+//
+unsigned int MultModP(unsigned int a, unsigned int b)
+{
+   unsigned int p = 0;
+
+   for (int i = 31; i >= 0; i--)
+       {p = (p & 0x80000000 ? (p << 1) ^ 0x04C11DB7 : p << 1);
+        if (a & (1U << i)) p ^= b;
+       }
+   return p;
+}
+
+// Compute x^(8*len) modulo the polynomial using a table of x^(2^n)
+//
+unsigned int X8nModP(unsigned long long len)
+{
+   static struct x2nTab
+         {unsigned int T[64];
+                       x2nTab() {T[0] = 2;
+                                 for (int n = 1; n < 64; n++)
+                                     T[n] = MultModP(T[n-1], T[n-1]);
+                                }
+         } x2n;
+   unsigned int p = 1;
+   int k = 3;
+
+   while(len) {if (len & 1) p = MultModP(x2n.T[k & 63], p); len >>= 1; k++;}
+   return p;
+}
+}
+
+/******************************************************************************/
+
+void XrdCksCalccrc32::Combine(XrdCksCalccrc32 &next, long long nextLen)
+{
+// The crc starts at zero and the length is only folded in by Final(), so the
+// running value is linear and can simply be shifted over the next piece.
+//
+   if (nextLen <= 0) return;
+   C32Result = MultModP(C32Result, X8nModP(nextLen)) ^ next.C32Result;
+   TotLen   += nextLen;
 }
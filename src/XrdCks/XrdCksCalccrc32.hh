@@ -42,6 +42,12 @@ class XrdCksCalccrc32 : public XrdCksCalc
 {
 public:
 
+// Combine() folds in the checksum of the nextLen bytes that immediately follow
+// the data checksummed so far. The result is as if those bytes were passed
+// to Update(). Final() must not have been called on either object.
+//
+void  Combine(XrdCksCalccrc32 &next, long long nextLen);
+
 char *Final() {char buff[sizeof(long long)];
                long long tLcs = TotLen;
                int i = 0;
@@ -30,17 +30,18 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
 #include <unistd.h>
-#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
   
 #include "XrdCks/XrdCksCalc.hh"
 #include "XrdCks/XrdCksCalcadler32.hh"
 #include "XrdCks/XrdCksCalccrc32.hh"
+#include "XrdCks/XrdCksCalccrc32C.hh"
 #include "XrdCks/XrdCksCalcmd5.hh"
 #include "XrdCks/XrdCksLoader.hh"
 #include "XrdCks/XrdCksManager.hh"
@@ -54,6 +55,164 @@
 #include "XrdSys/XrdSysPlugin.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+// A range of the file that is checksummed by a single thread
+//
+struct csRange
+      {XrdCksCalc *csP;
+       char       *Buff[2];
+       off_t       Offset;
+       off_t       Length;
+       pthread_t   tid;
+       int         FD;
+       int         bSize;
+       int         rc;
+       bool        Pipe;
+       bool        isRunning;
+
+                   csRange() : csP(0), Offset(0), Length(0), FD(-1), bSize(0),
+                               rc(0), Pipe(false), isRunning(false)
+                               {Buff[0] = Buff[1] = 0;}
+                  ~csRange() {if (Buff[0]) free(Buff[0]);
+                              if (Buff[1]) free(Buff[1]);
+                             }
+      };
+
+// The double buffer shared by a range's checksum thread and its reader. A
+// negative length indicates a read error (i.e. -errno).
+//
+struct csPipe
+      {XrdSysSemaphore bFree;
+       XrdSysSemaphore bFull;
+       csRange        *rP;
+       int             bLen[2];
+
+                       csPipe(csRange *rangeP) : bFree(2), bFull(0), rP(rangeP)
+                                               {bLen[0] = bLen[1] = 0;}
+      };
+}
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+// Combine the checksum of the nxLen bytes that follow those checksummed by
+// csP. With a null nxP simply indicate whether or not csP can be combined.
+//
+bool Combine(XrdCksCalc *csP, XrdCksCalc *nxP, long long nxLen)
+{
+   XrdCksCalcadler32 *aP;
+   XrdCksCalccrc32   *cP;
+   XrdCksCalccrc32C  *kP;
+
+   if ((aP = dynamic_cast<XrdCksCalcadler32 *>(csP)))
+      {if (nxP) aP->Combine(*static_cast<XrdCksCalcadler32 *>(nxP), nxLen);
+       return true;
+      }
+   if ((cP = dynamic_cast<XrdCksCalccrc32 *>(csP)))
+      {if (nxP) cP->Combine(*static_cast<XrdCksCalccrc32 *>(nxP), nxLen);
+       return true;
+      }
+   if ((kP = dynamic_cast<XrdCksCalccrc32C *>(csP)))
+      {if (nxP) kP->Combine(*static_cast<XrdCksCalccrc32C *>(nxP), nxLen);
+       return true;
+      }
+   return false;
+}
+
+// Read exactly bLen bytes at Offset returning 0 or -errno
+//
+int ReadAll(int FD, char *Buff, int bLen, off_t Offset)
+{
+   ssize_t rLen;
+
+   while(bLen > 0)
+        {if ((rLen = pread(FD, Buff, bLen, Offset)) <= 0)
+            {if (!rLen) return -EIO;
+             if (errno == EINTR) continue;
+             return -errno;
+            }
+         Buff += rLen; bLen -= rLen; Offset += rLen;
+        }
+   return 0;
+}
+
+// Read a range into alternate buffers ahead of the checksum calculation
+//
+void *Reader(void *carg)
+{
+   csPipe  *pP = (csPipe *)carg;
+   csRange *rP = pP->rP;
+   off_t    Left = rP->Length, Offset = rP->Offset;
+   int      i = 0, bLen, rc;
+
+   while(Left > 0)
+        {bLen = (Left < rP->bSize ? static_cast<int>(Left) : rP->bSize);
+         pP->bFree.Wait();
+         if ((rc = ReadAll(rP->FD, rP->Buff[i], bLen, Offset)))
+            {pP->bLen[i] = rc; pP->bFull.Post(); break;}
+         pP->bLen[i] = bLen;
+         pP->bFull.Post();
+         Offset += bLen; Left -= bLen; i ^= 1;
+        }
+   return (void *)0;
+}
+
+// Checksum a range. When pipelining, a reader thread fills one buffer while
+// we checksum the other. We fall back to inline reads if no thread can be had.
+//
+void *CalcRange(void *carg)
+{
+   csRange  *rP = (csRange *)carg;
+   pthread_t tid;
+   off_t     Left = rP->Length, Offset = rP->Offset;
+   int       i = 0, bLen;
+
+   if (rP->Pipe)
+      {csPipe Pipe(rP);
+       if (!XrdSysThread::Run(&tid, Reader, (void *)&Pipe,
+                              XRDSYSTHREAD_HOLD, "cks reader"))
+          {while(Left > 0)
+                {Pipe.bFull.Wait();
+                 if ((bLen = Pipe.bLen[i]) < 0) {rP->rc = bLen; break;}
+                 rP->csP->Update(rP->Buff[i], bLen);
+                 Left -= bLen; i ^= 1;
+                 Pipe.bFree.Post();
+                }
+           XrdSysThread::Join(tid, 0);
+           return (void *)0;
+          }
+      }
+
+   while(Left > 0)
+        {bLen = (Left < rP->bSize ? static_cast<int>(Left) : rP->bSize);
+         if ((rP->rc = ReadAll(rP->FD, rP->Buff[0], bLen, Offset))) break;
+         rP->csP->Update(rP->Buff[0], bLen);
+         Offset += bLen; Left -= bLen;
+        }
+   return (void *)0;
+}
+}
+
+/******************************************************************************/
+/*                               S t a t i c s                                */
+/******************************************************************************/
+
+XrdSysMutex XrdCksManager::calcMutex;
+int         XrdCksManager::calcUsed  = 0;
+int         XrdCksManager::calcMaxT  = 32;
+int         XrdCksManager::calcPar   = 4;
+int         XrdCksManager::calcBSize = 8*1024*1024;
+long long   XrdCksManager::calcMinR  = 256*1024*1024;
+bool        XrdCksManager::calcPipe  = true;
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -73,7 +232,8 @@ XrdCksManager::XrdCksManager(XrdSysError *erP, int rdsz, XrdVersionInfo &vInfo,
    strcpy(csTab[0].Name, "adler32");
    strcpy(csTab[1].Name, "crc32");
    strcpy(csTab[2].Name, "md5");
-   csLast = 2;
+   strcpy(csTab[3].Name, "crc32c");
+   csLast = 3;
 
 // Compute the i/o size
 //
@@ -151,11 +311,10 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
              ioFD() : FD(-1) {}
             ~ioFD() {if (FD >= 0) close(FD);}
         } In;
+   csRange *rTab;
    struct stat Stat;
-   char *inBuff;
-   off_t  Offset=0, fileSize;
-   size_t ioSize, calcSize;
-   int rc;
+   off_t  fileSize, perRange, Offset;
+   int i, bSize, numR = 1, numPipe = 0, rc = 0;
 
 // Open the input file
 //
@@ -165,28 +324,112 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
 //
    if (fstat(In.FD, &Stat)) return -errno;
    if (!(Stat.st_mode & S_IFREG)) return -EPERM;
-   calcSize = fileSize = Stat.st_size;
+   fileSize = Stat.st_size;
    MTime = Stat.st_mtime;
+   if (!fileSize) return 0;
 
-// We now compute checksum 64MB at a time using mmap I/O
-//
-   ioSize = (fileSize < (off_t)segSize ? fileSize : segSize); rc = 0;
-   while(calcSize)
-        {if ((inBuff = (char *)mmap(0, ioSize, PROT_READ, 
-                       MAP_NORESERVE|MAP_PRIVATE, In.FD, Offset)) == MAP_FAILED)
-            {rc = errno; eDest->Emsg("Cks", rc, "memory map", Pfn); break;}
-         madvise(inBuff, ioSize, MADV_SEQUENTIAL);
-         csP->Update(inBuff, ioSize);
-         calcSize -= ioSize; Offset += ioSize;
-         if (munmap(inBuff, ioSize) < 0)
-            {rc = errno; eDest->Emsg("Cks",rc,"unmap memory for",Pfn); break;}
-         if (calcSize < (size_t)segSize) ioSize = calcSize;
-        }
+// Large files whose checksum can be combined are split into ranges that are
+// checksummed in parallel. Each additional range needs a thread.
+//
+   if (calcPar > 1 && fileSize >= calcMinR*2 && Combine(csP, 0, 0))
+      {off_t maxR = fileSize / calcMinR;
+       numR = (maxR < calcPar ? static_cast<int>(maxR) : calcPar);
+       numR = 1 + GetThreads(numR-1);
+      }
 
-// Return if we failed
+// Reads are overlapped with the checksum calculation by reading ahead into a
+// second buffer using a reader thread per range. This is only worth doing if
+// a range takes more than one buffer.
+//
+   bSize = (segSize < calcBSize ? segSize : calcBSize);
+   perRange = fileSize / numR;
+   if (perRange < bSize) bSize = static_cast<int>(perRange);
+   if (calcPipe && perRange > bSize) numPipe = GetThreads(numR);
+
+// Setup the ranges. Ranges are kept to a multiple of the buffer size so that
+// all reads, except possibly the last one, are full and aligned.
+//
+   rTab = new csRange[numR];
+   perRange = (perRange / bSize) * bSize;
+   for (i = 0, Offset = 0; i < numR; i++)
+       {rTab[i].FD     = In.FD;
+        rTab[i].Offset = Offset;
+        rTab[i].Length = (i == numR-1 ? fileSize - Offset : perRange);
+        rTab[i].bSize  = bSize;
+        rTab[i].Pipe   = i < numPipe;
+        Offset += rTab[i].Length;
+        if (!(rTab[i].Buff[0] = (char *)malloc(bSize))
+        ||  (rTab[i].Pipe && !(rTab[i].Buff[1] = (char *)malloc(bSize)))
+        ||  !(rTab[i].csP = (i ? csP->New() : csP)))
+           {rc = -ENOMEM; break;}
+       }
+
+// Start a thread for each range but the first, we do that one. Should we not
+// be able to get a thread, the range is done inline after ours.
+//
+   if (!rc)
+      {for (i = 1; i < numR; i++)
+            rTab[i].isRunning = !XrdSysThread::Run(&rTab[i].tid, CalcRange,
+                                     (void *)&rTab[i], XRDSYSTHREAD_HOLD,
+                                     "cks calc");
+       CalcRange((void *)&rTab[0]);
+       for (i = 1; i < numR; i++)
+           {if (rTab[i].isRunning) XrdSysThread::Join(rTab[i].tid, 0);
+               else CalcRange((void *)&rTab[i]);
+           }
+
+   // Combine the results of the ranges in order
+   //
+       for (i = 0; i < numR && !rc; i++) rc = rTab[i].rc;
+       if (rc) eDest->Emsg("Cks", -rc, "read", Pfn);
+          else for (i = 1; i < numR; i++)
+                   Combine(csP, rTab[i].csP, rTab[i].Length);
+      }
+
+// Release the resources we used
 //
-   if (calcSize) return (rc ? -rc : -EIO);
-   return 0;
+   for (i = 1; i < numR; i++) if (rTab[i].csP) rTab[i].csP->Recycle();
+   delete [] rTab;
+   RetThreads(numR-1 + numPipe);
+   return rc;
+}
+
+/******************************************************************************/
+/*                               S e t C a l c                                */
+/******************************************************************************/
+
+void XrdCksManager::SetCalc(int nPar, int maxThreads, long long minRange,
+                            bool pipeline)
+{
+   if (nPar > 0)       calcPar  = nPar;
+   if (maxThreads >= 0) calcMaxT = maxThreads;
+   if (minRange > 0)   calcMinR = (minRange < 1048576 ? 1048576 : minRange);
+   calcPipe = pipeline;
+}
+
+/******************************************************************************/
+/* Private:                   G e t T h r e a d s                             */
+/******************************************************************************/
+
+int XrdCksManager::GetThreads(int want)
+{
+   XrdSysMutexHelper mHelp(calcMutex);
+
+   if (want > calcMaxT - calcUsed) want = calcMaxT - calcUsed;
+   if (want < 0) want = 0;
+   calcUsed += want;
+   return want;
+}
+
+/******************************************************************************/
+/* Private:                   R e t T h r e a d s                             */
+/******************************************************************************/
+
+void XrdCksManager::RetThreads(int num)
+{
+   XrdSysMutexHelper mHelp(calcMutex);
+
+   calcUsed -= num;
 }
 
 /******************************************************************************/
@@ -287,6 +530,8 @@ int XrdCksManager::Init(const char *ConfigFN, const char *DfltCalc)
                          csTab[i].Obj = new XrdCksCalccrc32;
                  else if (!strcmp("md5",     csTab[i].Name))
                          csTab[i].Obj = new XrdCksCalcmd5;
+                 else if (!strcmp("crc32c",  csTab[i].Name))
+                         csTab[i].Obj = new XrdCksCalccrc32C;
                  else {eDest->Emsg("Config", "Invalid native checksum -",
                                              csTab[i].Name);
                        return 0;
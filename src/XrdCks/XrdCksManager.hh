@@ -34,6 +34,7 @@
 
 #include "XrdCks/XrdCks.hh"
 #include "XrdCks/XrdCksData.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 /* This class defines the checksum management interface. It may also be used
    as the base class for a plugin. This allows you to replace selected methods
@@ -70,6 +71,16 @@ virtual int         Set(  const char *Pfn, XrdCksData &Cks, int myTime=0);
 
 virtual int         Ver(  const char *Pfn, XrdCksData &Cks);
 
+// SetCalc() sets how the default Calc() implementation reads files. Checksums
+// that can be combined (adler32, crc32, and crc32c) are calculated in up to
+// nPar ranges in parallel, each at least minRange bytes long. When pipeline
+// is true reads are overlapped with the calculation. No more than maxThreads
+// threads are used at any one time for all calculations combined. A value
+// that is negative (or zero for nPar and minRange) is left unchanged.
+//
+static void         SetCalc(int nPar, int maxThreads, long long minRange,
+                            bool pipeline);
+
                     XrdCksManager(XrdSysError *erP, int iosz,
                                   XrdVersionInfo &vInfo, bool autoload=false);
 virtual            ~XrdCksManager();
@@ -79,7 +90,8 @@ protected:
 /* Calc()     returns 0 if the checksum was successfully calculated using the
               supplied CksObj and places the file's modification time in MTime.
               Otherwise, it returns -errno. The default implementation uses
-              open(), fstat(), mmap(), and unmap() to calculate the results.
+              open(), fstat(), and pread() to calculate the results (see
+              SetCalc() for how this is done).
 */
 virtual int         Calc(const char *Pfn, time_t &MTime, XrdCksCalc *CksObj);
 
@@ -105,6 +117,10 @@ struct csInfo
 
 int     Config(const char *cFN, csInfo &Info);
 csInfo *Find(const char *Name);
+static
+int     GetThreads(int want);
+static
+void    RetThreads(int num);
 
 static const int csMax = 8;
 csInfo           csTab[csMax];
@@ -112,5 +128,13 @@ int              csLast;
 int              segSize;
 XrdCksLoader    *cksLoader;
 XrdVersionInfo  &myVersion;
+
+static XrdSysMutex calcMutex;
+static int         calcUsed;
+static int         calcMaxT;
+static int         calcPar;
+static int         calcBSize;
+static long long   calcMinR;
+static bool        calcPipe;
 };
 #endif
@@ -231,7 +231,7 @@ namespace XrdCl
     int  timeoutResolution = DefaultTimeoutResolution;
     env->GetInt( "TimeoutResolution", timeoutResolution );
 
-    pTransport->InitializeChannel( pChannelData );
+    pTransport->InitializeChannel( url, pChannelData );
     uint16_t numStreams = transport->StreamNumber( pChannelData );
     log->Debug( PostMasterMsg, "Creating new channel to: %s %d stream(s)",
                                 url.GetHostId().c_str(), numStreams );
@@ -27,6 +27,7 @@
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClFileSystem.hh"
 #include "XrdCl/XrdClMonitor.hh"
 #include "XrdCl/XrdClUtils.hh"
 #include "XrdCl/XrdClCheckSumManager.hh"
@@ -38,6 +39,9 @@
 #include <memory>
 #include <iostream>
 #include <queue>
+#include <deque>
+#include <list>
+#include <set>
 #include <algorithm>
 
 #include <sys/types.h>
@@ -539,6 +543,168 @@ namespace
       uint32_t        pChunkSize;
   };
 
+  //----------------------------------------------------------------------------
+  //! Adapts the chunk size and the number of chunks in flight of a source
+  //! to the throughput it observes
+  //!
+  //! The controller works on the number of bytes in flight. Every round,
+  //! that is once as many chunks have arrived as were in flight, it compares
+  //! the throughput of the round to the best one seen: while it improves the
+  //! window doubles, then it grows by a quarter per round. If the throughput
+  //! drops, or the chunks take more than twice as long as they did at best
+  //! without a gain in throughput, the server or the link is congested and
+  //! the window shrinks by a quarter. Below the configured chunk size and
+  //! parallelism the chunks get smaller first, above it more of them are
+  //! requested and only at the maximum parallelism they get bigger.
+  //----------------------------------------------------------------------------
+  class ChunkController
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      ChunkController( uint32_t chunkSize, uint16_t parallel,
+                       uint32_t minChunkSize, uint32_t maxChunkSize,
+                       uint16_t maxParallel ):
+        pBaseChunk( chunkSize ), pBaseParallel( parallel ),
+        pMinChunk( minChunkSize ), pMaxChunk( maxChunkSize ),
+        pMaxParallel( maxParallel ), pSlowStart( true ), pChanged( false ),
+        pBestRate( 0 ), pRate( 0 ), pMinLatency( 0 ), pRoundChunks( 0 ),
+        pRoundBytes( 0 ), pRoundLatency( 0 )
+      {
+        if( pMinChunk > pBaseChunk )   pMinChunk    = pBaseChunk;
+        if( pMaxChunk < pBaseChunk )   pMaxChunk    = pBaseChunk;
+        if( pMaxParallel < parallel )  pMaxParallel = parallel;
+        pWindow    = (uint64_t)pBaseChunk * pBaseParallel;
+        pChunkSize = pBaseChunk;
+        pParallel  = pBaseParallel;
+        pRoundStart.tv_sec = 0; pRoundStart.tv_usec = 0;
+      }
+
+      uint32_t GetChunkSize() const { return pChunkSize; }
+      uint16_t GetParallel()  const { return pParallel;  }
+
+      //------------------------------------------------------------------------
+      //! Account for the chunk the consumer has just taken
+      //------------------------------------------------------------------------
+      void ChunkDone( uint32_t length, const timeval &sent,
+                      const timeval &done )
+      {
+        if( !pRoundStart.tv_sec )
+          pRoundStart = sent;
+
+        ++pRoundChunks;
+        pRoundBytes   += length;
+        pRoundLatency += XrdCl::Utils::GetElapsedMicroSecs( sent, done );
+        if( pRoundChunks < pParallel )
+          return;
+
+        uint64_t elapsed = XrdCl::Utils::GetElapsedMicroSecs( pRoundStart,
+                                                              done );
+        if( elapsed < 1000 )
+          return;
+
+        pRate = pRoundBytes * 1000000 / elapsed;
+        uint64_t latency = pRoundLatency / pRoundChunks;
+        bool inflated = pMinLatency && latency > 2 * pMinLatency;
+        if( !pMinLatency || latency < pMinLatency )
+          pMinLatency = latency;
+
+        if( pRate > pBestRate + pBestRate / 10 )
+        {
+          pBestRate = pRate;
+          pWindow  += pSlowStart ? pWindow : pWindow / 4;
+        }
+        else if( pRate < pBestRate - pBestRate / 5 || inflated )
+        {
+          pSlowStart = false;
+          pBestRate  = pRate;
+          pWindow   -= pWindow / 4;
+        }
+        else
+          pSlowStart = false;
+
+        Apply();
+        pRoundStart   = done;
+        pRoundChunks  = 0;
+        pRoundBytes   = 0;
+        pRoundLatency = 0;
+      }
+
+      //------------------------------------------------------------------------
+      //! Check whether the settings changed since the last call
+      //------------------------------------------------------------------------
+      bool Changed( uint32_t &chunkSize, uint16_t &parallel, uint64_t &rate )
+      {
+        if( !pChanged )
+          return false;
+        pChanged  = false;
+        chunkSize = pChunkSize;
+        parallel  = pParallel;
+        rate      = pRate;
+        return true;
+      }
+
+    private:
+      //------------------------------------------------------------------------
+      // Split the window into chunks
+      //------------------------------------------------------------------------
+      void Apply()
+      {
+        uint64_t minWindow = pMinChunk;
+        uint64_t maxWindow = (uint64_t)pMaxChunk * pMaxParallel;
+        if( pWindow < minWindow ) pWindow = minWindow;
+        if( pWindow > maxWindow ) pWindow = maxWindow;
+
+        uint64_t chunk = pWindow / pBaseParallel;
+        if( pWindow > (uint64_t)pBaseChunk * pMaxParallel )
+          chunk = pWindow / pMaxParallel;
+        else if( chunk > pBaseChunk )
+          chunk = pBaseChunk;
+        if( chunk < pMinChunk ) chunk = pMinChunk;
+        if( chunk > pMaxChunk ) chunk = pMaxChunk;
+        chunk &= ~(uint64_t)4095;
+        if( !chunk ) chunk = 4096;
+
+        uint64_t parallel = (pWindow + chunk - 1) / chunk;
+        if( parallel < 1 )            parallel = 1;
+        if( parallel > pMaxParallel ) parallel = pMaxParallel;
+
+        if( chunk != pChunkSize || parallel != pParallel )
+        {
+          using namespace XrdCl;
+          Log *log = DefaultEnv::GetLog();
+          log->Debug( UtilityMsg, "Copy rate %llu B/s, changing chunks from "
+                      "%u x %u to %u x %u bytes",
+                      (unsigned long long)pRate, pParallel, pChunkSize,
+                      (unsigned)parallel, (unsigned)chunk );
+          if( chunk != pChunkSize )
+            pMinLatency = 0;
+          pChunkSize = chunk;
+          pParallel  = parallel;
+          pChanged   = true;
+        }
+      }
+
+      uint32_t pBaseChunk;
+      uint16_t pBaseParallel;
+      uint32_t pMinChunk;
+      uint32_t pMaxChunk;
+      uint16_t pMaxParallel;
+      uint32_t pChunkSize;
+      uint16_t pParallel;
+      uint64_t pWindow;
+      bool     pSlowStart;
+      bool     pChanged;
+      uint64_t pBestRate;
+      uint64_t pRate;
+      uint64_t pMinLatency;
+      timeval  pRoundStart;
+      uint32_t pRoundChunks;
+      uint64_t pRoundBytes;
+      uint64_t pRoundLatency;
+  };
+
   //----------------------------------------------------------------------------
   //! XRootDSource
   //----------------------------------------------------------------------------
@@ -550,10 +716,11 @@ namespace
       //------------------------------------------------------------------------
       XRootDSource( const XrdCl::URL *url,
                     uint32_t          chunkSize,
-                    uint8_t           parallelChunks ):
+                    uint16_t          parallelChunks,
+                    ChunkController  *controller = 0 ):
         pUrl( url ), pFile( new XrdCl::File() ), pSize( -1 ),
         pCurrentOffset( 0 ), pChunkSize( chunkSize ),
-        pParallel( parallelChunks )
+        pParallel( parallelChunks ), pController( controller )
       {
       }
 
@@ -627,6 +794,12 @@ namespace
         //----------------------------------------------------------------------
         // Fill the queue
         //----------------------------------------------------------------------
+        if( pController )
+        {
+          pChunkSize = pController->GetChunkSize();
+          pParallel  = pController->GetParallel();
+        }
+
         while( pChunks.size() < pParallel && pCurrentOffset < pSize )
         {
           uint64_t chunkSize = pChunkSize;
@@ -638,6 +811,7 @@ namespace
           ch->chunk.offset = pCurrentOffset;
           ch->chunk.length = chunkSize;
           ch->chunk.buffer = buffer;
+          gettimeofday( &ch->sent, 0 );
           ch->status = pFile->Read( pCurrentOffset, chunkSize, buffer, ch );
           pChunks.push( ch );
           pCurrentOffset += chunkSize;
@@ -668,6 +842,9 @@ namespace
           return ch->status;
         }
 
+        if( pController )
+          pController->ChunkDone( ch->chunk.length, ch->sent, ch->done );
+
         ci = ch->chunk;
         return XRootDStatus( stOK, suContinue );
       }
@@ -722,6 +899,7 @@ namespace
           virtual void HandleResponse( XrdCl::XRootDStatus *statusval,
                                        XrdCl::AnyObject    *response )
           {
+            gettimeofday( &done, 0 );
             this->status = *statusval;
             delete statusval;
             if( response )
@@ -738,16 +916,811 @@ namespace
         XrdCl::Semaphore    *sem;
         XrdCl::ChunkInfo     chunk;
         XrdCl::XRootDStatus  status;
+        timeval              sent;
+        timeval              done;
       };
       const XrdCl::URL           *pUrl;
       XrdCl::File                *pFile;
       int64_t                     pSize;
       int64_t                     pCurrentOffset;
       uint32_t                    pChunkSize;
-      uint8_t                     pParallel;
+      uint16_t                    pParallel;
+      ChunkController            *pController;
       std::queue<ChunkHandler *>  pChunks;
   };
 
+  //----------------------------------------------------------------------------
+  //! XRootDSource reading the file from several replicas at once
+  //!
+  //! The file is read from the data server the redirector picks right away,
+  //! the other replicas, taken from the metalink or found with a deep
+  //! locate, join as soon as they are open. Every chunk goes to the replica
+  //! expected to deliver it first, given the bytes it already has in flight
+  //! and the throughput it has shown, so the chunks are spread in proportion
+  //! to the throughput, but they are still handed out in file order. If the
+  //! chunk the consumer waits for takes much longer than its replica
+  //! promised, it is requested once more from a faster replica and the copy
+  //! that arrives first is used. A replica that fails a read gets no more
+  //! chunks.
+  //----------------------------------------------------------------------------
+  class XRootDSourceMulti: public Source
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      XRootDSourceMulti( const XrdCl::URL *url,
+                         uint32_t          chunkSize,
+                         uint16_t          parallelChunks,
+                         uint16_t          sourceLimit ):
+        pUrl( url ), pPrimary( 0 ), pSize( -1 ), pCurrentOffset( 0 ),
+        pChunkSize( chunkSize ), pParallel( parallelChunks ),
+        pSourceLimit( sourceLimit ), pCond( 0 ),
+        pLastError( XrdCl::stError, XrdCl::errDataError )
+      {
+      }
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      virtual ~XRootDSourceMulti()
+      {
+        using namespace XrdCl;
+        Log *log = DefaultEnv::GetLog();
+
+        //----------------------------------------------------------------------
+        // The replicas still being opened are left to their handlers
+        //----------------------------------------------------------------------
+        for( size_t i = 0; i < pOpening.size(); ++i )
+        {
+          OpenHandler *handler = pOpening[i];
+          handler->mutex.Lock();
+          bool done = handler->done;
+          handler->source = 0;
+          handler->mutex.UnLock();
+          if( done )
+            delete handler;
+        }
+
+        CleanUpChunks();
+        for( size_t i = 0; i < pReplicas.size(); ++i )
+        {
+          log->Debug( UtilityMsg, "Read %llu bytes at %llu B/s from %s",
+                      (unsigned long long)pReplicas[i]->bytes,
+                      (unsigned long long)pReplicas[i]->rate,
+                      pReplicas[i]->url.c_str() );
+          XRootDStatus st = pReplicas[i]->file->Close();
+          delete pReplicas[i]->file;
+          delete pReplicas[i];
+        }
+      }
+
+      //------------------------------------------------------------------------
+      //! Initialize the source
+      //------------------------------------------------------------------------
+      virtual XrdCl::XRootDStatus Initialize()
+      {
+        using namespace XrdCl;
+        Log *log = DefaultEnv::GetLog();
+        log->Debug( UtilityMsg, "Opening %s for reading from up to %d "
+                    "sources", pUrl->GetURL().c_str(), pSourceLimit );
+
+        std::string recovery;
+        DefaultEnv::GetEnv()->GetString( "ReadRecovery", recovery );
+
+        //----------------------------------------------------------------------
+        // Open the file where the redirector sends us
+        //----------------------------------------------------------------------
+        pPrimary = new Replica( pUrl->GetURL() );
+        pReplicas.push_back( pPrimary );
+        pPrimary->file->SetProperty( "ReadRecovery", recovery );
+
+        XRootDStatus st = pPrimary->file->Open( pUrl->GetURL(),
+                                                OpenFlags::Read );
+        if( !st.IsOK() )
+          return st;
+
+        StatInfo *statInfo;
+        st = pPrimary->file->Stat( false, statInfo );
+        if( !st.IsOK() )
+          return st;
+
+        pSize = statInfo->GetSize();
+        delete statInfo;
+
+        std::string server;
+        pPrimary->file->GetProperty( "DataServer", server );
+        pPrimary->file->GetProperty( "LastURL",    pPrimary->url );
+        pServers.insert( server );
+
+        //----------------------------------------------------------------------
+        // Start opening the other replicas, they do not recover from errors,
+        // the chunks are read from the remaining ones instead
+        //----------------------------------------------------------------------
+        std::vector<std::string> urls = FindReplicas( server );
+        for( size_t i = 0; i < urls.size(); ++i )
+        {
+          if( pOpening.size() + 1 >= pSourceLimit )
+            break;
+          Replica     *replica = new Replica( urls[i] );
+          OpenHandler *handler = new OpenHandler( this, replica );
+          replica->file->SetProperty( "ReadRecovery", "false" );
+          st = replica->file->Open( urls[i], OpenFlags::Read, Access::None,
+                                    handler );
+          if( !st.IsOK() )
+          {
+            delete handler;
+            delete replica->file;
+            delete replica;
+            continue;
+          }
+          pOpening.push_back( handler );
+        }
+        return XRootDStatus();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get size
+      //------------------------------------------------------------------------
+      virtual int64_t GetSize()
+      {
+        return pSize;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get a data chunk from the source
+      //!
+      //! @param  ci     chunk information
+      //! @return        status of the operation
+      //!                suContinue - there are some chunks left
+      //!                suDone     - no chunks left
+      //------------------------------------------------------------------------
+      virtual XrdCl::XRootDStatus GetChunk( XrdCl::ChunkInfo &ci )
+      {
+        using namespace XrdCl;
+        Log *log = DefaultEnv::GetLog();
+
+        //----------------------------------------------------------------------
+        // A replica that is no longer open, the primary one included, fails
+        // its reads and is dropped like any other
+        //----------------------------------------------------------------------
+        if( !pPrimary || pSize < 0 )
+          return XRootDStatus( stError, errUninitialized );
+
+        //----------------------------------------------------------------------
+        // The requests are sent without holding the lock, the handlers
+        // might be called in this thread
+        //----------------------------------------------------------------------
+        std::vector<ChunkHandler*> toSend;
+        pCond.Lock();
+        ReapOrphans();
+        while( 1 )
+        {
+          if( !toSend.empty() )
+          {
+            pCond.UnLock();
+            Send( toSend );
+            toSend.clear();
+            pCond.Lock();
+          }
+
+          //--------------------------------------------------------------------
+          // Fill the window
+          //--------------------------------------------------------------------
+          Replica *replica;
+          while( pSlots.size() < pParallel * Healthy() &&
+                 pCurrentOffset < pSize &&
+                 ( replica = Pick( 0, pChunkSize ) ) )
+          {
+            uint64_t chunkSize = pChunkSize;
+            if( pCurrentOffset + chunkSize > (uint64_t)pSize )
+              chunkSize = pSize - pCurrentOffset;
+            Slot slot;
+            slot.offset   = pCurrentOffset;
+            slot.length   = chunkSize;
+            slot.reissued = false;
+            slot.reqs.push_back( NewRequest( replica, pCurrentOffset,
+                                             chunkSize ) );
+            toSend.push_back( slot.reqs.back() );
+            pSlots.push_back( slot );
+            pCurrentOffset += chunkSize;
+          }
+          if( !toSend.empty() )
+            continue;
+
+          //--------------------------------------------------------------------
+          // Nothing is in flight; unless we are past the end every replica
+          // has failed
+          //--------------------------------------------------------------------
+          if( pSlots.empty() )
+          {
+            if( pCurrentOffset >= pSize )
+            {
+              pCond.UnLock();
+              return XRootDStatus( stOK, suDone );
+            }
+            XRootDStatus st = pLastError;
+            pCond.UnLock();
+            log->Debug( UtilityMsg, "Unable read at %ld from %s, all the "
+                        "replicas failed: %s", pCurrentOffset,
+                        pUrl->GetURL().c_str(), st.ToStr().c_str() );
+            return st;
+          }
+
+          //--------------------------------------------------------------------
+          // Check the chunk at the front
+          //--------------------------------------------------------------------
+          Slot         &slot    = pSlots.front();
+          ChunkHandler *winner  = 0;
+          ChunkHandler *failed  = 0;
+          bool          pending = false;
+          for( size_t i = 0; i < slot.reqs.size() && !winner; ++i )
+          {
+            if( !slot.reqs[i]->finished )
+              pending = true;
+            else if( slot.reqs[i]->status.IsOK() )
+              winner = slot.reqs[i];
+            else
+              failed = slot.reqs[i];
+          }
+
+          if( winner )
+          {
+            ci = winner->chunk;
+            winner->chunk.buffer = 0;
+            winner->replica->bytes += ci.length;
+            for( size_t i = 0; i < slot.reqs.size(); ++i )
+            {
+              if( slot.reqs[i] == winner || slot.reqs[i]->finished )
+                delete slot.reqs[i];
+              else
+              {
+                slot.reqs[i]->orphan = true;
+                pOrphans.push_back( slot.reqs[i] );
+              }
+            }
+            pSlots.pop_front();
+            pCond.UnLock();
+            return XRootDStatus( stOK, suContinue );
+          }
+
+          //--------------------------------------------------------------------
+          // All the requests for the chunk failed, ask another replica
+          //--------------------------------------------------------------------
+          if( !pending )
+          {
+            replica = Pick( 0, slot.length );
+            if( !replica )
+            {
+              XRootDStatus st = failed->status;
+              pCond.UnLock();
+              log->Debug( UtilityMsg, "Unable read %d bytes at %ld from %s: "
+                          "%s", slot.length, slot.offset,
+                          pUrl->GetURL().c_str(), st.ToStr().c_str() );
+              return st;
+            }
+            log->Debug( UtilityMsg, "Reading %d bytes at %ld from %s failed, "
+                        "trying %s", slot.length, slot.offset,
+                        failed->replica->url.c_str(), replica->url.c_str() );
+            slot.reqs.push_back( NewRequest( replica, slot.offset,
+                                             slot.length ) );
+            toSend.push_back( slot.reqs.back() );
+            continue;
+          }
+
+          //--------------------------------------------------------------------
+          // The chunk is late, ask a faster replica
+          //--------------------------------------------------------------------
+          if( !slot.reissued && ( replica = Straggler( slot ) ) )
+          {
+            log->Debug( UtilityMsg, "Reading %d bytes at %ld from %s is "
+                        "late, asking %s too", slot.length, slot.offset,
+                        slot.reqs[0]->replica->url.c_str(),
+                        replica->url.c_str() );
+            slot.reissued = true;
+            slot.reqs.push_back( NewRequest( replica, slot.offset,
+                                             slot.length ) );
+            toSend.push_back( slot.reqs.back() );
+            continue;
+          }
+
+          pCond.WaitMS( 50 );
+        }
+      }
+
+      //------------------------------------------------------------------------
+      // Get check sum
+      //------------------------------------------------------------------------
+      virtual XrdCl::XRootDStatus GetCheckSum( std::string &checkSum,
+                                               std::string &checkSumType )
+      {
+        if( pUrl->IsMetalink() )
+        {
+          XrdCl::RedirectorRegistry &registry   = XrdCl::RedirectorRegistry::Instance();
+          XrdCl::VirtualRedirector  *redirector = registry.Get( *pUrl );
+          checkSum = redirector->GetCheckSum( checkSumType );
+          if( !checkSum.empty() ) return XrdCl::XRootDStatus();
+        }
+
+        XrdCl::File *file = pPrimary->file;
+        std::string dataServer; file->GetProperty( "DataServer", dataServer );
+        std::string lastUrl;    file->GetProperty( "LastURL",    lastUrl );
+        return XrdCl::Utils::GetRemoteCheckSum( checkSum, checkSumType,
+                                                dataServer, XrdCl::URL( lastUrl ).GetPath() );
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the URLs of the replicas read from
+      //------------------------------------------------------------------------
+      std::vector<std::string> GetSources()
+      {
+        XrdSysCondVarHelper scopedLock( pCond );
+        std::vector<std::string> sources;
+        for( size_t i = 0; i < pReplicas.size(); ++i )
+          sources.push_back( pReplicas[i]->url );
+        return sources;
+      }
+
+    private:
+      XRootDSourceMulti(const XRootDSourceMulti &other);
+      XRootDSourceMulti &operator = (const XRootDSourceMulti &other);
+
+      //------------------------------------------------------------------------
+      // Replica of the file
+      //------------------------------------------------------------------------
+      struct Replica
+      {
+        Replica( const std::string &u ): url( u ), file( new XrdCl::File() ),
+          inFlight( 0 ), rate( 0 ), bytes( 0 ), failed( false ) {}
+        std::string  url;
+        XrdCl::File *file;
+        uint64_t     inFlight;  // bytes requested and not arrived yet
+        uint64_t     rate;      // bytes per second, moving average
+        uint64_t     bytes;     // bytes handed out
+        bool         failed;
+      };
+
+      //------------------------------------------------------------------------
+      // Asynchronous chunk handler, everything but the data is guarded
+      // by the condition variable of the source
+      //------------------------------------------------------------------------
+      class ChunkHandler: public XrdCl::ResponseHandler
+      {
+        public:
+          ChunkHandler( XRootDSourceMulti *src, Replica *rep,
+                        uint64_t offset, uint32_t length ):
+            source( src ), replica( rep ), size( length ), ahead( 0 ),
+            finished( false ), orphan( false )
+          {
+            chunk.offset = offset;
+            chunk.length = length;
+            chunk.buffer = new char[length];
+          }
+
+          virtual ~ChunkHandler()
+          {
+            delete [] (char *)chunk.buffer;
+          }
+
+          virtual void HandleResponse( XrdCl::XRootDStatus *statusval,
+                                       XrdCl::AnyObject    *response )
+          {
+            XrdSysCondVar &cond = source->pCond;
+            cond.Lock();
+            gettimeofday( &done, 0 );
+            status = *statusval;
+            delete statusval;
+            if( response )
+            {
+              XrdCl::ChunkInfo *resp = 0;
+              response->Get( resp );
+              if( resp )
+                chunk = *resp;
+              delete response;
+            }
+            source->ChunkArrived( this );
+            cond.Broadcast();
+            cond.UnLock();
+          }
+
+          XRootDSourceMulti   *source;
+          Replica             *replica;
+          XrdCl::ChunkInfo     chunk;
+          uint32_t             size;      // bytes requested
+          uint64_t             ahead;     // bytes in flight at the replica
+          XrdCl::XRootDStatus  status;
+          timeval              sent;
+          timeval              done;
+          bool                 finished;
+          bool                 orphan;    // the chunk was served by another
+      };
+      friend class ChunkHandler;
+
+      //------------------------------------------------------------------------
+      // Close handler of a replica that did not join, deletes the replica
+      // once it is closed (or immediately if it is not open)
+      //------------------------------------------------------------------------
+      class ReplicaCloseHandler: public XrdCl::ResponseHandler
+      {
+        public:
+          ReplicaCloseHandler( Replica *rep ): replica( rep ) {}
+
+          virtual ~ReplicaCloseHandler()
+          {
+            delete replica->file;
+            delete replica;
+          }
+
+          virtual void HandleResponse( XrdCl::XRootDStatus *status,
+                                       XrdCl::AnyObject    *response )
+          {
+            delete status;
+            delete response;
+            delete this;
+          }
+
+          Replica *replica;
+      };
+
+      //------------------------------------------------------------------------
+      // Open handler of another replica, the replica joins the source once
+      // it is open unless the source is gone by then
+      //------------------------------------------------------------------------
+      class OpenHandler: public XrdCl::ResponseHandler
+      {
+        public:
+          OpenHandler( XRootDSourceMulti *src, Replica *rep ):
+            source( src ), replica( rep ), done( false ) {}
+
+          virtual void HandleResponse( XrdCl::XRootDStatus *status,
+                                       XrdCl::AnyObject    *response )
+          {
+            delete response;
+            Replica *rep = replica;
+            mutex.Lock();
+            bool gone   = !source;
+            bool joined = !gone && source->Join( rep, *status );
+            done = true;
+            mutex.UnLock();
+
+            //------------------------------------------------------------------
+            // We are in a callback, so a replica that was opened but is not
+            // used is closed asynchronously
+            //------------------------------------------------------------------
+            if( !joined )
+            {
+              ReplicaCloseHandler *handler = new ReplicaCloseHandler( rep );
+              if( !status->IsOK() ||
+                  !rep->file->Close( handler ).IsOK() )
+                delete handler;
+            }
+            delete status;
+            if( gone )
+              delete this;
+          }
+
+          XrdSysMutex        mutex;
+          XRootDSourceMulti *source;
+          Replica           *replica;
+          bool               done;
+      };
+      friend class OpenHandler;
+
+      //------------------------------------------------------------------------
+      // Chunk in file order with the requests sent for it
+      //------------------------------------------------------------------------
+      struct Slot
+      {
+        uint64_t                   offset;
+        uint32_t                   length;
+        bool                       reissued;
+        std::vector<ChunkHandler*> reqs;
+      };
+
+      //------------------------------------------------------------------------
+      // Find the replicas other than the one on the given server
+      //------------------------------------------------------------------------
+      std::vector<std::string> FindReplicas( const std::string &server )
+      {
+        using namespace XrdCl;
+        std::vector<std::string> urls;
+
+        if( pUrl->IsMetalink() )
+        {
+          RedirectorRegistry &registry   = RedirectorRegistry::Instance();
+          VirtualRedirector  *redirector = registry.Get( *pUrl );
+          if( redirector )
+            urls = redirector->GetReplicas();
+        }
+        else
+        {
+          FileSystem    fs( *pUrl );
+          LocationInfo *info = 0;
+          XRootDStatus  st   = fs.DeepLocate( pUrl->GetPath(),
+                                              OpenFlags::None, info );
+          if( st.IsOK() && info )
+          {
+            std::string user;
+            if( !pUrl->GetUserName().empty() )
+              user = pUrl->GetUserName() + "@";
+            LocationInfo::Iterator it;
+            for( it = info->Begin(); it != info->End(); ++it )
+              if( it->GetType() == LocationInfo::ServerOnline )
+                urls.push_back( pUrl->GetProtocol() + "://" + user +
+                                it->GetAddress() + "/" +
+                                pUrl->GetPathWithParams() );
+          }
+          delete info;
+        }
+
+        std::vector<std::string> others;
+        for( size_t i = 0; i < urls.size(); ++i )
+        {
+          URL url( urls[i] );
+          if( url.IsValid() && url.GetHostId() != server )
+            others.push_back( urls[i] );
+        }
+        return others;
+      }
+
+      //------------------------------------------------------------------------
+      // Add an opened replica to the ones chunks are read from, it has to
+      // be of the same size and on a server not used yet
+      //------------------------------------------------------------------------
+      bool Join( Replica *replica, const XrdCl::XRootDStatus &status )
+      {
+        using namespace XrdCl;
+        Log          *log = DefaultEnv::GetLog();
+        XRootDStatus  st  = status;
+        std::string   server;
+
+        if( st.IsOK() )
+        {
+          StatInfo *statInfo = 0;
+          st = replica->file->Stat( false, statInfo );
+          if( st.IsOK() && statInfo->GetSize() != (uint64_t)pSize )
+            st = XRootDStatus( stError, errDataError, 0,
+                               "size differs from the first source" );
+          delete statInfo;
+          replica->file->GetProperty( "DataServer", server );
+        }
+
+        XrdSysCondVarHelper scopedLock( pCond );
+        if( st.IsOK() && !pServers.insert( server ).second )
+          st = XRootDStatus( stError, errInvalidOp, 0,
+                             "same server as another source" );
+        if( !st.IsOK() )
+        {
+          log->Debug( UtilityMsg, "Not reading from %s: %s",
+                      replica->url.c_str(), st.ToStr().c_str() );
+          return false;
+        }
+
+        log->Debug( UtilityMsg, "Reading %s from %s too",
+                    pUrl->GetURL().c_str(), replica->url.c_str() );
+        pReplicas.push_back( replica );
+        pCond.Broadcast();
+        return true;
+      }
+
+      //------------------------------------------------------------------------
+      // Number of the replicas still in use
+      //------------------------------------------------------------------------
+      size_t Healthy() const
+      {
+        size_t n = 0;
+        for( size_t i = 0; i < pReplicas.size(); ++i )
+          if( !pReplicas[i]->failed )
+            ++n;
+        return n;
+      }
+
+      //------------------------------------------------------------------------
+      // Rate of the replica, a replica that has not delivered anything yet
+      // is assumed to be as fast as the fastest one
+      //------------------------------------------------------------------------
+      uint64_t Rate( const Replica *replica ) const
+      {
+        if( replica->rate )
+          return replica->rate;
+        uint64_t best = 0;
+        for( size_t i = 0; i < pReplicas.size(); ++i )
+          if( pReplicas[i]->rate > best )
+            best = pReplicas[i]->rate;
+        return best;
+      }
+
+      //------------------------------------------------------------------------
+      // Microseconds until the replica delivers the given number of bytes
+      // more, 0 if nothing is known yet
+      //------------------------------------------------------------------------
+      uint64_t Expected( const Replica *replica, uint64_t bytes ) const
+      {
+        uint64_t rate = Rate( replica );
+        if( !rate )
+          return 0;
+        return bytes * 1000000 / rate;
+      }
+
+      //------------------------------------------------------------------------
+      // Pick the replica expected to deliver a chunk first
+      //------------------------------------------------------------------------
+      Replica *Pick( const Replica *exclude, uint32_t length ) const
+      {
+        Replica *best     = 0;
+        uint64_t bestTime = 0;
+        for( size_t i = 0; i < pReplicas.size(); ++i )
+        {
+          Replica *replica = pReplicas[i];
+          if( replica == exclude || replica->failed )
+            continue;
+
+          //--------------------------------------------------------------------
+          // Until the rates are known the bytes in flight decide
+          //--------------------------------------------------------------------
+          uint64_t time = Expected( replica, replica->inFlight + length );
+          if( !time )
+            time = replica->inFlight + length;
+          if( !best || time < bestTime )
+          {
+            best     = replica;
+            bestTime = time;
+          }
+        }
+        return best;
+      }
+
+      //------------------------------------------------------------------------
+      // Check whether the chunk is late and return the replica to ask for
+      // another copy, the chunk is late if it takes three times longer than
+      // expected and another replica is expected to deliver it before
+      //------------------------------------------------------------------------
+      Replica *Straggler( const Slot &slot ) const
+      {
+        ChunkHandler *req = 0;
+        for( size_t i = 0; i < slot.reqs.size() && !req; ++i )
+          if( !slot.reqs[i]->finished )
+            req = slot.reqs[i];
+
+        uint64_t expected = Expected( req->replica, req->ahead );
+        if( !expected )
+          return 0;
+
+        timeval now;
+        gettimeofday( &now, 0 );
+        uint64_t elapsed = XrdCl::Utils::GetElapsedMicroSecs( req->sent, now );
+        if( elapsed < 3 * expected || elapsed < 100000 )
+          return 0;
+
+        Replica *replica = Pick( req->replica, slot.length );
+        if( !replica || Expected( replica, replica->inFlight + slot.length )
+                        >= elapsed )
+          return 0;
+        return replica;
+      }
+
+      //------------------------------------------------------------------------
+      // Create a request for the chunk, called with the lock held
+      //------------------------------------------------------------------------
+      ChunkHandler *NewRequest( Replica *replica, uint64_t offset,
+                                uint32_t length )
+      {
+        ChunkHandler *ch = new ChunkHandler( this, replica, offset, length );
+        replica->inFlight += length;
+        ch->ahead          = replica->inFlight;
+        gettimeofday( &ch->sent, 0 );
+        return ch;
+      }
+
+      //------------------------------------------------------------------------
+      // Send the requests, called without the lock
+      //------------------------------------------------------------------------
+      void Send( const std::vector<ChunkHandler*> &reqs )
+      {
+        for( size_t i = 0; i < reqs.size(); ++i )
+        {
+          ChunkHandler        *ch = reqs[i];
+          XrdCl::XRootDStatus  st = ch->replica->file->Read( ch->chunk.offset,
+                                                             ch->size,
+                                                             ch->chunk.buffer,
+                                                             ch );
+          if( !st.IsOK() )
+            ch->HandleResponse( new XrdCl::XRootDStatus( st ), 0 );
+        }
+      }
+
+      //------------------------------------------------------------------------
+      // Account for an arrived chunk, called with the lock held
+      //
+      // A chunk requested while the replica had n bytes in flight, itself
+      // included, arrives after about n bytes have been transfered, so n
+      // over the time it took is a sample of the rate of the replica.
+      //------------------------------------------------------------------------
+      void ChunkArrived( ChunkHandler *ch )
+      {
+        Replica *replica = ch->replica;
+        replica->inFlight -= ch->size;
+        ch->finished       = true;
+
+        //----------------------------------------------------------------------
+        // A copy nobody waits for anymore does not count against the replica
+        //----------------------------------------------------------------------
+        if( !ch->status.IsOK() )
+        {
+          if( !ch->orphan )
+          {
+            replica->failed = true;
+            pLastError      = ch->status;
+          }
+          return;
+        }
+
+        uint64_t elapsed = XrdCl::Utils::GetElapsedMicroSecs( ch->sent,
+                                                              ch->done );
+        if( !elapsed )
+          elapsed = 1;
+        uint64_t sample = ch->ahead * 1000000 / elapsed;
+        replica->rate = replica->rate ? ( 3 * replica->rate + sample ) / 4
+                                      : sample;
+      }
+
+      //------------------------------------------------------------------------
+      // Delete the losing copies that have arrived, called with the lock held
+      //------------------------------------------------------------------------
+      void ReapOrphans()
+      {
+        std::list<ChunkHandler*>::iterator it = pOrphans.begin();
+        while( it != pOrphans.end() )
+        {
+          if( (*it)->finished )
+          {
+            delete *it;
+            it = pOrphans.erase( it );
+          }
+          else
+            ++it;
+        }
+      }
+
+      //------------------------------------------------------------------------
+      // Wait for the chunks that are flying and delete them
+      //------------------------------------------------------------------------
+      void CleanUpChunks()
+      {
+        XrdSysCondVarHelper scopedLock( pCond );
+        while( 1 )
+        {
+          ReapOrphans();
+          while( !pSlots.empty() )
+          {
+            Slot &slot = pSlots.front();
+            for( size_t i = 0; i < slot.reqs.size(); ++i )
+              pOrphans.push_back( slot.reqs[i] );
+            pSlots.pop_front();
+          }
+          ReapOrphans();
+          if( pOrphans.empty() )
+            break;
+          pCond.Wait();
+        }
+      }
+
+      const XrdCl::URL          *pUrl;
+      Replica                   *pPrimary;
+      int64_t                    pSize;
+      int64_t                    pCurrentOffset;
+      uint32_t                   pChunkSize;
+      uint16_t                   pParallel;
+      uint16_t                   pSourceLimit;
+      std::vector<Replica*>      pReplicas;
+      std::vector<OpenHandler*>  pOpening;
+      std::set<std::string>      pServers;
+      XrdSysCondVar              pCond;
+      std::deque<Slot>           pSlots;
+      std::list<ChunkHandler*>   pOrphans;
+      XrdCl::XRootDStatus        pLastError;
+  };
+
   //----------------------------------------------------------------------------
   //! XRootDSource
   //----------------------------------------------------------------------------
@@ -1611,9 +2584,9 @@ namespace XrdCl
     std::string checkSumType;
     std::string checkSumPreset;
     std::string zipSource;
-    uint16_t    parallelChunks;
-    uint32_t    chunkSize;
-    bool        posc, force, coerce, makeDir, dynamicSource, zip;
+    uint16_t    parallelChunks, maxParallelChunks, sourceLimit = 1;
+    uint32_t    chunkSize, minChunkSize, maxChunkSize;
+    bool        posc, force, coerce, makeDir, dynamicSource, zip, adaptive;
 
     pProperties->Get( "checkSumMode",    checkSumMode );
     pProperties->Get( "checkSumType",    checkSumType );
@@ -1626,6 +2599,11 @@ namespace XrdCl
     pProperties->Get( "makeDir",         makeDir );
     pProperties->Get( "dynamicSource",   dynamicSource );
     pProperties->Get( "zipArchive",      zip );
+    pProperties->Get( "adaptiveChunks",  adaptive );
+    pProperties->Get( "minChunkSize",    minChunkSize );
+    pProperties->Get( "maxChunkSize",    maxChunkSize );
+    pProperties->Get( "maxParallelChunks", maxParallelChunks );
+    pProperties->Get( "sourceLimit",     sourceLimit );
 
     if( zip )
       pProperties->Get( "zipSource",     zipSource );
@@ -1633,7 +2611,9 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Initialize the source and the destination
     //--------------------------------------------------------------------------
-    XRDCL_SMART_PTR_T<Source> src;
+    XRDCL_SMART_PTR_T<Source>          src;
+    XRDCL_SMART_PTR_T<ChunkController> controller;
+    XRootDSourceMulti                 *multiSource = 0;
     if( zip )
       src.reset( new XRootDSourceZip( zipSource, &GetSource(), chunkSize, parallelChunks ) );
     else if( GetSource().GetProtocol() == "file" )
@@ -1644,8 +2624,21 @@ namespace XrdCl
     {
       if( dynamicSource )
         src.reset( new XRootDSourceDynamic( &GetSource(), chunkSize ) );
+      else if( sourceLimit > 1 )
+      {
+        multiSource = new XRootDSourceMulti( &GetSource(), chunkSize,
+                                             parallelChunks, sourceLimit );
+        src.reset( multiSource );
+      }
       else
-        src.reset( new XRootDSource( &GetSource(), chunkSize, parallelChunks ) );
+      {
+        if( adaptive )
+          controller.reset( new ChunkController( chunkSize, parallelChunks,
+                                                 minChunkSize, maxChunkSize,
+                                                 maxParallelChunks ) );
+        src.reset( new XRootDSource( &GetSource(), chunkSize, parallelChunks,
+                                     controller.get() ) );
+      }
     }
 
     XRootDStatus st = src->Initialize();
@@ -1703,6 +2696,13 @@ namespace XrdCl
 
       processed += chunkInfo.length;
       if( progress ) progress->JobProgress( pJobId, processed, size );
+
+      uint32_t newChunkSize;
+      uint16_t newParallel;
+      uint64_t rate;
+      if( controller.get() && controller->Changed( newChunkSize, newParallel,
+                                                   rate ) && progress )
+        progress->JobTuning( pJobId, newChunkSize, newParallel, rate );
     }
 
     st = dest->Flush();
@@ -1720,6 +2720,8 @@ namespace XrdCl
       return XRootDStatus( stError, errDataError );
     }
     pResults->Set( "size", processed );
+    if( multiSource )
+      pResults->Set( "sources", multiSource->GetSources() );
 
     //--------------------------------------------------------------------------
     // Finalize the destination
@@ -54,6 +54,10 @@ namespace XrdCl
   const int DefaultWorkerThreads        = 3;
   const int DefaultCPChunkSize          = 16777216;
   const int DefaultCPParallelChunks     = 4;
+  const int DefaultCPAdaptiveChunks     = 0;
+  const int DefaultCPMinChunkSize       = 1048576;
+  const int DefaultCPMaxChunkSize       = 67108864;
+  const int DefaultCPMaxParallelChunks  = 16;
   const int DefaultDataServerTTL        = 300;
   const int DefaultLoadBalancerTTL      = 1200;
   const int DefaultCPInitTimeout        = 600;
@@ -66,6 +70,9 @@ namespace XrdCl
   const int DefaultParallelEvtLoop      = 1;
   const int DefaultMetalinkProcessing   = 1;
   const int DefaultLocalMetalinkFile    = 1;
+  const int DefaultReadCacheSize        = 0;
+  const int DefaultReadCacheBlockSize   = 65536;
+  const int DefaultReadAheadWindow      = 4194304;
 
   const char * const DefaultPollerPreference   = "built-in";
   const char * const DefaultNetworkStack       = "IPAuto";
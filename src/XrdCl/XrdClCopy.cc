@@ -306,12 +306,6 @@ bool AllOptionsSupported( XrdCpConfig *config )
     return false;
   }
 
-  if( config->nSrcs != 1 )
-  {
-    std::cerr << "Multiple sources are not yet supported" << std::endl;
-    return false;
-  }
-
   return true;
 }
 
@@ -794,6 +788,7 @@ int main( int argc, char **argv )
     properties.Set( "checkSumPreset", checkSumPreset );
     properties.Set( "chunkSize",      chunkSize      );
     properties.Set( "parallelChunks", parallelChunks );
+    properties.Set( "sourceLimit",    (uint16_t)config.nSrcs );
     properties.Set( "zipArchive",     zip            );
 
     if( zip )
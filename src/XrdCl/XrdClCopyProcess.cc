@@ -229,6 +229,37 @@ namespace XrdCl
     if( !p.HasProperty( "dynamicSource" ) )
       p.Set( "dynamicSource", false );
 
+    if( !p.HasProperty( "sourceLimit" ) )
+      p.Set( "sourceLimit", (uint16_t)1 );
+
+    if( !p.HasProperty( "adaptiveChunks" ) )
+    {
+      int val = DefaultCPAdaptiveChunks;
+      env->GetInt( "CPAdaptiveChunks", val );
+      p.Set( "adaptiveChunks", (bool)val );
+    }
+
+    if( !p.HasProperty( "minChunkSize" ) )
+    {
+      int val = DefaultCPMinChunkSize;
+      env->GetInt( "CPMinChunkSize", val );
+      p.Set( "minChunkSize", val );
+    }
+
+    if( !p.HasProperty( "maxChunkSize" ) )
+    {
+      int val = DefaultCPMaxChunkSize;
+      env->GetInt( "CPMaxChunkSize", val );
+      p.Set( "maxChunkSize", val );
+    }
+
+    if( !p.HasProperty( "maxParallelChunks" ) )
+    {
+      int val = DefaultCPMaxParallelChunks;
+      env->GetInt( "CPMaxParallelChunks", val );
+      p.Set( "maxParallelChunks", val );
+    }
+
     //--------------------------------------------------------------------------
     // Insert the properties
     //--------------------------------------------------------------------------
@@ -94,6 +94,23 @@ namespace XrdCl
         (void)jobNum;
         return false;
       }
+
+      //------------------------------------------------------------------------
+      //! Notify that the current job changed the size or the number of the
+      //! chunks it reads in parallel, see adaptiveChunks
+      //!
+      //! @param jobNum         job number
+      //! @param chunkSize      new size of a chunk in bytes
+      //! @param parallelChunks new number of chunks requested in parallel
+      //! @param bytesPerSec    throughput that led to the change
+      //------------------------------------------------------------------------
+      virtual void JobTuning( uint16_t jobNum,
+                              uint32_t chunkSize,
+                              uint16_t parallelChunks,
+                              uint64_t bytesPerSec )
+      {
+        (void)jobNum; (void)chunkSize; (void)parallelChunks; (void)bytesPerSec;
+      };
   };
 
   //----------------------------------------------------------------------------
@@ -121,7 +138,10 @@ namespace XrdCl
       //! Configuration properties:
       //! source         [string]   - original source URL
       //! target         [string]   - target directory or file
-      //! sourceLimit    [uint16_t] - maximum number sources
+      //! sourceLimit    [uint16_t] - maximum number of sources, an xrootd
+      //!                             source with more than one replica is
+      //!                             read from up to this many replicas
+      //!                             at once
       //! force          [bool]     - overwrite target if exists
       //! posc           [bool]     - persistify only on successful close
       //! coerce         [bool]     - ignore locking semantics on destination
@@ -144,6 +164,13 @@ namespace XrdCl
       //! tpcTimeout     [uint16_t] - time limit for the actual copy to finish
       //! dynamicSource  [bool]     - support for the case where the size source
       //!                             file may change during reading process
+      //! adaptiveChunks [bool]     - adapt the chunk size and the number of
+      //!                             chunks in parallel to the throughput
+      //!                             observed while reading an xrootd source
+      //! minChunkSize   [uint32_t] - lower bound of the adaptive chunk size
+      //! maxChunkSize   [uint32_t] - upper bound of the adaptive chunk size
+      //! maxParallelChunks [uint16_t] - upper bound of the adaptive number of
+      //!                             chunks in parallel
       //!
       //! Configuration job - this is a job that that is supposed to configure
       //! the copy process as a whole instead of adding a copy job:
@@ -274,6 +274,10 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "WorkerThreads",        DefaultWorkerThreads        );
     REGISTER_VAR_INT( varsInt, "CPChunkSize",          DefaultCPChunkSize          );
     REGISTER_VAR_INT( varsInt, "CPParallelChunks",     DefaultCPParallelChunks     );
+    REGISTER_VAR_INT( varsInt, "CPAdaptiveChunks",     DefaultCPAdaptiveChunks     );
+    REGISTER_VAR_INT( varsInt, "CPMinChunkSize",       DefaultCPMinChunkSize       );
+    REGISTER_VAR_INT( varsInt, "CPMaxChunkSize",       DefaultCPMaxChunkSize       );
+    REGISTER_VAR_INT( varsInt, "CPMaxParallelChunks",  DefaultCPMaxParallelChunks  );
     REGISTER_VAR_INT( varsInt, "DataServerTTL",        DefaultDataServerTTL        );
     REGISTER_VAR_INT( varsInt, "LoadBalancerTTL",      DefaultLoadBalancerTTL      );
     REGISTER_VAR_INT( varsInt, "CPInitTimeout",        DefaultCPInitTimeout        );
@@ -286,6 +290,9 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "ParallelEvtLoop",      DefaultParallelEvtLoop      );
     REGISTER_VAR_INT( varsInt, "MetalinkProcessing",   DefaultMetalinkProcessing   );
     REGISTER_VAR_INT( varsInt, "LocalMetalinkFile",    DefaultLocalMetalinkFile    );
+    REGISTER_VAR_INT( varsInt, "ReadCacheSize",        DefaultReadCacheSize        );
+    REGISTER_VAR_INT( varsInt, "ReadCacheBlockSize",   DefaultReadCacheBlockSize   );
+    REGISTER_VAR_INT( varsInt, "ReadAheadWindow",      DefaultReadAheadWindow      );
 
     REGISTER_VAR_STR( varsStr, "PollerPreference",     DefaultPollerPreference     );
     REGISTER_VAR_STR( varsStr, "ClientMonitor",        DefaultClientMonitor        );
@@ -33,6 +33,16 @@
 #include "XrdCl/XrdClPlugInManager.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 
+#include <algorithm>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Number of times a page with a bad checksum is read or written again
+  //----------------------------------------------------------------------------
+  const int PgRetries = 3;
+}
+
 namespace XrdCl
 {
   //----------------------------------------------------------------------------
@@ -334,6 +344,192 @@ namespace XrdCl
     return MessageUtils::WaitForResponse( &handler, vReadInfo );
   }
 
+  //----------------------------------------------------------------------------
+  // Write scattered data chunks in one operation - async
+  //----------------------------------------------------------------------------
+  XRootDStatus File::VectorWrite( const ChunkList &chunks,
+                                  ResponseHandler *handler,
+                                  uint16_t         timeout )
+  {
+    if( pPlugIn )
+      return pPlugIn->VectorWrite( chunks, handler, timeout );
+
+    return pStateHandler->VectorWrite( chunks, handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Write scattered data chunks in one operation - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus File::VectorWrite( const ChunkList &chunks,
+                                  uint16_t         timeout )
+  {
+    SyncResponseHandler handler;
+    Status st = VectorWrite( chunks, &handler, timeout );
+    if( !st.IsOK() )
+      return st;
+
+    XRootDStatus status = MessageUtils::WaitForStatus( &handler );
+    return status;
+  }
+
+  //----------------------------------------------------------------------------
+  // Read data pages at a given offset - async
+  //----------------------------------------------------------------------------
+  XRootDStatus File::PgRead( uint64_t         offset,
+                             uint32_t         size,
+                             void            *buffer,
+                             ResponseHandler *handler,
+                             uint16_t         timeout )
+  {
+    if( pPlugIn )
+      return pPlugIn->PgRead( offset, size, buffer, handler, timeout );
+
+    return pStateHandler->PgRead( offset, size, buffer, handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Read data pages at a given offset - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus File::PgRead( uint64_t               offset,
+                             uint32_t               size,
+                             void                  *buffer,
+                             std::vector<uint32_t> &cksums,
+                             uint32_t              &bytesRead,
+                             uint16_t               timeout )
+  {
+    SyncResponseHandler handler;
+    Status st = PgRead( offset, size, buffer, &handler, timeout );
+    if( !st.IsOK() )
+      return st;
+
+    PageInfo *pageInfo = 0;
+    XRootDStatus status = MessageUtils::WaitForResponse( &handler, pageInfo );
+    if( !status.IsOK() )
+      return status;
+
+    std::vector<uint64_t> badPages;
+    bytesRead = pageInfo->GetLength();
+    cksums.swap( pageInfo->GetCksums() );
+    badPages.swap( pageInfo->GetBadPages() );
+    delete pageInfo;
+
+    //--------------------------------------------------------------------------
+    // Read again, one by one, the pages that arrived corrupted
+    //--------------------------------------------------------------------------
+    uint64_t fpEnd = offset - offset % kXR_pgPageSZ + kXR_pgPageSZ;
+    for( size_t i = 0; i < badPages.size(); ++i )
+    {
+      uint64_t pgOff = badPages[i];
+      uint32_t pgLen = std::min<uint64_t>( kXR_pgPageSZ - pgOff % kXR_pgPageSZ,
+                                           offset + bytesRead - pgOff );
+      size_t   pgIdx = pgOff < fpEnd ? 0 : 1 + ( pgOff - fpEnd ) / kXR_pgPageSZ;
+      char    *pgBuf = (char*)buffer + ( pgOff - offset );
+      bool     pgOK  = false;
+
+      for( int n = 0; n < PgRetries && !pgOK; ++n )
+      {
+        SyncResponseHandler pgHandler;
+        st = PgRead( pgOff, pgLen, pgBuf, &pgHandler, timeout );
+        if( !st.IsOK() )
+          return st;
+
+        status = MessageUtils::WaitForResponse( &pgHandler, pageInfo );
+        if( !status.IsOK() )
+          return status;
+
+        pgOK = pageInfo->GetBadPages().empty() &&
+               pageInfo->GetLength() == pgLen;
+        if( pgOK )
+          cksums[pgIdx] = pageInfo->GetCksums().front();
+        delete pageInfo;
+      }
+
+      if( !pgOK )
+        return XRootDStatus( stError, errDataError );
+    }
+    return status;
+  }
+
+  //----------------------------------------------------------------------------
+  // Write data pages at a given offset - async
+  //----------------------------------------------------------------------------
+  XRootDStatus File::PgWrite( uint64_t                     offset,
+                              uint32_t                     size,
+                              const void                  *buffer,
+                              const std::vector<uint32_t> &cksums,
+                              ResponseHandler             *handler,
+                              uint16_t                     timeout )
+  {
+    if( pPlugIn )
+      return pPlugIn->PgWrite( offset, size, buffer, cksums, handler, timeout );
+
+    return pStateHandler->PgWrite( offset, size, buffer, cksums, handler,
+                                   timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Write data pages at a given offset - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus File::PgWrite( uint64_t                     offset,
+                              uint32_t                     size,
+                              const void                  *buffer,
+                              const std::vector<uint32_t> &cksums,
+                              uint16_t                     timeout )
+  {
+    SyncResponseHandler handler;
+    Status st = PgWrite( offset, size, buffer, cksums, &handler, timeout );
+    if( !st.IsOK() )
+      return st;
+
+    PageInfo *pageInfo = 0;
+    XRootDStatus status = MessageUtils::WaitForResponse( &handler, pageInfo );
+    if( !status.IsOK() )
+      return status;
+
+    std::vector<uint64_t> badPages;
+    badPages.swap( pageInfo->GetBadPages() );
+    delete pageInfo;
+
+    //--------------------------------------------------------------------------
+    // Send again, one by one, the pages the server got corrupted
+    //--------------------------------------------------------------------------
+    uint64_t fpEnd = offset - offset % kXR_pgPageSZ + kXR_pgPageSZ;
+    for( size_t i = 0; i < badPages.size(); ++i )
+    {
+      uint64_t pgOff = badPages[i];
+      if( pgOff < offset || pgOff >= offset + size )
+        return XRootDStatus( stError, errInvalidResponse );
+
+      uint32_t pgLen = std::min<uint64_t>( kXR_pgPageSZ - pgOff % kXR_pgPageSZ,
+                                           offset + size - pgOff );
+      size_t   pgIdx = pgOff < fpEnd ? 0 : 1 + ( pgOff - fpEnd ) / kXR_pgPageSZ;
+      const char *pgBuf = (const char*)buffer + ( pgOff - offset );
+      std::vector<uint32_t> pgCksum;
+      if( !cksums.empty() )
+        pgCksum.push_back( cksums[pgIdx] );
+      bool pgOK = false;
+
+      for( int n = 0; n < PgRetries && !pgOK; ++n )
+      {
+        SyncResponseHandler pgHandler;
+        st = PgWrite( pgOff, pgLen, pgBuf, pgCksum, &pgHandler, timeout );
+        if( !st.IsOK() )
+          return st;
+
+        status = MessageUtils::WaitForResponse( &pgHandler, pageInfo );
+        if( !status.IsOK() )
+          return status;
+
+        pgOK = pageInfo->GetBadPages().empty();
+        delete pageInfo;
+      }
+
+      if( !pgOK )
+        return XRootDStatus( stError, errDataError );
+    }
+    return status;
+  }
+
   //----------------------------------------------------------------------------
   // Performs a custom operation on an open file, server implementation
   // dependent - async
@@ -326,6 +326,134 @@ namespace XrdCl
                                uint16_t          timeout = 0 )
                                XRD_WARN_UNUSED_RESULT;
 
+      //------------------------------------------------------------------------
+      //! Write scattered data chunks in one operation - async
+      //! The call interprets and returns the server response, which may be
+      //! either a success or a failure, it does not contain the number
+      //! of bytes that were actually written.
+      //!
+      //! @param chunks    list of the chunks to be written, each holding the
+      //!                  offset, the length and a pointer to the data. The
+      //!                  maximum number of chunks per request is 1024.
+      //! @param handler   handler to be notified when the response arrives
+      //! @param timeout   timeout value, if 0 then the environment default
+      //!                  will be used
+      //! @return          status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus VectorWrite( const ChunkList &chunks,
+                                ResponseHandler *handler,
+                                uint16_t         timeout = 0 )
+                                XRD_WARN_UNUSED_RESULT;
+
+      //------------------------------------------------------------------------
+      //! Write scattered data chunks in one operation - sync
+      //!
+      //! @param chunks    list of the chunks to be written, each holding the
+      //!                  offset, the length and a pointer to the data. The
+      //!                  maximum number of chunks per request is 1024.
+      //! @param timeout   timeout value, if 0 then the environment default
+      //!                  will be used
+      //! @return          status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus VectorWrite( const ChunkList &chunks,
+                                uint16_t         timeout = 0 )
+                                XRD_WARN_UNUSED_RESULT;
+
+      //------------------------------------------------------------------------
+      //! Read data pages at a given offset - async
+      //!
+      //! The server sends the CRC32C of every page (kXR_pgPageSZ bytes, the
+      //! first and last pages may be short) along with the data. The pages
+      //! whose checksum does not match are listed in the PageInfo response,
+      //! their data is still placed in the buffer.
+      //!
+      //! @param offset  offset from the beginning of the file
+      //! @param size    number of bytes to be read
+      //! @param buffer  a pointer to a buffer big enough to hold the data
+      //! @param handler handler to be notified when the response arrives,
+      //!                the response parameter will hold a PageInfo object
+      //!                if the procedure was successful
+      //! @param timeout timeout value, if 0 the environment default will
+      //!                be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus PgRead( uint64_t         offset,
+                           uint32_t         size,
+                           void            *buffer,
+                           ResponseHandler *handler,
+                           uint16_t         timeout = 0 )
+                           XRD_WARN_UNUSED_RESULT;
+
+      //------------------------------------------------------------------------
+      //! Read data pages at a given offset - sync
+      //!
+      //! Pages that arrive with a bad checksum are read again. If that does
+      //! not help the call fails with errDataError.
+      //!
+      //! @param offset    offset from the beginning of the file
+      //! @param size      number of bytes to be read
+      //! @param buffer    a pointer to a buffer big enough to hold the data
+      //! @param cksums    the CRC32C of each page read
+      //! @param bytesRead number of bytes actually read
+      //! @param timeout   timeout value, if 0 the environment default will
+      //!                  be used
+      //! @return          status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus PgRead( uint64_t               offset,
+                           uint32_t               size,
+                           void                  *buffer,
+                           std::vector<uint32_t> &cksums,
+                           uint32_t              &bytesRead,
+                           uint16_t               timeout = 0 )
+                           XRD_WARN_UNUSED_RESULT;
+
+      //------------------------------------------------------------------------
+      //! Write data pages at a given offset - async
+      //!
+      //! Every page is sent along with its CRC32C. The server does not write
+      //! the pages whose checksum does not match and the PageInfo response
+      //! lists them so that they can be sent again.
+      //!
+      //! @param offset  offset from the beginning of the file
+      //! @param size    number of bytes to be written
+      //! @param buffer  a pointer to the buffer holding the data to be written
+      //! @param cksums  the CRC32C of each page, computed here if empty
+      //! @param handler handler to be notified when the response arrives,
+      //!                the response parameter will hold a PageInfo object
+      //!                if the procedure was successful
+      //! @param timeout timeout value, if 0 the environment default will
+      //!                be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus PgWrite( uint64_t                     offset,
+                            uint32_t                     size,
+                            const void                  *buffer,
+                            const std::vector<uint32_t> &cksums,
+                            ResponseHandler             *handler,
+                            uint16_t                     timeout = 0 )
+                            XRD_WARN_UNUSED_RESULT;
+
+      //------------------------------------------------------------------------
+      //! Write data pages at a given offset - sync
+      //!
+      //! Pages the server reports as corrupted are sent again. If that does
+      //! not help the call fails with errDataError.
+      //!
+      //! @param offset  offset from the beginning of the file
+      //! @param size    number of bytes to be written
+      //! @param buffer  a pointer to the buffer holding the data to be written
+      //! @param cksums  the CRC32C of each page, computed here if empty
+      //! @param timeout timeout value, if 0 the environment default will
+      //!                be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus PgWrite( uint64_t                     offset,
+                            uint32_t                     size,
+                            const void                  *buffer,
+                            const std::vector<uint32_t> &cksums,
+                            uint16_t                     timeout = 0 )
+                            XRD_WARN_UNUSED_RESULT;
+
       //------------------------------------------------------------------------
       //! Performs a custom operation on an open file, server implementation
       //! dependent - async
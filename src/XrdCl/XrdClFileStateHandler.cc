@@ -37,11 +37,14 @@
 #include "XrdCl/XrdClResponseJob.hh"
 #include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClUglyHacks.hh"
+#include "XrdCl/XrdClReadCache.hh"
 #include "XrdClRedirectorRegistry.hh"
+#include "XrdOuc/XrdOucCRC.hh"
 
 #include <sstream>
 #include <memory>
 #include <sys/time.h>
+#include <arpa/inet.h>
 
 namespace
 {
@@ -332,9 +335,11 @@ namespace XrdCl
     pDoRecoverWrite( true ),
     pFollowRedirects( true ),
     pUseVirtRedirector( true ),
+    pReadCache( 0 ),
     pReOpenHandler( 0 )
   {
     pFileHandle = new uint8_t[4];
+    pReadCache  = ReadCache::Create( this );
     ResetMonitoringVars();
     DefaultEnv::GetForkHandler()->RegisterFileObject( this );
     DefaultEnv::GetFileTimer()->RegisterFileObject( this );
@@ -361,9 +366,11 @@ namespace XrdCl
     pDoRecoverWrite( true ),
     pFollowRedirects( true ),
     pUseVirtRedirector( useVirtRedirector ),
+    pReadCache( 0 ),
     pReOpenHandler( 0 )
   {
     pFileHandle = new uint8_t[4];
+    pReadCache  = ReadCache::Create( this );
     ResetMonitoringVars();
     DefaultEnv::GetForkHandler()->RegisterFileObject( this );
     DefaultEnv::GetFileTimer()->RegisterFileObject( this );
@@ -403,6 +410,7 @@ namespace XrdCl
     delete pDataServer;
     delete pLoadBalancer;
     delete [] pFileHandle;
+    delete pReadCache;
   }
 
   //----------------------------------------------------------------------------
@@ -430,6 +438,8 @@ namespace XrdCl
       return XRootDStatus( stError, errInvalidOp );
 
     pFileState = OpenInProgress;
+    if( pReadCache )
+      pReadCache->Reset();
 
     //--------------------------------------------------------------------------
     // Check if the parameters are valid
@@ -537,6 +547,13 @@ namespace XrdCl
   XRootDStatus FileStateHandler::Close( ResponseHandler *handler,
                                         uint16_t         timeout )
   {
+    //--------------------------------------------------------------------------
+    // Readahead may still be in flight, the cache closes the file when it
+    // has arrived
+    //--------------------------------------------------------------------------
+    if( pReadCache && pReadCache->DeferClose( handler, timeout ) )
+      return XRootDStatus();
+
     XrdSysMutexHelper scopedLock( pMutex );
 
     //--------------------------------------------------------------------------
@@ -657,6 +674,39 @@ namespace XrdCl
                                        void            *buffer,
                                        ResponseHandler *handler,
                                        uint16_t         timeout )
+  {
+    //--------------------------------------------------------------------------
+    // Small reads of files opened for reading go through the cache if we
+    // have one
+    //--------------------------------------------------------------------------
+    if( pReadCache && pReadCache->Accepts( size, buffer ) )
+    {
+      bool     cached   = false;
+      uint64_t fileSize = 0;
+      {
+        XrdSysMutexHelper scopedLock( pMutex );
+        if( (pFileState == Opened || pFileState == Recovering) &&
+            IsReadOnly() )
+        {
+          cached   = true;
+          fileSize = pStatInfo ? pStatInfo->GetSize() : 0;
+        }
+      }
+      if( cached )
+        return pReadCache->Read( offset, size, buffer, handler, timeout,
+                                 fileSize );
+    }
+    return ReadDirect( offset, size, buffer, handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Read a data chunk at a given offset bypassing the read cache - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::ReadDirect( uint64_t         offset,
+                                             uint32_t         size,
+                                             void            *buffer,
+                                             ResponseHandler *handler,
+                                             uint16_t         timeout )
   {
     XrdSysMutexHelper scopedLock( pMutex );
 
@@ -879,6 +929,189 @@ namespace XrdCl
     return SendOrQueue( *pDataServer, msg, stHandler, params );
   }
 
+  //----------------------------------------------------------------------------
+  // Write scattered data chunks in one operation - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::VectorWrite( const ChunkList &chunks,
+                                              ResponseHandler *handler,
+                                              uint16_t         timeout )
+  {
+    //--------------------------------------------------------------------------
+    // Sanity check
+    //--------------------------------------------------------------------------
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    if( pFileState != Opened && pFileState != Recovering )
+      return XRootDStatus( stError, errInvalidOp );
+
+    //--------------------------------------------------------------------------
+    // The server takes at most 1024 chunks and drops the connection if there
+    // are more, so refuse them here
+    //--------------------------------------------------------------------------
+    if( chunks.empty() || chunks.size() > 1024 )
+      return XRootDStatus( stError, errInvalidArgs );
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileMsg, "[0x%x@%s] Sending a vector write command for handle "
+                "0x%x to %s", this, pFileUrl->GetURL().c_str(),
+                *((uint32_t*)pFileHandle), pDataServer->GetHostId().c_str() );
+
+    //--------------------------------------------------------------------------
+    // Build the message, the data itself follows the write list on the wire
+    //--------------------------------------------------------------------------
+    Message             *msg;
+    ClientWriteVRequest *req;
+    MessageUtils::CreateRequest( msg, req, sizeof(write_list)*chunks.size() );
+
+    req->requestid = kXR_writev;
+    req->dlen      = sizeof(write_list)*chunks.size();
+
+    ChunkList  *list      = new ChunkList();
+    write_list *dataChunk = (write_list*)msg->GetBuffer( 24 );
+    for( size_t i = 0; i < chunks.size(); ++i )
+    {
+      dataChunk[i].wlen   = chunks[i].length;
+      dataChunk[i].offset = chunks[i].offset;
+      memcpy( dataChunk[i].fhandle, pFileHandle, 4 );
+      list->push_back( chunks[i] );
+    }
+
+    //--------------------------------------------------------------------------
+    // Send the message
+    //--------------------------------------------------------------------------
+    MessageSendParams params;
+    params.timeout         = timeout;
+    params.followRedirects = false;
+    params.stateful        = true;
+    params.chunkList       = list;
+    MessageUtils::ProcessSendParams( params );
+
+    XRootDTransport::SetDescription( msg );
+    StatefulHandler *stHandler = new StatefulHandler( this, handler, msg, params );
+    return SendOrQueue( *pDataServer, msg, stHandler, params );
+  }
+
+  //----------------------------------------------------------------------------
+  // Read data pages at a given offset - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::PgRead( uint64_t         offset,
+                                         uint32_t         size,
+                                         void            *buffer,
+                                         ResponseHandler *handler,
+                                         uint16_t         timeout )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    if( pFileState != Opened && pFileState != Recovering )
+      return XRootDStatus( stError, errInvalidOp );
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileMsg, "[0x%x@%s] Sending a pgread command for handle 0x%x "
+                "to %s", this, pFileUrl->GetURL().c_str(),
+                *((uint32_t*)pFileHandle), pDataServer->GetHostId().c_str() );
+
+    Message             *msg;
+    ClientPgReadRequest *req;
+    MessageUtils::CreateRequest( msg, req );
+
+    req->requestid  = kXR_pgread;
+    req->offset     = offset;
+    req->rlen       = size;
+    memcpy( req->fhandle, pFileHandle, 4 );
+
+    ChunkList *list   = new ChunkList();
+    list->push_back( ChunkInfo( offset, size, buffer ) );
+
+    XRootDTransport::SetDescription( msg );
+    MessageSendParams params;
+    params.timeout         = timeout;
+    params.followRedirects = false;
+    params.stateful        = true;
+    params.chunkList       = list;
+    MessageUtils::ProcessSendParams( params );
+
+    StatefulHandler *stHandler = new StatefulHandler( this, handler, msg, params );
+    return SendOrQueue( *pDataServer, msg, stHandler, params );
+  }
+
+  //----------------------------------------------------------------------------
+  // Write data pages at a given offset - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::PgWrite( uint64_t                     offset,
+                                          uint32_t                     size,
+                                          const void                  *buffer,
+                                          const std::vector<uint32_t> &cksums,
+                                          ResponseHandler             *handler,
+                                          uint16_t                     timeout )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    if( pFileState != Opened && pFileState != Recovering )
+      return XRootDStatus( stError, errInvalidOp );
+
+    //--------------------------------------------------------------------------
+    // Count the pages, the first one ends at a page boundary
+    //--------------------------------------------------------------------------
+    uint32_t fpLen   = kXR_pgPageSZ - offset % kXR_pgPageSZ;
+    uint32_t nbPages = 0;
+    if( size )
+      nbPages = size <= fpLen ? 1 :
+                1 + ( size - fpLen + kXR_pgPageSZ - 1 ) / kXR_pgPageSZ;
+
+    if( !cksums.empty() && cksums.size() != nbPages )
+      return XRootDStatus( stError, errInvalidArgs );
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileMsg, "[0x%x@%s] Sending a pgwrite command for handle 0x%x "
+                "to %s", this, pFileUrl->GetURL().c_str(),
+                *((uint32_t*)pFileHandle), pDataServer->GetHostId().c_str() );
+
+    //--------------------------------------------------------------------------
+    // Build the message, each page is followed by its checksum
+    //--------------------------------------------------------------------------
+    Message              *msg;
+    ClientPgWriteRequest *req;
+    uint32_t              dlen = size + nbPages * sizeof( uint32_t );
+    MessageUtils::CreateRequest( msg, req, dlen );
+
+    req->requestid  = kXR_pgwrite;
+    req->offset     = offset;
+    req->dlen       = dlen;
+    memcpy( req->fhandle, pFileHandle, 4 );
+
+    const char *src    = (const char*)buffer;
+    char       *cursor = msg->GetBuffer( sizeof(ClientPgWriteRequest) );
+    uint32_t    pgLen  = fpLen;
+    for( uint32_t i = 0; i < nbPages; ++i )
+    {
+      if( pgLen > size ) pgLen = size;
+      uint32_t crc = cksums.empty() ? XrdOucCRC::Calc32C( src, pgLen )
+                                    : cksums[i];
+      crc = htonl( crc );
+      memcpy( cursor, src, pgLen );
+      memcpy( cursor + pgLen, &crc, sizeof( uint32_t ) );
+      cursor += pgLen + sizeof( uint32_t );
+      src    += pgLen;
+      size   -= pgLen;
+      pgLen   = kXR_pgPageSZ;
+    }
+
+    ChunkList *list   = new ChunkList();
+    list->push_back( ChunkInfo( offset, src - (const char*)buffer,
+                                (void*)buffer ) );
+
+    XRootDTransport::SetDescription( msg );
+    MessageSendParams params;
+    params.timeout         = timeout;
+    params.followRedirects = false;
+    params.stateful        = true;
+    params.chunkList       = list;
+    MessageUtils::ProcessSendParams( params );
+
+    StatefulHandler *stHandler = new StatefulHandler( this, handler, msg, params );
+    return SendOrQueue( *pDataServer, msg, stHandler, params );
+  }
+
   //----------------------------------------------------------------------------
   // Performs a custom operation on an open file, server implementation
   // dependent - async
@@ -1213,7 +1446,10 @@ namespace XrdCl
       {
         case kXR_read:  i.opCode = Monitor::ErrorInfo::ErrRead;  break;
         case kXR_readv: i.opCode = Monitor::ErrorInfo::ErrReadV; break;
-        case kXR_write: i.opCode = Monitor::ErrorInfo::ErrWrite; break;
+        case kXR_write:  i.opCode = Monitor::ErrorInfo::ErrWrite; break;
+        case kXR_writev: i.opCode = Monitor::ErrorInfo::ErrWrite; break;
+        case kXR_pgread:  i.opCode = Monitor::ErrorInfo::ErrRead;  break;
+        case kXR_pgwrite: i.opCode = Monitor::ErrorInfo::ErrWrite; break;
         default: i.opCode = Monitor::ErrorInfo::ErrUnc;
       }
 
@@ -1346,6 +1582,40 @@ namespace XrdCl
         pWBytes += req->write.dlen;
         break;
       }
+
+      //------------------------------------------------------------------------
+      // Handle writev response
+      //------------------------------------------------------------------------
+      case kXR_writev:
+      {
+        ++pWCount;
+        size_t segs = req->header.dlen/sizeof(write_list);
+        write_list *dataChunk = (write_list*)message->GetBuffer( 24 );
+        for( size_t i = 0; i < segs; ++i )
+          pWBytes += dataChunk[i].wlen;
+        break;
+      }
+
+      //------------------------------------------------------------------------
+      // Handle pgread and pgwrite responses
+      //------------------------------------------------------------------------
+      case kXR_pgread:
+      {
+        PageInfo *info = 0;
+        response->Get( info );
+        ++pRCount;
+        pRBytes += info->GetLength();
+        break;
+      }
+
+      case kXR_pgwrite:
+      {
+        PageInfo *info = 0;
+        response->Get( info );
+        ++pWCount;
+        pWBytes += info->GetLength();
+        break;
+      }
     };
   }
 
@@ -1745,6 +2015,26 @@ namespace XrdCl
           memcpy( dataChunk[i].fhandle, pFileHandle, 4 );
         break;
       }
+      case kXR_pgread:
+      {
+        ClientPgReadRequest *req = (ClientPgReadRequest*)msg->GetBuffer();
+        memcpy( req->fhandle, pFileHandle, 4 );
+        break;
+      }
+      case kXR_pgwrite:
+      {
+        ClientPgWriteRequest *req = (ClientPgWriteRequest*)msg->GetBuffer();
+        memcpy( req->fhandle, pFileHandle, 4 );
+        break;
+      }
+      case kXR_writev:
+      {
+        ClientWriteVRequest *req = (ClientWriteVRequest*)msg->GetBuffer();
+        write_list *dataChunk = (write_list*)msg->GetBuffer( 24 );
+        for( size_t i = 0; i < req->dlen/sizeof(write_list); ++i )
+          memcpy( dataChunk[i].fhandle, pFileHandle, 4 );
+        break;
+      }
     }
 
     Log *log = DefaultEnv::GetLog();
@@ -1774,6 +2064,14 @@ namespace XrdCl
       i.vCount = pVCount;
       i.wCount = pWCount;
       i.status = status;
+      if( pReadCache )
+      {
+        ReadCache::Stats rc = pReadCache->GetStats();
+        i.rcHits   = rc.hits;
+        i.rcMisses = rc.misses;
+        i.rcBytes  = rc.bytes;
+        i.raBytes  = rc.raBytes;
+      }
       mon->Event( Monitor::EvClose, &i );
     }
   }
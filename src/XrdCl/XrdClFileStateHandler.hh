@@ -37,6 +37,7 @@ namespace XrdCl
 {
   class ResponseHandlerHolder;
   class Message;
+  class ReadCache;
 
   //----------------------------------------------------------------------------
   //! Handle the stateful operations
@@ -141,6 +142,17 @@ namespace XrdCl
                          ResponseHandler *handler,
                          uint16_t         timeout = 0 );
 
+      //------------------------------------------------------------------------
+      //! Read a data chunk at a given offset bypassing the read cache - async
+      //!
+      //! @see Read
+      //------------------------------------------------------------------------
+      XRootDStatus ReadDirect( uint64_t         offset,
+                               uint32_t         size,
+                               void            *buffer,
+                               ResponseHandler *handler,
+                               uint16_t         timeout = 0 );
+
       //------------------------------------------------------------------------
       //! Write a data chunk at a given offset - async
       //!
@@ -198,6 +210,57 @@ namespace XrdCl
                                ResponseHandler *handler,
                                uint16_t         timeout = 0 );
 
+      //------------------------------------------------------------------------
+      //! Write scattered data chunks in one operation - async
+      //!
+      //! @param chunks    list of the chunks to be written
+      //! @param handler   handler to be notified when the response arrives
+      //! @param timeout   timeout value, if 0 then the environment default
+      //!                  will be used
+      //! @return          status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus VectorWrite( const ChunkList &chunks,
+                                ResponseHandler *handler,
+                                uint16_t         timeout = 0 );
+
+      //------------------------------------------------------------------------
+      //! Read data pages at a given offset - async
+      //!
+      //! @param offset  offset from the beginning of the file
+      //! @param size    number of bytes to be read
+      //! @param buffer  a pointer to a buffer big enough to hold the data
+      //! @param handler handler to be notified when the response arrives,
+      //!                the response parameter will hold a PageInfo object
+      //! @param timeout timeout value, if 0 the environment default will
+      //!                be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus PgRead( uint64_t         offset,
+                           uint32_t         size,
+                           void            *buffer,
+                           ResponseHandler *handler,
+                           uint16_t         timeout = 0 );
+
+      //------------------------------------------------------------------------
+      //! Write data pages at a given offset - async
+      //!
+      //! @param offset  offset from the beginning of the file
+      //! @param size    number of bytes to be written
+      //! @param buffer  a pointer to the buffer holding the data to be written
+      //! @param cksums  CRC32C of each page, computed if empty
+      //! @param handler handler to be notified when the response arrives,
+      //!                the response parameter will hold a PageInfo object
+      //! @param timeout timeout value, if 0 the environment default will
+      //!                be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus PgWrite( uint64_t                     offset,
+                            uint32_t                     size,
+                            const void                  *buffer,
+                            const std::vector<uint32_t> &cksums,
+                            ResponseHandler             *handler,
+                            uint16_t                     timeout = 0 );
+
       //------------------------------------------------------------------------
       //! Performs a custom operation on an open file, server implementation
       //! dependent - async
@@ -445,6 +508,11 @@ namespace XrdCl
       uint64_t                 pWCount;
       XRootDStatus             pCloseReason;
 
+      //------------------------------------------------------------------------
+      // Block cache for small reads, 0 unless enabled in the environment
+      //------------------------------------------------------------------------
+      ReadCache               *pReadCache;
+
       //------------------------------------------------------------------------
       // Holds the OpenHanlder used to issue reopen
       // (there is only only OpenHandler reopening a file at a time)
@@ -22,9 +22,29 @@
 #include "XrdCl/XrdClMessage.hh"
 
 #include <arpa/inet.h>              // for network unmarshalling stuff
+#include <string.h>
+#include <limits>
 
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  InQueue::InQueue():
+    pNextExpiry( std::numeric_limits<time_t>::max() )
+  {
+    memset( pPages, 0, sizeof( pPages ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  InQueue::~InQueue()
+  {
+    for( uint32_t i = 0; i < NumPages; ++i )
+      delete pPages[i];
+  }
+
   //----------------------------------------------------------------------------
   // Filter messages
   //----------------------------------------------------------------------------
@@ -59,6 +79,44 @@ namespace XrdCl
     return false;
   }
 
+  //----------------------------------------------------------------------------
+  // Get the slot of a SID, adding its page if needed
+  //----------------------------------------------------------------------------
+  InQueue::Slot *InQueue::GetSlot( uint16_t sid )
+  {
+    Page *&page = pPages[sid / PageSize];
+    if( !page )
+      page = new Page();
+    return &page->slot[sid % PageSize];
+  }
+
+  //----------------------------------------------------------------------------
+  // Set the handler of a SID
+  //----------------------------------------------------------------------------
+  void InQueue::SetHandler( uint16_t            sid,
+                            IncomingMsgHandler *handler,
+                            time_t              expires )
+  {
+    Slot *slot = GetSlot( sid );
+    if( !slot->handler )
+      ++pPages[sid / PageSize]->nHandlers;
+    slot->handler = handler;
+    slot->expires = expires;
+    if( expires < pNextExpiry )
+      pNextExpiry = expires;
+  }
+
+  //----------------------------------------------------------------------------
+  // Clear the handler of a SID
+  //----------------------------------------------------------------------------
+  void InQueue::ClearHandler( uint16_t sid )
+  {
+    Slot *slot = GetSlot( sid );
+    if( slot->handler )
+      --pPages[sid / PageSize]->nHandlers;
+    slot->handler = 0;
+  }
+
   //----------------------------------------------------------------------------
   // Add a message to the queue
   //----------------------------------------------------------------------------
@@ -73,21 +131,21 @@ namespace XrdCl
       return true;
     }
 
-    // Lookup the sid in the map of handlers
+    // Lookup the sid in the table of handlers
     pMutex.Lock();
-    HandlerMap::iterator it = pHandlers.find(msgSid);
+    Slot *slot = GetSlot( msgSid );
 
-    if (it != pHandlers.end())
+    if( slot->handler )
     {
-      handler = it->second.first;
+      handler = slot->handler;
       action  = handler->Examine( msg );
 
       if( action & IncomingMsgHandler::RemoveHandler )
-	pHandlers.erase( it );
+        ClearHandler( msgSid );
     }
 
     if( !(action & IncomingMsgHandler::Take) )
-      pMessages[msgSid] = msg;
+      slot->message = msg;
 
     pMutex.UnLock();
 
@@ -105,23 +163,23 @@ namespace XrdCl
     uint16_t action = 0;
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    MessageMap::iterator it = pMessages.find(handlerSid);
+    Slot *slot = GetSlot( handlerSid );
 
-    if (it != pMessages.end())
+    if( slot->message )
     {
-      action = handler->Examine( it->second );
+      action = handler->Examine( slot->message );
 
       if( action & IncomingMsgHandler::Take )
       {
-	if( !(action & IncomingMsgHandler::NoProcess ) )
-	  handler->Process( it->second );
+        if( !(action & IncomingMsgHandler::NoProcess ) )
+          handler->Process( slot->message );
 
-	pMessages.erase( it );
+        slot->message = 0;
       }
     }
 
     if( !(action & IncomingMsgHandler::RemoveHandler) )
-      pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+      SetHandler( handlerSid, handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -129,11 +187,9 @@ namespace XrdCl
   // is stored in msg
   //----------------------------------------------------------------------------
   IncomingMsgHandler *InQueue::GetHandlerForMessage( Message  *msg,
-						     time_t   &expires,
-						     uint16_t &action )
+                                                     time_t   &expires,
+                                                     uint16_t &action )
   {
-    time_t   exp = 0;
-    uint16_t act = 0;
     uint16_t msgSid = 0;
     IncomingMsgHandler* handler = 0;
 
@@ -143,22 +199,16 @@ namespace XrdCl
     }
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.find(msgSid);
+    Slot *slot = GetSlot( msgSid );
 
-    if (it != pHandlers.end())
+    if( slot->handler )
     {
-      handler = it->second.first;
-      act     = handler->Examine( msg );
-      exp     = it->second.second;
-
-      if( act & IncomingMsgHandler::Take )
-	pHandlers.erase( it );
-    }
+      handler = slot->handler;
+      action  = handler->Examine( msg );
+      expires = slot->expires;
 
-    if( handler )
-    {
-      expires = exp;
-      action  = act;
+      if( action & IncomingMsgHandler::Take )
+        ClearHandler( msgSid );
     }
 
     return handler;
@@ -168,11 +218,11 @@ namespace XrdCl
   // Re-insert the handler without scanning the cached messages
   //----------------------------------------------------------------------------
   void InQueue::ReAddMessageHandler( IncomingMsgHandler *handler,
-				     time_t              expires )
+                                     time_t              expires )
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+    SetHandler( handlerSid, handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -182,26 +232,34 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers.erase(handlerSid);
+    ClearHandler( handlerSid );
   }
 
   //----------------------------------------------------------------------------
   // Report an event to the handlers
   //----------------------------------------------------------------------------
   void InQueue::ReportStreamEvent( IncomingMsgHandler::StreamEvent event,
-				   uint16_t                        streamNum,
-				   Status                          status )
+                                   uint16_t                        streamNum,
+                                   Status                          status )
   {
     uint8_t action = 0;
     XrdSysMutexHelper scopedLock( pMutex );
-    for( HandlerMap::iterator it = pHandlers.begin(); it != pHandlers.end(); )
+    for( uint32_t i = 0; i < NumPages; ++i )
     {
-      action = it->second.first->OnStreamEvent( event, streamNum, status );
+      if( !pPages[i] || !pPages[i]->nHandlers )
+        continue;
 
-      if( action & IncomingMsgHandler::RemoveHandler )
-	pHandlers.erase( it++ );
-      else
-	++it;
+      for( uint32_t j = 0; j < PageSize; ++j )
+      {
+        Slot *slot = &pPages[i]->slot[j];
+        if( !slot->handler )
+          continue;
+
+        action = slot->handler->OnStreamEvent( event, streamNum, status );
+
+        if( action & IncomingMsgHandler::RemoveHandler )
+          ClearHandler( i * PageSize + j );
+      }
     }
   }
 
@@ -214,17 +272,35 @@ namespace XrdCl
       now = ::time(0);
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.begin();
-    while( it != pHandlers.end() )
+    if( now < pNextExpiry )
+      return;
+
+    //--------------------------------------------------------------------------
+    // Expire everything that is due in one pass and remember when the next
+    // handler is due
+    //--------------------------------------------------------------------------
+    time_t next = std::numeric_limits<time_t>::max();
+    for( uint32_t i = 0; i < NumPages; ++i )
     {
-      if( it->second.second <= now )
+      if( !pPages[i] || !pPages[i]->nHandlers )
+        continue;
+
+      for( uint32_t j = 0; j < PageSize; ++j )
       {
-	it->second.first->OnStreamEvent( IncomingMsgHandler::Timeout, 0,
-				  Status( stError, errOperationExpired ) );
-	pHandlers.erase( it++ );
+        Slot *slot = &pPages[i]->slot[j];
+        if( !slot->handler )
+          continue;
+
+        if( slot->expires <= now )
+        {
+          slot->handler->OnStreamEvent( IncomingMsgHandler::Timeout, 0,
+                                        Status( stError, errOperationExpired ) );
+          ClearHandler( i * PageSize + j );
+        }
+        else if( slot->expires < next )
+          next = slot->expires;
       }
-      else
-	++it;
     }
+    pNextExpiry = next;
   }
 }
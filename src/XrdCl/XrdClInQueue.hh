@@ -20,8 +20,7 @@
 #define __XRD_CL_IN_QUEUE_HH__
 
 #include <XrdSys/XrdSysPthread.hh>
-#include <map>
-#include <utility>
+#include <time.h>
 #include "XrdCl/XrdClStatus.hh"
 #include "XrdCl/XrdClPostMasterInterfaces.hh"
 
@@ -31,10 +30,26 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! A synchronize queue for incoming data
+  //!
+  //! The handlers and the messages nobody has claimed yet are kept in a
+  //! table indexed by the SID, split into pages that are allocated when a
+  //! SID in their range is first used, so matching a message to its handler
+  //! does not search or allocate. The handlers are only scanned for
+  //! expiration once the earliest of them may have expired.
   //----------------------------------------------------------------------------
   class InQueue
   {
     public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      InQueue();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~InQueue();
+
       //------------------------------------------------------------------------
       //! Add a fully reconstructed message to the queue
       //------------------------------------------------------------------------
@@ -98,12 +113,36 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool DiscardMessage(Message* msg, uint16_t& sid) const;
 
-      typedef std::pair<IncomingMsgHandler *, time_t> HandlerAndExpire;
-      typedef std::map<uint16_t, HandlerAndExpire> HandlerMap;
-      typedef std::map<uint16_t, Message*> MessageMap;
-      MessageMap pMessages;
-      HandlerMap pHandlers;
-      XrdSysMutex pMutex;
+      InQueue( const InQueue &other );
+      InQueue &operator = ( const InQueue &other );
+
+      static const uint32_t PageSize = 256;
+      static const uint32_t NumPages = 65536 / PageSize;
+
+      //------------------------------------------------------------------------
+      //! The handler waiting for a SID and the message waiting for a handler
+      //------------------------------------------------------------------------
+      struct Slot
+      {
+        IncomingMsgHandler *handler;
+        time_t              expires;
+        Message            *message;
+      };
+
+      struct Page
+      {
+        Slot     slot[PageSize];
+        uint32_t nHandlers;
+      };
+
+      Slot *GetSlot( uint16_t sid );
+      void  SetHandler( uint16_t sid, IncomingMsgHandler *handler,
+                        time_t expires );
+      void  ClearHandler( uint16_t sid );
+
+      Page        *pPages[NumPages];
+      time_t       pNextExpiry;  //!< no handler expires before that
+      XrdSysMutex  pMutex;
   };
 }
 
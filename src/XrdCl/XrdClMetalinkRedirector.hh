@@ -83,6 +83,14 @@ class MetalinkRedirector : public VirtualRedirector
       return pFileSize;
     }
 
+    //----------------------------------------------------------------------------
+    //! Returns the URLs of all the replicas in the order of preference
+    //----------------------------------------------------------------------------
+    std::vector<std::string> GetReplicas() const
+    {
+      return std::vector<std::string>( pReplicas.begin(), pReplicas.end() );
+    }
+
   private:
 
     //----------------------------------------------------------------------------
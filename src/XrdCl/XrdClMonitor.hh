@@ -113,7 +113,8 @@ namespace XrdCl
       {
         CloseInfo():
           file(0), rBytes(0), vBytes(0), wBytes(0), vSegs(0), rCount(0),
-          vCount(0), wCount(0), status(0)
+          vCount(0), wCount(0), status(0), rcBytes(0), raBytes(0), rcHits(0),
+          rcMisses(0)
         {
           oTOD.tv_sec = 0; oTOD.tv_usec = 0;
           cTOD.tv_sec = 0; cTOD.tv_usec = 0;
@@ -129,6 +130,10 @@ namespace XrdCl
         uint32_t            vCount;  //!< Total count  of readv
         uint32_t            wCount;  //!< Total count  of writes
         const XRootDStatus *status;  //!< Close status
+        uint64_t            rcBytes; //!< Bytes returned via the read cache
+        uint64_t            raBytes; //!< Bytes requested by readahead
+        uint32_t            rcHits;  //!< Cached reads served from memory
+        uint32_t            rcMisses;//!< Cached reads that fetched a block
       };
 
       //------------------------------------------------------------------------
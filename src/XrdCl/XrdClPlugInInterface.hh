@@ -134,6 +134,45 @@ namespace XrdCl
         return XRootDStatus( stError, errNotImplemented );
       }
 
+      //------------------------------------------------------------------------
+      //! @see XrdCl::File::VectorWrite
+      //------------------------------------------------------------------------
+      virtual XRootDStatus VectorWrite( const ChunkList &chunks,
+                                        ResponseHandler *handler,
+                                        uint16_t         timeout )
+      {
+        (void)chunks; (void)handler; (void)timeout;
+        return XRootDStatus( stError, errNotImplemented );
+      }
+
+      //------------------------------------------------------------------------
+      //! @see XrdCl::File::PgRead
+      //------------------------------------------------------------------------
+      virtual XRootDStatus PgRead( uint64_t         offset,
+                                   uint32_t         size,
+                                   void            *buffer,
+                                   ResponseHandler *handler,
+                                   uint16_t         timeout )
+      {
+        (void)offset; (void)size; (void)buffer; (void)handler; (void)timeout;
+        return XRootDStatus( stError, errNotImplemented );
+      }
+
+      //------------------------------------------------------------------------
+      //! @see XrdCl::File::PgWrite
+      //------------------------------------------------------------------------
+      virtual XRootDStatus PgWrite( uint64_t                     offset,
+                                    uint32_t                     size,
+                                    const void                  *buffer,
+                                    const std::vector<uint32_t> &cksums,
+                                    ResponseHandler             *handler,
+                                    uint16_t                     timeout )
+      {
+        (void)offset; (void)size; (void)buffer; (void)cksums; (void)handler;
+        (void)timeout;
+        return XRootDStatus( stError, errNotImplemented );
+      }
+
       //------------------------------------------------------------------------
       //! @see XrdCl::File::Fcntl
       //------------------------------------------------------------------------
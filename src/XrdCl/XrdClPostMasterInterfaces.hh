@@ -445,6 +445,21 @@ namespace XrdCl
                                 uint16_t   subStream,
                                 uint32_t   bytesSent,
                                 AnyObject &channelData ) = 0;
+
+      //------------------------------------------------------------------------
+      //! Initialize channel for the URL it is first created for. Channels
+      //! are shared by all the URLs pointing to the same host, so the
+      //! settings taken from the URL apply to all of them.
+      //!
+      //! @param url         the URL the channel is created for
+      //! @param channelData the channel specific data
+      //------------------------------------------------------------------------
+      virtual void InitializeChannel( const URL &url,
+                                      AnyObject &channelData )
+      {
+        (void)url;
+        InitializeChannel( channelData );
+      }
   };
 }
 
@@ -0,0 +1,516 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2014 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClReadCache.hh"
+#include "XrdCl/XrdClFileStateHandler.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClPostMaster.hh"
+#include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClResponseJob.hh"
+#include "XrdCl/XrdClLog.hh"
+#include <string.h>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Issue a deferred close
+  //----------------------------------------------------------------------------
+  class CloseJob: public XrdCl::Job
+  {
+    public:
+      CloseJob( XrdCl::FileStateHandler *stateHandler,
+                XrdCl::ResponseHandler  *handler,
+                uint16_t                 timeout ):
+        pStateHandler( stateHandler ), pHandler( handler ), pTimeout( timeout )
+      {
+      }
+
+      virtual void Run( void * )
+      {
+        using namespace XrdCl;
+        XRootDStatus st = pStateHandler->Close( pHandler, pTimeout );
+        if( !st.IsOK() && pHandler )
+          pHandler->HandleResponse( new XRootDStatus( st ), 0 );
+        delete this;
+      }
+
+    private:
+      XrdCl::FileStateHandler *pStateHandler;
+      XrdCl::ResponseHandler  *pHandler;
+      uint16_t                 pTimeout;
+  };
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Receives a block from the server
+  //----------------------------------------------------------------------------
+  class ReadCacheHandler: public ResponseHandler
+  {
+    public:
+      ReadCacheHandler( ReadCache *cache, ReadCache::Block *block ):
+        pCache( cache ), pBlock( block )
+      {
+      }
+
+      virtual void HandleResponse( XRootDStatus *status, AnyObject *response )
+      {
+        pCache->OnBlock( pBlock, status, response );
+        delete this;
+      }
+
+    private:
+      ReadCache        *pCache;
+      ReadCache::Block *pBlock;
+  };
+
+  //----------------------------------------------------------------------------
+  // Create a cache if the environment enables it
+  //----------------------------------------------------------------------------
+  ReadCache *ReadCache::Create( FileStateHandler *stateHandler )
+  {
+    Env *env = DefaultEnv::GetEnv();
+    int cacheSize = DefaultReadCacheSize;
+    int blockSize = DefaultReadCacheBlockSize;
+    int maxWindow = DefaultReadAheadWindow;
+    env->GetInt( "ReadCacheSize",      cacheSize );
+    env->GetInt( "ReadCacheBlockSize", blockSize );
+    env->GetInt( "ReadAheadWindow",    maxWindow );
+
+    if( cacheSize <= 0 )
+      return 0;
+    if( blockSize < 4096 )
+      blockSize = 4096;
+    if( maxWindow < 0 )
+      maxWindow = 0;
+    return new ReadCache( stateHandler, cacheSize, blockSize, maxWindow );
+  }
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ReadCache::ReadCache( FileStateHandler *stateHandler,
+                        uint32_t          cacheSize,
+                        uint32_t          blockSize,
+                        uint32_t          maxWindow ):
+    pStateHandler( stateHandler ),
+    pBlockSize( blockSize ),
+    pMaxBlocks( cacheSize / blockSize ),
+    pMaxWindow( maxWindow ),
+    pInFlight( 0 ),
+    pNextOffset( 0 ),
+    pWindow( 0 ),
+    pEOF( (uint64_t)-1 ),
+    pClosing( false ),
+    pCloseHandler( 0 ),
+    pCloseTimeout( 0 )
+  {
+    //--------------------------------------------------------------------------
+    // Keep room for the blocks of one read besides a full readahead window
+    //--------------------------------------------------------------------------
+    if( pMaxBlocks < 2 )
+      pMaxBlocks = 2;
+    if( pMaxWindow > (pMaxBlocks - 2) * pBlockSize )
+      pMaxWindow = (pMaxBlocks - 2) * pBlockSize;
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  ReadCache::~ReadCache()
+  {
+    Clear();
+  }
+
+  //----------------------------------------------------------------------------
+  // Read a data chunk through the cache
+  //----------------------------------------------------------------------------
+  XRootDStatus ReadCache::Read( uint64_t         offset,
+                                uint32_t         size,
+                                void            *buffer,
+                                ResponseHandler *handler,
+                                uint16_t         timeout,
+                                uint64_t         fileSize )
+  {
+    BlockVec  fetch;
+    Request  *req = new Request();
+    bool      done;
+    bool      bypass = false;
+
+    req->offset  = offset;
+    req->size    = size;
+    req->buffer  = (char*)buffer;
+    req->handler = handler;
+    req->end     = offset + size;
+    req->pending = 0;
+
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      if( pClosing )
+      {
+        delete req;
+        return XRootDStatus( stError, errInvalidOp );
+      }
+
+      //------------------------------------------------------------------------
+      // Sequential reads open the readahead window, random ones close it
+      //------------------------------------------------------------------------
+      bool sequential = offset == pNextOffset;
+      if( sequential && pMaxWindow )
+      {
+        pWindow = pWindow ? pWindow * 2 : pBlockSize;
+        if( pWindow > pMaxWindow )
+          pWindow = pMaxWindow;
+      }
+      else
+        pWindow = 0;
+      pNextOffset = offset + size;
+
+      //------------------------------------------------------------------------
+      // A random read that misses is not worth a block, it goes straight
+      // to the server
+      //------------------------------------------------------------------------
+      uint64_t first = offset / pBlockSize;
+      uint64_t last  = (offset + size - 1) / pBlockSize;
+
+      if( !sequential )
+      {
+        for( uint64_t i = first; i <= last && !bypass; ++i )
+          bypass = pBlocks.find( i ) == pBlocks.end();
+      }
+
+      if( bypass )
+        ++pStats.misses;
+      else
+      {
+        //----------------------------------------------------------------------
+        // Collect the blocks of the request, copying the ones we have
+        //----------------------------------------------------------------------
+        for( uint64_t i = first; i <= last; ++i )
+        {
+          BlockMap::iterator it = pBlocks.find( i );
+          Block *block = it != pBlocks.end() ? it->second
+                                             : NewBlock( i, fetch );
+          if( block->ready )
+          {
+            Copy( req, block );
+            pLRU.splice( pLRU.begin(), pLRU, block->lru );
+          }
+          else
+          {
+            block->waiters.push_back( req );
+            ++req->pending;
+          }
+        }
+
+        if( fetch.empty() )
+          ++pStats.hits;
+        else
+          ++pStats.misses;
+      }
+
+      uint64_t limit = pEOF;
+      if( fileSize && fileSize < limit )
+        limit = fileSize;
+
+      if( pWindow && limit > pNextOffset )
+      {
+        if( pNextOffset + pWindow < limit )
+          limit = pNextOffset + pWindow;
+        uint64_t raLast = (limit - 1) / pBlockSize;
+        for( uint64_t i = last + 1; i <= raLast; ++i )
+        {
+          if( pBlocks.find( i ) != pBlocks.end() )
+            continue;
+          if( pInFlight >= pMaxBlocks )
+            break;
+          NewBlock( i, fetch );
+          pStats.raBytes += pBlockSize;
+        }
+      }
+
+      done = req->pending == 0;
+    }
+
+    if( bypass )
+    {
+      delete req;
+      return pStateHandler->ReadDirect( offset, size, buffer, handler,
+                                        timeout );
+    }
+
+    //--------------------------------------------------------------------------
+    // The request may complete in another thread as soon as the blocks are
+    // asked for, so we don't touch it afterwards unless it is done already
+    //--------------------------------------------------------------------------
+    Fetch( fetch, timeout );
+    if( done )
+      Complete( req );
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Defer closing the file until the blocks in flight have arrived
+  //----------------------------------------------------------------------------
+  bool ReadCache::DeferClose( ResponseHandler *handler, uint16_t timeout )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    if( pClosing )
+      return false;
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileMsg, "[0x%x] Read cache: %llu hits, %llu misses, %llu "
+                "bytes read, %llu bytes read ahead", pStateHandler,
+                (unsigned long long)pStats.hits,
+                (unsigned long long)pStats.misses,
+                (unsigned long long)pStats.bytes,
+                (unsigned long long)pStats.raBytes );
+
+    Clear();
+    if( !pInFlight )
+      return false;
+
+    pClosing      = true;
+    pCloseHandler = handler;
+    pCloseTimeout = timeout;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop all blocks and statistics
+  //----------------------------------------------------------------------------
+  void ReadCache::Reset()
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    Clear();
+    pNextOffset = 0;
+    pWindow     = 0;
+    pEOF        = (uint64_t)-1;
+    pClosing    = false;
+    pStats      = Stats();
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the statistics
+  //----------------------------------------------------------------------------
+  ReadCache::Stats ReadCache::GetStats() const
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    return pStats;
+  }
+
+  //----------------------------------------------------------------------------
+  // Handle a block arriving from the server
+  //----------------------------------------------------------------------------
+  void ReadCache::OnBlock( Block        *block,
+                           XRootDStatus *status,
+                           AnyObject    *response )
+  {
+    RequestVec       done;
+    ResponseHandler *closeHandler = 0;
+    uint16_t         closeTimeout = 0;
+    bool             closeNow;
+    bool             ok = status->IsOK();
+
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      --pInFlight;
+
+      if( ok )
+      {
+        ChunkInfo *chunk = 0;
+        response->Get( chunk );
+        block->length = chunk ? chunk->length : 0;
+        block->ready  = true;
+        if( block->length < pBlockSize )
+        {
+          uint64_t eof = block->index * pBlockSize + block->length;
+          if( eof < pEOF )
+            pEOF = eof;
+        }
+      }
+
+      for( size_t i = 0; i < block->waiters.size(); ++i )
+      {
+        Request *req = block->waiters[i];
+        if( ok )
+          Copy( req, block );
+        else if( req->status.IsOK() )
+          req->status = *status;
+        if( --req->pending == 0 )
+          done.push_back( req );
+      }
+      block->waiters.clear();
+
+      //------------------------------------------------------------------------
+      // Keep the block unless it failed or the cache was dropped meanwhile,
+      // in which case it is no longer in the map
+      //------------------------------------------------------------------------
+      BlockMap::iterator it = pBlocks.find( block->index );
+      bool keep = ok && it != pBlocks.end() && it->second == block;
+      if( keep )
+      {
+        block->lru = pLRU.insert( pLRU.begin(), block );
+        while( pLRU.size() > pMaxBlocks )
+        {
+          Block *victim = pLRU.back();
+          pLRU.pop_back();
+          pBlocks.erase( victim->index );
+          delete [] victim->data;
+          delete victim;
+        }
+      }
+      else
+      {
+        if( it != pBlocks.end() && it->second == block )
+          pBlocks.erase( it );
+        delete [] block->data;
+        delete block;
+      }
+
+      closeNow = pClosing && !pInFlight;
+      if( closeNow )
+      {
+        closeHandler = pCloseHandler;
+        closeTimeout = pCloseTimeout;
+        pCloseHandler = 0;
+      }
+    }
+
+    delete status;
+    delete response;
+
+    //--------------------------------------------------------------------------
+    // Errors are delivered with the state handler locked, so the user
+    // handlers and the deferred close go through the job manager then
+    //--------------------------------------------------------------------------
+    JobManager *jobMan = DefaultEnv::GetPostMaster()->GetJobManager();
+    for( size_t i = 0; i < done.size(); ++i )
+    {
+      if( ok )
+        Complete( done[i] );
+      else
+      {
+        jobMan->QueueJob( new ResponseJob( done[i]->handler,
+                                           new XRootDStatus( done[i]->status ),
+                                           0, 0 ) );
+        delete done[i];
+      }
+    }
+
+    if( closeNow )
+      jobMan->QueueJob( new CloseJob( pStateHandler, closeHandler,
+                                      closeTimeout ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Create a block in flight, the caller fetches it after unlocking
+  //----------------------------------------------------------------------------
+  ReadCache::Block *ReadCache::NewBlock( uint64_t index, BlockVec &fetch )
+  {
+    Block *block  = new Block();
+    block->index  = index;
+    block->data   = new char[pBlockSize];
+    block->length = 0;
+    block->ready  = false;
+    pBlocks[index] = block;
+    fetch.push_back( block );
+    ++pInFlight;
+    return block;
+  }
+
+  //----------------------------------------------------------------------------
+  // Ask the server for the blocks
+  //----------------------------------------------------------------------------
+  void ReadCache::Fetch( BlockVec &fetch, uint16_t timeout )
+  {
+    for( size_t i = 0; i < fetch.size(); ++i )
+    {
+      Block            *block   = fetch[i];
+      ReadCacheHandler *handler = new ReadCacheHandler( this, block );
+      XRootDStatus st = pStateHandler->ReadDirect( block->index * pBlockSize,
+                                                   pBlockSize, block->data,
+                                                   handler, timeout );
+      if( !st.IsOK() )
+      {
+        delete handler;
+        OnBlock( block, new XRootDStatus( st ), 0 );
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Copy the part of the block that the request wants
+  //----------------------------------------------------------------------------
+  void ReadCache::Copy( Request *req, Block *block )
+  {
+    uint64_t start = block->index * pBlockSize;
+    uint64_t end   = start + block->length;
+    if( block->length < pBlockSize && end < req->end )
+      req->end = end;
+
+    uint64_t reqEnd = req->offset + req->size;
+    uint64_t from   = start > req->offset ? start : req->offset;
+    uint64_t to     = end < reqEnd ? end : reqEnd;
+    if( to > from )
+      memcpy( req->buffer + (from - req->offset), block->data + (from - start),
+              to - from );
+  }
+
+  //----------------------------------------------------------------------------
+  // Hand the data to the user
+  //----------------------------------------------------------------------------
+  void ReadCache::Complete( Request *req )
+  {
+    uint32_t length = req->end > req->offset ? req->end - req->offset : 0;
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      pStats.bytes += length;
+    }
+
+    AnyObject *obj = new AnyObject();
+    obj->Set( new ChunkInfo( req->offset, length, req->buffer ) );
+    req->handler->HandleResponse( new XRootDStatus(), obj );
+    delete req;
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop the ready blocks, the ones in flight are freed when they arrive
+  //----------------------------------------------------------------------------
+  void ReadCache::Clear()
+  {
+    BlockMap::iterator it = pBlocks.begin();
+    while( it != pBlocks.end() )
+    {
+      if( it->second->ready )
+      {
+        delete [] it->second->data;
+        delete it->second;
+      }
+      pBlocks.erase( it++ );
+    }
+    pLRU.clear();
+  }
+}
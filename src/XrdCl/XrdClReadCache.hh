@@ -0,0 +1,196 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2014 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_READ_CACHE_HH__
+#define __XRD_CL_READ_CACHE_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <vector>
+
+namespace XrdCl
+{
+  class FileStateHandler;
+
+  //----------------------------------------------------------------------------
+  //! Block cache with adaptive readahead for the small reads of a file
+  //!
+  //! Reads that fit in a block are served from a bounded LRU cache of
+  //! aligned blocks, missing blocks are fetched from the server as a whole.
+  //! While the file is read sequentially the readahead window doubles with
+  //! every read up to the configured maximum, a random read closes it again.
+  //! The cache is only used for files opened for reading, so there is
+  //! nothing to invalidate.
+  //!
+  //! Locking: the cache never calls the state handler or a user handler
+  //! while holding its own mutex, the state handler may call the cache
+  //! while holding its own.
+  //----------------------------------------------------------------------------
+  class ReadCache
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Create a cache for the given file if the environment enables it
+      //!
+      //! @return the cache or 0 if ReadCacheSize is not positive
+      //------------------------------------------------------------------------
+      static ReadCache *Create( FileStateHandler *stateHandler );
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param stateHandler the file the blocks are read from
+      //! @param cacheSize    maximum number of bytes held in blocks
+      //! @param blockSize    size of a block
+      //! @param maxWindow    maximum readahead window in bytes
+      //------------------------------------------------------------------------
+      ReadCache( FileStateHandler *stateHandler,
+                 uint32_t          cacheSize,
+                 uint32_t          blockSize,
+                 uint32_t          maxWindow );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~ReadCache();
+
+      //------------------------------------------------------------------------
+      //! Check whether a read should go through the cache
+      //------------------------------------------------------------------------
+      bool Accepts( uint32_t size, void *buffer ) const
+      {
+        return buffer && size && size <= pBlockSize;
+      }
+
+      //------------------------------------------------------------------------
+      //! Read a data chunk through the cache - async
+      //!
+      //! The handler is called in this thread if all the data is cached.
+      //!
+      //! @param fileSize size of the file if known, 0 otherwise; readahead
+      //!                 does not go beyond it
+      //------------------------------------------------------------------------
+      XRootDStatus Read( uint64_t         offset,
+                         uint32_t         size,
+                         void            *buffer,
+                         ResponseHandler *handler,
+                         uint16_t         timeout,
+                         uint64_t         fileSize );
+
+      //------------------------------------------------------------------------
+      //! Defer closing the file until the blocks in flight have arrived
+      //!
+      //! @return true if the close has been deferred and will be issued
+      //!         when the last block arrives, false if the file may be
+      //!         closed now; the cached blocks are dropped in either case
+      //------------------------------------------------------------------------
+      bool DeferClose( ResponseHandler *handler, uint16_t timeout );
+
+      //------------------------------------------------------------------------
+      //! Drop all blocks and statistics, called when the file is (re)opened
+      //------------------------------------------------------------------------
+      void Reset();
+
+      //------------------------------------------------------------------------
+      //! Statistics
+      //------------------------------------------------------------------------
+      struct Stats
+      {
+        Stats(): hits( 0 ), misses( 0 ), bytes( 0 ), raBytes( 0 ) {}
+        uint64_t hits;     //!< reads that did not fetch a block themselves
+        uint64_t misses;   //!< reads that had to fetch a block
+        uint64_t bytes;    //!< bytes returned by the reads above
+        uint64_t raBytes;  //!< bytes requested by readahead
+      };
+
+      Stats GetStats() const;
+
+    private:
+      ReadCache(const ReadCache &other);
+      ReadCache &operator = (const ReadCache &other);
+
+      struct Request;
+      struct Block;
+      typedef std::map<uint64_t, Block*> BlockMap;
+      typedef std::list<Block*>          BlockList;
+      typedef std::vector<Block*>        BlockVec;
+      typedef std::vector<Request*>      RequestVec;
+
+      //------------------------------------------------------------------------
+      //! Read request of the user waiting for blocks
+      //------------------------------------------------------------------------
+      struct Request
+      {
+        uint64_t         offset;
+        uint32_t         size;
+        char            *buffer;
+        ResponseHandler *handler;
+        uint64_t         end;      //!< end of the data, lowered at eof
+        int              pending;  //!< blocks still to arrive
+        XRootDStatus     status;
+      };
+
+      //------------------------------------------------------------------------
+      //! Aligned block of the file, ready or in flight
+      //------------------------------------------------------------------------
+      struct Block
+      {
+        uint64_t            index;
+        char               *data;
+        uint32_t            length;  //!< valid bytes, short at eof
+        bool                ready;
+        RequestVec          waiters;
+        BlockList::iterator lru;
+      };
+
+      friend class ReadCacheHandler;
+      void OnBlock( Block *block, XRootDStatus *status, AnyObject *response );
+
+      Block *NewBlock( uint64_t index, BlockVec &fetch );
+      void   Fetch( BlockVec &fetch, uint16_t timeout );
+      void   Copy( Request *req, Block *block );
+      void   Complete( Request *req );
+      void   Clear();
+
+      FileStateHandler    *pStateHandler;
+      uint32_t             pBlockSize;
+      uint32_t             pMaxBlocks;
+      uint32_t             pMaxWindow;
+      mutable XrdSysMutex  pMutex;
+      BlockMap             pBlocks;
+      BlockList            pLRU;           //!< ready blocks, most recent first
+      uint32_t             pInFlight;
+      uint64_t             pNextOffset;
+      uint32_t             pWindow;
+      uint64_t             pEOF;
+      bool                 pClosing;
+      ResponseHandler     *pCloseHandler;
+      uint16_t             pCloseTimeout;
+      Stats                pStats;
+  };
+}
+
+#endif // __XRD_CL_READ_CACHE_HH__
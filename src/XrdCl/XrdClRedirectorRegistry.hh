@@ -14,6 +14,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace XrdCl
 {
@@ -60,6 +61,11 @@ class VirtualRedirector
     //! or a negative number if size was not specified
     //----------------------------------------------------------------------------
     virtual long long GetSize() const = 0;
+
+    //----------------------------------------------------------------------------
+    //! Returns the URLs of all the replicas in the order of preference
+    //----------------------------------------------------------------------------
+    virtual std::vector<std::string> GetReplicas() const = 0;
 };
 
 //--------------------------------------------------------------------------------
@@ -18,34 +18,55 @@
 
 #include "XrdCl/XrdClSIDManager.hh"
 
+#include <string.h>
+
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  SIDManager::SIDManager():
+    pFreeHead( 0 ),
+    pRetiredHead( 0 ),
+    pSIDCeiling( 1 ),
+    pAllocated( 0 ),
+    pTimedOut( 0 )
+  {
+    memset( pPages, 0, sizeof( pPages ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  SIDManager::~SIDManager()
+  {
+    for( uint32_t i = 0; i < NumPages; ++i )
+      delete pPages[i];
+  }
+
   //----------------------------------------------------------------------------
   // Allocate a SID
   //---------------------------------------------------------------------------
   Status SIDManager::AllocateSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-
-    uint16_t allocSID = 1;
-
     //--------------------------------------------------------------------------
-    // Get a SID from the list of free SIDs if it's not empty
+    // Get a SID from the stack of free SIDs, refill it with the retired ones
+    // if it's empty and allocate a new one if there are none
     //--------------------------------------------------------------------------
-    if( !pFreeSIDs.empty() )
+    uint16_t allocSID = Pop();
+    if( !allocSID )
+      allocSID = Recycle();
+    if( !allocSID )
     {
-      allocSID = pFreeSIDs.front();
-      pFreeSIDs.pop_front();
-    }
-    //--------------------------------------------------------------------------
-    // Allocate a new SID if possible
-    //--------------------------------------------------------------------------
-    else
-    {
-      if( pSIDCeiling == 0xffff )
+      allocSID = Grow();
+      if( !allocSID )
         return Status( stError, errNoMoreFreeSIDs );
-      allocSID = pSIDCeiling++;
     }
+    SetState( allocSID, Free, Allocated );
+
+    AtomicBeg( pMutex );
+    AtomicInc( pAllocated );
+    AtomicEnd( pMutex );
 
     memcpy( sid, &allocSID, 2 );
     return Status();
@@ -56,10 +77,15 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void SIDManager::ReleaseSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t relSID = 0;
     memcpy( &relSID, sid, 2 );
-    pFreeSIDs.push_back( relSID );
+    if( !SetState( relSID, Allocated, Free ) )
+      return;
+
+    AtomicBeg( pMutex );
+    AtomicDec( pAllocated );
+    AtomicEnd( pMutex );
+    Retire( relSID );
   }
 
   //----------------------------------------------------------------------------
@@ -67,10 +93,15 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void SIDManager::TimeOutSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.insert( tiSID );
+    if( !SetState( tiSID, Allocated, TimedOut ) )
+      return;
+
+    AtomicBeg( pMutex );
+    AtomicDec( pAllocated );
+    AtomicInc( pTimedOut );
+    AtomicEnd( pMutex );
   }
 
   //----------------------------------------------------------------------------
@@ -78,13 +109,16 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   bool SIDManager::IsTimedOut( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    std::set<uint16_t>::iterator it = pTimeOutSIDs.find( tiSID );
-    if( it != pTimeOutSIDs.end() )
-      return true;
-    return false;
+    Page *page = GetPage( tiSID );
+    if( !page )
+      return false;
+
+    AtomicBeg( pMutex );
+    bool timedOut = AtomicGet( page->state[tiSID % PageSize] ) == TimedOut;
+    AtomicEnd( pMutex );
+    return timedOut;
   }
 
   //----------------------------------------------------------------------------
@@ -92,11 +126,15 @@ namespace XrdCl
   //-----------------------------------------------------------------------------
   void SIDManager::ReleaseTimedOut( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.erase( tiSID );
-    pFreeSIDs.push_back( tiSID );
+    if( !SetState( tiSID, TimedOut, Free ) )
+      return;
+
+    AtomicBeg( pMutex );
+    AtomicDec( pTimedOut );
+    AtomicEnd( pMutex );
+    Retire( tiSID );
   }
 
   //------------------------------------------------------------------------
@@ -104,19 +142,213 @@ namespace XrdCl
   //------------------------------------------------------------------------
   void SIDManager::ReleaseAllTimedOut()
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    std::set<uint16_t>::iterator it;
-    for( it = pTimeOutSIDs.begin(); it != pTimeOutSIDs.end(); ++it )
-      pFreeSIDs.push_back( *it );
-    pTimeOutSIDs.clear();
+    pMutex.Lock();
+    uint32_t ceiling = pSIDCeiling;
+    pMutex.UnLock();
+
+    //--------------------------------------------------------------------------
+    // Scan the table once, a SID released by someone else in the meantime
+    // fails to change state and is skipped
+    //--------------------------------------------------------------------------
+    uint8_t sid[2];
+    for( uint32_t i = 1; i < ceiling; ++i )
+    {
+      if( GetPage( i )->state[i % PageSize] != TimedOut )
+        continue;
+      uint16_t tiSID = i;
+      memcpy( sid, &tiSID, 2 );
+      ReleaseTimedOut( sid );
+    }
   }
 
   //----------------------------------------------------------------------------
   // Get number of allocated SIDs
   //----------------------------------------------------------------------------
   uint16_t SIDManager::GetNumberOfAllocatedSIDs() const
+  {
+    AtomicRet( pMutex, pAllocated );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the page holding the SID, 0 if the SID has never been allocated
+  //----------------------------------------------------------------------------
+  SIDManager::Page *SIDManager::GetPage( uint16_t sid ) const
+  {
+    if( !sid )
+      return 0;
+    return pPages[sid / PageSize];
+  }
+
+#ifdef HAVE_ATOMICS
+  //----------------------------------------------------------------------------
+  // Push a chain of SIDs linked from first to last onto the free stack, the
+  // tag in the upper bits of the head changes with every update so that a
+  // pop working on a stale head fails
+  //----------------------------------------------------------------------------
+  void SIDManager::PushChain( uint16_t first, uint16_t last )
+  {
+    uint16_t &next = GetPage( last )->next[last % PageSize];
+    uint64_t  head;
+    do
+    {
+      head = AtomicGet( pFreeHead );
+      next = (uint16_t)head;
+    }
+    while( !AtomicCAS( pFreeHead, head, ((head >> 16) + 1) << 16 | first ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Pop a SID from the free stack, 0 if it's empty
+  //----------------------------------------------------------------------------
+  uint16_t SIDManager::Pop()
+  {
+    uint64_t head;
+    uint16_t sid;
+    uint16_t next;
+    do
+    {
+      head = AtomicGet( pFreeHead );
+      sid  = (uint16_t)head;
+      if( !sid )
+        return 0;
+      next = GetPage( sid )->next[sid % PageSize];
+    }
+    while( !AtomicCAS( pFreeHead, head, ((head >> 16) + 1) << 16 | next ) );
+    return sid;
+  }
+
+  //----------------------------------------------------------------------------
+  // Push a released SID onto the retired stack, it is only ever emptied as
+  // a whole so there is no need for a tag
+  //----------------------------------------------------------------------------
+  void SIDManager::Retire( uint16_t sid )
+  {
+    uint16_t &next = GetPage( sid )->next[sid % PageSize];
+    uint32_t  head;
+    do
+    {
+      head = AtomicGet( pRetiredHead );
+      next = (uint16_t)head;
+    }
+    while( !AtomicCAS( pRetiredHead, head, (uint32_t)sid ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Take all the retired SIDs, keep the first one and move the rest to the
+  // free stack; 0 if there are none or while there are few SIDs
+  //----------------------------------------------------------------------------
+  uint16_t SIDManager::Recycle()
+  {
+    if( AtomicGet( pSIDCeiling ) <= ReuseDelay )
+      return 0;
+
+    uint32_t retired;
+    AtomicFZAP( retired, pRetiredHead );
+    uint16_t sid = (uint16_t)retired;
+    if( !sid )
+      return 0;
+
+    //--------------------------------------------------------------------------
+    // The chain is ours now, nobody else can link the free SIDs in it
+    //--------------------------------------------------------------------------
+    uint16_t first = GetPage( sid )->next[sid % PageSize];
+    if( first )
+    {
+      uint16_t last = first, next;
+      while( ( next = GetPage( last )->next[last % PageSize] ) )
+        last = next;
+      PushChain( first, last );
+    }
+    return sid;
+  }
+
+  //----------------------------------------------------------------------------
+  // Change the state of a SID if it is in the expected one
+  //----------------------------------------------------------------------------
+  bool SIDManager::SetState( uint16_t sid, uint8_t from, uint8_t to )
+  {
+    Page *page = GetPage( sid );
+    if( !page )
+      return false;
+    return AtomicCAS( page->state[sid % PageSize], from, to );
+  }
+#else
+  //----------------------------------------------------------------------------
+  // Push a chain of SIDs linked from first to last onto the free stack
+  //----------------------------------------------------------------------------
+  void SIDManager::PushChain( uint16_t first, uint16_t last )
   {
     XrdSysMutexHelper scopedLock( pMutex );
-    return pSIDCeiling - pFreeSIDs.size() - pTimeOutSIDs.size() - 1;
+    GetPage( last )->next[last % PageSize] = pFreeHead;
+    pFreeHead = first;
+  }
+
+  //----------------------------------------------------------------------------
+  // Pop a SID from the free stack, 0 if it's empty
+  //----------------------------------------------------------------------------
+  uint16_t SIDManager::Pop()
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    uint16_t sid = pFreeHead;
+    if( sid )
+      pFreeHead = GetPage( sid )->next[sid % PageSize];
+    return sid;
+  }
+
+  //----------------------------------------------------------------------------
+  // Push a released SID onto the retired stack
+  //----------------------------------------------------------------------------
+  void SIDManager::Retire( uint16_t sid )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    GetPage( sid )->next[sid % PageSize] = pRetiredHead;
+    pRetiredHead = sid;
+  }
+
+  //----------------------------------------------------------------------------
+  // Take all the retired SIDs, keep the first one and move the rest to the
+  // free stack; 0 if there are none or while there are few SIDs
+  //----------------------------------------------------------------------------
+  uint16_t SIDManager::Recycle()
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    uint16_t sid = pRetiredHead;
+    if( pSIDCeiling <= ReuseDelay || !sid )
+      return 0;
+
+    pFreeHead    = GetPage( sid )->next[sid % PageSize];
+    pRetiredHead = 0;
+    return sid;
+  }
+
+  //----------------------------------------------------------------------------
+  // Change the state of a SID if it is in the expected one
+  //----------------------------------------------------------------------------
+  bool SIDManager::SetState( uint16_t sid, uint8_t from, uint8_t to )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    Page *page = GetPage( sid );
+    if( !page || page->state[sid % PageSize] != from )
+      return false;
+    page->state[sid % PageSize] = to;
+    return true;
+  }
+#endif
+
+  //----------------------------------------------------------------------------
+  // Allocate a SID that has never been used, adding a page to the table if
+  // needed
+  //----------------------------------------------------------------------------
+  uint16_t SIDManager::Grow()
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    if( pSIDCeiling == 0xffff )
+      return 0;
+
+    uint16_t sid = pSIDCeiling;
+    if( !pPages[sid / PageSize] )
+      pPages[sid / PageSize] = new Page();
+    ++pSIDCeiling;
+    return sid;
   }
 }
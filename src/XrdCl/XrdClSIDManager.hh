@@ -19,9 +19,8 @@
 #ifndef __XRD_CL_SID_MANAGER_HH__
 #define __XRD_CL_SID_MANAGER_HH__
 
-#include <list>
-#include <set>
 #include <stdint.h>
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdCl/XrdClStatus.hh"
 
@@ -29,6 +28,18 @@ namespace XrdCl
 {
   //----------------------------------------------------------------------------
   //! Handle XRootD stream IDs
+  //!
+  //! The state of the SIDs is kept in a table indexed by the SID itself,
+  //! split into pages that are allocated as the number of SIDs in use
+  //! grows. The free SIDs form stacks threaded through the table that are
+  //! updated with compare-and-swap, so that allocating and releasing a SID
+  //! does not take a lock. The mutex is only taken to grow the table.
+  //!
+  //! Released SIDs are not reused right away: they are retired and only
+  //! handed out again once the SIDs retired before them have all been
+  //! reused, so a SID is reused after roughly as many allocations as there
+  //! were SIDs freed with it. The first ReuseDelay SIDs are always new.
+  //! A SID that is not allocated (or not timed out) cannot be released.
   //----------------------------------------------------------------------------
   class SIDManager
   {
@@ -37,7 +48,12 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
-      SIDManager(): pSIDCeiling(1) {}
+      SIDManager();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~SIDManager();
 
       //------------------------------------------------------------------------
       //! Allocate a SID
@@ -77,8 +93,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       uint32_t NumberOfTimedOutSIDs() const
       {
-        XrdSysMutexHelper scopedLock( pMutex );
-        return pTimeOutSIDs.size();
+        AtomicRet( pMutex, pTimedOut );
       }
 
       //------------------------------------------------------------------------
@@ -87,9 +102,43 @@ namespace XrdCl
       uint16_t GetNumberOfAllocatedSIDs() const;
 
     private:
-      std::list<uint16_t>  pFreeSIDs;
-      std::set<uint16_t>   pTimeOutSIDs;
-      uint16_t             pSIDCeiling;
+      SIDManager( const SIDManager &other );
+      SIDManager &operator = ( const SIDManager &other );
+
+      static const uint32_t PageSize   = 256;
+      static const uint32_t NumPages   = 65536 / PageSize;
+      static const uint32_t ReuseDelay = 64;
+
+      //------------------------------------------------------------------------
+      //! States of a SID
+      //------------------------------------------------------------------------
+      static const uint8_t Free      = 0;
+      static const uint8_t Allocated = 1;
+      static const uint8_t TimedOut  = 2;
+
+      //------------------------------------------------------------------------
+      //! Entries of PageSize consecutive SIDs
+      //------------------------------------------------------------------------
+      struct Page
+      {
+        uint16_t next[PageSize];      //!< next SID on a free stack
+        uint8_t  state[PageSize];     //!< Free, Allocated or TimedOut
+      };
+
+      Page    *GetPage( uint16_t sid ) const;
+      void     PushChain( uint16_t first, uint16_t last );
+      uint16_t Pop();
+      void     Retire( uint16_t sid );
+      uint16_t Recycle();
+      uint16_t Grow();
+      bool     SetState( uint16_t sid, uint8_t from, uint8_t to );
+
+      Page                *pPages[NumPages];
+      uint64_t             pFreeHead;     //!< ABA tag << 16 | SID, 0 if empty
+      uint32_t             pRetiredHead;  //!< retired SIDs, 0 if none
+      uint32_t             pSIDCeiling;
+      mutable uint32_t     pAllocated;
+      mutable uint32_t     pTimedOut;
       mutable XrdSysMutex  pMutex;
   };
 }
@@ -479,7 +479,7 @@ namespace XrdCl
   std::string Utils::NormalizeChecksum( const std::string &name,
                                         const std::string &checksum )
   {
-    if( name == "adler32" || name == "crc32" )
+    if( name == "adler32" || name == "crc32" || name == "crc32c" )
     {
       size_t i;
       for( i = 0; i < checksum.length(); ++i )
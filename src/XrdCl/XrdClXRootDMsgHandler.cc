@@ -34,6 +34,7 @@
 #include "XrdCl/XrdClTaskManager.hh"
 #include "XrdCl/XrdClSIDManager.hh"
 #include "XrdCl/XrdClMessageUtils.hh"
+#include "XrdOuc/XrdOucCRC.hh"
 
 #include <arpa/inet.h>              // for network unmarshalling stuff
 #include "XrdSys/XrdSysPlatform.hh" // same as above
@@ -176,6 +177,21 @@ namespace XrdCl
           return Take | Raw | RemoveHandler;
         }
 
+        //----------------------------------------------------------------------
+        // kXR_pgread pages go straight to the user buffer as well, unless
+        // the message has been cached
+        //----------------------------------------------------------------------
+        if( reqId == kXR_pgread )
+        {
+          if( msg->GetSize() == 8 )
+          {
+            pAsyncMsgSize       = dlen;
+            pPgReadRawMsgOffset = 0;
+            return Take | Raw | RemoveHandler;
+          }
+          UnPackPgRead( msg->GetBuffer( msg->GetSize() - dlen ), dlen );
+        }
+
         //----------------------------------------------------------------------
         // For everything else we just take what we got
         //----------------------------------------------------------------------
@@ -230,6 +246,21 @@ namespace XrdCl
             return Take | NoProcess;
         }
 
+        //----------------------------------------------------------------------
+        // kXR_pgread is like kXR_read, but the cached messages are unpacked
+        // right away so that the pages land in order
+        //----------------------------------------------------------------------
+        if( reqId == kXR_pgread )
+        {
+          if( msg->GetSize() == 8 )
+          {
+            pAsyncMsgSize       = dlen;
+            pPgReadRawMsgOffset = 0;
+            return Take | Raw | NoProcess;
+          }
+          UnPackPgRead( msg->GetBuffer( msg->GetSize() - dlen ), dlen );
+        }
+
         return Take | NoProcess;
       }
 
@@ -471,8 +502,19 @@ namespace XrdCl
 	}
 
 	std::string xrdCgi = ossXrd.str();
+
+	//----------------------------------------------------------------------
+	// Keep the number of sub-streams asked for, the channel to the new
+	// location is created from pUrl
+	//----------------------------------------------------------------------
+	URL::ParamsMap channelParams;
+	URL::ParamsMap::const_iterator ssIt = urlParams.find( "xrdcl.substreams" );
+	if( ssIt != urlParams.end() )
+	  channelParams[ssIt->first] = ssIt->second;
+
 	pUrl         = newUrl;
 	pRedirectUrl = newUrl.GetURL();
+	pUrl.SetParams( channelParams );
 
 	URL cgiURL;
 	if( urlComponents.size() > 1 )
@@ -683,6 +725,9 @@ namespace XrdCl
     if( reqId == kXR_readv )
       return ReadRawReadV( msg, socket, bytesRead );
 
+    if( reqId == kXR_pgread )
+      return ReadRawPgRead( msg, socket, bytesRead );
+
     return ReadRawOther( msg, socket, bytesRead );
   }
 
@@ -928,6 +973,135 @@ namespace XrdCl
     return st;
   }
 
+  //----------------------------------------------------------------------------
+  // Handle a kXR_pgread in raw mode
+  //----------------------------------------------------------------------------
+  Status XRootDMsgHandler::ReadRawPgRead( Message  *msg,
+                                          int       socket,
+                                          uint32_t &bytesRead )
+  {
+    //--------------------------------------------------------------------------
+    // If the response does not fit the user buffer or is malformed we
+    // discard the rest of it to keep the stream sane
+    //--------------------------------------------------------------------------
+    if( pChunkStatus.front().sizeError )
+      return ReadRawOther( msg, socket, bytesRead );
+
+    ChunkInfo chunk = pChunkList->front();
+    while( 1 )
+    {
+      //------------------------------------------------------------------------
+      // Set up reading the data of the next page
+      //------------------------------------------------------------------------
+      if( !pPgReadRawUnitStarted )
+      {
+        if( pPgReadRawMsgOffset == pAsyncMsgSize )
+          return Status( stOK, suDone );
+
+        uint32_t pgLen = NextPgReadPage( pAsyncMsgSize - pPgReadRawMsgOffset );
+        if( !pgLen )
+        {
+          pAsyncMsgSize    -= pPgReadRawMsgOffset;
+          pOtherRawStarted  = false;
+          return ReadRawOther( msg, socket, bytesRead );
+        }
+
+        pAsyncOffset          = 0;
+        pAsyncReadSize        = pgLen;
+        pAsyncReadBuffer      = (char*)chunk.buffer + pPgReadLength;
+        pPgReadRawUnitStarted = true;
+        pPgReadRawInCksum     = false;
+      }
+
+      Status st = ReadAsync( socket, bytesRead );
+      if( !st.IsOK() || st.code != suDone )
+        return st;
+
+      //------------------------------------------------------------------------
+      // The data is in, read the checksum that follows it
+      //------------------------------------------------------------------------
+      if( !pPgReadRawInCksum )
+      {
+        pPgReadRawInCksum = true;
+        pAsyncOffset      = 0;
+        pAsyncReadBuffer  = (char*)&pPgReadRawCksum;
+        pAsyncReadSize    = sizeof( pPgReadRawCksum );
+        continue;
+      }
+
+      //------------------------------------------------------------------------
+      // The page is complete, the length is recomputed as nothing it depends
+      // on has changed since it was set up
+      //------------------------------------------------------------------------
+      uint32_t pgLen = NextPgReadPage( pAsyncMsgSize - pPgReadRawMsgOffset );
+      AddPgReadPage( pgLen, ntohl( pPgReadRawCksum ) );
+      pPgReadRawMsgOffset   += pgLen + sizeof( pPgReadRawCksum );
+      pPgReadRawUnitStarted  = false;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Unpack the pages of a kXR_pgread response received as a whole
+  //----------------------------------------------------------------------------
+  void XRootDMsgHandler::UnPackPgRead( const char *data, uint32_t dlen )
+  {
+    ChunkInfo chunk = pChunkList->front();
+    uint32_t  pgLen, cksum;
+
+    while( dlen > 0 && !pChunkStatus.front().sizeError )
+    {
+      if( !(pgLen = NextPgReadPage( dlen )) )
+        return;
+      memcpy( (char*)chunk.buffer + pPgReadLength, data, pgLen );
+      memcpy( &cksum, data + pgLen, sizeof( cksum ) );
+      AddPgReadPage( pgLen, ntohl( cksum ) );
+      data += pgLen + sizeof( cksum );
+      dlen -= pgLen + sizeof( cksum );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the length of the next page of a kXR_pgread response
+  //----------------------------------------------------------------------------
+  uint32_t XRootDMsgHandler::NextPgReadPage( uint32_t left )
+  {
+    //--------------------------------------------------------------------------
+    // Pages are aligned on the file offset, only the last one of a response
+    // may be short
+    //--------------------------------------------------------------------------
+    ChunkInfo chunk  = pChunkList->front();
+    uint64_t  offset = chunk.offset + pPgReadLength;
+    uint32_t  pgLen  = kXR_pgPageSZ - offset % kXR_pgPageSZ;
+
+    if( left > sizeof( uint32_t ) && pgLen + sizeof( uint32_t ) > left )
+      pgLen = left - sizeof( uint32_t );
+
+    if( left <= sizeof( uint32_t ) || pPgReadLength + pgLen > chunk.length )
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Error( XRootDMsg, "[%s] Malformed or overflowing response to %s, "
+                  "discarding it", pUrl.GetHostId().c_str(),
+                  pRequest->GetDescription().c_str() );
+      pChunkStatus.front().sizeError = true;
+      return 0;
+    }
+    return pgLen;
+  }
+
+  //----------------------------------------------------------------------------
+  // Account for a page of a kXR_pgread response
+  //----------------------------------------------------------------------------
+  void XRootDMsgHandler::AddPgReadPage( uint32_t pgLen, uint32_t cksum )
+  {
+    ChunkInfo  chunk = pChunkList->front();
+    char      *page  = (char*)chunk.buffer + pPgReadLength;
+
+    pPgReadCksums.push_back( cksum );
+    if( XrdOucCRC::Calc32C( page, pgLen ) != cksum )
+      pPgReadBadPages.push_back( chunk.offset + pPgReadLength );
+    pPgReadLength += pgLen;
+  }
+
   //----------------------------------------------------------------------------
   // Handle anything other than kXR_read and kXR_readv in raw mode
   //----------------------------------------------------------------------------
@@ -1017,7 +1191,7 @@ namespace XrdCl
   {
     ClientRequest  *req = (ClientRequest *)pRequest->GetBuffer();
     uint16_t reqId = ntohs( req->header.requestid );
-    if( reqId == kXR_write )
+    if( reqId == kXR_write || reqId == kXR_writev )
       return true;
     return false;
   }
@@ -1028,43 +1202,53 @@ namespace XrdCl
   Status XRootDMsgHandler::WriteMessageBody( int       socket,
                                              uint32_t &bytesRead )
   {
-    char     *buffer          = (char*)(*pChunkList)[0].buffer;
-    uint32_t  size            = (*pChunkList)[0].length;
-    uint32_t  leftToBeWritten = size-pAsyncOffset;
-
-    while( leftToBeWritten )
+    //--------------------------------------------------------------------------
+    // Write the chunks one after another, kXR_write has just one of them
+    //--------------------------------------------------------------------------
+    while( pAsyncChunkIndex < pChunkList->size() )
     {
-      //------------------------------------------------------------------------
-      // We use send with MSG_NOSIGNAL to avoid SIGPIPEs on Linux
-      //------------------------------------------------------------------------
-#ifdef __linux__
-      int status = ::send( socket, buffer+pAsyncOffset, leftToBeWritten,
-                           MSG_NOSIGNAL );
-#else
-      int status = ::write( socket, buffer+pAsyncOffset, leftToBeWritten );
-#endif
-      if( status <= 0 )
-      {
-        //----------------------------------------------------------------------
-        // Writing operation would block! So we are done for now, but we will
-        // return here
-        //----------------------------------------------------------------------
-        if( errno == EAGAIN || errno == EWOULDBLOCK )
-          return Status( stOK, suRetry );
+      char     *buffer          = (char*)(*pChunkList)[pAsyncChunkIndex].buffer;
+      uint32_t  size            = (*pChunkList)[pAsyncChunkIndex].length;
+      uint32_t  leftToBeWritten = size-pAsyncOffset;
 
+      while( leftToBeWritten )
+      {
         //----------------------------------------------------------------------
-        // Actual socket error error!
+        // We use send with MSG_NOSIGNAL to avoid SIGPIPEs on Linux
         //----------------------------------------------------------------------
-        return Status( stError, errSocketError, errno );
+#ifdef __linux__
+        int status = ::send( socket, buffer+pAsyncOffset, leftToBeWritten,
+                             MSG_NOSIGNAL );
+#else
+        int status = ::write( socket, buffer+pAsyncOffset, leftToBeWritten );
+#endif
+        if( status <= 0 )
+        {
+          //--------------------------------------------------------------------
+          // Writing operation would block! So we are done for now, but we
+          // will return here
+          //--------------------------------------------------------------------
+          if( errno == EAGAIN || errno == EWOULDBLOCK )
+            return Status( stOK, suRetry );
+
+          //--------------------------------------------------------------------
+          // Actual socket error error!
+          //--------------------------------------------------------------------
+          return Status( stError, errSocketError, errno );
+        }
+        pAsyncOffset    += status;
+        bytesRead       += status;
+        leftToBeWritten -= status;
       }
-      pAsyncOffset    += status;
-      bytesRead       += status;
-      leftToBeWritten -= status;
+      pAsyncOffset = 0;
+      ++pAsyncChunkIndex;
     }
 
     //--------------------------------------------------------------------------
-    // We're done have written the message successfully
+    // We're done have written the message successfully, reset the cursor in
+    // case the request needs to be sent again
     //--------------------------------------------------------------------------
+    pAsyncChunkIndex = 0;
     return Status();
   }
 
@@ -1192,7 +1376,8 @@ namespace XrdCl
     // Partial answers, we need to glue them together before parsing
     //--------------------------------------------------------------------------
     else if( req->header.requestid != kXR_read &&
-             req->header.requestid != kXR_readv )
+             req->header.requestid != kXR_readv &&
+             req->header.requestid != kXR_pgread )
     {
       for( uint32_t i = 0; i < pPartialResps.size(); ++i )
       {
@@ -1220,7 +1405,7 @@ namespace XrdCl
     {
       //------------------------------------------------------------------------
       // kXR_mv, kXR_truncate, kXR_rm, kXR_mkdir, kXR_rmdir, kXR_chmod,
-      // kXR_ping, kXR_close, kXR_write, kXR_sync
+      // kXR_ping, kXR_close, kXR_write, kXR_writev, kXR_sync
       //------------------------------------------------------------------------
       case kXR_mv:
       case kXR_truncate:
@@ -1231,6 +1416,7 @@ namespace XrdCl
       case kXR_ping:
       case kXR_close:
       case kXR_write:
+      case kXR_writev:
       case kXR_sync:
         return Status();
 
@@ -1532,6 +1718,58 @@ namespace XrdCl
         return Status();
       }
 
+      //------------------------------------------------------------------------
+      // kXR_pgread - unpack the data and verify the page checksums
+      //------------------------------------------------------------------------
+      case kXR_pgread:
+      {
+        log->Dump( XRootDMsg, "[%s] Parsing the response to %s as PageInfo",
+                   pUrl.GetHostId().c_str(),
+                   pRequest->GetDescription().c_str() );
+
+        ChunkInfo  chunk  = pChunkList->front();
+        PageInfo  *pgInfo = new PageInfo( chunk.offset, 0, chunk.buffer );
+        Status st = PostProcessPgRead( pgInfo );
+        if( !st.IsOK() )
+        {
+          delete pgInfo;
+          return st;
+        }
+
+        AnyObject *obj = new AnyObject();
+        obj->Set( pgInfo );
+        response = obj;
+        return Status();
+      }
+
+      //------------------------------------------------------------------------
+      // kXR_pgwrite - the response lists the pages that need to be resent
+      //------------------------------------------------------------------------
+      case kXR_pgwrite:
+      {
+        log->Dump( XRootDMsg, "[%s] Parsing the response to %s as PageInfo",
+                   pUrl.GetHostId().c_str(),
+                   pRequest->GetDescription().c_str() );
+
+        if( length % sizeof( uint64_t ) )
+          return Status( stError, errInvalidResponse );
+
+        ChunkInfo  chunk  = pChunkList->front();
+        PageInfo  *pgInfo = new PageInfo( chunk.offset, chunk.length,
+                                          chunk.buffer );
+        uint64_t   pgOff;
+        for( uint32_t i = 0; i < length; i += sizeof( uint64_t ) )
+        {
+          memcpy( &pgOff, buffer + i, sizeof( uint64_t ) );
+          pgInfo->GetBadPages().push_back( ntohll( pgOff ) );
+        }
+
+        AnyObject *obj = new AnyObject();
+        obj->Set( pgInfo );
+        response = obj;
+        return Status();
+      }
+
       //------------------------------------------------------------------------
       // kXR_query
       //------------------------------------------------------------------------
@@ -1709,6 +1947,36 @@ namespace XrdCl
     return Status();
   }
 
+  //----------------------------------------------------------------------------
+  // Post process page read
+  //----------------------------------------------------------------------------
+  Status XRootDMsgHandler::PostProcessPgRead( PageInfo *pgInfo )
+  {
+    //--------------------------------------------------------------------------
+    // The pages have been unpacked into the user buffer as they arrived
+    //--------------------------------------------------------------------------
+    Log *log = DefaultEnv::GetLog();
+    if( pChunkStatus.front().sizeError )
+    {
+      log->Error( XRootDMsg, "[%s] Handling response to %s: the response is "
+                  "malformed or the user supplied buffer is too small for "
+                  "the received data.", pUrl.GetHostId().c_str(),
+                  pRequest->GetDescription().c_str() );
+      return Status( stError, errInvalidResponse );
+    }
+
+    if( !pPgReadBadPages.empty() )
+      log->Warning( XRootDMsg, "[%s] Response to %s has %d page(s) with an "
+                    "invalid checksum", pUrl.GetHostId().c_str(),
+                    pRequest->GetDescription().c_str(),
+                    (int)pPgReadBadPages.size() );
+
+    pgInfo->GetCksums().swap( pPgReadCksums );
+    pgInfo->GetBadPages().swap( pPgReadBadPages );
+    pgInfo->SetLength( pPgReadLength );
+    return Status();
+  }
+
   //----------------------------------------------------------------------------
   //! Unpack a single readv response
   //----------------------------------------------------------------------------
@@ -75,6 +75,7 @@ namespace XrdCl
         pAsyncReadSize( 0 ),
         pAsyncReadBuffer( 0 ),
         pAsyncMsgSize( 0 ),
+        pAsyncChunkIndex( 0 ),
 
         pReadRawStarted( false ),
         pReadRawCurrentOffset( 0 ),
@@ -86,6 +87,12 @@ namespace XrdCl
         pReadVRawChunkIndex( 0 ),
         pReadVRawMsgDiscard( false ),
 
+        pPgReadRawMsgOffset( 0 ),
+        pPgReadRawUnitStarted( false ),
+        pPgReadRawInCksum( false ),
+        pPgReadRawCksum( 0 ),
+        pPgReadLength( 0 ),
+
         pOtherRawStarted( false )
       {
         pPostMaster = DefaultEnv::GetPostMaster();
@@ -267,6 +274,32 @@ namespace XrdCl
                            int       socket,
                            uint32_t &bytesRead );
 
+      //------------------------------------------------------------------------
+      //! Handle a kXR_pgread in raw mode, the pages go to the user buffer
+      //! and their checksums are verified as they come
+      //------------------------------------------------------------------------
+      Status ReadRawPgRead( Message  *msg,
+                            int       socket,
+                            uint32_t &bytesRead );
+
+      //------------------------------------------------------------------------
+      //! Unpack the pages of a kXR_pgread response that has been received
+      //! as a whole
+      //------------------------------------------------------------------------
+      void UnPackPgRead( const char *data, uint32_t dlen );
+
+      //------------------------------------------------------------------------
+      //! Get the length of the next page of a kXR_pgread response, 0 if
+      //! the response is malformed
+      //------------------------------------------------------------------------
+      uint32_t NextPgReadPage( uint32_t left );
+
+      //------------------------------------------------------------------------
+      //! Account for a page of a kXR_pgread response that is in the user
+      //! buffer
+      //------------------------------------------------------------------------
+      void AddPgReadPage( uint32_t pgLen, uint32_t cksum );
+
       //------------------------------------------------------------------------
       //! Handle anything other than kXR_read and kXR_readv in raw mode
       //------------------------------------------------------------------------
@@ -328,6 +361,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       Status UnPackReadVResponse( Message *msg );
 
+      //------------------------------------------------------------------------
+      //! Post process page read
+      //------------------------------------------------------------------------
+      Status PostProcessPgRead( PageInfo *pgInfo );
+
       //------------------------------------------------------------------------
       //! Update the "tried=" part of the CGI of the current message
       //------------------------------------------------------------------------
@@ -371,6 +409,7 @@ namespace XrdCl
       uint32_t                   pAsyncReadSize;
       char*                      pAsyncReadBuffer;
       uint32_t                   pAsyncMsgSize;
+      uint32_t                   pAsyncChunkIndex;
 
       bool                       pReadRawStarted;
       uint32_t                   pReadRawCurrentOffset;
@@ -383,6 +422,14 @@ namespace XrdCl
       readahead_list             pReadVRawChunkHeader;
       bool                       pReadVRawMsgDiscard;
 
+      uint32_t                   pPgReadRawMsgOffset;
+      bool                       pPgReadRawUnitStarted;
+      bool                       pPgReadRawInCksum;
+      uint32_t                   pPgReadRawCksum;
+      uint32_t                   pPgReadLength;
+      std::vector<uint32_t>      pPgReadCksums;
+      std::vector<uint64_t>      pPgReadBadPages;
+
       bool                       pOtherRawStarted;
   };
 }
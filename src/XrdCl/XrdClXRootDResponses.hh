@@ -810,6 +810,76 @@ namespace XrdCl
       uint32_t  pSize;
   };
 
+  //----------------------------------------------------------------------------
+  //! Page read/write info, the data is accompanied by a CRC32C checksum for
+  //! every page of kXR_pgPageSZ bytes, the first and last pages may be short
+  //----------------------------------------------------------------------------
+  class PageInfo
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      PageInfo( uint64_t offset = 0, uint32_t length = 0, void *buffer = 0 ):
+        pOffset( offset ), pLength( length ), pBuffer( buffer ) {}
+
+      //------------------------------------------------------------------------
+      //! Get the offset
+      //------------------------------------------------------------------------
+      uint64_t GetOffset() const
+      {
+        return pOffset;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the data length
+      //------------------------------------------------------------------------
+      uint32_t GetLength() const
+      {
+        return pLength;
+      }
+
+      //------------------------------------------------------------------------
+      //! Set the data length
+      //------------------------------------------------------------------------
+      void SetLength( uint32_t length )
+      {
+        pLength = length;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the buffer
+      //------------------------------------------------------------------------
+      void *GetBuffer()
+      {
+        return pBuffer;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the checksums received for the pages (pgread only)
+      //------------------------------------------------------------------------
+      std::vector<uint32_t> &GetCksums()
+      {
+        return pCksums;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the offsets of the pages whose checksum did not match, these
+      //! pages need to be read or written again
+      //------------------------------------------------------------------------
+      std::vector<uint64_t> &GetBadPages()
+      {
+        return pBadPages;
+      }
+
+    private:
+      uint64_t              pOffset;
+      uint32_t              pLength;
+      void                 *pBuffer;
+      std::vector<uint32_t> pCksums;
+      std::vector<uint64_t> pBadPages;
+  };
+
   //----------------------------------------------------------------------------
   // List of URLs
   //----------------------------------------------------------------------------
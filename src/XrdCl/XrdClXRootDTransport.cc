@@ -146,7 +146,8 @@ namespace XrdCl
       waitBarrier(0),
       protection(0),
       protRespBody(0),
-      protRespSize(0)
+      protRespSize(0),
+      nextStream(0)
     {
       sidManager = new SIDManager();
       memset( sessionId, 0, 16 );
@@ -187,9 +188,39 @@ namespace XrdCl
     XrdSecProtect               *protection;
     ServerResponseBody_Protocol *protRespBody;
     unsigned int                 protRespSize;
+    uint16_t                     nextStream;
     XrdSysMutex                  mutex;
   };
 
+  //----------------------------------------------------------------------------
+  // Responses of at least this size come through the sub-streams
+  //----------------------------------------------------------------------------
+  static const uint64_t SubStreamMinSize = 65536;
+
+  //----------------------------------------------------------------------------
+  // Get the size of the data an unmarshalled request reads
+  //----------------------------------------------------------------------------
+  static uint64_t GetResponseSize( Message *msg )
+  {
+    ClientRequest *req  = (ClientRequest*)msg->GetBuffer();
+    uint64_t       size = 0;
+    switch( req->header.requestid )
+    {
+      case kXR_read:
+        size = req->read.rlen;
+        break;
+
+      case kXR_readv:
+      {
+        readahead_list *dataChunk = (readahead_list*)msg->GetBuffer( 24 );
+        for( size_t i = 0; i < req->header.dlen/sizeof(readahead_list); ++i )
+          size += dataChunk[i].rlen;
+        break;
+      }
+    };
+    return size;
+  }
+
   //----------------------------------------------------------------------------
   // Constructor
   //----------------------------------------------------------------------------
@@ -282,15 +313,36 @@ namespace XrdCl
   // Initialize channel
   //----------------------------------------------------------------------------
   void XRootDTransport::InitializeChannel( AnyObject &channelData )
+  {
+    InitializeChannel( URL(), channelData );
+  }
+
+  //----------------------------------------------------------------------------
+  // Initialize channel for an URL
+  //----------------------------------------------------------------------------
+  void XRootDTransport::InitializeChannel( const URL &url,
+                                           AnyObject &channelData )
   {
     XRootDChannelInfo *info = new XRootDChannelInfo();
     XrdSysMutexHelper scopedLock( info->mutex );
     channelData.Set( info );
 
+    //--------------------------------------------------------------------------
+    // The number of streams may be given per URL, the server binds at most
+    // 15 streams to a session. The channel is shared by all the URLs for the
+    // same host, so the first one to create it decides.
+    //--------------------------------------------------------------------------
     Env *env = DefaultEnv::GetEnv();
     int streams = DefaultSubStreamsPerChannel;
     env->GetInt( "SubStreamsPerChannel", streams );
-    if( streams < 1 ) streams = 1;
+
+    const URL::ParamsMap &params = url.GetParams();
+    URL::ParamsMap::const_iterator it = params.find( "xrdcl.substreams" );
+    if( it != params.end() )
+      streams = atoi( it->second.c_str() );
+
+    if( streams < 1 )  streams = 1;
+    if( streams > 16 ) streams = 16;
     info->stream.resize( streams );
   }
 
@@ -652,12 +704,20 @@ namespace XrdCl
     uint16_t upStream   = 0;
     uint16_t downStream = 0;
 
+    UnMarshallRequest( msg );
+    ClientRequestHdr *hdr = (ClientRequestHdr*)msg->GetBuffer();
+
     if( hint )
     {
       upStream   = hint->up;
       downStream = hint->down;
     }
-    else
+    //--------------------------------------------------------------------------
+    // Bulk data is returned through the connected sub-streams in turn so
+    // that every one of them keeps its congestion window open, small
+    // responses come through stream 0 not to queue up behind the bulk data
+    //--------------------------------------------------------------------------
+    else if( GetResponseSize( msg ) >= SubStreamMinSize )
     {
       upStream = 0;
       std::vector<uint16_t> connected;
@@ -668,7 +728,7 @@ namespace XrdCl
       if( connected.empty() )
         downStream = 0;
       else
-        downStream = connected[random()%connected.size()];
+        downStream = connected[info->nextStream++ % connected.size()];
     }
 
     if( upStream >= info->stream.size() )
@@ -690,8 +750,6 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Modify the message
     //--------------------------------------------------------------------------
-    UnMarshallRequest( msg );
-    ClientRequestHdr *hdr = (ClientRequestHdr*)msg->GetBuffer();
     switch( hdr->requestid )
     {
       //------------------------------------------------------------------------
@@ -727,7 +785,9 @@ namespace XrdCl
       }
 
       //------------------------------------------------------------------------
-      // Write - multiplexing writes doesn't work properly in the server
+      // Write - multiplexing writes doesn't work properly in the server, it
+      // expects the request through stream 0 and the data through the
+      // sub-stream
       //------------------------------------------------------------------------
       case kXR_write:
       {
@@ -847,6 +907,21 @@ namespace XrdCl
         req->write.offset = htonll( req->write.offset );
         break;
 
+      //------------------------------------------------------------------------
+      // kXR_pgread
+      //------------------------------------------------------------------------
+      case kXR_pgread:
+        req->pgread.offset = htonll( req->pgread.offset );
+        req->pgread.rlen   = htonl( req->pgread.rlen );
+        break;
+
+      //------------------------------------------------------------------------
+      // kXR_pgwrite
+      //------------------------------------------------------------------------
+      case kXR_pgwrite:
+        req->pgwrite.offset = htonll( req->pgwrite.offset );
+        break;
+
       //------------------------------------------------------------------------
       // kXR_mv
       //------------------------------------------------------------------------
@@ -866,6 +941,21 @@ namespace XrdCl
           dataChunk[i].rlen   = htonl( dataChunk[i].rlen );
           dataChunk[i].offset = htonll( dataChunk[i].offset );
         }
+        break;
+      }
+
+      //------------------------------------------------------------------------
+      // kXR_writev
+      //------------------------------------------------------------------------
+      case kXR_writev:
+      {
+        uint16_t numChunks  = (req->writev.dlen)/16;
+        write_list *dataChunk = (write_list*)msg->GetBuffer( 24 );
+        for( size_t i = 0; i < numChunks; ++i )
+        {
+          dataChunk[i].wlen   = htonl( dataChunk[i].wlen );
+          dataChunk[i].offset = htonll( dataChunk[i].offset );
+        }
       }
     };
 
@@ -2149,6 +2239,36 @@ namespace XrdCl
         break;
       }
 
+      //------------------------------------------------------------------------
+      // kXR_pgread
+      //------------------------------------------------------------------------
+      case kXR_pgread:
+      {
+        ClientPgReadRequest *sreq = (ClientPgReadRequest *)msg->GetBuffer();
+        o << "kXR_pgread (";
+        o << "handle: " << FileHandleToStr( sreq->fhandle );
+        o << std::setbase(10);
+        o << ", ";
+        o << "offset: " << sreq->offset << ", ";
+        o << "size: " << sreq->rlen << ")";
+        break;
+      }
+
+      //------------------------------------------------------------------------
+      // kXR_pgwrite
+      //------------------------------------------------------------------------
+      case kXR_pgwrite:
+      {
+        ClientPgWriteRequest *sreq = (ClientPgWriteRequest *)msg->GetBuffer();
+        o << "kXR_pgwrite (";
+        o << "handle: " << FileHandleToStr( sreq->fhandle );
+        o << std::setbase(10);
+        o << ", ";
+        o << "offset: " << sreq->offset << ", ";
+        o << "size: " << sreq->dlen << ")";
+        break;
+      }
+
       //------------------------------------------------------------------------
       // kXR_sync
       //------------------------------------------------------------------------
@@ -2212,6 +2332,35 @@ namespace XrdCl
         break;
       }
 
+      //------------------------------------------------------------------------
+      // kXR_writev
+      //------------------------------------------------------------------------
+      case kXR_writev:
+      {
+        unsigned char *fhandle = 0;
+        o << "kXR_writev (";
+
+        write_list *dataChunk = (write_list*)msg->GetBuffer( 24 );
+        uint64_t size      = 0;
+        uint32_t numChunks = 0;
+        for( size_t i = 0; i < req->dlen/sizeof(write_list); ++i )
+        {
+          fhandle = dataChunk[i].fhandle;
+          size += dataChunk[i].wlen;
+          ++numChunks;
+        }
+        o << "handle: ";
+        if( fhandle )
+          o << FileHandleToStr( fhandle );
+        else
+          o << "unknown";
+        o << ", ";
+        o << std::setbase(10);
+        o << "chunks: " << numChunks << ", ";
+        o << "total size: " << size << ")";
+        break;
+      }
+
       //------------------------------------------------------------------------
       // kXR_locate
       //------------------------------------------------------------------------
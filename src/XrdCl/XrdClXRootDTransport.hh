@@ -95,6 +95,13 @@ namespace XrdCl
       //------------------------------------------------------------------------
       virtual void InitializeChannel( AnyObject &channelData );
 
+      //------------------------------------------------------------------------
+      //! Initialize channel, the number of streams may be given with the
+      //! xrdcl.substreams CGI element of the URL
+      //------------------------------------------------------------------------
+      virtual void InitializeChannel( const URL &url,
+                                      AnyObject &channelData );
+
       //------------------------------------------------------------------------
       //! Finalize channel
       //------------------------------------------------------------------------
@@ -56,6 +56,7 @@
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdCms/XrdCmsTypes.hh"
 
+#include "XrdOuc/XrdOucBloom.hh"
 #include "XrdOuc/XrdOucPup.hh"
 
 #include "XrdSys/XrdSysPlatform.hh"
@@ -122,6 +123,7 @@ XrdCmsCluster::XrdCmsCluster()
      resetMask = 0;
      peerHost  = 0;
      peerMask  = ~peerHost;
+     sumMask   = 0;
 }
   
 /******************************************************************************/
@@ -1171,6 +1173,29 @@ int XrdCmsCluster::SelFail(XrdCmsSelect &Sel, int rc)
     return -1;
 }
   
+/******************************************************************************/
+/*                            s e t S u m m a r y                             */
+/******************************************************************************/
+
+void XrdCmsCluster::setSummary(XrdCmsNode *nP, unsigned char *bits,
+                               int nbits, int nhash)
+{
+   unsigned char *oldBits;
+
+// Swap in the new summary under the lock that selection holds while testing
+//
+   STMutex.Lock();
+   oldBits      = nP->sumBits;
+   nP->sumBits  = bits;
+   nP->sumNBits = nbits;
+   nP->sumNHash = nhash;
+   if (bits) sumMask |=  nP->NodeMask;
+      else   sumMask &= ~nP->NodeMask;
+   STMutex.UnLock();
+
+   if (oldBits) delete [] oldBits;
+}
+
 /******************************************************************************/
 /*                                 S p a c e                                  */
 /******************************************************************************/
@@ -1428,6 +1453,10 @@ int XrdCmsCluster::Drop(int sent, int sinst, XrdCmsDrop *djp)
 //
    if (nP->isPeer) {peerHost &= nP->NodeMask; peerMask = ~peerHost;}
 
+// The node's cache summary goes away with it
+//
+   sumMask &= ~nP->NodeMask;
+
 // Remove node entry from the alternate list and readjust the end pointer.
 //
    if (nP->isMan)
@@ -1568,6 +1597,23 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
 // returns the node unlocked but we have he global mutex so that is OK.
 //
    STMutex.Lock();
+
+// When reading, first try the primary nodes whose cache summary says that
+// they hold the file completely and then those that hold part of it. The
+// summaries are only hints so we fall back to all nodes if none qualifies.
+//
+   if (!selR.needSpace && (mask = pmask & peerMask & sumMask))
+      {SMask_t cmask, hmask;
+       SelSum(Sel.Path.Val, mask, cmask, hmask);
+       if (cmask)
+          nP = (Config.sched_RR || (Sel.Opts & XrdCmsSelect::UseRef)
+             ?  SelbyRef(cmask,selR) : SelbyLoad(cmask,selR));
+       if (!nP && (hmask &= ~cmask))
+          nP = (Config.sched_RR || (Sel.Opts & XrdCmsSelect::UseRef)
+             ?  SelbyRef(hmask,selR) : SelbyLoad(hmask,selR));
+       if (nP) pass = 0;
+      }
+
    mask = pmask & peerMask;
    while(pass--)
         {if (mask)
@@ -1675,6 +1721,42 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
             sP->Shrem = sP->Share; sP->Shrin++;                \
            }
   
+/******************************************************************************/
+/*                                S e l S u m                                 */
+/******************************************************************************/
+
+// Warning: STMutex must be locked upon entry!
+
+void XrdCmsCluster::SelSum(const char *path, SMask_t mask,
+                           SMask_t &cmask, SMask_t &hmask)
+{
+   XrdCmsNode *nP;
+   uint64_t h1, h2;
+   int i, nBytes;
+
+// Summaries are keyed by the path with a single leading slash
+//
+   while(path[0] == '/' && path[1] == '/') path++;
+   XrdOucBloom::Hash(path, h1, h2);
+
+// Check the summary of each node in the mask. The first filter holds all
+// cached files, the second one only complete files.
+//
+   cmask = hmask = 0;
+   for (i = 0; i <= STHi && mask; i++)
+       {if (!(nP = NodeTab[i]) || !(mask & nP->NodeMask)) continue;
+        mask &= ~nP->NodeMask;
+        if (!nP->sumBits) continue;
+        nBytes = nP->sumNBits/8;
+        if (XrdOucBloom::Test(nP->sumBits, nP->sumNBits, nP->sumNHash, h1, h2))
+           {hmask |= nP->NodeMask;
+            if (XrdOucBloom::Test(nP->sumBits+nBytes, nP->sumNBits,
+                                  nP->sumNHash, h1, h2))
+               cmask |= nP->NodeMask;
+           }
+       }
+}
+
 /******************************************************************************/
 /*                             S e l b y C o s t                              */
 /******************************************************************************/
@@ -190,6 +190,12 @@ int             Select(XrdCmsSelect &Sel);
 int             Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
                        int isrw, int isMulti, int ifWant);
 
+// Install the cache summary received from a node, replacing the previous one.
+// The bit vectors must have been allocated with new[] and become ours.
+//
+void            setSummary(XrdCmsNode *nP, unsigned char *bits,
+                           int nbits, int nhash);
+
 // Manipulate the global selection lock
 //
 void            SLock(bool dolock)
@@ -220,6 +226,8 @@ int         Multiple(SMask_t mVec);
 enum        {eExists, eDups, eROfs, eNoRep, eNoSel, eNoEnt}; // Passed to SelFail
 int         SelFail(XrdCmsSelect &Sel, int rc);
 int         SelNode(XrdCmsSelect &Sel, SMask_t  pmask, SMask_t  amask);
+void        SelSum(const char *path, SMask_t mask,
+                   SMask_t &cmask, SMask_t &hmask);
 XrdCmsNode *SelbyCost(SMask_t, XrdCmsSelector &selR);
 XrdCmsNode *SelbyLoad(SMask_t, XrdCmsSelector &selR);
 XrdCmsNode *SelbyRef (SMask_t, XrdCmsSelector &selR);
@@ -259,6 +267,7 @@ int           AltMent;
 SMask_t       resetMask;        // Nodes to receive a reset event
 SMask_t       peerHost;         // Nodes that are acting as peers
 SMask_t       peerMask;         // Always ~peerHost
+SMask_t       sumMask;          // Nodes that sent a cache summary
 };
 
 XRDOUC_ENUM_OPERATORS(XrdCmsCluster::CmsLSOpts)
@@ -63,6 +63,7 @@
 #include "XrdCms/XrdCmsRRQ.hh"
 #include "XrdCms/XrdCmsSecurity.hh"
 #include "XrdCms/XrdCmsState.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsSupervisor.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdCms/XrdCmsUtils.hh"
@@ -508,6 +509,7 @@ int XrdCmsConfig::ConfigXeq(char *var, XrdOucStream &CFile, XrdSysError *eDest)
    TS_Xeq("role",          xrole);   // Server,  non-dynamic
    TS_Xeq("seclib",        xsecl);   // Server,  non-dynamic
    TS_Xeq("subcluster",    xsubc);   // Manager, non-dynamic
+   TS_Xeq("summary",       xsumm);   // Server,  non-dynamic
    TS_Set("wait",          doWait);  // Server,  non-dynamic (backward compat)
    TS_unSet("nowait",      doWait);  // Server,  non-dynamic
    TS_Xer("whitelist",     xblk,true);//Manager, non-dynamic
@@ -585,6 +587,10 @@ void XrdCmsConfig::DoIt()
 //
    if (isManager || isServer || isPeer) XrdCmsManager::Start(ManList);
 
+// Start forwarding the cache summary if we have one
+//
+   if (isServer && sumPath) XrdCmsSummary::Start(sumPath, sumIntv);
+
 // Start state monitoring thread
 //
    if (XrdSysThread::Run(&tid, XrdCmsStartMonStat, (void *)0,
@@ -708,6 +714,8 @@ void XrdCmsConfig::ConfigDefaults(void)
    ifList    =0;
    perfint  = 3*60;
    perfpgm  = 0;
+   sumPath  = 0;
+   sumIntv  = 30;
    AdminPath= strdup("/tmp/");
    AdminMode= 0700;
    AdminSock= 0;
@@ -2932,6 +2940,55 @@ int XrdCmsConfig::xsubc(XrdSysError *eDest, XrdOucStream &CFile)
 //
    return (XrdCmsUtils::ParseMan(eDest, &SanList, hSpec, hPort) ? 0 : 1);
 }
+
+/******************************************************************************/
+/*                                 x s u m m                                  */
+/******************************************************************************/
+
+/* Function: xsumm
+
+   Purpose:  To parse the directive: summary <path> [every <sec>]
+
+             <path>        the file a caching proxy writes its summary of cached
+                           files to (see pfc.summary).
+             every <sec>   seconds between checks of the file (default 30). The
+                           summary is sent to the managers when it changed and
+                           every ten checks in any case.
+
+   Type: Server only, non-dynamic.
+
+   Output: 0 upon success or !0 upon failure. Ignored by manager.
+*/
+int XrdCmsConfig::xsumm(XrdSysError *eDest, XrdOucStream &CFile)
+{   int   ival = 30;
+    char *path, *val;
+
+    if (!isServer) return CFile.noEcho();
+
+    if (!(val = CFile.GetWord()) || *val != '/')
+       {eDest->Emsg("Config", "summary path not specified or not absolute");
+        return 1;
+       }
+    path = strdup(val);
+
+    while((val = CFile.GetWord()))
+         {if (!strcmp("every", val))
+             {if (!(val = CFile.GetWord()))
+                 {eDest->Emsg("Config", "summary every value not specified");
+                  free(path); return 1;
+                 }
+              if (XrdOuca2x::a2tm(*eDest,"summary every",val,&ival,1))
+                 {free(path); return 1;}
+             }
+             else eDest->Say("Config warning: ignoring invalid summary option '",
+                             val, "'.");
+         }
+
+    if (sumPath) free(sumPath);
+    sumPath = path;
+    sumIntv = ival;
+    return 0;
+}
   
 /******************************************************************************/
 /*                                x t r a c e                                 */
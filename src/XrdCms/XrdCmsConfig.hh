@@ -227,6 +227,7 @@ int  xschedm(char *val, XrdSysError *eDest, XrdOucStream &CFile);
 int  xsecl(XrdSysError *edest, XrdOucStream &CFile);
 int  xspace(XrdSysError *edest, XrdOucStream &CFile);
 int  xsubc(XrdSysError *edest, XrdOucStream &CFile);
+int  xsumm(XrdSysError *edest, XrdOucStream &CFile);
 int  xtrace(XrdSysError *edest, XrdOucStream &CFile);
 
 XrdInet          *NetTCPr;     // Network for supervisors
@@ -247,6 +248,8 @@ int               isServer;
 int               isSolo;
 char             *perfpgm;
 int               perfint;
+char             *sumPath;
+int               sumIntv;
 int               cachelife;
 int               emptylife;
 int               pendplife;
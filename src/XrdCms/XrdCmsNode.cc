@@ -147,6 +147,14 @@ XrdCmsNode::XrdCmsNode(XrdLink *lnkp, const char *theIF, const char *nid,
     ulCount  = 0;
     Manager  = 0;
 
+    sumBits  = 0;
+    sumNBits = 0;
+    sumNHash = 0;
+    sumPend  = 0;
+    sumGen   = 0;
+    sumSize  = 0;
+    sumRcvd  = 0;
+
 // setName() will set the node identification information
 //
    setName(lnkp, theIF, (nid ? port : 0));
@@ -171,6 +179,8 @@ XrdCmsNode::~XrdCmsNode()
    if (Ident) free(Ident);
    if (myNID) free(myNID);
    if (myName)free(myName);
+   if (sumBits) delete [] sumBits;
+   if (sumPend) delete [] sumPend;
 }
 
 /******************************************************************************/
@@ -1626,6 +1636,72 @@ const char *XrdCmsNode::do_Status(XrdCmsRRData &Arg)
    return 0;
 }
 
+/******************************************************************************/
+/*                            d o _ S u m m a r y                             */
+/******************************************************************************/
+
+// Summary requests carry a part of the Bloom filters describing the files a
+// caching server holds. Parts arrive in order on this node's link; once all
+// of them are in, the summary replaces the previous one in the cluster. A
+// part that does not fit the summary being assembled discards it and the
+// server will resend the summary later.
+//
+const char *XrdCmsNode::do_Summary(XrdCmsRRData &Arg)
+{
+   EPNAME("do_Summary")
+   static const int hdrLen = sizeof(CmsSummaryRequest) - sizeof(CmsRRHdr);
+   static const unsigned int maxBits = 64*1024*1024;
+   CmsSummaryRequest sReq;
+   unsigned int Gen, nBits, Offset, pLen;
+   int nHash;
+
+// Summaries are only of use to nodes that select servers for clients
+//
+   if (!Config.asManager() || Arg.Dlen < hdrLen) return 0;
+
+// Extract the fields describing this part (they may be unaligned)
+//
+   memcpy(&sReq.Gen, Arg.Buff, hdrLen);
+   Gen    = ntohl(sReq.Gen);
+   nBits  = ntohl(sReq.nBits);
+   Offset = ntohl(sReq.Offset);
+   nHash  = ntohs(sReq.nHash);
+   pLen   = Arg.Dlen - hdrLen;
+
+   if (nBits < 64 || nBits > maxBits || (nBits & (nBits-1))
+   ||  nHash < 1  || nHash > 16 || Offset + pLen > nBits/4)
+      {Say.Emsg("Node", Name(), "sent an invalid summary.");
+       return 0;
+      }
+
+// A part at offset zero starts a new summary. Any other part must continue
+// the summary being received.
+//
+   if (!Offset)
+      {if (sumPend && sumSize != nBits/4) {delete [] sumPend; sumPend = 0;}
+       if (!sumPend) sumPend = new unsigned char[nBits/4];
+       sumGen = Gen; sumSize = nBits/4; sumRcvd = 0;
+      }
+      else if (!sumPend || Gen != sumGen || sumSize != nBits/4
+           ||  Offset != sumRcvd)
+              {DEBUGR("summary " <<Gen <<" part at " <<Offset <<" ignored");
+               return 0;
+              }
+
+   memcpy(sumPend + Offset, Arg.Buff + hdrLen, pLen);
+   sumRcvd += pLen;
+
+// Install the summary once it is complete
+//
+   if (sumRcvd == sumSize)
+      {DEBUGR("summary " <<Gen <<" installed; " <<nBits <<" bits " <<nHash
+              <<" hashes");
+       Cluster.setSummary(this, sumPend, nBits, nHash);
+       sumPend = 0; sumRcvd = 0;
+      }
+   return 0;
+}
+
 /******************************************************************************/
 /*                              d o _ T r u n c                               */
 /******************************************************************************/
@@ -117,6 +117,7 @@ static void   do_StateDFS(XrdCmsBaseFR *rP, int rc);
 const  char  *do_StatFS(XrdCmsRRData &Arg);
 const  char  *do_Stats(XrdCmsRRData &Arg);
 const  char  *do_Status(XrdCmsRRData &Arg);
+const  char  *do_Summary(XrdCmsRRData &Arg);
 const  char  *do_Trunc(XrdCmsRRData &Arg);
 const  char  *do_Try(XrdCmsRRData &Arg);
 const  char  *do_Update(XrdCmsRRData &Arg);
@@ -269,6 +270,17 @@ char               Shrip;        // Share of requests to skip
 char               Rsvd[2];
 int                Shrin;        // Share intervals used
 
+// The cache summary of the node. The active one is protected by the STMutex,
+// the one being received is only used by the node's protocol thread.
+//
+unsigned char     *sumBits;      // Active summary bit vectors or nil
+int                sumNBits;     // Bits per filter in the active summary
+int                sumNHash;     // Hashes per filter in the active summary
+unsigned char     *sumPend;      // Summary being received or nil
+unsigned int       sumGen;       // Generation of the summary being received
+unsigned int       sumSize;      // Bytes in the summary being received
+unsigned int       sumRcvd;      // Bytes received so far
+
 // The following fields are used to keep the supervisor's free space value
 //
 static XrdSysMutex mlMutex;
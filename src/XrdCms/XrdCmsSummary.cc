@@ -0,0 +1,167 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C m s S u m m a r y . c c                       */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include "XProtocol/YProtocol.hh"
+
+#include "Xrd/XrdScheduler.hh"
+
+#include "XrdCms/XrdCmsConfig.hh"
+#include "XrdCms/XrdCmsManager.hh"
+#include "XrdCms/XrdCmsSummary.hh"
+#include "XrdCms/XrdCmsTrace.hh"
+
+#include "XrdSys/XrdSysError.hh"
+
+using namespace XrdCms;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdCmsSummary::XrdCmsSummary(const char *path, int intv)
+              : XrdJob("summary sender"), sumPath(path), sumIntv(intv),
+                sumTick(0), sumIno(0), sumMtime(0), sumSize(0)
+{}
+
+/******************************************************************************/
+/*                                  D o I t                                   */
+/******************************************************************************/
+  
+void XrdCmsSummary::DoIt()
+{
+   struct stat Stat;
+
+// Send the summary if it was replaced or it is time to resend it
+//
+   if (!stat(sumPath, &Stat))
+      {if (Stat.st_ino != sumIno || Stat.st_mtime != sumMtime
+       ||  Stat.st_size != sumSize || ++sumTick >= RsndTicks)
+          {if (Send())
+              {sumIno = Stat.st_ino; sumMtime = Stat.st_mtime;
+               sumSize = Stat.st_size; sumTick = 0;
+              }
+          }
+      }
+
+// Reschedule ourselves
+//
+   Sched->Schedule((XrdJob *)this, time(0)+sumIntv);
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+  
+void XrdCmsSummary::Start(const char *path, int intv)
+{
+   XrdCmsSummary *sP = new XrdCmsSummary(path, intv);
+
+   Sched->Schedule((XrdJob *)sP);
+}
+
+/******************************************************************************/
+/* Private:                         S e n d                                   */
+/******************************************************************************/
+  
+bool XrdCmsSummary::Send()
+{
+   EPNAME("Summary");
+   static const int hdrLen = sizeof(CmsSummaryRequest) - sizeof(CmsRRHdr);
+   static const off_t maxSize = 16*1024*1024 + 1024;
+   CmsSummaryRequest sReq;
+   struct iovec ioV[2];
+   struct stat Stat;
+   char *buff, *bits;
+   unsigned int Gen, nBits, bLen, pLen, Offset;
+   int fd, nHash, hLen, vers, rc;
+
+// Read the whole summary; it is replaced by rename so we see a complete one
+//
+   if ((fd = open(sumPath, O_RDONLY)) < 0)
+      {Say.Emsg("Summary", errno, "open", sumPath); return false;}
+   if (fstat(fd, &Stat))
+      {Say.Emsg("Summary", errno, "stat", sumPath); close(fd); return false;}
+   if (Stat.st_size > maxSize)
+      {Say.Emsg("Summary", sumPath, "is too large."); close(fd); return false;}
+   buff = new char[Stat.st_size+1];
+   rc = read(fd, buff, Stat.st_size);
+   close(fd);
+   if (rc != Stat.st_size)
+      {Say.Emsg("Summary", (rc < 0 ? errno : EIO), "read", sumPath);
+       delete [] buff;
+       return false;
+      }
+   buff[Stat.st_size] = 0;
+
+// The header is "pfc-summary <vers> <gen> <nbits> <nhash>\n" and is followed
+// by two bit vectors of nbits/8 bytes each.
+//
+   if (sscanf(buff, "pfc-summary %d %u %u %d\n%n", &vers, &Gen, &nBits,
+              &nHash, &hLen) != 4 || vers != 1
+   ||  nBits < 64 || (nBits & (nBits-1)) || nHash < 1
+   ||  Stat.st_size != hLen + (off_t)nBits/4)
+      {Say.Emsg("Summary", sumPath, "has an invalid format.");
+       delete [] buff;
+       return false;
+      }
+   bits = buff + hLen; bLen = nBits/4;
+
+// Send the bit vectors in parts small enough for a single request
+//
+   memset(&sReq, 0, sizeof(sReq));
+   sReq.Hdr.rrCode   = kYR_summary;
+   sReq.Hdr.modifier = kYR_raw;
+   sReq.Gen          = htonl(Gen);
+   sReq.nBits        = htonl(nBits);
+   sReq.nHash        = htons(static_cast<unsigned short>(nHash));
+   ioV[0].iov_base   = (char *)&sReq;
+   ioV[0].iov_len    = sizeof(sReq);
+
+   for (Offset = 0; Offset < bLen; Offset += pLen)
+       {pLen = bLen - Offset;
+        if (pLen > CmsSummaryRequest::MaxPart) pLen = CmsSummaryRequest::MaxPart;
+        sReq.Hdr.datalen = htons(static_cast<unsigned short>(hdrLen + pLen));
+        sReq.Offset      = htonl(Offset);
+        ioV[1].iov_base  = bits + Offset;
+        ioV[1].iov_len   = pLen;
+        XrdCmsManager::Inform("summary", ioV, 2, sizeof(sReq) + pLen);
+       }
+
+   DEBUG("sent summary " <<Gen <<" of " <<nBits <<" bits in "
+         <<(bLen + CmsSummaryRequest::MaxPart - 1)/CmsSummaryRequest::MaxPart
+         <<" parts");
+   delete [] buff;
+   return true;
+}
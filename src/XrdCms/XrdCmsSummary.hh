@@ -0,0 +1,61 @@
+#ifndef __CMS_SUMMARY_H__
+#define __CMS_SUMMARY_H__
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C m s S u m m a r y . h h                       */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <sys/types.h>
+
+#include "Xrd/XrdJob.hh"
+
+// The summary job forwards the cache summary written by a caching proxy on
+// this server (see pfc.summary) to all of our managers. The file is checked
+// every interval and sent when it changed, and also every RsndTicks intervals
+// so that managers that connected in the meantime get it as well.
+//
+class XrdCmsSummary : public XrdJob
+{
+public:
+
+       void DoIt();
+
+static void Start(const char *path, int intv);
+
+            XrdCmsSummary(const char *path, int intv);
+           ~XrdCmsSummary() {}
+
+private:
+
+static const int RsndTicks = 10;
+
+       bool  Send();
+
+const char  *sumPath;
+int          sumIntv;
+int          sumTick;
+ino_t        sumIno;
+time_t       sumMtime;
+off_t        sumSize;
+};
+#endif
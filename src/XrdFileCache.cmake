@@ -19,7 +19,12 @@ add_library(
   XrdFileCache/XrdFileCache.cc              XrdFileCache/XrdFileCache.hh
   XrdFileCache/XrdFileCacheConfiguration.cc
   XrdFileCache/XrdFileCachePurge.cc
+  XrdFileCache/XrdFileCacheTiers.cc
   XrdFileCache/XrdFileCacheFile.cc          XrdFileCache/XrdFileCacheFile.hh
+  XrdFileCache/XrdFileCacheBlockPool.cc     XrdFileCache/XrdFileCacheBlockPool.hh
+  XrdFileCache/XrdFileCachePrefetch.cc      XrdFileCache/XrdFileCachePrefetch.hh
+  XrdFileCache/XrdFileCachePurgeIndex.cc    XrdFileCache/XrdFileCachePurgeIndex.hh
+  XrdFileCache/XrdFileCacheSummary.cc       XrdFileCache/XrdFileCacheSummary.hh
   XrdFileCache/XrdFileCacheVRead.cc
   XrdFileCache/XrdFileCacheStats.hh
   XrdFileCache/XrdFileCacheInfo.cc          XrdFileCache/XrdFileCacheInfo.hh
@@ -47,10 +47,9 @@ void *CacheDirCleanupThread(void* cache_void)
    return NULL;
 }
 
-void *ProcessWriteTaskThread(void* c)
+void *ProcessWriteTaskThread(void* qIdx)
 {
-   Cache *cache = static_cast<Cache*>(c);
-   cache->ProcessWriteTasks();
+   Cache::GetInstance().ProcessWriteTasks((int) (long) qIdx);
    return NULL;
 }
 
@@ -77,11 +76,13 @@ XrdOucCache2 *XrdOucGetCache2(XrdSysLogger *logger,
       err.Emsg("Retrieve", "Error - unable to create a factory.");
       return NULL;
    }
+   if (! factory.StartWriteThreads())
+   {
+      err.Emsg("Retrieve", "Error - unable to start write threads.");
+      return NULL;
+   }
    err.Emsg("Retrieve", "Success - returning a factory.");
 
-   pthread_t tid1;
-   XrdSysThread::Run(&tid1, ProcessWriteTaskThread, (void*)(&factory), 0, "XrdFileCache WriteTasks ");
-
    pthread_t tid2;
    XrdSysThread::Run(&tid2, PrefetchThread, (void*)(&factory), 0, "XrdFileCache Prefetch ");
 
@@ -128,7 +129,14 @@ Cache::Cache() : XrdOucCache(),
    m_trace(0),
    m_traceID("Manager"),
    m_prefetch_condVar(0),
-   m_RAMblocks_used(0)
+   m_RAMblocks_used(0),
+   m_writeQ(0),
+   m_nWriteQ(0),
+   m_active_cond(0),
+   m_closedBlockMapLocks(0),
+   m_closedBlockMapContended(0),
+   m_prefetchNext(0),
+   m_prefetchInFlight(0)
 {
    m_trace = new XrdOucTrace(&m_log);
    // default log level is Warning
@@ -168,75 +176,186 @@ int Cache::isAttached()
    return true;
 }
 
-void Cache::Detach(File* file)
+void Cache::Detach(File* file, IO* io)
 {
    TRACE(Debug, "Cache::Detach() file = " << file);
 
-   std::map<std::string, File*>::iterator it = m_active.find(file->GetLocalPath());
-   assert (it != m_active.end());
-   m_active.erase(it);
+   {
+      XrdSysCondVarHelper lock(m_active_cond);
+      if ( ! file->RemoveIO(io)) return;
+
+      std::map<std::string, File*>::iterator it = m_active.find(file->GetLocalPath());
+      assert (it != m_active.end());
+      m_active.erase(it);
+
+      long long nLocks, nContended;
+      file->GetBlockMapLockStats(nLocks, nContended);
+      m_closedBlockMapLocks     += nLocks;
+      m_closedBlockMapContended += nContended;
+   }
+   m_tierStats[file->GetTier()].AddStat(file->GetStats());
    delete file;
 }
 
+//______________________________________________________________________________
+bool
+Cache::StartWriteThreads()
+{
+   m_nWriteQ = m_configuration.m_wqueue_threads;
+   m_writeQ  = new WriteQ[m_nWriteQ];
+
+   for (int i = 0; i < m_nWriteQ; ++i)
+   {
+      pthread_t tid;
+      if (XrdSysThread::Run(&tid, ProcessWriteTaskThread, (void*)(long) i, 0, "XrdFileCache WriteTasks "))
+      {
+         m_log.Emsg("StartWriteThreads", errno, "start write thread");
+         return false;
+      }
+   }
+   return true;
+}
+
+//______________________________________________________________________________
+Cache::WriteQ&
+Cache::GetWriteQ(Block* b)
+{
+   // Spread the blocks of a file over all queues so that a single hot file
+   // is written by several threads.
+   unsigned long h = (unsigned long) b->m_file / sizeof(void*) +
+                     (unsigned long) (b->m_offset / m_configuration.m_bufferSize);
+   return m_writeQ[h % m_nWriteQ];
+}
+
 //______________________________________________________________________________
 void
 Cache::AddWriteTask(Block* b, bool fromRead)
 {
    TRACE(Dump, "Cache::AddWriteTask() bOff=%ld " <<  b->m_offset);
-   m_writeQ.condVar.Lock();
+   WriteQ &wq = GetWriteQ(b);
+   wq.Lock();
    if (fromRead)
-      m_writeQ.queue.push_back(b);
+      wq.queue.push_back(b);
    else
-      m_writeQ.queue.push_front(b);
-   m_writeQ.size++;
-   m_writeQ.condVar.Signal();
-   m_writeQ.condVar.UnLock();
+      wq.queue.push_front(b);
+   if (++wq.size > wq.maxSize) wq.maxSize = wq.size;
+   wq.condVar.Signal();
+   wq.condVar.UnLock();
 }
 
 //______________________________________________________________________________
 void Cache::RemoveWriteQEntriesFor(File *iFile)
 {
-   m_writeQ.condVar.Lock();
-   std::list<Block*>::iterator i = m_writeQ.queue.begin();
-   while (i != m_writeQ.queue.end())
+   for (int q = 0; q < m_nWriteQ; ++q)
    {
-      if ((*i)->m_file == iFile)
-      {
-         TRACE(Dump, "Cache::Remove entries for " <<  (void*)(*i) << " path " <<  iFile->lPath());
-         std::list<Block*>::iterator j = i++;
-         iFile->BlockRemovedFromWriteQ(*j);
-         m_writeQ.queue.erase(j);
-         --m_writeQ.size;
-      }
-      else
+      WriteQ &wq = m_writeQ[q];
+      wq.Lock();
+      std::list<Block*>::iterator i = wq.queue.begin();
+      while (i != wq.queue.end())
       {
-         ++i;
+         if ((*i)->m_file == iFile)
+         {
+            TRACE(Dump, "Cache::Remove entries for " <<  (void*)(*i) << " path " <<  iFile->lPath());
+            std::list<Block*>::iterator j = i++;
+            iFile->BlockRemovedFromWriteQ(*j);
+            wq.queue.erase(j);
+            --wq.size;
+         }
+         else
+         {
+            ++i;
+         }
       }
+      wq.condVar.UnLock();
    }
-   m_writeQ.condVar.UnLock();
 }
 
 //______________________________________________________________________________
 void
-Cache::ProcessWriteTasks()
+Cache::ProcessWriteTasks(int qIdx)
 {
+   WriteQ &wq = m_writeQ[qIdx];
    while (true)
    {
-      m_writeQ.condVar.Lock();
-      while (m_writeQ.queue.empty())
+      wq.Lock();
+      while (wq.queue.empty())
       {
-         m_writeQ.condVar.Wait();
+         wq.condVar.Wait();
       }
-      Block* block = m_writeQ.queue.front();
-      m_writeQ.queue.pop_front();
-      m_writeQ.size--;
+      Block* block = wq.queue.front();
+      wq.queue.pop_front();
+      wq.size--;
+      wq.nWritten++;
       TRACE(Dump, "Cache::ProcessWriteTasks  for %p " <<  (void*)(block) << " path " << block->m_file->lPath());
-      m_writeQ.condVar.UnLock();
+      wq.condVar.UnLock();
 
       block->m_file->WriteBlockToDisk(block);
    }
 }
 
+//______________________________________________________________________________
+void
+Cache::ReportStats()
+{
+   size_t    depth = 0, maxDepth = 0;
+   long long nWritten = 0, nLocks = 0, nContended = 0;
+
+   for (int q = 0; q < m_nWriteQ; ++q)
+   {
+      WriteQ &wq = m_writeQ[q];
+      wq.Lock();
+      depth      += wq.size;
+      maxDepth    = std::max(maxDepth, wq.maxSize);
+      nWritten   += wq.nWritten;
+      nLocks     += wq.nLocks;
+      nContended += wq.nContended;
+      wq.maxSize  = wq.size;
+      wq.condVar.UnLock();
+   }
+
+   TRACE(Info, "Cache::ReportStats() write queues " << m_nWriteQ << " depth " << depth
+         << " max depth " << maxDepth << " blocks written " << nWritten
+         << " locks " << nLocks << " contended " << nContended);
+
+   long long bmLocks, bmContended;
+   int nFiles;
+   {
+      XrdSysCondVarHelper lock(m_active_cond);
+      bmLocks     = m_closedBlockMapLocks;
+      bmContended = m_closedBlockMapContended;
+      nFiles      = (int) m_active.size();
+      for (std::map<std::string, File*>::iterator it = m_active.begin(); it != m_active.end(); ++it)
+      {
+         if ( ! it->second) continue;
+         long long l, c;
+         it->second->GetBlockMapLockStats(l, c);
+         bmLocks     += l;
+         bmContended += c;
+      }
+   }
+
+   TRACE(Info, "Cache::ReportStats() active files " << nFiles << " block map locks "
+         << bmLocks << " contended " << bmContended);
+
+   BlockPoolStats ps;
+   m_block_pool.GetStats(ps);
+   TRACE(Info, "Cache::ReportStats() block pool free " << ps.m_nFree << "/" << ps.m_nSlots
+         << " allocs " << ps.m_nAlloc << " heap allocs " << ps.m_nAllocHeap
+         << " first touch " << ps.m_nFirstTouch << " minor faults " << ps.m_nMinorFaults
+         << " major faults " << ps.m_nMajorFaults);
+
+   // Hit ratios of detached files; disk hits are split by the tier the data
+   // file was in.
+   const XrdFileCache::Stats &bulk = m_tierStats[0], &fast = m_tierStats[1];
+   long long ram    = bulk.m_BytesRam    + fast.m_BytesRam;
+   long long missed = bulk.m_BytesMissed + fast.m_BytesMissed;
+   long long total  = ram + missed + bulk.m_BytesDisk + fast.m_BytesDisk;
+   double    norm   = total ? 100.0 / total : 0;
+   TRACE(Info, "Cache::ReportStats() bytes read " << total << " hits ram " << ram * norm
+         << "% fast " << fast.m_BytesDisk * norm << "% bulk " << bulk.m_BytesDisk * norm
+         << "% missed " << missed * norm << "%");
+}
+
 //______________________________________________________________________________
 
 bool
@@ -261,29 +380,36 @@ Cache::RAMBlockReleased()
 void
 Cache::AddActive(File* file)
 {
-   XrdSysMutexHelper lock(&m_active_mutex);
+   XrdSysCondVarHelper lock(m_active_cond);
    m_active[file->GetLocalPath()] = file;
+   m_active_cond.Broadcast();
 }
 
 
 File* Cache::GetFileWithLocalPath(std::string path, IO* iIo)
 {
-   XrdSysMutexHelper lock(&m_active_mutex);
+   XrdSysCondVarHelper lock(m_active_cond);
+
+   std::map<std::string, File*>::iterator it;
+   while ((it = m_active.find(path)) != m_active.end() && ! it->second)
+   {
+      m_active_cond.Wait();
+   }
 
-   std::map<std::string, File*>::iterator it = m_active.find(path);
    if (it != m_active.end())
    {
-      it->second->WakeUp(iIo);
+      it->second->AddIO(iIo);
       return it->second;
    }
 
-
+   // The caller opens the file, others wait for it in the loop above.
+   m_active[path] = 0;
    return 0;
 }
 
 bool Cache::HaveActiveFileWithLocalPath(std::string path)
 {
-   XrdSysMutexHelper lock(&m_active_mutex);
+   XrdSysCondVarHelper lock(m_active_cond);
 
    std::map<std::string, File*>::iterator it = m_active.find(path);
 
@@ -341,20 +467,38 @@ Cache::DeRegisterPrefetchFile(File* file)
 
 //______________________________________________________________________________
 
+void
+Cache::PrefetchIssued(long long bytes)
+{
+   m_prefetch_condVar.Lock();
+   m_prefetchInFlight += bytes;
+   m_prefetch_condVar.UnLock();
+}
+
+//______________________________________________________________________________
+
+void
+Cache::PrefetchDone(long long bytes)
+{
+   m_prefetch_condVar.Lock();
+   m_prefetchInFlight -= bytes;
+   m_prefetch_condVar.Signal();
+   m_prefetch_condVar.UnLock();
+}
+
+//______________________________________________________________________________
+
 File*
 Cache::GetNextFileToPrefetch()
 {
    m_prefetch_condVar.Lock();
-   while (m_prefetchList.empty())
+   while (m_prefetchList.empty() || m_prefetchInFlight >= m_configuration.m_prefetch_budget)
    {
       m_prefetch_condVar.Wait();
    }
 
-   //  std::sort(m_prefetchList.begin(), m_prefetchList.end(), myobject);
-
-   size_t l = m_prefetchList.size();
-   int idx = rand() % l;
-   File* f = m_prefetchList[idx];
+   // Serve files round-robin so that all of them have requests in flight.
+   File* f = m_prefetchList[m_prefetchNext++ % m_prefetchList.size()];
 
    m_prefetch_condVar.UnLock();
    return f;
@@ -376,6 +520,15 @@ Cache::Prepare(const char *url, int oflags, mode_t mode)
    std::string curl(url);
    XrdCl::URL xx(curl);
    std::string spath = xx.GetPath();
+
+   // A file that is open, or being opened, by another client will have its
+   // info file by the time this one attaches.
+   if (HaveActiveFileWithLocalPath(spath))
+   {
+      TRACE( Dump, "Cache::Prefetch defer open of active " << spath);
+      return 1;
+   }
+
    spath += ".cinfo";
 
    struct stat buf;
@@ -403,6 +556,18 @@ int Cache::Stat(const char *curl, struct stat &sbuff)
 {
    XrdCl::URL url(curl);
    std::string name = url.GetPath();
+
+   // If another client is opening the file wait for it to create the info
+   // file instead of also going to the origin.
+   {
+      XrdSysCondVarHelper lock(m_active_cond);
+      std::map<std::string, File*>::iterator it;
+      while ((it = m_active.find(name)) != m_active.end() && ! it->second)
+      {
+         m_active_cond.Wait();
+      }
+   }
+
    name += ".cinfo";
 
    if (m_output_fs->Stat(name.c_str(), &sbuff) == XrdOssOK)
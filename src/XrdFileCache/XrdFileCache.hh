@@ -26,6 +26,8 @@
 #include "XrdOuc/XrdOucCallBack.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdFileCacheFile.hh"
+#include "XrdFileCacheBlockPool.hh"
+#include "XrdFileCachePurgeIndex.hh"
 #include "XrdFileCacheDecision.hh"
 
 class XrdOucStream;
@@ -52,13 +54,27 @@ struct Configuration
       m_hdfsmode(false),
       m_data_space("public"),
       m_meta_space("public"),
+      m_fastUsageLWM(-1),
+      m_fastUsageHWM(-1),
+      m_tierHotAccesses(3),
+      m_tierWindow(86400),
       m_diskUsageLWM(-1),
       m_diskUsageHWM(-1),
       m_purgeInterval(300),
+      m_purgePolicy(PurgeIndex::kLRU),
+      m_purgeIndexPath("/.pfc-purge.index"),
+      m_purgeThreads(4),
+      m_purgeRescan(86400),
+      m_summaryBits(1024*1024),
+      m_summaryHashes(4),
       m_bufferSize(1024*1024),
       m_RamAbsAvailable(0),
       m_NRamBuffers(-1),
+      m_hugePages(false),
       m_prefetch_max_blocks(10),
+      m_prefetch_budget(256*1024*1024),
+      m_prefetch_policy("pattern"),
+      m_wqueue_threads(4),
       m_hdfsbsize(128*1024*1024)
    {}
 
@@ -67,15 +83,31 @@ struct Configuration
    std::string m_username;              //!< username passed to oss plugin
    std::string m_data_space;            //!< oss space for data files
    std::string m_meta_space;            //!< oss space for metadata files (cinfo)
+   std::string m_fast_space;            //!< oss space hot data files are moved to, empty if none
+   long long m_fastUsageLWM;            //!< fast space low water mark
+   long long m_fastUsageHWM;            //!< fast space high water mark
+   int       m_tierHotAccesses;         //!< accesses within m_tierWindow that make a file hot
+   int       m_tierWindow;              //!< seconds without access after which a file is demoted
 
    long long m_diskUsageLWM;            //!< cache purge low water mark
    long long m_diskUsageHWM;            //!< cache purge high water mark
    int       m_purgeInterval;           //!< sleep interval between cache purges
+   PurgeIndex::Policy_e m_purgePolicy;  //!< how purge victims are selected
+   std::string m_purgeIndexPath;        //!< lfn of the saved purge index, empty if not saved
+   int       m_purgeThreads;            //!< number of threads scanning the cache namespace
+   int       m_purgeRescan;             //!< seconds between rescans of the cache namespace
+   std::string m_summaryPath;           //!< file the summary for the cmsd is written to, empty if none
+   long long m_summaryBits;             //!< number of bits of each summary filter
+   int       m_summaryHashes;           //!< number of hash functions of the summary filters
 
    long long m_bufferSize;              //!< prefetch buffer size, default 1MB
    long long m_RamAbsAvailable;         //!< available from configuration
    int       m_NRamBuffers;             //!< number of total in-memory cache blocks, cached
+   bool      m_hugePages;               //!< back RAM blocks with transparent huge pages
    size_t    m_prefetch_max_blocks;     //!< maximum number of blocks to prefetch per file
+   long long m_prefetch_budget;         //!< maximum prefetch bytes in flight over all files
+   std::string m_prefetch_policy;       //!< name of the per-file Prefetcher
+   int       m_wqueue_threads;          //!< number of disk write queues, each with its own thread
 
    long long m_hdfsbsize;               //!< used with m_hdfsmode, default 128MB
 };
@@ -84,9 +116,12 @@ struct TmpConfiguration
 {
    std::string m_diskUsageLWM;
    std::string m_diskUsageHWM;
+   std::string m_fastUsageLWM;
+   std::string m_fastUsageHWM;
 
    TmpConfiguration() :
-      m_diskUsageLWM("0.90"), m_diskUsageHWM("0.95")
+      m_diskUsageLWM("0.90"), m_diskUsageHWM("0.95"),
+      m_fastUsageLWM("0.90"), m_fastUsageHWM("0.95")
    {}
 };
 
@@ -160,6 +195,17 @@ public:
    //---------------------------------------------------------------------
    void CacheDirCleanup();
 
+   //---------------------------------------------------------------------
+   //! Move hot files to the fast space and cold ones out of it. Called
+   //! from the purge thread.
+   //---------------------------------------------------------------------
+   void BalanceTiers();
+
+   //---------------------------------------------------------------------
+   //! Storage tier of a data file: 1 if it is in the fast space, else 0.
+   //---------------------------------------------------------------------
+   int GetTier(const std::string &dataPath);
+
    //---------------------------------------------------------------------
    //! Add downloaded block in write queue.
    //---------------------------------------------------------------------
@@ -172,9 +218,20 @@ public:
    void RemoveWriteQEntriesFor(File *f);
 
    //---------------------------------------------------------------------
-   //! Separate task which writes blocks from ram to disk.
+   //! Separate task which writes blocks from ram to disk. There is one
+   //! such task per write queue.
    //---------------------------------------------------------------------
-   void ProcessWriteTasks();
+   void ProcessWriteTasks(int qIdx);
+
+   //---------------------------------------------------------------------
+   //! Start a writer thread for each write queue.
+   //---------------------------------------------------------------------
+   bool StartWriteThreads();
+
+   //---------------------------------------------------------------------
+   //! Log write queue depths and lock contention at Info level.
+   //---------------------------------------------------------------------
+   void ReportStats();
 
    bool RequestRAMBlock();
 
@@ -183,17 +240,29 @@ public:
    void RegisterPrefetchFile(File*);
    void DeRegisterPrefetchFile(File*);
 
+   //! Account for prefetch requests in flight, limited by m_prefetch_budget.
+   void PrefetchIssued(long long bytes);
+   void PrefetchDone(long long bytes);
+
    File* GetNextFileToPrefetch();
 
    void Prefetch();
 
-   //! Decrease attached count. Called from IO::Detach().
-   void Detach(File*);
+   //! Detach io from file, the file is deleted when no IO is left.
+   //! Called from IO::Detach() or IO::ioActive().
+   void Detach(File*, IO*);
 
    XrdOss* GetOss() const { return m_output_fs; }
 
    XrdSysError& GetSysError() { return m_log; }
 
+   //---------------------------------------------------------------------
+   //! Get the active file for path and attach io to it, waiting if the
+   //! file is being opened by another IO. If there is none, returns 0 and
+   //! the caller must create the File and pass it to AddActive(); other
+   //! IOs asking for path wait until then, so each file is opened and each
+   //! of its blocks is requested from the origin only once.
+   //---------------------------------------------------------------------
    File* GetFileWithLocalPath(std::string, IO* io);
 
    bool  HaveActiveFileWithLocalPath(std::string);
@@ -202,8 +271,15 @@ public:
 
    XrdOucTrace* GetTrace() { return m_trace; }
 
+   BlockPool& GetBlockPool() { return m_block_pool; }
+
+   PurgeIndex& GetPurgeIndex() { return m_purgeIndex; }
+
 private:
    bool ConfigParameters(std::string, XrdOucStream&, TmpConfiguration &tmpc);
+   bool ConfigUsage(const char *space, const std::string &lwm, const std::string &hwm,
+                    long long &lwmBytes, long long &hwmBytes);
+   bool MoveToTier(const PurgeIndex::Victim &v, int tier, time_t hotSince);
    bool ConfigXeq(char *, XrdOucStream &);
    bool xdlib(XrdOucStream &);
    bool xtrace(XrdOucStream &);
@@ -227,15 +303,33 @@ private:
    XrdSysMutex m_RAMblock_mutex;              //!< central lock for this class
    int m_RAMblocks_used;
 
+   BlockPool m_block_pool;                    //!< buffers of RAM blocks
+
+   PurgeIndex m_purgeIndex;                   //!< cached files ordered for purging
+
    struct WriteQ
    {
-      WriteQ() : condVar(0), size(0) {}
+      WriteQ() : condVar(0), size(0), maxSize(0), nWritten(0),
+                 nLocks(0), nContended(0) {}
       XrdSysCondVar condVar;                //!< write list condVar
       size_t size;                          //!< cache size of a container
+      size_t maxSize;                       //!< max size since last report
+      long long nWritten;                   //!< blocks written
+      long long nLocks;                     //!< lock acquisitions
+      long long nContended;                 //!< acquisitions that had to wait
       std::list<Block*>     queue;          //!< container
+
+      void Lock()
+      {
+         if ( ! condVar.CondLock()) { condVar.Lock(); ++nContended; }
+         ++nLocks;
+      }
    };
 
-   WriteQ m_writeQ;
+   WriteQ& GetWriteQ(Block *b);
+
+   WriteQ *m_writeQ;                        //!< write queues, one per writer thread
+   int     m_nWriteQ;
 
    struct DiskNetIO
    {
@@ -244,12 +338,17 @@ private:
       File* file;
    };
 
-   std::map<std::string, File*>         m_active;
-   XrdSysMutex m_active_mutex;
+   std::map<std::string, File*>         m_active;   //!< 0 while the file is being opened
+   XrdSysCondVar m_active_cond;
+   long long   m_closedBlockMapLocks;       //!< block map lock stats of detached files
+   long long   m_closedBlockMapContended;
+   XrdFileCache::Stats m_tierStats[2];      //!< read stats of detached files by tier
 
    // prefetching
    typedef std::vector<File*>  PrefetchList;
    PrefetchList m_prefetchList;
+   size_t       m_prefetchNext;             //!< round-robin position in m_prefetchList
+   long long    m_prefetchInFlight;         //!< prefetch bytes requested but not arrived
 };
 
 }
@@ -0,0 +1,145 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "XrdSys/XrdSysError.hh"
+#include "XrdFileCacheBlockPool.hh"
+
+using namespace XrdFileCache;
+
+//______________________________________________________________________________
+
+BlockPool::BlockPool() :
+   m_base(0),
+   m_mapSize(0),
+   m_slotSize(0),
+   m_nSlots(0),
+   m_nTouched(0)
+{}
+
+//______________________________________________________________________________
+
+BlockPool::~BlockPool()
+{
+   if (m_base) munmap(m_base, m_mapSize);
+}
+
+//______________________________________________________________________________
+
+bool BlockPool::Init(long long blockSize, int nBlocks, bool hugePages, XrdSysError &log)
+{
+   const long long pgSize = sysconf(_SC_PAGESIZE);
+
+   m_slotSize = (blockSize + pgSize - 1) / pgSize * pgSize;
+   m_mapSize  = (size_t) m_slotSize * nBlocks;
+
+   // The mapping only reserves address space, pages are faulted in on use.
+   void *addr = mmap(0, m_mapSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+   if (addr == MAP_FAILED)
+   {
+      log.Emsg("BlockPool::Init", errno, "map RAM block pool");
+      m_mapSize = 0;
+      return false;
+   }
+   m_base = (char*) addr;
+
+#ifdef MADV_HUGEPAGE
+   if (hugePages && madvise(m_base, m_mapSize, MADV_HUGEPAGE))
+   {
+      log.Emsg("BlockPool::Init", errno, "enable huge pages for RAM block pool");
+   }
+#endif
+
+   // Push slots in reverse so that the lowest addresses are used first.
+   m_free.reserve(nBlocks);
+   for (int i = nBlocks - 1; i >= 0; --i)
+   {
+      m_free.push_back(m_base + (size_t) i * m_slotSize);
+   }
+   m_nSlots = nBlocks;
+   return true;
+}
+
+//______________________________________________________________________________
+
+char* BlockPool::Alloc(long long size)
+{
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+      if (size <= m_slotSize && ! m_free.empty())
+      {
+         char *buff = m_free.back();
+         m_free.pop_back();
+         ++m_stats.m_nAlloc;
+         if ((buff - m_base) / m_slotSize >= m_nTouched)
+         {
+            ++m_nTouched;
+            ++m_stats.m_nFirstTouch;
+         }
+         return buff;
+      }
+      ++m_stats.m_nAllocHeap;
+   }
+
+   void *buff = 0;
+   if (posix_memalign(&buff, sysconf(_SC_PAGESIZE), size))
+   {
+      return 0;
+   }
+   return (char*) buff;
+}
+
+//______________________________________________________________________________
+
+void BlockPool::Free(char *buff)
+{
+   if (buff >= m_base && buff < m_base + m_mapSize)
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+      m_free.push_back(buff);
+   }
+   else
+   {
+      free(buff);
+   }
+}
+
+//______________________________________________________________________________
+
+void BlockPool::GetStats(BlockPoolStats &stats)
+{
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+      stats          = m_stats;
+      stats.m_nFree  = (int) m_free.size();
+      stats.m_nSlots = m_nSlots;
+   }
+
+   struct rusage ru;
+   if (getrusage(RUSAGE_SELF, &ru) == 0)
+   {
+      stats.m_nMinorFaults = ru.ru_minflt;
+      stats.m_nMajorFaults = ru.ru_majflt;
+   }
+}
@@ -0,0 +1,86 @@
+#ifndef __XRDFILECACHE_BLOCKPOOL_HH__
+#define __XRDFILECACHE_BLOCKPOOL_HH__
+
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <vector>
+
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdFileCacheStats.hh"
+
+class XrdSysError;
+
+namespace XrdFileCache
+{
+//----------------------------------------------------------------------------
+//! Pool of page aligned RAM block buffers shared by all files.
+//!
+//! The pool reserves one anonymous mapping large enough for all RAM blocks.
+//! Pages are faulted in when a slot is first used and stay resident when a
+//! buffer is returned, so a recycled slot costs neither malloc nor page
+//! faults. Free slots are reused last-in first-out to keep the set of
+//! touched pages small. Buffers larger than a slot, or requested when all
+//! slots are in use, are allocated from the heap with the same alignment.
+//----------------------------------------------------------------------------
+class BlockPool
+{
+public:
+   BlockPool();
+   ~BlockPool();
+
+   //---------------------------------------------------------------------
+   //! Reserve the pool.
+   //!
+   //! @param blockSize   size of one slot, rounded up to the page size
+   //! @param nBlocks     number of slots
+   //! @param hugePages   ask for transparent huge pages for the mapping
+   //! @param log         error logger
+   //!
+   //! @return false if the mapping could not be created
+   //---------------------------------------------------------------------
+   bool Init(long long blockSize, int nBlocks, bool hugePages, XrdSysError &log);
+
+   //---------------------------------------------------------------------
+   //! Get a page aligned buffer of at least size bytes.
+   //---------------------------------------------------------------------
+   char* Alloc(long long size);
+
+   //---------------------------------------------------------------------
+   //! Return a buffer obtained with Alloc().
+   //---------------------------------------------------------------------
+   void  Free(char *buff);
+
+   //---------------------------------------------------------------------
+   //! Fill pool statistics, including page faults of the process.
+   //---------------------------------------------------------------------
+   void  GetStats(BlockPoolStats &stats);
+
+private:
+   XrdSysMutex         m_mutex;
+   char               *m_base;         //!< start of the mapping
+   size_t              m_mapSize;      //!< size of the mapping
+   long long           m_slotSize;     //!< bytes per slot
+   std::vector<char*>  m_free;         //!< free slots, used as a stack
+   int                 m_nSlots;
+   int                 m_nTouched;     //!< slots handed out at least once
+   BlockPoolStats      m_stats;
+};
+}
+
+#endif
@@ -179,42 +179,30 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
    Config.Close();
 
    // sets default value for disk usage
+   if ( ! ConfigUsage(m_configuration.m_data_space.c_str(), tmpc.m_diskUsageLWM, tmpc.m_diskUsageHWM,
+                      m_configuration.m_diskUsageLWM, m_configuration.m_diskUsageHWM))
    {
-      XrdOssVSInfo sP;
-      if (m_output_fs->StatVS(&sP, m_configuration.m_data_space.c_str(), 1) < 0)
+      return false;
+   }
+
+   if ( ! m_configuration.m_fast_space.empty())
+   {
+      if (m_configuration.m_fast_space == m_configuration.m_data_space)
       {
-         m_log.Emsg("Cache::ConfigParameters() error obtaining stat info for space ", m_configuration.m_data_space.c_str());
+         m_log.Emsg("Cache::ConfigParameters() fast space must differ from data space ", m_configuration.m_fast_space.c_str());
          return false;
       }
-
-      if (::isalpha(*(tmpc.m_diskUsageLWM.rbegin())) && ::isalpha(*(tmpc.m_diskUsageHWM.rbegin())))
+      if ( ! ConfigUsage(m_configuration.m_fast_space.c_str(), tmpc.m_fastUsageLWM, tmpc.m_fastUsageHWM,
+                         m_configuration.m_fastUsageLWM, m_configuration.m_fastUsageHWM))
       {
-         if (XrdOuca2x::a2sz(m_log, "Error getting disk usage low watermark",  tmpc.m_diskUsageLWM.c_str(), &m_configuration.m_diskUsageLWM, 0, sP.Total) ||
-             XrdOuca2x::a2sz(m_log, "Error getting disk usage high watermark", tmpc.m_diskUsageHWM.c_str(), &m_configuration.m_diskUsageHWM, 0, sP.Total))
-         {
-            return false;
-         }
+         return false;
       }
-      else
-      {
-         char* eP;
-         errno = 0;
-         double lwmf = strtod(tmpc.m_diskUsageLWM.c_str(), &eP);
-         if (errno || eP == tmpc.m_diskUsageLWM.c_str())
-         {
-            m_log.Emsg("Cache::ConfigParameters() error parsing diskusage parameter ", tmpc.m_diskUsageLWM.c_str());
-            return false;
-         }
-         double hwmf = strtod(tmpc.m_diskUsageHWM.c_str(), &eP);
-         if (errno || eP == tmpc.m_diskUsageHWM.c_str())
-         {
-            m_log.Emsg("Cache::ConfigParameters() error parsing diskusage parameter ", tmpc.m_diskUsageHWM.c_str());
-            return false;
-         }
+   }
 
-         m_configuration.m_diskUsageLWM = static_cast<long long>(sP.Total * lwmf + 0.5);
-         m_configuration.m_diskUsageHWM = static_cast<long long>(sP.Total * hwmf + 0.5);
-      }
+   if ( ! m_configuration.m_summaryPath.empty())
+   {
+      m_purgeIndex.EnableSummary(m_configuration.m_summaryBits, m_configuration.m_summaryHashes,
+                                 m_configuration.m_hdfsmode);
    }
 
    // get number of available RAM blocks after process configuration
@@ -227,6 +215,12 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
    }
    m_configuration.m_NRamBuffers = static_cast<int>(m_configuration.m_RamAbsAvailable/ m_configuration.m_bufferSize);
 
+   if (retval && ! m_block_pool.Init(m_configuration.m_bufferSize, m_configuration.m_NRamBuffers,
+                                     m_configuration.m_hugePages, m_log))
+   {
+      retval = false;
+   }
+
    // Set tracing to debug if this is set in environment
    char* cenv = getenv("XRDDEBUG");
    if (cenv && ! strcmp(cenv,"1")) m_trace->What = 4;
@@ -238,20 +232,40 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
       float rg =  (m_configuration.m_RamAbsAvailable)/float(1024*1024*1024);
       loff = snprintf(buff, sizeof(buff), "Config effective %s pfc configuration:\n"
                       "       pfc.blocksize %lld\n"
-                      "       pfc.prefetch %zu\n"
-                      "       pfc.ram %.fg\n"
+                      "       pfc.prefetch %zu budget %lld policy %s\n"
+                      "       pfc.ram %.fg%s\n"
                       "       pfc.diskusage %lld %lld sleep %d\n"
+                      "       pfc.purge policy %s index %s threads %d rescan %d\n"
+                      "       pfc.summary %s bits %lld hashes %d\n"
                       "       pfc.spaces %s %s\n"
+                      "       pfc.fastspace %s hot %d window %d usage %lld %lld\n"
+                      "       pfc.writequeue %d\n"
                       "       pfc.trace %d",
                       config_filename,
                       m_configuration.m_bufferSize,
                       m_configuration.m_prefetch_max_blocks,
+                      m_configuration.m_prefetch_budget,
+                      m_configuration.m_prefetch_policy.c_str(),
                       rg,
+                      m_configuration.m_hugePages ? " hugepages" : "",
                       m_configuration.m_diskUsageLWM,
                       m_configuration.m_diskUsageHWM,
                       m_configuration.m_purgeInterval,
+                      PurgeIndex::PolicyName(m_configuration.m_purgePolicy),
+                      m_configuration.m_purgeIndexPath.empty() ? "off" : m_configuration.m_purgeIndexPath.c_str(),
+                      m_configuration.m_purgeThreads,
+                      m_configuration.m_purgeRescan,
+                      m_configuration.m_summaryPath.empty() ? "off" : m_configuration.m_summaryPath.c_str(),
+                      m_configuration.m_summaryBits,
+                      m_configuration.m_summaryHashes,
                       m_configuration.m_data_space.c_str(),
                       m_configuration.m_meta_space.c_str(),
+                      m_configuration.m_fast_space.empty() ? "none" : m_configuration.m_fast_space.c_str(),
+                      m_configuration.m_tierHotAccesses,
+                      m_configuration.m_tierWindow,
+                      m_configuration.m_fastUsageLWM,
+                      m_configuration.m_fastUsageHWM,
+                      m_configuration.m_wqueue_threads,
                       m_trace->What);
 
       if (m_configuration.m_hdfsmode)
@@ -285,6 +299,50 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
 
 //______________________________________________________________________________
 
+bool Cache::ConfigUsage(const char *space, const std::string &lwm, const std::string &hwm,
+                        long long &lwmBytes, long long &hwmBytes)
+{
+   // Converts usage boundaries given as fractions or sizes to bytes of the space.
+   XrdOssVSInfo sP;
+   if (m_output_fs->StatVS(&sP, space, 1) < 0)
+   {
+      m_log.Emsg("Cache::ConfigParameters() error obtaining stat info for space ", space);
+      return false;
+   }
+
+   if (::isalpha(*(lwm.rbegin())) && ::isalpha(*(hwm.rbegin())))
+   {
+      if (XrdOuca2x::a2sz(m_log, "Error getting disk usage low watermark",  lwm.c_str(), &lwmBytes, 0, sP.Total) ||
+          XrdOuca2x::a2sz(m_log, "Error getting disk usage high watermark", hwm.c_str(), &hwmBytes, 0, sP.Total))
+      {
+         return false;
+      }
+   }
+   else
+   {
+      char* eP;
+      errno = 0;
+      double lwmf = strtod(lwm.c_str(), &eP);
+      if (errno || eP == lwm.c_str())
+      {
+         m_log.Emsg("Cache::ConfigParameters() error parsing diskusage parameter ", lwm.c_str());
+         return false;
+      }
+      double hwmf = strtod(hwm.c_str(), &eP);
+      if (errno || eP == hwm.c_str())
+      {
+         m_log.Emsg("Cache::ConfigParameters() error parsing diskusage parameter ", hwm.c_str());
+         return false;
+      }
+
+      lwmBytes = static_cast<long long>(sP.Total * lwmf + 0.5);
+      hwmBytes = static_cast<long long>(sP.Total * hwmf + 0.5);
+   }
+   return true;
+}
+
+//______________________________________________________________________________
+
 
 bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfiguration &tmpc)
 {
@@ -313,6 +371,84 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
          }
       }
    }
+   else if ( part == "purge" )
+   {
+      const char *p;
+      while ((p = config.GetWord()))
+      {
+         if ( ! strcmp(p, "policy"))
+         {
+            p = config.GetWord();
+            if ( ! p || ! PurgeIndex::ParsePolicy(p, m_configuration.m_purgePolicy))
+            {
+               m_log.Emsg("Config", "Error: unknown purge policy", p ? p : "");
+               return false;
+            }
+         }
+         else if ( ! strcmp(p, "index"))
+         {
+            p = config.GetWord();
+            if ( ! p || (strcmp(p, "off") && *p != '/'))
+            {
+               m_log.Emsg("Config", "Error: purge index requires an absolute path or off");
+               return false;
+            }
+            m_configuration.m_purgeIndexPath = strcmp(p, "off") ? p : "";
+         }
+         else if ( ! strcmp(p, "threads"))
+         {
+            if (XrdOuca2x::a2i(m_log, "Error getting number of purge threads", config.GetWord(), &m_configuration.m_purgeThreads, 1, 64))
+            {
+               return false;
+            }
+         }
+         else if ( ! strcmp(p, "rescan"))
+         {
+            if (XrdOuca2x::a2tm(m_log, "Error getting purge rescan interval", config.GetWord(), &m_configuration.m_purgeRescan, 60))
+            {
+               return false;
+            }
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: unknown pfc.purge option", p);
+            return false;
+         }
+      }
+   }
+   else if ( part == "summary" )
+   {
+      const char *p = config.GetWord();
+      if ( ! p || (strcmp(p, "off") && *p != '/'))
+      {
+         m_log.Emsg("Config", "Error: summary requires an absolute path or off");
+         return false;
+      }
+      m_configuration.m_summaryPath = strcmp(p, "off") ? p : "";
+
+      while ((p = config.GetWord()))
+      {
+         if ( ! strcmp(p, "bits"))
+         {
+            if (XrdOuca2x::a2sz(m_log, "Error getting summary bits", config.GetWord(), &m_configuration.m_summaryBits, 1024, 64*1024*1024))
+            {
+               return false;
+            }
+         }
+         else if ( ! strcmp(p, "hashes"))
+         {
+            if (XrdOuca2x::a2i(m_log, "Error getting summary hashes", config.GetWord(), &m_configuration.m_summaryHashes, 1, 16))
+            {
+               return false;
+            }
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: unknown pfc.summary option", p);
+            return false;
+         }
+      }
+   }
    else if  ( part == "blocksize" )
    {
       long long minBSize = 64 * 1024;
@@ -349,6 +485,34 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
          m_log.Emsg("Config", "Error setting prefetch level.");
          return false;
       }
+
+      while ((params = config.GetWord()))
+      {
+         if ( ! strcmp(params, "budget"))
+         {
+            if (XrdOuca2x::a2sz(m_log, "get prefetch budget", config.GetWord(), &m_configuration.m_prefetch_budget, 1024*1024))
+            {
+               return false;
+            }
+         }
+         else if ( ! strcmp(params, "policy"))
+         {
+            params = config.GetWord();
+            Prefetcher *pf = params ? Prefetcher::Create(params) : 0;
+            if ( ! pf)
+            {
+               m_log.Emsg("Config", "Error: unknown prefetch policy", params ? params : "");
+               return false;
+            }
+            delete pf;
+            m_configuration.m_prefetch_policy = params;
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: unknown pfc.prefetch option", params);
+            return false;
+         }
+      }
    }
    else if ( part == "nramread" )
    {
@@ -363,6 +527,23 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
       {
          return false;
       }
+      const char *p = config.GetWord();
+      if (p)
+      {
+         if (strcmp(p, "hugepages"))
+         {
+            m_log.Emsg("Config", "Error: unknown pfc.ram option", p);
+            return false;
+         }
+         m_configuration.m_hugePages = true;
+      }
+   }
+   else if ( part == "writequeue" )
+   {
+      if (XrdOuca2x::a2i(m_log, "Error getting number of write queues", config.GetWord(), &m_configuration.m_wqueue_threads, 1, 64))
+      {
+         return false;
+      }
    }
    else if ( part == "spaces" )
    {
@@ -377,6 +558,50 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
          return false;
       }
    }
+   else if ( part == "fastspace" )
+   {
+      const char *p = config.GetWord();
+      if ( ! p)
+      {
+         m_log.Emsg("Config", "fastspace requires a space name.");
+         return false;
+      }
+      m_configuration.m_fast_space = p;
+      while ((p = config.GetWord()))
+      {
+         if ( ! strcmp(p, "hot"))
+         {
+            if (XrdOuca2x::a2i(m_log, "Error getting number of accesses of hot files", config.GetWord(), &m_configuration.m_tierHotAccesses, 1))
+            {
+               return false;
+            }
+         }
+         else if ( ! strcmp(p, "window"))
+         {
+            if (XrdOuca2x::a2tm(m_log, "Error getting fast space window", config.GetWord(), &m_configuration.m_tierWindow, 60))
+            {
+               return false;
+            }
+         }
+         else if ( ! strcmp(p, "usage"))
+         {
+            const char *lwm = config.GetWord();
+            if (lwm) tmpc.m_fastUsageLWM = lwm;
+            const char *hwm = lwm ? config.GetWord() : 0;
+            if ( ! hwm)
+            {
+               m_log.Emsg("Config", "Error: fastspace usage requires <low> <high>");
+               return false;
+            }
+            tmpc.m_fastUsageHWM = hwm;
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: unknown pfc.fastspace option", p);
+            return false;
+         }
+      }
+   }
    else if ( part == "hdfsmode" || part == "filefragmentmode" )
    {
       if (part == "filefragmentmode")
@@ -24,6 +24,7 @@
 #include <sstream>
 #include <fcntl.h>
 #include <assert.h>
+#include <new>
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdCl/XrdClFile.hh"
@@ -69,11 +70,38 @@ Cache* cache() { return &Cache::GetInstance(); }
 
 const char *File::m_traceID = "File";
 
+const int   File::s_prefetchBatch     = 4;
+const int   File::s_prefetchMinReads  = 64;
+const float File::s_prefetchMinScore  = 0.1;
+const int   File::s_vreadDiskParts    = 4;
+const int   File::s_vreadDiskMinPart  = 256 * 1024;
+
+//------------------------------------------------------------------------------
+
+Block::Block(File *f, long long off, int size, bool prefetch) :
+   m_buff(cache()->GetBlockPool().Alloc(size)), m_size(size),
+   m_offset(off), m_file(f), m_io(0), m_prefetch(prefetch), m_refcnt(0),
+   m_errno(0), m_downloaded(false)
+{
+   if ( ! m_buff) throw std::bad_alloc();
+}
+
+Block::~Block()
+{
+   if (m_buff) cache()->GetBlockPool().Free(m_buff);
+}
+
+void Block::set_error_and_free(int err)
+{
+   m_errno = err;
+   cache()->GetBlockPool().Free(m_buff);
+   m_buff = 0;
+}
+
 //------------------------------------------------------------------------------
 
 File::File(IO *io, std::string& disk_file_path, long long iOffset, long long iFileSize) :
    m_is_open(false),
-   m_io(io),
    m_output(0),
    m_infoFile(0),
    m_cfi(Cache::GetInstance().GetTrace(), Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks > 0),
@@ -84,12 +112,17 @@ File::File(IO *io, std::string& disk_file_path, long long iOffset, long long iFi
    m_non_flushed_cnt(0),
    m_in_sync(false),
    m_downloadCond(0),
+   m_nBlocks(0),
    m_prefetchState(kOff),
    m_prefetchReadCnt(0),
    m_prefetchHitCnt(0),
    m_prefetchScore(1),
-   m_detachTimeIsLogged(false)
+   m_prefetcher(Prefetcher::Create(Cache::GetInstance().RefConfiguration().m_prefetch_policy)),
+   m_detachTimeIsLogged(false),
+   m_tier(0)
 {
+   m_io_map[io] = IODetails();
+   m_current_io = m_io_map.begin();
    Open();
 }
 
@@ -114,6 +147,8 @@ File::~File()
    delete m_syncer;
    m_syncer = NULL;
 
+   delete m_prefetcher;
+
    TRACEF(Debug, "File::~File() ended, prefetch score = " <<  m_prefetchScore);
 }
 
@@ -121,43 +156,57 @@ File::~File()
 
 void File::BlockRemovedFromWriteQ(Block* b)
 {
-   m_downloadCond.Lock();
-   dec_ref_count(b);
    TRACEF(Dump, "File::BlockRemovedFromWriteQ() check write queues block = "
           << (void*)b << " idx= " << b->m_offset/m_cfi.GetBufferSize());
-   m_downloadCond.UnLock();
+   release_block(b);
 }
 
 //------------------------------------------------------------------------------
 
-bool File::ioActive()
+bool File::ioActive(IO *io)
 {
    // Retruns true if delay is needed
 
    TRACEF(Debug, "File::ioActive start");
-   bool blockMapEmpty = false;
+   bool blockMapEmpty = true;
    {
       XrdSysCondVarHelper _lck(m_downloadCond);
       if (! m_is_open) return false;
 
+      // If other IOs stay attached the file remains open for them; only
+      // wait for the requests issued through this one.
+      IoMap_i mi = m_io_map.find(io);
+      if (mi != m_io_map.end())
+      {
+         mi->second.m_detaching = true;
+         bool othersActive = false;
+         for (IoMap_i i = m_io_map.begin(); i != m_io_map.end(); ++i)
+         {
+            if ( ! i->second.m_detaching) { othersActive = true; break; }
+         }
+         if (othersActive)
+         {
+            TRACEF(Debug, "File::ioActive other IOs attached, in flight " << mi->second.m_nInFlight);
+            return mi->second.m_nInFlight > 0;
+         }
+      }
+
       if (m_prefetchState != kStopped)
       {
          m_prefetchState = kStopped;
          cache()->DeRegisterPrefetchFile(this);
       }
 
+      TRACEF(Info, "ioActive block_map.size() = " << m_nBlocks);
+   }
 
-      // High debug print
-      // for (BlockMap_i it = m_block_map.begin(); it != m_block_map.end(); ++it)
-      // {
-      //    Block* b = it->second;
-      //    TRACEF(Dump, "File::ioActive block idx = " <<  b->m_offset/m_cfi.GetBufferSize() << " prefetch = " << b->prefetch <<  " refcnt " << b->refcnt);
-      // }
-      TRACEF(Info, "ioActive block_map.size() = " << m_block_map.size());
-
-      // remove failed blocks and check if map is empty
-      BlockMap_i itr = m_block_map.begin();
-      while (itr != m_block_map.end())
+   // remove failed blocks and check if map is empty
+   for (int s = 0; s < s_nBlockShards; ++s)
+   {
+      BlockShard &shd = m_shards[s];
+      lock_shard(shd);
+      BlockMap_i itr = shd.m_map.begin();
+      while (itr != shd.m_map.end())
       {
          if (itr->second->is_failed() && itr->second->m_refcnt == 1)
          {
@@ -171,8 +220,8 @@ bool File::ioActive()
             ++itr;
          }
       }
-
-      blockMapEmpty =  m_block_map.empty();
+      if ( ! shd.m_map.empty()) blockMapEmpty = false;
+      shd.m_cond.UnLock();
    }
    
    if (blockMapEmpty)
@@ -191,6 +240,11 @@ bool File::ioActive()
             {
                m_cfi.WriteIOStatDetach(m_stats);
                m_detachTimeIsLogged = true;
+               // The data file may have been moved to another tier while open.
+               m_tier = cache()->GetTier(m_temp_filename);
+               cache()->GetPurgeIndex().Update(m_temp_filename + Info::m_infoExtension, time(0),
+                                               m_cfi.GetNDownloadedBytes(), m_cfi.GetAccessCnt(), m_tier,
+                                               m_cfi.IsComplete());
                schedule_sync = true;
             }
          }
@@ -219,14 +273,70 @@ bool File::ioActive()
 
 //------------------------------------------------------------------------------
 
-void File::WakeUp(IO *io)
+void File::AddIO(IO *io)
 {
-   // called if this object is recycled by other IO
+   // Called when another client opens the file while it is active. If all
+   // previous IOs were detaching, prefetching was stopped; resume it.
+   bool resume = false;
    m_downloadCond.Lock();
-   m_io->RelinquishFile(this);
-   m_io = io;
-   if (m_prefetchState != kComplete) m_prefetchState = kOn;
+   bool allDetaching = true;
+   for (IoMap_i i = m_io_map.begin(); i != m_io_map.end(); ++i)
+   {
+      if ( ! i->second.m_detaching) { allDetaching = false; break; }
+   }
+   m_io_map[io] = IODetails();
+   if (allDetaching && m_prefetchState == kStopped && m_is_open && ! m_cfi.IsComplete())
+   {
+      m_prefetchState = kOn;
+      resume = true;
+   }
    m_downloadCond.UnLock();
+
+   if (resume) cache()->RegisterPrefetchFile(this);
+}
+
+//------------------------------------------------------------------------------
+
+bool File::RemoveIO(IO *io)
+{
+   XrdSysCondVarHelper _lck(m_downloadCond);
+   IoMap_i mi = m_io_map.find(io);
+   if (mi != m_io_map.end())
+   {
+      if (m_current_io == mi) ++m_current_io;
+      m_io_map.erase(mi);
+   }
+   return m_io_map.empty();
+}
+
+//------------------------------------------------------------------------------
+
+IO* File::GetPrefetchIO()
+{
+   // Must be called w/ m_downloadCond locked. Picks attached IOs in turn and
+   // reserves one request on the chosen one so it is not detached before
+   // the requests are issued; the caller releases it with RequestsDone().
+   for (size_t n = 0; n < m_io_map.size(); ++n, ++m_current_io)
+   {
+      if (m_current_io == m_io_map.end()) m_current_io = m_io_map.begin();
+      if ( ! m_current_io->second.m_detaching)
+      {
+         IO *io = m_current_io->first;
+         ++m_current_io->second.m_nInFlight;
+         ++m_current_io;
+         return io;
+      }
+   }
+   return 0;
+}
+
+//------------------------------------------------------------------------------
+
+void File::RequestsDone(IO *io, int n)
+{
+   XrdSysCondVarHelper _lck(m_downloadCond);
+   IoMap_i mi = m_io_map.find(io);
+   if (mi != m_io_map.end()) mi->second.m_nInFlight -= n;
 }
 
 //------------------------------------------------------------------------------
@@ -300,6 +410,9 @@ bool File::Open()
    }
 
    m_cfi.WriteIOStatAttach();
+   m_tier = cache()->GetTier(m_temp_filename);
+   cache()->GetPurgeIndex().Update(ifn, time(0), m_cfi.GetNDownloadedBytes(), m_cfi.GetAccessCnt(), m_tier,
+                                   m_cfi.IsComplete());
    m_downloadCond.Lock();
    m_is_open = true;
    m_prefetchState = (m_cfi.IsComplete()) ? kComplete : kOn;
@@ -349,7 +462,7 @@ bool File::overlap(int blk,            // block to query
 
 Block* File::PrepareBlockRequest(int i, bool prefetch)
 {
-   // Must be called w/ block_map locked.
+   // Must be called w/ the shard of block i locked.
    // Checks on size etc should be done before.
    //
    // Reference count is 0 so increase it in calling function if you want to
@@ -363,12 +476,14 @@ Block* File::PrepareBlockRequest(int i, bool prefetch)
 
    Block *b = new Block(this, off, this_bs, prefetch); // should block be reused to avoid recreation
 
-   m_block_map[i] = b;
+   shard(i).m_map[i] = b;
 
    // Actual Read request is issued in ProcessBlockRequests().
    TRACEF(Dump, "File::PrepareBlockRequest() " <<  i << "prefetch" <<  prefetch << "address " << (void*)b);
 
-   if (m_prefetchState == kOn && m_block_map.size() > Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks)
+   XrdSysCondVarHelper _lck(m_downloadCond);
+   ++m_nBlocks;
+   if (m_prefetchState == kOn && m_nBlocks > Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks)
    {
       m_prefetchState = kHold;
       cache()->DeRegisterPrefetchFile(this);
@@ -377,21 +492,29 @@ Block* File::PrepareBlockRequest(int i, bool prefetch)
    return b;
 }
 
-void File::ProcessBlockRequests(BlockList_t& blks)
+void File::ProcessBlockRequests(BlockList_t& blks, IO *io)
 {
-   // This *must not* be called with block_map locked.
+   // This *must not* be called with a shard locked.
+
+   if (blks.empty()) return;
+
+   // Count the requests before issuing them as responses can come at once.
+   m_downloadCond.Lock();
+   m_io_map[io].m_nInFlight += blks.size();
+   m_downloadCond.UnLock();
 
    for (BlockList_i bi = blks.begin(); bi != blks.end(); ++bi)
    {
       Block *b = *bi;
+      b->m_io = io;
       BlockResponseHandler* oucCB = new BlockResponseHandler(b);
-      m_io->GetInput()->Read(*oucCB, b->get_buff(), b->get_offset(), b->get_size());
+      io->GetInput()->Read(*oucCB, b->get_buff(), b->get_offset(), b->get_size());
    }
 }
 
 //------------------------------------------------------------------------------
 
-int File::RequestBlocksDirect(DirectResponseHandler *handler, IntList_t& blocks,
+int File::RequestBlocksDirect(IO *io, DirectResponseHandler *handler, IntList_t& blocks,
                               char* req_buf, long long req_off, long long req_size)
 {
    const long long BS = m_cfi.GetBufferSize();
@@ -409,7 +532,7 @@ int File::RequestBlocksDirect(DirectResponseHandler *handler, IntList_t& blocks,
 
       overlap(*ii, BS, req_off, req_size, off, blk_off, size);
 
-      m_io->GetInput()->Read( *handler, req_buf + off, *ii * BS + blk_off, size);
+      io->GetInput()->Read( *handler, req_buf + off, *ii * BS + blk_off, size);
       TRACEF(Dump, "RequestBlockDirect success, idx = " <<  *ii << " size = " <<  size);
 
       total += size;
@@ -463,11 +586,11 @@ int File::ReadBlocksFromDisk(std::list<int>& blocks,
 
 //------------------------------------------------------------------------------
 
-int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
+int File::Read(IO *io, char* iUserBuff, long long iUserOff, int iUserSize)
 {
    if ( ! isOpen())
    {
-      return m_io->GetInput()->Read(iUserBuff, iUserOff, iUserSize);
+      return io->GetInput()->Read(iUserBuff, iUserOff, iUserSize);
    }
 
    const long long BS = m_cfi.GetBufferSize();
@@ -484,8 +607,6 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
    BlockList_t blks;
    bool preProcOK = true;
 
-   m_downloadCond.Lock();
-
    const int idx_first = iUserOff / BS;
    const int idx_last  = (iUserOff + iUserSize - 1) / BS;
 
@@ -495,10 +616,12 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
    for (int block_idx = idx_first; block_idx <= idx_last; ++block_idx)
    {
       TRACEF(Dump, "File::Read() idx " << block_idx);
-      BlockMap_i bi = m_block_map.find(block_idx);
+      BlockShard &shd = shard(block_idx);
+      lock_shard(shd);
+      BlockMap_i bi = shd.m_map.find(block_idx);
 
       // In RAM or incoming?
-      if (bi != m_block_map.end())
+      if (bi != shd.m_map.end())
       {
          inc_ref_count(bi->second);
          TRACEF(Dump, "File::Read() " << iUserBuff << "inc_ref_count for existing block << " << bi->second << " idx = " <<  block_idx);
@@ -520,6 +643,7 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
             Block *b = PrepareBlockRequest(block_idx, false);
             if ( ! b)
             {
+               shd.m_cond.UnLock();
                preProcOK = false;
                break;
             }
@@ -534,18 +658,17 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
             blks_direct.push_back(block_idx);
          }
       }
+      shd.m_cond.UnLock();
    }
 
-   m_downloadCond.UnLock();
-
    if ( ! preProcOK)
    {
       for (BlockList_i i = blks_to_process.begin(); i != blks_to_process.end(); ++i)
-         dec_ref_count(*i);
+         release_block(*i);
       return -1;
    }
 
-   ProcessBlockRequests(blks_to_request);
+   ProcessBlockRequests(blks_to_request, io);
 
    long long bytes_read = 0;
 
@@ -558,12 +681,12 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
    {
       direct_handler = new DirectResponseHandler(blks_direct.size());
 
-      direct_size = RequestBlocksDirect(direct_handler, blks_direct, iUserBuff, iUserOff, iUserSize);
+      direct_size = RequestBlocksDirect(io, direct_handler, blks_direct, iUserBuff, iUserOff, iUserSize);
       // failed to send direct client request
       if (direct_size < 0)
       {
          for (BlockList_i i = blks_to_process.begin(); i!= blks_to_process.end(); ++i )
-            dec_ref_count(*i);
+            release_block(*i);
          delete direct_handler;
          return -1;
       }
@@ -594,12 +717,10 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
       BlockList_t finished;
 
       {
-         XrdSysCondVarHelper _lck(m_downloadCond);
-
          BlockList_i bi = blks_to_process.begin();
          while (bi != blks_to_process.end())
          {
-            if ((*bi)->is_finished())
+            if (block_finished(*bi))
             {
                TRACEF(Dump, "File::Read() requested block downloaded " << (void*)(*bi));
                finished.push_back(*bi);
@@ -614,7 +735,7 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
 
          if (finished.empty())
          {
-            m_downloadCond.Wait();
+            wait_for_block(blks_to_process.front());
             continue;
          }
       }
@@ -681,17 +802,17 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
 
    // Last, stamp and release blocks, release file.
    {
-      XrdSysCondVarHelper _lck(m_downloadCond);
-
       // blks_to_process can be non-empty, if we're exiting with an error.
       std::copy(blks_to_process.begin(), blks_to_process.end(), std::back_inserter(blks_processed));
 
       for (BlockList_i bi = blks_processed.begin(); bi != blks_processed.end(); ++bi)
       {
          TRACEF(Dump, "File::Read() dec_ref_count " << (void*)(*bi) << " idx = " << (int)((*bi)->m_offset/BufferSize()));
-         dec_ref_count(*bi);
+         release_block(*bi);
       }
 
+      XrdSysCondVarHelper _lck(m_downloadCond);
+
       // update prefetch score
       m_prefetchHitCnt += prefetchHitsRam;
       for (IntList_i d = blks_on_disk.begin(); d !=  blks_on_disk.end(); ++d)
@@ -699,7 +820,10 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
          if (m_cfi.TestPrefetchBit(offsetIdx(*d)))
             m_prefetchHitCnt++;
       }
-      m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
+      if (m_prefetchReadCnt)
+         m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
+
+      m_prefetcher->Access(idx_first, idx_last, 1);
    }
 
    return bytes_read;
@@ -707,6 +831,49 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
 
 //------------------------------------------------------------------------------
 
+int File::SFVec(XrdOucSFVec *sfv, int sfvnum, long long iUserOff, int iUserSize)
+{
+   if ( ! isOpen() || sfvnum < 1 || iUserSize <= 0) return 0;
+
+   const int fd = m_output->getFD();
+   if (fd < 0) return 0;
+
+   const long long BS = m_cfi.GetBufferSize();
+   const int idx_first = iUserOff / BS;
+   const int idx_last  = (iUserOff + iUserSize - 1) / BS;
+
+   // Written bits are set while holding m_downloadCond and are never
+   // cleared, so the blocks stay on disk while the file is attached.
+   XrdSysCondVarHelper _lck(m_downloadCond);
+
+   for (int block_idx = idx_first; block_idx <= idx_last; ++block_idx)
+   {
+      if ( ! m_cfi.TestBit(offsetIdx(block_idx))) return 0;
+   }
+
+   sfv->fdnum  = fd;
+   sfv->offset = iUserOff - m_offset;
+   sfv->sendsz = iUserSize;
+
+   m_stats.m_BytesDisk += iUserSize;
+
+   // update prefetch score
+   for (int block_idx = idx_first; block_idx <= idx_last; ++block_idx)
+   {
+      if (m_cfi.TestPrefetchBit(offsetIdx(block_idx)))
+         m_prefetchHitCnt++;
+   }
+   if (m_prefetchReadCnt)
+      m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
+
+   m_prefetcher->Access(idx_first, idx_last, 1);
+
+   TRACEF(Dump, "File::SFVec() " << iUserSize << "@" << iUserOff << " from fd " << fd);
+   return 1;
+}
+
+//------------------------------------------------------------------------------
+
 void File::WriteBlockToDisk(Block* b)
 {
    int retval = 0;
@@ -741,7 +908,11 @@ void File::WriteBlockToDisk(Block* b)
    int pfIdx =  (b->m_offset - m_offset)/m_cfi.GetBufferSize();
 
    bool schedule_sync = false;
+   BlockShard &shd = shard_of(b);
+   lock_shard(shd);
    {
+      // The written bit is set while holding the block's shard lock so that
+      // lookups under that lock see either the block or the bit.
       XrdSysCondVarHelper _lck(m_downloadCond);
 
       m_cfi.SetBitWritten(pfIdx);
@@ -749,10 +920,6 @@ void File::WriteBlockToDisk(Block* b)
       if (b->m_prefetch)
          m_cfi.SetBitPrefetch(pfIdx);
 
-      // clLog()->Dump(XrdCl::AppMsg, "File::WriteToDisk() dec_ref_count %d %s", pfIdx, lPath());
-      dec_ref_count(b);
-
-
       // set bit synced
       if (m_in_sync)
       {
@@ -770,6 +937,8 @@ void File::WriteBlockToDisk(Block* b)
          }
       }
    }
+   dec_ref_count(b);
+   shd.m_cond.UnLock();
 
    if (schedule_sync)
    {
@@ -803,9 +972,57 @@ void File::Sync()
 
 //------------------------------------------------------------------------------
 
+void File::lock_shard(BlockShard &shd)
+{
+   if ( ! shd.m_cond.CondLock())
+   {
+      shd.m_cond.Lock();
+      ++shd.m_nContended;
+   }
+   ++shd.m_nLocks;
+}
+
+//------------------------------------------------------------------------------
+
+bool File::block_finished(Block* b)
+{
+   BlockShard &shd = shard_of(b);
+   lock_shard(shd);
+   bool finished = b->is_finished();
+   shd.m_cond.UnLock();
+   return finished;
+}
+
+//------------------------------------------------------------------------------
+
+void File::wait_for_block(Block* b)
+{
+   BlockShard &shd = shard_of(b);
+   lock_shard(shd);
+   while ( ! b->is_finished())
+   {
+      shd.m_cond.Wait();
+   }
+   shd.m_cond.UnLock();
+}
+
+//------------------------------------------------------------------------------
+
+void File::GetBlockMapLockStats(long long &nLocks, long long &nContended) const
+{
+   nLocks = nContended = 0;
+   for (int s = 0; s < s_nBlockShards; ++s)
+   {
+      nLocks     += m_shards[s].m_nLocks;
+      nContended += m_shards[s].m_nContended;
+   }
+}
+
+//------------------------------------------------------------------------------
+
 void File::inc_ref_count(Block* b)
 {
-   // Method always called under lock
+   // Method always called under shard lock
    b->m_refcnt++;
    TRACEF(Dump, "File::inc_ref_count " << b << " refcnt  " << b->m_refcnt);
 }
@@ -814,7 +1031,7 @@ void File::inc_ref_count(Block* b)
 
 void File::dec_ref_count(Block* b)
 {
-   // Method always called under lock
+   // Method always called under shard lock
    b->m_refcnt--;
    assert(b->m_refcnt >= 0);
 
@@ -825,11 +1042,22 @@ void File::dec_ref_count(Block* b)
    }
 }
 
+void File::release_block(Block* b)
+{
+   BlockShard &shd = shard_of(b);
+   lock_shard(shd);
+   dec_ref_count(b);
+   shd.m_cond.UnLock();
+}
+
+//------------------------------------------------------------------------------
+
 void File::free_block(Block* b)
 {
+   // Method always called under shard lock
    int i = b->m_offset/BufferSize();
    TRACEF(Dump, "File::free_block block " << b << "  idx =  " <<  i);
-   size_t ret = m_block_map.erase(i);
+   size_t ret = shard(i).m_map.erase(i);
    if (ret != 1)
    {
       // assert might be a better option than a warning
@@ -841,7 +1069,9 @@ void File::free_block(Block* b)
       cache()->RAMBlockReleased();
    }
 
-   if (m_prefetchState == kHold && m_block_map.size() < Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks)
+   XrdSysCondVarHelper _lck(m_downloadCond);
+   if (ret == 1) --m_nBlocks;
+   if (m_prefetchState == kHold && m_nBlocks < Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks)
    {
       m_prefetchState = kOn;
       cache()->RegisterPrefetchFile(this);
@@ -852,9 +1082,15 @@ void File::free_block(Block* b)
 
 void File::ProcessBlockResponse(Block* b, int res)
 {
-   m_downloadCond.Lock();
+   BlockShard &shd = shard_of(b);
+   lock_shard(shd);
 
    TRACEF(Dump, "File::ProcessBlockResponse " << (void*)b << "  " << b->m_offset/BufferSize());
+   if (b->m_prefetch)
+   {
+      cache()->PrefetchDone(b->get_size());
+   }
+
    if (res >= 0)
    {
       b->m_downloaded = true;
@@ -871,9 +1107,13 @@ void File::ProcessBlockResponse(Block* b, int res)
       inc_ref_count(b);
    }
 
-   m_downloadCond.Broadcast();
+   IO *io = b->m_io;
 
-   m_downloadCond.UnLock();
+   shd.m_cond.Broadcast();
+
+   shd.m_cond.UnLock();
+
+   RequestsDone(io, 1);
 }
 
 long long File::BufferSize()
@@ -896,14 +1136,50 @@ int File::offsetIdx(int iIdx)
 }
 
 
+//------------------------------------------------------------------------------
+
+int File::PrefetchBlock(int idx, BlockList_t &blks)
+{
+   // Returns 1 if the block was requested, 0 if it is not needed and -1 if
+   // there is no RAM for it.
+   //
+   // Written bits are only ever set, so testing them without the lock is
+   // safe; the bit is checked again under the shard lock.
+   const int f = offsetIdx(idx);
+   if (f < 0 || f >= m_cfi.GetSizeInBits() || m_cfi.TestBit(f))
+      return 0;
+
+   int rc = 0;
+   BlockShard &shd = shard(idx);
+   lock_shard(shd);
+   if (shd.m_map.find(idx) == shd.m_map.end() && ! m_cfi.TestBit(f))
+   {
+      if (cache()->RequestRAMBlock())
+      {
+         TRACEF(Dump, "File::Prefetch take block " << idx);
+         Block *b = PrepareBlockRequest(idx, true);
+         cache()->PrefetchIssued(b->get_size());
+         blks.push_back(b);
+         rc = 1;
+      }
+      else
+      {
+         rc = -1;
+      }
+   }
+   shd.m_cond.UnLock();
+   return rc;
+}
+
 //------------------------------------------------------------------------------
 
 void File::Prefetch()
 {
    // Check that block is not on disk and not in RAM.
-   // TODO: Could prefetch several blocks at once!
 
-   BlockList_t blks;
+   BlockList_t      blks;
+   std::vector<int> candidates;
+   IO              *io;
 
    TRACEF(Dump, "File::Prefetch enter to check download status");
    {
@@ -912,31 +1188,51 @@ void File::Prefetch()
       if (m_prefetchState != kOn)
          return;
 
-      for (int f = 0; f < m_cfi.GetSizeInBits(); ++f)
+      if ( ! (io = GetPrefetchIO()))
+         return;
+
+      // Give up on files where prefetched blocks are rarely read.
+      if (m_prefetchReadCnt >= s_prefetchMinReads && m_prefetchScore < s_prefetchMinScore)
       {
-         if ( ! m_cfi.TestBit(f))
-         {
-            f += m_offset/m_cfi.GetBufferSize();
-            BlockMap_i bi = m_block_map.find(f);
-            if (bi == m_block_map.end())
-            {
-               TRACEF(Dump, "File::Prefetch take block " << f);
-               cache()->RequestRAMBlock();
-               blks.push_back( PrepareBlockRequest(f, true) );
-               m_prefetchReadCnt++;
-               m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
-               break;
-            }
-         }
+         TRACEF(Info, "File::Prefetch stopping, score " << m_prefetchScore << " after "
+                << m_prefetchReadCnt << " blocks, pattern " << m_prefetcher->PatternName());
+         m_prefetchState = kStopped;
+         m_io_map[io].m_nInFlight--;
+         cache()->DeRegisterPrefetchFile(this);
+         return;
       }
+
+      m_prefetcher->GetCandidates(candidates, 4 * s_prefetchBatch);
    }
 
+   // Blocks predicted from the access pattern come first ...
+   bool noRAM = false;
+   for (std::vector<int>::iterator i = candidates.begin();
+        i != candidates.end() && (int) blks.size() < s_prefetchBatch && ! noRAM; ++i)
+   {
+      noRAM = PrefetchBlock(*i, blks) < 0;
+   }
+
+   // ... otherwise continue with the first missing blocks of the file.
+   if (blks.empty() && ! noRAM)
+   {
+      const int idx_offset = m_offset/m_cfi.GetBufferSize();
+      for (int f = 0; f < m_cfi.GetSizeInBits() && (int) blks.size() < s_prefetchBatch && ! noRAM; ++f)
+      {
+         noRAM = PrefetchBlock(f + idx_offset, blks) < 0;
+      }
+   }
 
    if ( ! blks.empty())
    {
-      ProcessBlockRequests(blks);
+      {
+         XrdSysCondVarHelper _lck(m_downloadCond);
+         m_prefetchReadCnt += blks.size();
+         m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
+      }
+      ProcessBlockRequests(blks, io);
    }
-   else
+   else if ( ! noRAM)
    {
       TRACEF(Dump, "File::Prefetch no free block found ");
       m_downloadCond.Lock();
@@ -944,6 +1240,8 @@ void File::Prefetch()
       m_downloadCond.UnLock();
       cache()->DeRegisterPrefetchFile(this);
    }
+
+   RequestsDone(io, 1);
 }
 
 
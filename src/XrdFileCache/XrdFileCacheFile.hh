@@ -26,6 +26,7 @@
 
 #include "XrdFileCacheInfo.hh"
 #include "XrdFileCacheStats.hh"
+#include "XrdFileCachePrefetch.hh"
 
 #include <string>
 #include <map>
@@ -59,35 +60,32 @@ class File;
 class Block
 {
 public:
-   std::vector<char>   m_buff;
+   char               *m_buff;                          // from Cache's BlockPool
+   int                 m_size;
    long long           m_offset;
    File               *m_file;
+   IO                 *m_io;                            // IO the block was requested through
    bool                m_prefetch;
    int                 m_refcnt;
    int                 m_errno;                         // stores negative errno
    bool                m_downloaded;
 
-   Block(File *f, long long off, int size, bool m_prefetch) :
-      m_offset(off), m_file(f), m_prefetch(m_prefetch), m_refcnt(0),
-      m_errno(0), m_downloaded(false)
-   {
-      m_buff.resize(size);
-   }
+   Block(File *f, long long off, int size, bool m_prefetch);
+   ~Block();
 
-   char*     get_buff(long long pos = 0) { return &m_buff[pos]; }
-   int       get_size()   { return (int) m_buff.size(); }
+   char*     get_buff(long long pos = 0) { return m_buff + pos; }
+   int       get_size()   { return m_size; }
    long long get_offset() { return m_offset; }
 
    bool is_finished() { return m_downloaded || m_errno != 0; }
    bool is_ok()       { return m_downloaded; }
    bool is_failed()   { return m_errno != 0; }
 
-   void set_error_and_free(int err)
-   {
-      m_errno = err;
-      std::vector<char> x;
-      m_buff.swap(x);
-   }
+   void set_error_and_free(int err);
+
+private:
+   Block(const Block&);
+   Block& operator=(const Block&);
 };
 
 // ================================================================
@@ -141,9 +139,16 @@ public:
    bool Open();
 
    //! Vector read from disk if block is already downloaded, else ReadV from client.
-   int ReadV (const XrdOucIOVec *readV, int n);
+   int ReadV (IO *io, const XrdOucIOVec *readV, int n);
 
-   int Read(char* buff, long long offset, int size);
+   //! Read on behalf of io; missing data is requested through io.
+   int Read(IO *io, char* buff, long long offset, int size);
+
+   //----------------------------------------------------------------------
+   //! Describe the range as a range of the data file if all of its blocks
+   //! are on disk. Returns the number of sfv elements filled in (0 or 1).
+   //----------------------------------------------------------------------
+   int SFVec(XrdOucSFVec *sfv, int sfvnum, long long offset, int size);
 
    //----------------------------------------------------------------------
    //! \brief Data and cinfo files are open.
@@ -151,10 +156,11 @@ public:
    bool isOpen() const { return m_is_open; }
 
    //----------------------------------------------------------------------
-   //! \brief Initiate close. Return true if still IO active.
-   //! Used in XrdPosixXrootd::Close()
+   //! \brief Initiate close of io. Return true if still IO active.
+   //! Used in XrdPosixXrootd::Close(). When other IOs remain attached
+   //! only requests issued through io are waited for.
    //----------------------------------------------------------------------
-   bool ioActive();
+   bool ioActive(IO *io);
 
    //----------------------------------------------------------------------
    //! Sync file cache inf o and output data with disk
@@ -166,6 +172,11 @@ public:
    //----------------------------------------------------------------------
    Stats& GetStats() { return m_stats; }
 
+   //----------------------------------------------------------------------
+   //! Storage tier the data file was in when it was opened.
+   //----------------------------------------------------------------------
+   int GetTier() const { return m_tier; }
+
    void ProcessBlockResponse(Block* b, int res);
    void WriteBlockToDisk(Block* b);
 
@@ -182,7 +193,22 @@ public:
 
    long long GetFileSize() { return m_fileSize; }
 
-   void WakeUp(IO* io);
+   //----------------------------------------------------------------------
+   //! Attach another IO to this file. Called by Cache under its lock.
+   //----------------------------------------------------------------------
+   void AddIO(IO *io);
+
+   //----------------------------------------------------------------------
+   //! Detach io. Returns true if no IO is attached anymore. Called by
+   //! Cache under its lock.
+   //----------------------------------------------------------------------
+   bool RemoveIO(IO *io);
+
+   //----------------------------------------------------------------------
+   //! Number of block map lock acquisitions and how many of them had to
+   //! wait for another thread. Values are not locked, for monitoring only.
+   //----------------------------------------------------------------------
+   void GetBlockMapLockStats(long long &nLocks, long long &nContended) const;
 
 
 private:
@@ -190,7 +216,18 @@ private:
 
    bool m_is_open;                      //!< open state
 
-   IO             *m_io;                //!< original data source
+   struct IODetails
+   {
+      IODetails() : m_nInFlight(0), m_detaching(false) {}
+      int  m_nInFlight;                 //!< remote requests issued through the IO
+      bool m_detaching;                 //!< ioActive() was called, no new prefetch requests
+   };
+
+   typedef std::map<IO*, IODetails> IoMap_t;
+   typedef IoMap_t::iterator        IoMap_i;
+
+   IoMap_t         m_io_map;            //!< attached IOs, data sources; under m_downloadCond
+   IoMap_i         m_current_io;        //!< next IO used for prefetching
    XrdOssDF       *m_output;            //!< file handle for data file on disk
    XrdOssDF       *m_infoFile;          //!< file handle for data-info file on disk
    Info m_cfi;                          //!< download status of file blocks and access statistics
@@ -215,10 +252,30 @@ private:
    typedef BlockMap_t::iterator BlockMap_i;
 
 
-   BlockMap_t m_block_map;
+   //! Blocks in RAM or being downloaded are kept in shards selected by
+   //! block index. A shard's lock protects its map and the state and
+   //! reference count of its blocks; its condition variable is broadcast
+   //! when one of its blocks finishes downloading.
+   struct BlockShard
+   {
+      BlockShard() : m_cond(0), m_nLocks(0), m_nContended(0) {}
+
+      XrdSysCondVar m_cond;
+      BlockMap_t    m_map;
+      long long     m_nLocks;           //!< lock acquisitions
+      long long     m_nContended;       //!< acquisitions that had to wait
+   };
 
+   static const int s_nBlockShards = 8; //!< must be a power of 2
+
+   BlockShard m_shards[s_nBlockShards];
+
+   //! Protects file state other than the block map: m_cfi, sync and
+   //! prefetch state. When both are needed a shard lock is taken first.
    XrdSysCondVar m_downloadCond;
 
+   size_t m_nBlocks;                    //!< blocks in all shards, under m_downloadCond
+
    Stats m_stats;                   //!< cache statistics, used in IO detach
 
    PrefetchState_e m_prefetchState;
@@ -226,9 +283,20 @@ private:
    int   m_prefetchReadCnt;
    int   m_prefetchHitCnt;
    float m_prefetchScore;              //cached
+
+   Prefetcher *m_prefetcher;           //!< access pattern detection, under m_downloadCond
+
+   static const int   s_prefetchBatch;     //!< max blocks issued per Prefetch() call
+   static const int   s_prefetchMinReads;  //!< prefetched blocks before judging the score
+   static const float s_prefetchMinScore;  //!< stop prefetching below this hit ratio
+
+   static const int   s_vreadDiskParts;    //!< max parallel disk reads per ReadV()
+   static const int   s_vreadDiskMinPart;  //!< min bytes per parallel disk read
    
    bool  m_detachTimeIsLogged;
 
+   int   m_tier;                       //!< see Cache::GetTier()
+
    static const char *m_traceID;
    bool overlap(int blk,               // block to query
                 long long blk_size,    //
@@ -240,10 +308,16 @@ private:
                 long long &size);
    // Read
    Block* PrepareBlockRequest(int i, bool prefetch);
+
+   int    PrefetchBlock(int idx, BlockList_t& blks);
    
-   void   ProcessBlockRequests(BlockList_t& blks);
+   void   ProcessBlockRequests(BlockList_t& blks, IO *io);
+
+   IO*    GetPrefetchIO();
 
-   int    RequestBlocksDirect(DirectResponseHandler *handler, IntList_t& blocks,
+   void   RequestsDone(IO *io, int n);
+
+   int    RequestBlocksDirect(IO *io, DirectResponseHandler *handler, IntList_t& blocks,
                               char* buff, long long req_off, long long req_size);
 
    int    ReadBlocksFromDisk(IntList_t& blocks,
@@ -254,9 +328,11 @@ private:
    bool VReadPreProcess   (const XrdOucIOVec *readV, int n,
                            ReadVBlockListRAM&  blks_to_process,
                            ReadVBlockListDisk& blks_on_disk,
+                           BlockList_t&        blks_to_request,
                            std::vector<XrdOucIOVec>& chunkVec);
-   int  VReadFromDisk     (const XrdOucIOVec *readV, int n,
-                           ReadVBlockListDisk& blks_on_disk);
+   void VReadDiskSegments (const XrdOucIOVec *readV, int n,
+                           ReadVBlockListDisk& blks_on_disk,
+                           std::vector<XrdOucIOVec>& segs);
    int  VReadProcessBlocks(const XrdOucIOVec *readV, int n,
                            std::vector<ReadVChunkListRAM>& blks_to_process,
                            std::vector<ReadVChunkListRAM>& blks_rocessed);
@@ -264,8 +340,16 @@ private:
    long long BufferSize();
    void AppendIOStatToFileInfo();
 
+   BlockShard& shard(int idx)     { return m_shards[idx & (s_nBlockShards - 1)]; }
+   BlockShard& shard_of(Block *b) { return shard(b->m_offset / m_cfi.GetBufferSize()); }
+
+   void lock_shard(BlockShard&);
+   bool block_finished(Block*);
+   void wait_for_block(Block*);
+
    void inc_ref_count(Block*);
    void dec_ref_count(Block*);
+   void release_block(Block*);
    void free_block(Block*);
 
    int  offsetIdx(int idx);
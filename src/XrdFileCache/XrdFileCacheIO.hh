@@ -33,8 +33,6 @@ public:
 
    virtual void Update(XrdOucCacheIO2 &iocp);
 
-   virtual void RelinquishFile(File*) = 0;
-
    XrdOucTrace* GetTrace() {return m_cache.GetTrace(); }
 
    XrdOucCacheIO2* GetInput();
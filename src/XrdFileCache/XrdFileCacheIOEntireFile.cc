@@ -53,9 +53,8 @@ IOEntireFile::IOEntireFile(XrdOucCacheIO2 *io, XrdOucCacheStats &stats, Cache &
          TRACEIO(Error, "IOEntireFile::IOEntireFile, could not get valid stat");
 
       m_file = new File(this, fname, 0, st.st_size);
+      Cache::GetInstance().AddActive(m_file);
    }
-
-   Cache::GetInstance().AddActive(m_file);
 }
 
 IOEntireFile::~IOEntireFile()
@@ -86,13 +85,6 @@ long long IOEntireFile::FSize()
    return m_file->GetFileSize();
 }
 
-void IOEntireFile::RelinquishFile(File* f)
-{
-   TRACEIO(Info, "IOEntireFile::RelinquishFile");
-   assert(m_file == f);
-   m_file = 0;
-}
-
 int IOEntireFile::initCachedStat(const char* path)
 {
    // Called indirectly from the constructor.
@@ -149,11 +141,11 @@ bool IOEntireFile::ioActive()
    }
    else
    {
-      bool active = m_file->ioActive();
+      bool active = m_file->ioActive(this);
       if (! active && m_file)
       {
          TRACEIO(Debug, "IOEntireFile::ioActive() detaching file");
-         m_cache.Detach(m_file);
+         m_cache.Detach(m_file, this);
          m_file = 0;
       }
       return active;
@@ -189,7 +181,7 @@ int IOEntireFile::Read (char *buff, long long off, int size)
    ssize_t bytes_read = 0;
    ssize_t retval = 0;
 
-   retval = m_file->Read(buff, off, size);
+   retval = m_file->Read(this, buff, off, size);
    if (retval >= 0)
    {
       bytes_read += retval;
@@ -208,12 +200,23 @@ int IOEntireFile::Read (char *buff, long long off, int size)
 }
 
 
+int IOEntireFile::SFVec(XrdOucSFVec *sfv, int sfvnum, long long off, int size)
+{
+   TRACEIO(Dump, "IOEntireFile::SFVec() "<< this << " off: " << off << " size: " << size );
+
+   if (off < 0 || size <= 0 || off + size > FSize())
+      return 0;
+
+   return m_file->SFVec(sfv, sfvnum, off, size);
+}
+
+
 /*
  * Perform a readv from the cache
  */
 int IOEntireFile::ReadV (const XrdOucIOVec *readV, int n)
 {
    TRACEIO(Dump, "IO::ReadV(), get " <<  n << " requests" );
-   return m_file->ReadV(readV, n);
+   return m_file->ReadV(this, readV, n);
 }
 
@@ -71,6 +71,11 @@ public:
    //---------------------------------------------------------------------
    virtual int ReadV(const XrdOucIOVec *readV, int n);
 
+   //---------------------------------------------------------------------
+   //! Pass SFVec request to the corresponding File object.
+   //---------------------------------------------------------------------
+   virtual int SFVec(XrdOucSFVec *sfv, int sfvnum, long long offs, int rlen);
+
    //---------------------------------------------------------------------
    //! Detach itself from Cache. Note: this will delete the object.
    //!
@@ -86,7 +91,6 @@ public:
 
    virtual long long FSize();
 
-   virtual void RelinquishFile(File*);
 
 private:
    File* m_file;
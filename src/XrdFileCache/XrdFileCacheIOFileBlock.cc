@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <iostream>
 #include <assert.h>
+#include <algorithm>
 #include <fcntl.h>
 
 #include "XrdFileCacheIOFileBlock.hh"
@@ -54,7 +55,7 @@ XrdOucCacheIO* IOFileBlock::Detach()
    while (! m_blocks.empty())
    {
       std::map<int, File*>::iterator it = m_blocks.begin();
-      m_cache.Detach(it->second);
+      m_cache.Detach(it->second, this);
       m_blocks.erase(it);
    }
    delete this;
@@ -230,35 +231,69 @@ int IOFileBlock::initLocalStat()
 }
 
 //______________________________________________________________________________
-void IOFileBlock::RelinquishFile(File* f)
+bool IOFileBlock::ioActive()
 {
-   // called from Cache::Detach() or Cache::GetFileWithLocalPath()
-   // the object is in process of dying
+   CloseInfoFile();
 
    XrdSysMutexHelper lock(&m_mutex);
+   bool active = false;
    for (std::map<int, File*>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
    {
-      if (it->second == f)
-      {
-         m_blocks.erase(it);
-         break;
-      }
+      if (it->second->ioActive(this)) active = true;
    }
+
+   return active;
 }
 
 //______________________________________________________________________________
-bool IOFileBlock::ioActive()
+File* IOFileBlock::getBlockFile(int blockIdx, long long fileSize)
 {
-   CloseInfoFile();
-
    XrdSysMutexHelper lock(&m_mutex);
-   bool active = false;
-   for (std::map<int, File*>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+
+   std::map<int, File*>::iterator it = m_blocks.find(blockIdx);
+   if (it != m_blocks.end())
+      return it->second;
+
+   size_t pbs = m_blocksize;
+   // check if this is last block
+   int lastIOFileBlock = (fileSize-1)/m_blocksize;
+   if (blockIdx == lastIOFileBlock )
    {
-      if (it->second->ioActive()) active = true;
+      pbs = fileSize - blockIdx*m_blocksize;
+      // TRACEIO(Dump, "IOFileBlock::Read() last block, change output file size to " << pbs);
    }
 
-   return active;
+   File *fb = newBlockFile(blockIdx*m_blocksize, pbs);
+   m_blocks.insert(std::pair<int,File*>(blockIdx, fb));
+   return fb;
+}
+
+//______________________________________________________________________________
+int IOFileBlock::SFVec(XrdOucSFVec *sfv, int sfvnum, long long off, int size)
+{
+   if (off < 0 || size <= 0 || off + size > FSize())
+      return 0;
+
+   const int idx_first = off / m_blocksize;
+   const int idx_last  = (off + size - 1) / m_blocksize;
+   int n = 0;
+
+   for (int blockIdx = idx_first; blockIdx <= idx_last; ++blockIdx)
+   {
+      if (n >= sfvnum) return 0;
+
+      File *fb = getBlockFile(blockIdx, FSize());
+      long long blockEnd = (long long) (blockIdx + 1) * m_blocksize;
+      int       partSize = (int) (std::min(blockEnd, off + size) - off);
+      if (fb->SFVec(&sfv[n], sfvnum - n, off, partSize) != 1) return 0;
+
+      ++n;
+      off  += partSize;
+      size -= partSize;
+   }
+
+   TRACEIO(Dump, "IOFileBlock::SFVec() block range ["<< idx_first << ", " << idx_last << "] in " << n << " parts");
+   return n;
 }
 
 //______________________________________________________________________________
@@ -287,28 +322,7 @@ int IOFileBlock::Read(char *buff, long long off, int size)
    for (int blockIdx = idx_first; blockIdx <= idx_last; ++blockIdx )
    {
       // locate block
-      File* fb;
-      m_mutex.Lock();
-      std::map<int, File*>::iterator it = m_blocks.find(blockIdx);
-      if (it != m_blocks.end())
-      {
-         fb = it->second;
-      }
-      else
-      {
-         size_t pbs = m_blocksize;
-         // check if this is last block
-         int lastIOFileBlock = (fileSize-1)/m_blocksize;
-         if (blockIdx == lastIOFileBlock )
-         {
-            pbs = fileSize - blockIdx*m_blocksize;
-            // TRACEIO(Dump, "IOFileBlock::Read() last block, change output file size to " << pbs);
-         }
-
-         fb = newBlockFile(blockIdx*m_blocksize, pbs);
-         m_blocks.insert(std::pair<int,File*>(blockIdx, (File*) fb));
-      }
-      m_mutex.UnLock();
+      File* fb = getBlockFile(blockIdx, fileSize);
 
       // edit size if read request is reaching more than a block
       int readBlockSize = size;
@@ -332,7 +346,7 @@ int IOFileBlock::Read(char *buff, long long off, int size)
 
       TRACEIO(Dump, "IOFileBlock::Read() block[ " << blockIdx << "] read-block-size[" << readBlockSize << "], offset[" << readBlockSize << "] off = " << off );
 
-      int retvalBlock = fb->Read(buff, off, readBlockSize);
+      int retvalBlock = fb->Read(this, buff, off, readBlockSize);
 
       TRACEIO(Dump, "IOFileBlock::Read()  Block read returned " << retvalBlock);
       if (retvalBlock == readBlockSize)
@@ -60,6 +60,11 @@ public:
    //---------------------------------------------------------------------
    virtual int Read(char *Buffer, long long Offset, int Length);
 
+   //---------------------------------------------------------------------
+   //! Collect data file ranges from the File objects of the blocks.
+   //---------------------------------------------------------------------
+   virtual int SFVec(XrdOucSFVec *sfv, int sfvnum, long long offs, int rlen);
+
    //! \brief Virtual method of XrdOucCacheIO.
    //! Called to check if destruction needs to be done in a separate task.
    virtual bool ioActive();
@@ -68,7 +73,6 @@ public:
 
    virtual long long FSize();
 
-   virtual void RelinquishFile(File*);
 
 private:
    long long                  m_blocksize;       //!< size of file-block
@@ -81,6 +85,7 @@ private:
    void GetBlockSizeFromPath();
    int initLocalStat();
    File* newBlockFile(long long off, int blocksize);
+   File* getBlockFile(int blockIdx, long long fileSize);
    void  CloseInfoFile();
 };
 }
@@ -22,6 +22,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <algorithm>
 
 #include "XrdOss/XrdOss.hh"
 #include "XrdCks/XrdCksCalcmd5.hh"
@@ -93,14 +94,27 @@ struct FpHelper
       return WriteRaw(&loc, sizeof(T));
    }
 };
+
+//! Start of the version 3 cinfo file, padded to a page.
+struct HeaderV3
+{
+   int       m_version;
+   int       m_reserved;
+   long long m_bufferSize;
+   long long m_fileSize;
+   long long m_creationTime;
+   long long m_logBase;           //!< accesses before the first access log record
+   char      m_cksum[16];         //!< cksum of the download state bit-vector
+};
 }
 
 using namespace XrdFileCache;
 
 const char*  Info::m_infoExtension  = ".cinfo";
 const char*  Info::m_traceID        = "Cinfo";
-const int    Info::m_defaultVersion = 2;
+const int    Info::m_defaultVersion = 3;
 const size_t Info::m_maxNumAccess   = 20;
+const int    Info::m_pageSize       = 4096;
 
 //------------------------------------------------------------------------------
 
@@ -110,6 +124,9 @@ Info::Info(XrdOucTrace* trace, bool prefetchBuffer) :
    m_buff_written(0),  m_buff_prefetch(0),
    m_sizeInBits(0),
    m_complete(false),
+   m_needFullWrite(true),
+   m_logBase(0),
+   m_nDirtyAStats(0),
    m_cksCalc(0)
 {}
 
@@ -159,6 +176,9 @@ void Info::ResizeBits(int s)
       m_buff_prefetch = (unsigned char*) malloc(GetSizeInBytes());
       memset(m_buff_prefetch, 0, GetSizeInBytes());
    }
+
+   m_dirtyPages.assign((GetSizeInBytes() + m_pageSize - 1) / m_pageSize, false);
+   m_needFullWrite = true;
 }
 
 
@@ -174,16 +194,85 @@ bool Info::Read(XrdOssDF* fp, const std::string &fname)
 
    FpHelper r(fp, 0, m_trace, m_traceID, trace_pfx + "oss read failed");
 
-   if (r.Read(m_store.m_version)) return false;
+   HeaderV3 h;
+   if (r.Read(h.m_version)) return false;
 
-   if (m_store.m_version == 0)
+   if (h.m_version == 0)
    {
       TRACE(Warning, trace_pfx << " File version 0 non supported");
       return false;
    }
-   else if (abs(m_store.m_version) == 1)
+   else if (abs(h.m_version) == 1)
       return ReadV1(fp, fname);
+   else if (h.m_version == 2)
+      return ReadV2(fp, fname);
+   else if (h.m_version != m_defaultVersion)
+   {
+      TRACE(Warning, trace_pfx << " File version " << h.m_version << " non supported");
+      return false;
+   }
+
+   r.f_off = 0;
+   if (r.Read(h)) return false;
+
+   m_store.m_version    = h.m_version;
+   m_store.m_bufferSize = h.m_bufferSize;
+   SetFileSize(h.m_fileSize);
+   m_store.m_creationTime = h.m_creationTime;
+   memcpy(m_store.m_cksum, h.m_cksum, 16);
+
+   r.f_off = m_pageSize;
+   if (r.ReadRaw(m_store.m_buff_synced, GetSizeInBytes())) return false;
+   memcpy(m_buff_written, m_store.m_buff_synced, GetSizeInBytes());
+
+   char tmpCksum[16];
+   GetCksum(&m_store.m_buff_synced[0], &tmpCksum[0]);
+   if (memcmp(m_store.m_cksum, &tmpCksum[0], 16))
+   {
+      TRACE(Error, trace_pfx << " buffer cksum and saved cksum don't match \n");
+      return false;
+   }
+
+   // cache complete status
+   m_complete = ! IsAnythingEmptyInRng(0, m_sizeInBits);
+
+   // The access log runs to the end of the file; a partially written last
+   // record is ignored.
+   struct stat st;
+   if (fp->Fstat(&st) != XrdOssOK)
+   {
+      TRACE(Warning, trace_pfx << " fstat failed " << strerror(errno));
+      return false;
+   }
+   const long long logOff = m_pageSize + (long long) m_dirtyPages.size() * m_pageSize;
+   const long long nRec   = st.st_size > logOff ? (st.st_size - logOff) / (long long) sizeof(AStat) : 0;
 
+   m_logBase = h.m_logBase;
+   m_store.m_accessCnt = m_logBase + nRec;
+   TRACE(Dump, trace_pfx << " complete "<< m_complete << " access_cnt " << m_store.m_accessCnt);
+
+   // read the latest access statistics
+   long long vs = nRec < (long long) m_maxNumAccess ? nRec : m_maxNumAccess;
+   m_store.m_astats.resize(vs);
+   r.f_off = logOff + (nRec - vs) * sizeof(AStat);
+   for (std::vector<AStat>::iterator it = m_store.m_astats.begin(); it != m_store.m_astats.end(); ++it)
+   {
+      if (r.Read(*it)) return false;
+   }
+
+   m_needFullWrite = false;
+   m_nDirtyAStats  = 0;
+   return true;
+}
+
+bool Info::ReadV2(XrdOssDF* fp, const std::string &fname)
+{
+   std::string trace_pfx("Info:::ReadV2() ");
+   trace_pfx += fname + " ";
+
+   FpHelper r(fp, 0, m_trace, m_traceID, trace_pfx + "oss read failed");
+
+   if (r.Read(m_store.m_version)) return false;
    if (r.Read(m_store.m_bufferSize)) return false;
 
    long long fs;
@@ -325,21 +414,84 @@ bool Info::Write(XrdOssDF* fp, const std::string &fname)
    FpHelper w(fp, 0, m_trace, m_traceID, trace_pfx + "oss write failed");
 
    m_store.m_version = m_defaultVersion;
-   if (w.Write(m_store.m_version)) return false;
-   if (w.Write(m_store.m_bufferSize)) return false;
-   if (w.Write(m_store.m_fileSize)) return false;
+   GetCksum(&m_store.m_buff_synced[0], &m_store.m_cksum[0]);
 
-   if (w.WriteRaw(m_store.m_buff_synced, GetSizeInBytes())) return false;
+   const int       nPages = (int) m_dirtyPages.size();
+   const long long logOff = m_pageSize + (long long) nPages * m_pageSize;
+   // Compact the access log once it holds twice the records that are kept.
+   bool fullWrite = m_needFullWrite ||
+                    m_store.m_accessCnt - m_logBase > 2 * (long long) m_maxNumAccess;
 
-   GetCksum(&m_store.m_buff_synced[0], &m_store.m_cksum[0]);
-   if (w.Write(m_store.m_cksum)) return false;
+   if (fullWrite)
+   {
+      // Access records that did not fit into m_astats are only counted.
+      m_logBase      = m_store.m_accessCnt - m_store.m_astats.size();
+      m_nDirtyAStats = m_store.m_astats.size();
+   }
 
-   if (w.Write(m_store.m_creationTime)) return false;
+   HeaderV3 h;
+   memset(&h, 0, sizeof(h));
+   h.m_version      = m_store.m_version;
+   h.m_bufferSize   = m_store.m_bufferSize;
+   h.m_fileSize     = m_store.m_fileSize;
+   h.m_creationTime = m_store.m_creationTime;
+   h.m_logBase      = m_logBase;
+   memcpy(h.m_cksum, m_store.m_cksum, 16);
+
+   // Bit-vector pages go first so that the header cksum never refers to
+   // state that is not on disk yet. Adjacent dirty pages are written at once.
+   std::vector<unsigned char> region;
+   if (fullWrite)
+   {
+      region.resize((size_t) nPages * m_pageSize, 0);
+      memcpy(&region[0], m_store.m_buff_synced, GetSizeInBytes());
+   }
+   for (int first = 0; first < nPages; )
+   {
+      if ( ! fullWrite && ! m_dirtyPages[first]) { ++first; continue; }
+
+      int end = first + 1;
+      while (end < nPages && (fullWrite || m_dirtyPages[end])) ++end;
+      for (int i = first; i < end; ++i) m_dirtyPages[i] = false;
+
+      long long off = (long long) first * m_pageSize;
+      long long len = fullWrite ? (long long) (end - first) * m_pageSize
+                                : std::min((long long) end * m_pageSize, (long long) GetSizeInBytes()) - off;
+      unsigned char *src = fullWrite ? &region[off] : &m_store.m_buff_synced[off];
+      w.f_off = m_pageSize + off;
+      if (w.WriteRaw(src, len)) { m_needFullWrite = true; return false; }
+      first = end;
+   }
 
-   if (w.Write(m_store.m_accessCnt)) return false;
-   for (std::vector<AStat>::iterator it = m_store.m_astats.begin(); it != m_store.m_astats.end(); ++it)
+   if (fullWrite)
    {
-      if (w.WriteRaw(&(*it), sizeof(AStat))) return false;
+      std::vector<char> page(m_pageSize, 0);
+      memcpy(&page[0], &h, sizeof(h));
+      w.f_off = 0;
+      if (w.WriteRaw(&page[0], m_pageSize)) { m_needFullWrite = true; return false; }
+   }
+   else
+   {
+      w.f_off = 0;
+      if (w.Write(h)) return false;
+   }
+
+   // Append new access records and rewrite the one updated on detach.
+   w.f_off = logOff + (m_store.m_accessCnt - m_nDirtyAStats - m_logBase) * sizeof(AStat);
+   for (size_t i = m_store.m_astats.size() - m_nDirtyAStats; i < m_store.m_astats.size(); ++i)
+   {
+      if (w.Write(m_store.m_astats[i])) { m_needFullWrite = true; return false; }
+   }
+   m_nDirtyAStats = 0;
+
+   if (fullWrite)
+   {
+      // Drop the remainder of an older, longer file.
+      if (fp->Ftruncate(w.f_off) != XrdOssOK)
+      {
+         TRACE(Warning, trace_pfx << " truncate failed " << strerror(errno));
+      }
+      m_needFullWrite = false;
    }
 
    // Can this really fail?
@@ -359,6 +511,7 @@ void Info::WriteIOStatDetach(Stats& s)
    m_store.m_astats.back().BytesDisk   = s.m_BytesDisk;
    m_store.m_astats.back().BytesRam    = s.m_BytesRam;
    m_store.m_astats.back().BytesMissed = s.m_BytesMissed;
+   if (m_nDirtyAStats == 0) m_nDirtyAStats = 1;
 }
 
 void Info::WriteIOStatAttach()
@@ -370,14 +523,28 @@ void Info::WriteIOStatAttach()
    AStat as;
    as.AttachTime = time(0);
    m_store.m_astats.push_back(as);
+   m_nDirtyAStats = std::min(m_nDirtyAStats + 1, m_store.m_astats.size());
 }
 
 //------------------------------------------------------------------------------
 
 bool Info::GetLatestDetachTime(time_t& t) const
 {
-   if (! m_store.m_accessCnt) return false;
+   // Only the last m_maxNumAccess records are kept in m_astats.
+   if (m_store.m_astats.empty()) return false;
 
-   t =  m_store.m_astats[m_store.m_accessCnt-1].DetachTime;
-   return true;
+   t =  m_store.m_astats.back().DetachTime;
+   return t != 0;
+}
+
+//------------------------------------------------------------------------------
+
+int Info::GetNAccessesSince(time_t t) const
+{
+   int n = 0;
+   for (std::vector<AStat>::const_iterator i = m_store.m_astats.begin(); i != m_store.m_astats.end(); ++i)
+   {
+      if (i->AttachTime >= t) ++n;
+   }
+   return n;
 }
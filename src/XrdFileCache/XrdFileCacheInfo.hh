@@ -43,6 +43,15 @@ class Stats;
 
 //----------------------------------------------------------------------------
 //! Status of cached file. Can be read from and written into a binary file.
+//!
+//! Since version 3 the file consists of a header page, the download state
+//! bit-vector padded to whole pages starting at the second page and a log of
+//! access statistics after it. Once the file has been written in full, Write()
+//! only rewrites the header, the bit-vector pages changed since the previous
+//! write and the latest access records. The log is compacted to the last
+//! m_maxNumAccess records by a full write once it holds twice as many.
+//! Versions 1 and 2 are still read; they are converted to the current version
+//! on the first write.
 //----------------------------------------------------------------------------
 class Info
 {
@@ -125,7 +134,9 @@ public:
    bool Read(XrdOssDF* fp, const std::string &fname = "<unknown>");
 
    //---------------------------------------------------------------------
-   //! Write number of blocks and read buffer size
+   //! Write number of blocks, read buffer size, download state and access
+   //! statistics. Only changes since the previous Write() are written
+   //! unless the file was read in an older version.
    //! @return true on success
    //---------------------------------------------------------------------
    bool Write(XrdOssDF* fp, const std::string &fname = "<unknown>");
@@ -170,6 +181,11 @@ public:
    //---------------------------------------------------------------------
    bool GetLatestDetachTime(time_t& t) const;
 
+   //---------------------------------------------------------------------
+   //! Get number of recorded accesses attached at or after t
+   //---------------------------------------------------------------------
+   int GetNAccessesSince(time_t t) const;
+
    //---------------------------------------------------------------------
    //! Get prefetch buffer size
    //---------------------------------------------------------------------
@@ -229,6 +245,7 @@ public:
    const static char*   m_traceID;
    const static int     m_defaultVersion;
    const static size_t  m_maxNumAccess;
+   const static int     m_pageSize;
 
    XrdOucTrace* GetTrace() const {return m_trace; }
 
@@ -245,11 +262,17 @@ protected:
    int m_sizeInBits;                         //!cached
    bool m_complete;                          //!< cached
 
+   std::vector<bool> m_dirtyPages;           //!< pages of m_buff_synced changed since last write
+   bool      m_needFullWrite;                //!< file not yet written in the current version
+   long long m_logBase;                      //!< accesses not recorded in the access log
+   size_t    m_nDirtyAStats;                 //!< trailing m_astats entries not yet written
+
 private:
    inline unsigned char cfiBIT(int n) const { return 1 << n; }
 
-   // split reading for V1
+   // split reading for V1 and V2
    bool ReadV1(XrdOssDF* fp, const std::string &fname);
+   bool ReadV2(XrdOssDF* fp, const std::string &fname);
    XrdCksCalc*   m_cksCalc;
 };
 
@@ -333,6 +356,7 @@ inline void Info::SetBitSynced(int i)
 
    const int off = i - cn*8;
    m_store.m_buff_synced[cn] |= cfiBIT(off);
+   m_dirtyPages[cn / m_pageSize] = true;
 }
 
 inline void Info::SetBitWritten(int i)
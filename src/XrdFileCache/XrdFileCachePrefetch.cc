@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdFileCachePrefetch.hh"
+
+using namespace XrdFileCache;
+
+namespace
+{
+//----------------------------------------------------------------------------
+//! Never proposes blocks, the file is prefetched front to back.
+//----------------------------------------------------------------------------
+class LinearPrefetcher : public Prefetcher
+{
+public:
+   virtual void Access(int, int, int) {}
+   virtual void GetCandidates(std::vector<int>&, int) {}
+   virtual const char* PatternName() const { return "linear"; }
+};
+
+//----------------------------------------------------------------------------
+//! Detects sequential, strided and clustered vector read access.
+//!
+//! - sequential: a read starts within or right after the previous one;
+//!   prefetch the blocks following the last read.
+//! - strided: reads start a constant number of blocks apart; prefetch the
+//!   next strides.
+//! - cluster: a vector read spans [first, last]; ROOT reads baskets cluster
+//!   by cluster, so prefetch a region of the same size after it.
+//!
+//! A pattern is accepted after it has been seen twice in a row.
+//----------------------------------------------------------------------------
+class PatternPrefetcher : public Prefetcher
+{
+public:
+   PatternPrefetcher() :
+      m_pattern(kUnknown), m_haveLast(false), m_lastFirst(0), m_lastLast(0),
+      m_seqCnt(0), m_stride(0), m_strideCnt(0), m_clusterEnd(0)
+   {}
+
+   virtual void Access(int first, int last, int nChunks)
+   {
+      if (nChunks > 1)
+      {
+         m_pattern    = kCluster;
+         m_clusterEnd = last + (last - first + 1);
+      }
+      else if (m_haveLast)
+      {
+         if (first >= m_lastFirst && first <= m_lastLast + 1)
+         {
+            ++m_seqCnt;
+            m_strideCnt = 0;
+         }
+         else
+         {
+            int stride = first - m_lastFirst;
+            if (stride == m_stride) ++m_strideCnt;
+            else { m_stride = stride; m_strideCnt = 1; }
+            m_seqCnt = 0;
+         }
+
+         if      (m_seqCnt    >= 2) m_pattern = kSequential;
+         else if (m_strideCnt >= 2) m_pattern = kStrided;
+         else if (m_pattern != kCluster || last > m_clusterEnd) m_pattern = kUnknown;
+      }
+
+      m_haveLast  = true;
+      m_lastFirst = first;
+      m_lastLast  = last;
+   }
+
+   virtual void GetCandidates(std::vector<int> &blocks, int max)
+   {
+      switch (m_pattern)
+      {
+         case kSequential:
+            for (int i = 1; i <= max; ++i)
+               blocks.push_back(m_lastLast + i);
+            break;
+         case kStrided:
+         {
+            const int width = m_lastLast - m_lastFirst + 1;
+            for (int s = 1; (int) blocks.size() < max; ++s)
+               for (int i = 0; i < width && (int) blocks.size() < max; ++i)
+                  blocks.push_back(m_lastFirst + s * m_stride + i);
+            break;
+         }
+         case kCluster:
+            for (int i = m_lastLast + 1; i <= m_clusterEnd && (int) blocks.size() < max; ++i)
+               blocks.push_back(i);
+            break;
+         default:
+            break;
+      }
+   }
+
+   virtual const char* PatternName() const
+   {
+      static const char *names[] = { "unknown", "sequential", "strided", "cluster" };
+      return names[m_pattern];
+   }
+
+private:
+   enum Pattern_e { kUnknown, kSequential, kStrided, kCluster };
+
+   Pattern_e m_pattern;
+   bool      m_haveLast;
+   int       m_lastFirst;     //!< first block of the previous read
+   int       m_lastLast;      //!< last block of the previous read
+   int       m_seqCnt;        //!< consecutive sequential reads
+   int       m_stride;        //!< distance in blocks between read starts
+   int       m_strideCnt;     //!< consecutive reads with m_stride
+   int       m_clusterEnd;    //!< last block predicted for the next cluster
+};
+}
+
+//______________________________________________________________________________
+
+Prefetcher* Prefetcher::Create(const std::string &name)
+{
+   if (name == "pattern") return new PatternPrefetcher;
+   if (name == "linear")  return new LinearPrefetcher;
+   return 0;
+}
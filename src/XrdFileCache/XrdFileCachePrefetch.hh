@@ -0,0 +1,64 @@
+#ifndef __XRDFILECACHE_PREFETCH_HH__
+#define __XRDFILECACHE_PREFETCH_HH__
+
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+namespace XrdFileCache
+{
+//----------------------------------------------------------------------------
+//! Per-file prefetch engine. A File reports every client read and asks the
+//! engine which blocks to prefetch next; blocks that are already on disk or
+//! in RAM are skipped by the File. When no block is proposed the File falls
+//! back to prefetching the first missing block of the file. Calls are made
+//! with the File's state lock held.
+//----------------------------------------------------------------------------
+class Prefetcher
+{
+public:
+   virtual ~Prefetcher() {}
+
+   //---------------------------------------------------------------------
+   //! Record a client read spanning blocks [first, last]. For a vector
+   //! read these are the lowest and highest block, nChunks is the number
+   //! of chunks in the request.
+   //---------------------------------------------------------------------
+   virtual void Access(int first, int last, int nChunks) = 0;
+
+   //---------------------------------------------------------------------
+   //! Append up to max block indices, most urgent first.
+   //---------------------------------------------------------------------
+   virtual void GetCandidates(std::vector<int> &blocks, int max) = 0;
+
+   //---------------------------------------------------------------------
+   //! Name of the detected access pattern, for tracing.
+   //---------------------------------------------------------------------
+   virtual const char* PatternName() const = 0;
+
+   //---------------------------------------------------------------------
+   //! Create the engine selected with pfc.prefetch ... policy <name>.
+   //! Known names are "pattern" and "linear". Returns 0 for unknown names.
+   //---------------------------------------------------------------------
+   static Prefetcher* Create(const std::string &name);
+};
+}
+
+#endif
@@ -7,145 +7,23 @@ using namespace XrdFileCache;
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucTrace.hh"
 
-namespace
-{
-class FPurgeState
-{
-public:
-   struct FS
-   {
-      std::string path;
-      long long nByte;
-      FS(const char* p, long long n) : path(p), nByte(n) {}
-   };
-
-   typedef std::multimap<time_t, FS> map_t;
-   typedef map_t::iterator map_i;
-   map_t fmap;
-   
-   FPurgeState(long long iNByteReq) : nByteReq(iNByteReq), nByteAccum(0) {}
-
-   void checkFile (time_t iTime, const char* iPath,  long long iNByte)
-   {
-      if (nByteAccum < nByteReq || iTime < fmap.rbegin()->first)
-      {
-         fmap.insert(std::pair<const time_t, FS> (iTime, FS(iPath, iNByte)));
-         nByteAccum += iNByte;
-
-         // remove newest files from map if necessary
-         while (nByteAccum > nByteReq)
-         {
-            time_t nt = fmap.begin()->first;
-            std::pair<map_i, map_i> ret = fmap.equal_range(nt);
-            for (map_i it2 = ret.first; it2 != ret.second; ++it2)
-               nByteAccum -= it2->second.nByte;
-            fmap.erase(ret.first, ret.second);
-         }
-      }
-   }
-
-private:
-   long long nByteReq;
-   long long nByteAccum;
-};
-
-XrdOucTrace* GetTrace()
-{
-   // needed for logging macros
-   return Cache::GetInstance().GetTrace();
-}
-
-void FillFileMapRecurse( XrdOssDF* iOssDF, const std::string& path, FPurgeState& purgeState)
-{
-   char buff[256];
-   XrdOucEnv env;
-   int rdr;
-   const size_t InfoExtLen = strlen(XrdFileCache::Info::m_infoExtension);  // cached var
-
-   static const char* m_traceID = "Purge";
-   Cache& factory = Cache::GetInstance();
-   while ((rdr = iOssDF->Readdir(&buff[0], 256)) >= 0)
-   {
-      // printf("readdir [%s]\n", buff);
-      std::string np = path + "/" + std::string(buff);
-      size_t fname_len = strlen(&buff[0]);
-      if (fname_len == 0)
-      {
-         // std::cout << "Finish read dir.[" << np <<"] Break loop \n";
-         break;
-      }
-
-      if (strncmp("..", &buff[0], 2) && strncmp(".", &buff[0], 1))
-      {
-         XrdOssDF* dh = factory.GetOss()->newDir(factory.RefConfiguration().m_username.c_str());
-         XrdOssDF* fh = factory.GetOss()->newFile(factory.RefConfiguration().m_username.c_str());
-
-         if (fname_len > InfoExtLen && strncmp(&buff[fname_len - InfoExtLen], XrdFileCache::Info::m_infoExtension, InfoExtLen) == 0)
-         {
-            // We could also check if it is currently opened with Cache::HaveActiveFileWihtLocalPath()
-            // This is not relay necessary because we do that check before unlinking the file
-            Info cinfo(Cache::GetInstance().GetTrace());
-            if (fh->Open(np.c_str(), O_RDONLY, 0600, env) == XrdOssOK && cinfo.Read(fh, np))
-            {
-               time_t accessTime;
-               if (cinfo.GetLatestDetachTime(accessTime))
-               {
-                  TRACE(Dump, "FillFileMapRecurse() checking " << buff << " accessTime  " << accessTime);
-                  purgeState.checkFile(accessTime, np.c_str(), cinfo.GetNDownloadedBytes());
-               }
-               else
-               {
-                  // cinfo file does not contain any known accesses, use stat.mtime instead.
-
-                  TRACE(Warning, "FillFileMapRecurse() could not get access time for " << np << ", trying stat");
-
-                  XrdOss* oss = Cache::GetInstance().GetOss();
-                  struct stat fstat;
-
-                  if (oss->Stat(np.c_str(), &fstat) == XrdOssOK)
-                  {
-                     accessTime = fstat.st_mtime;
-                     TRACE(Dump, "FillFileMapRecurse() have access time for " << np << " via stat: " << accessTime);
-                     purgeState.checkFile(accessTime, np.c_str(), cinfo.GetNDownloadedBytes());
-                  }
-                  else
-                  {
-                     // This really shouldn't happen ... but if it does remove cinfo and the data file right away.
-
-                     TRACE(Warning, "FillFileMapRecurse() could not get access time for " << np
-                                                                                          << "; purging.");
-                     oss->Unlink(np.c_str());
-                     np = np.substr(0, np.size() - strlen(XrdFileCache::Info::m_infoExtension));
-                     oss->Unlink(np.c_str());
-                  }
-               }
-            }
-            else
-            {
-               TRACE(Warning, "FillFileMapRecurse() can't open or read " << np << ", err " << strerror(errno)
-                                                                         << "; purging.");
-               XrdOss* oss = Cache::GetInstance().GetOss();
-               oss->Unlink(np.c_str());
-               np = np.substr(0, np.size() - strlen(XrdFileCache::Info::m_infoExtension));
-               oss->Unlink(np.c_str());
-            }
-         }
-         else if (dh->Opendir(np.c_str(), env) == XrdOssOK)
-         {
-            FillFileMapRecurse(dh, np, purgeState);
-         }
-
-         delete dh; dh = 0;
-         delete fh; fh = 0;
-      }
-   }
-}
-}
 void Cache::CacheDirCleanup()
 {
    XrdOucEnv env;
    XrdOss*      oss = Cache::GetInstance().GetOss();
    XrdOssVSInfo sP;
+   const char  *user = m_configuration.m_username.c_str();
+   const std::string &indexPath = m_configuration.m_purgeIndexPath;
+
+   // Start from the saved index if there is one; otherwise, or if it is
+   // older than the rescan interval, scan the cache namespace.
+   time_t lastScan = 0;
+   if (indexPath.empty() || ! m_purgeIndex.Load(oss, user, indexPath, lastScan) ||
+       time(0) - lastScan >= m_configuration.m_purgeRescan)
+   {
+      m_purgeIndex.Rebuild(oss, user, m_configuration.m_purgeThreads);
+      lastScan = time(0);
+   }
 
    while (1)
    {
@@ -169,51 +47,71 @@ void Cache::CacheDirCleanup()
 
       if (bytesToRemove > 0)
       {
-         // make a sorted map of file patch by access time
-         XrdOssDF* dh = oss->newDir(m_configuration.m_username.c_str());
-         if (dh->Opendir("", env) == XrdOssOK)
+         // Pick candidates in the data space from the index; prepare 20%
+         // more volume than required as some of them may be in use. Files
+         // in the fast space are demoted before they are purged.
+         std::vector<PurgeIndex::Victim> victims;
+         m_purgeIndex.GetVictims(m_configuration.m_purgePolicy, bytesToRemove * 5 / 4, 0, victims);
+
+         struct stat fstat;
+         for (std::vector<PurgeIndex::Victim>::iterator it = victims.begin(); it != victims.end(); ++it)
          {
-            FPurgeState purgeState(bytesToRemove * 5 / 4); // prepare 20% more volume than required
+            std::string infoPath = it->m_path;
+            std::string dataPath = infoPath.substr(0, infoPath.size() - strlen(XrdFileCache::Info::m_infoExtension));
 
-            FillFileMapRecurse(dh, "", purgeState);
+            if (HaveActiveFileWithLocalPath(dataPath))
+               continue;
 
-            // loop over map and remove files with highest value of access time
-            struct stat fstat;
-            for (FPurgeState::map_i it = purgeState.fmap.begin(); it != purgeState.fmap.end(); ++it)
+            // remove info file
+            if (oss->Stat(infoPath.c_str(), &fstat) == XrdOssOK)
             {
+               // cinfo file can be on another oss.space, do not subtract for now.
+               // bytesToRemove -= fstat.st_size;
+               oss->Unlink(infoPath.c_str());
+               TRACE(Info, "Cache::CacheDirCleanup() removed file:" <<  infoPath <<  " size: " << fstat.st_size);
+            }
 
-               std::string infoPath = it->second.path;
-               std::string dataPath = infoPath.substr(0, infoPath.size() - strlen(XrdFileCache::Info::m_infoExtension));
-
-               if (HaveActiveFileWithLocalPath(dataPath))
-                  continue;
+            // remove data file
+            if (oss->Stat(dataPath.c_str(), &fstat) == XrdOssOK)
+            {
+               bytesToRemove -= it->m_nBytes;
 
-               // remove info file
-               if (oss->Stat(infoPath.c_str(), &fstat) == XrdOssOK)
-               {
-                  // cinfo file can be on another oss.space, do not subtract for now.
-                  // bytesToRemove -= fstat.st_size;
-                  oss->Unlink(infoPath.c_str());
-                  TRACE(Info, "Cache::CacheDirCleanup() removed file:" <<  infoPath <<  " size: " << fstat.st_size);
-               }
+               oss->Unlink(dataPath.c_str());
+               TRACE(Info, "Cache::CacheDirCleanup() removed file: " << dataPath << " size " << it->m_nBytes);
+            }
 
-               // remove data file
-               if (oss->Stat(dataPath.c_str(), &fstat) == XrdOssOK)
-               {
-                  bytesToRemove -= it->second.nByte;
+            m_purgeIndex.Remove(infoPath);
 
-                  oss->Unlink(dataPath.c_str());
-                  TRACE(Info, "Cache::CacheDirCleanup() removed file: %s " << dataPath << " size " << it->second.nByte);
-               }
+            if (bytesToRemove <= 0)
+               break;
+         }
 
-               if (bytesToRemove <= 0)
-                  break;
-            }
+         // The index did not cover enough; files may have been added
+         // behind our back, rescan on the next pass.
+         if (bytesToRemove > 0)
+         {
+            TRACE(Warning, "Cache::CacheDirCleanup() index of " << m_purgeIndex.Size() << " files short by "
+                  << bytesToRemove << " bytes, forcing rescan.");
+            lastScan = 0;
          }
-         dh->Close();
-         delete dh; dh = 0;
       }
 
+      BalanceTiers();
+
+      if (time(0) - lastScan >= m_configuration.m_purgeRescan)
+      {
+         m_purgeIndex.Rebuild(oss, user, m_configuration.m_purgeThreads);
+         lastScan = time(0);
+      }
+
+      if ( ! indexPath.empty())
+         m_purgeIndex.Save(oss, user, indexPath);
+
+      if ( ! m_configuration.m_summaryPath.empty())
+         m_purgeIndex.WriteSummary(m_configuration.m_summaryPath);
+
+      ReportStats();
+
       sleep(m_configuration.m_purgeInterval);
    }
 }
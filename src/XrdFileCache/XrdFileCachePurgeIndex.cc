@@ -0,0 +1,593 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <list>
+
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdFileCache.hh"
+#include "XrdFileCacheInfo.hh"
+#include "XrdFileCachePurgeIndex.hh"
+#include "XrdFileCacheSummary.hh"
+#include "XrdFileCacheTrace.hh"
+
+using namespace XrdFileCache;
+
+namespace
+{
+const char *m_traceID = "Purge";
+
+XrdOucTrace* GetTrace()
+{
+   // needed for logging macros
+   return Cache::GetInstance().GetTrace();
+}
+
+//----------------------------------------------------------------------------
+//! Directories still to be scanned and the results of a parallel scan.
+//----------------------------------------------------------------------------
+struct ScanState
+{
+   ScanState(XrdOss *oss, const char *user) :
+      m_cond(0), m_nBusy(0), m_oss(oss), m_user(user)
+   {}
+
+   XrdSysCondVar           m_cond;
+   std::list<std::string>  m_dirs;      //!< directories waiting for a scanner
+   int                     m_nBusy;     //!< scanners working on a directory
+   XrdOss                 *m_oss;
+   const char             *m_user;
+
+   XrdSysMutex             m_resMutex;
+   PurgeIndex::EntryMap_t  m_result;
+};
+
+//! Orders scored purge candidates for std heap algorithms.
+struct HeapLess
+{
+   template<class T> bool operator()(const T &a, const T &b) const { return a.first < b.first; }
+};
+
+//______________________________________________________________________________
+
+void ScanInfoFile(ScanState &ss, const std::string &np)
+{
+   XrdOucEnv env;
+   XrdOssDF *fh = ss.m_oss->newFile(ss.m_user);
+   Info cinfo(Cache::GetInstance().GetTrace());
+
+   if (fh->Open(np.c_str(), O_RDONLY, 0600, env) == XrdOssOK && cinfo.Read(fh, np))
+   {
+      PurgeIndex::Entry e;
+      e.m_nBytes   = cinfo.GetNDownloadedBytes();
+      e.m_nAccess  = cinfo.GetAccessCnt();
+      e.m_complete = cinfo.IsComplete();
+      e.m_tier     = Cache::GetInstance().GetTier(np.substr(0, np.size() - strlen(Info::m_infoExtension)));
+
+      struct stat fstat;
+      if (cinfo.GetLatestDetachTime(e.m_atime))
+      {
+         TRACE(Dump, "ScanInfoFile() checking " << np << " accessTime  " << e.m_atime);
+      }
+      // cinfo file does not contain any known accesses, use stat.mtime instead.
+      else if (ss.m_oss->Stat(np.c_str(), &fstat) == XrdOssOK)
+      {
+         e.m_atime = fstat.st_mtime;
+         TRACE(Dump, "ScanInfoFile() have access time for " << np << " via stat: " << e.m_atime);
+      }
+      else
+      {
+         // This really shouldn't happen ... but if it does remove cinfo and the data file right away.
+         TRACE(Warning, "ScanInfoFile() could not get access time for " << np << "; purging.");
+         ss.m_oss->Unlink(np.c_str());
+         ss.m_oss->Unlink(np.substr(0, np.size() - strlen(Info::m_infoExtension)).c_str());
+         fh->Close();
+         delete fh;
+         return;
+      }
+
+      XrdSysMutexHelper lock(&ss.m_resMutex);
+      ss.m_result[np] = e;
+   }
+   else
+   {
+      TRACE(Warning, "ScanInfoFile() can't open or read " << np << ", err " << strerror(errno)
+                                                          << "; purging.");
+      ss.m_oss->Unlink(np.c_str());
+      ss.m_oss->Unlink(np.substr(0, np.size() - strlen(Info::m_infoExtension)).c_str());
+   }
+   fh->Close();
+   delete fh;
+}
+
+//______________________________________________________________________________
+
+void ScanDir(ScanState &ss, const std::string &path, std::list<std::string> &subdirs)
+{
+   char buff[256];
+   XrdOucEnv env;
+   const size_t InfoExtLen = strlen(Info::m_infoExtension);  // cached var
+
+   XrdOssDF *dh = ss.m_oss->newDir(ss.m_user);
+   if (dh->Opendir(path.empty() ? "/" : path.c_str(), env) != XrdOssOK)
+   {
+      delete dh;
+      return;
+   }
+
+   while (dh->Readdir(&buff[0], 256) >= 0)
+   {
+      size_t fname_len = strlen(&buff[0]);
+      if (fname_len == 0) break;
+
+      // Skips ".", ".." and hidden files, e.g. the saved purge index.
+      if (buff[0] == '.') continue;
+
+      std::string np = path + "/" + std::string(buff);
+
+      if (fname_len > InfoExtLen && strncmp(&buff[fname_len - InfoExtLen], Info::m_infoExtension, InfoExtLen) == 0)
+      {
+         ScanInfoFile(ss, np);
+      }
+      else
+      {
+         XrdOssDF *sdh = ss.m_oss->newDir(ss.m_user);
+         if (sdh->Opendir(np.c_str(), env) == XrdOssOK)
+         {
+            subdirs.push_back(np);
+            sdh->Close();
+         }
+         delete sdh;
+      }
+   }
+
+   dh->Close();
+   delete dh;
+}
+
+//______________________________________________________________________________
+
+void *ScanThread(void *arg)
+{
+   ScanState &ss = *static_cast<ScanState*>(arg);
+
+   while (true)
+   {
+      std::string dir;
+
+      ss.m_cond.Lock();
+      while (ss.m_dirs.empty() && ss.m_nBusy > 0)
+      {
+         ss.m_cond.Wait();
+      }
+      if (ss.m_dirs.empty())
+      {
+         ss.m_cond.UnLock();
+         return 0;
+      }
+      dir = ss.m_dirs.front();
+      ss.m_dirs.pop_front();
+      ss.m_nBusy++;
+      ss.m_cond.UnLock();
+
+      std::list<std::string> subdirs;
+      ScanDir(ss, dir, subdirs);
+
+      ss.m_cond.Lock();
+      ss.m_dirs.splice(ss.m_dirs.end(), subdirs);
+      ss.m_nBusy--;
+      ss.m_cond.Broadcast();
+      ss.m_cond.UnLock();
+   }
+}
+}
+
+//______________________________________________________________________________
+
+PurgeIndex::PurgeIndex() : m_nChanges(0), m_summary(0)
+{}
+
+//______________________________________________________________________________
+
+PurgeIndex::~PurgeIndex()
+{
+   delete m_summary;
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::insert(const std::string &path, const Entry &e)
+{
+   // Must be called with m_mutex held.
+   std::pair<EntryMap_t::iterator, bool> ret = m_entries.insert(std::make_pair(path, e));
+   if ( ! ret.second)
+   {
+      m_byTime.erase(TimeKey_t(ret.first->second.m_atime, &ret.first->first));
+      if (m_summary && ret.first->second.m_complete != e.m_complete)
+         m_summary->SetComplete(path, e.m_complete);
+      ret.first->second = e;
+   }
+   else if (m_summary)
+   {
+      m_summary->Add(path, e.m_complete);
+   }
+   m_byTime.insert(TimeKey_t(e.m_atime, &ret.first->first));
+   ++m_nChanges;
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::clear()
+{
+   // Must be called with m_mutex held.
+   m_entries.clear();
+   m_byTime.clear();
+   if (m_summary) m_summary->Clear();
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::Update(const std::string &cinfoPath, time_t atime, long long nBytes, int nAccess, int tier,
+                        bool complete)
+{
+   Entry e;
+   e.m_atime    = atime;
+   e.m_nBytes   = nBytes;
+   e.m_nAccess  = nAccess;
+   e.m_tier     = tier;
+   e.m_complete = complete;
+
+   XrdSysMutexHelper lock(&m_mutex);
+   insert(cinfoPath, e);
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::Remove(const std::string &cinfoPath)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   EntryMap_t::iterator it = m_entries.find(cinfoPath);
+   if (it != m_entries.end())
+   {
+      m_byTime.erase(TimeKey_t(it->second.m_atime, &it->first));
+      if (m_summary) m_summary->Remove(it->first, it->second.m_complete);
+      m_entries.erase(it);
+      ++m_nChanges;
+   }
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::SetTier(const std::string &cinfoPath, int tier)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   EntryMap_t::iterator it = m_entries.find(cinfoPath);
+   if (it != m_entries.end() && it->second.m_tier != tier)
+   {
+      it->second.m_tier = tier;
+      ++m_nChanges;
+   }
+}
+
+//______________________________________________________________________________
+
+int PurgeIndex::Size()
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   return (int) m_entries.size();
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::GetVictims(Policy_e policy, long long nBytes, int tier, std::vector<Victim> &victims)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   long long nAccum = 0;
+
+   if (policy == kLRU)
+   {
+      for (TimeSet_t::iterator it = m_byTime.begin(); it != m_byTime.end() && nAccum < nBytes; ++it)
+      {
+         const Entry &e = m_entries[*it->second];
+         if (e.m_tier != tier) continue;
+         victims.push_back(Victim(*it->second, e.m_nBytes));
+         nAccum += e.m_nBytes;
+      }
+      return;
+   }
+
+   // Score every entry, then pop the highest scores off a heap.
+   const time_t now = time(0);
+   std::vector<std::pair<double, EntryMap_t::iterator> > heap;
+   heap.reserve(m_entries.size());
+   for (EntryMap_t::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+   {
+      if (it->second.m_tier != tier) continue;
+      double age = std::max(1.0, double(now - it->second.m_atime));
+      double score = (policy == kSize) ? age * double(it->second.m_nBytes)
+                                       : age / (1 + it->second.m_nAccess);
+      heap.push_back(std::make_pair(score, it));
+   }
+
+   std::make_heap(heap.begin(), heap.end(), HeapLess());
+   while ( ! heap.empty() && nAccum < nBytes)
+   {
+      std::pop_heap(heap.begin(), heap.end(), HeapLess());
+      EntryMap_t::iterator it = heap.back().second;
+      heap.pop_back();
+      victims.push_back(Victim(it->first, it->second.m_nBytes));
+      nAccum += it->second.m_nBytes;
+   }
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::GetDemoteCandidates(time_t t, long long nBytes, std::vector<Victim> &victims)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   long long nAccum = 0;
+
+   for (TimeSet_t::iterator it = m_byTime.begin(); it != m_byTime.end(); ++it)
+   {
+      if (it->first >= t && nAccum >= nBytes) break;
+      const Entry &e = m_entries[*it->second];
+      if (e.m_tier != 1) continue;
+      victims.push_back(Victim(*it->second, e.m_nBytes));
+      nAccum += e.m_nBytes;
+   }
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::GetPromoteCandidates(time_t t, int minAccess, std::vector<Victim> &victims)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+
+   for (TimeSet_t::reverse_iterator it = m_byTime.rbegin(); it != m_byTime.rend() && it->first >= t; ++it)
+   {
+      const Entry &e = m_entries[*it->second];
+      if (e.m_tier != 0 || e.m_nAccess < minAccess) continue;
+      victims.push_back(Victim(*it->second, e.m_nBytes));
+   }
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::Rebuild(XrdOss *oss, const char *user, int nThreads)
+{
+   const time_t scanStart = time(0);
+   ScanState ss(oss, user);
+   ss.m_dirs.push_back("");
+
+   std::vector<pthread_t> tids;
+   for (int i = 0; i < nThreads; ++i)
+   {
+      pthread_t tid;
+      if (XrdSysThread::Run(&tid, ScanThread, &ss, XRDSYSTHREAD_HOLD, "XrdFileCache purge scan") == 0)
+         tids.push_back(tid);
+   }
+   // If no thread could be started do the scan here.
+   if (tids.empty()) ScanThread(&ss);
+   for (size_t i = 0; i < tids.size(); ++i)
+   {
+      XrdSysThread::Join(tids[i], 0);
+   }
+
+   XrdSysMutexHelper lock(&m_mutex);
+
+   // Keep entries of files that were attached or detached during the scan.
+   for (EntryMap_t::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+   {
+      if (it->second.m_atime >= scanStart)
+         ss.m_result[it->first] = it->second;
+   }
+
+   clear();
+   for (EntryMap_t::iterator it = ss.m_result.begin(); it != ss.m_result.end(); ++it)
+   {
+      insert(it->first, it->second);
+   }
+
+   TRACE(Info, "PurgeIndex::Rebuild() indexed " << m_entries.size() << " files in "
+         << time(0) - scanStart << " seconds using " << std::max((size_t) 1, tids.size()) << " threads");
+}
+
+//______________________________________________________________________________
+
+bool PurgeIndex::Load(XrdOss *oss, const char *user, const std::string &path, time_t &saveTime)
+{
+   XrdOucEnv env;
+   XrdOssDF *fh = oss->newFile(user);
+   if (fh->Open(path.c_str(), O_RDONLY, 0600, env) != XrdOssOK)
+   {
+      delete fh;
+      return false;
+   }
+
+   struct stat st;
+   std::string data;
+   bool ok = (fh->Fstat(&st) == XrdOssOK);
+   if (ok)
+   {
+      data.resize(st.st_size);
+      ok = (st.st_size == 0 || fh->Read(&data[0], 0, st.st_size) == st.st_size);
+   }
+   fh->Close();
+   delete fh;
+   if ( ! ok) return false;
+
+   // Format: header line "pfc-purge-index 1 <save-time>" followed by one
+   // "<atime> <bytes> <accesses> <tier> <complete> <cinfo-path>" line per
+   // file. Any other file is not used; the cache is then rescanned.
+   const char *p = data.c_str(), *end = p + data.size();
+   long long t;
+   int n, version;
+   if (sscanf(p, "pfc-purge-index %d %lld\n%n", &version, &t, &n) != 2 || version != 1)
+   {
+      TRACE(Warning, "PurgeIndex::Load() " << path << " has an unknown format");
+      return false;
+   }
+   saveTime = t;
+   p += n;
+
+   EntryMap_t entries;
+   while (p < end)
+   {
+      const char *eol = (const char*) memchr(p, '\n', end - p);
+      if ( ! eol) break;
+
+      long long atime, nBytes;
+      int nAccess, tier, complete;
+      if (sscanf(p, "%lld %lld %d %d %d %n", &atime, &nBytes, &nAccess, &tier, &complete, &n) != 5 ||
+          p + n >= eol)
+      {
+         TRACE(Warning, "PurgeIndex::Load() " << path << " is corrupt");
+         return false;
+      }
+      Entry &e = entries[std::string(p + n, eol - p - n)];
+      e.m_atime    = atime;
+      e.m_nBytes   = nBytes;
+      e.m_nAccess  = nAccess;
+      e.m_tier     = tier;
+      e.m_complete = (complete != 0);
+      p = eol + 1;
+   }
+
+   XrdSysMutexHelper lock(&m_mutex);
+   for (EntryMap_t::iterator it = entries.begin(); it != entries.end(); ++it)
+   {
+      if (m_entries.find(it->first) == m_entries.end())
+         insert(it->first, it->second);
+   }
+   m_nChanges = 0;
+
+   TRACE(Info, "PurgeIndex::Load() loaded " << entries.size() << " files from " << path);
+   return true;
+}
+
+//______________________________________________________________________________
+
+bool PurgeIndex::Save(XrdOss *oss, const char *user, const std::string &path)
+{
+   std::string data;
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+      if ( ! m_nChanges) return true;
+
+      char line[128];
+      snprintf(line, sizeof(line), "pfc-purge-index 1 %lld\n", (long long) time(0));
+      data.reserve(m_entries.size() * 96);
+      data += line;
+      for (EntryMap_t::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+      {
+         snprintf(line, sizeof(line), "%lld %lld %d %d %d ", (long long) it->second.m_atime,
+                  it->second.m_nBytes, it->second.m_nAccess, it->second.m_tier,
+                  it->second.m_complete ? 1 : 0);
+         data += line;
+         data += it->first;
+         data += '\n';
+      }
+      m_nChanges = 0;
+   }
+
+   // Write a temporary file and rename it so that a crash never leaves a
+   // partial index. Oss rename does not replace an existing file; a missing
+   // index only costs a rescan.
+   XrdOucEnv env;
+   std::string tmp = path + ".tmp";
+   oss->Unlink(tmp.c_str());
+   bool ok = false;
+   if (oss->Create(user, tmp.c_str(), 0600, env, XRDOSS_mkpath) == XrdOssOK)
+   {
+      XrdOssDF *fh = oss->newFile(user);
+      if (fh->Open(tmp.c_str(), O_RDWR, 0600, env) == XrdOssOK)
+      {
+         ok = (fh->Write(data.c_str(), 0, data.size()) == (ssize_t) data.size()) && fh->Fsync() == XrdOssOK;
+         fh->Close();
+      }
+      delete fh;
+   }
+
+   if (ok) oss->Unlink(path.c_str());
+   if ( ! ok || oss->Rename(tmp.c_str(), path.c_str()) != XrdOssOK)
+   {
+      TRACE(Error, "PurgeIndex::Save() failed to write " << path);
+      oss->Unlink(tmp.c_str());
+      XrdSysMutexHelper lock(&m_mutex);
+      ++m_nChanges;
+      return false;
+   }
+   return true;
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::EnableSummary(int nBits, int nHash, bool hdfsmode)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   if (m_summary) return;
+
+   m_summary = new Summary(nBits, nHash, hdfsmode);
+   for (EntryMap_t::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+   {
+      m_summary->Add(it->first, it->second.m_complete);
+   }
+}
+
+//______________________________________________________________________________
+
+bool PurgeIndex::WriteSummary(const std::string &path)
+{
+   std::string data;
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+      if ( ! m_summary || ! m_summary->Export(data)) return true;
+   }
+
+   if ( ! Summary::Write(path, data))
+   {
+      TRACE(Error, "PurgeIndex::WriteSummary() failed to write " << path << ", err " << strerror(errno));
+      return false;
+   }
+   TRACE(Debug, "PurgeIndex::WriteSummary() wrote " << path);
+   return true;
+}
+
+//______________________________________________________________________________
+
+bool PurgeIndex::ParsePolicy(const char *name, Policy_e &policy)
+{
+   if      ( ! strcmp(name, "lru"))    policy = kLRU;
+   else if ( ! strcmp(name, "size"))   policy = kSize;
+   else if ( ! strcmp(name, "agepop")) policy = kAgePop;
+   else return false;
+   return true;
+}
+
+const char* PurgeIndex::PolicyName(Policy_e policy)
+{
+   static const char *names[] = { "lru", "size", "agepop" };
+   return names[policy];
+}
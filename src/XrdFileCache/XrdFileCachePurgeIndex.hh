@@ -0,0 +1,168 @@
+#ifndef __XRDFILECACHE_PURGEINDEX_HH__
+#define __XRDFILECACHE_PURGEINDEX_HH__
+
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <time.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdOss;
+
+namespace XrdFileCache
+{
+class Summary;
+
+//----------------------------------------------------------------------------
+//! Index of cached files used to select purge victims.
+//!
+//! Each entry is keyed by the path of the .cinfo file and holds the last
+//! access time, number of bytes on disk, number of accesses, the storage
+//! tier the data file is in and whether it is complete. Files update
+//! their entry on attach and detach so the cache namespace only has to be
+//! scanned at startup, and then rarely to pick up changes made behind the
+//! cache's back. The index can be saved to and loaded from a file in the
+//! cache so that a restart does not require a scan. Optionally the index
+//! maintains a Summary of the cached files for the redirector.
+//----------------------------------------------------------------------------
+class PurgeIndex
+{
+public:
+   enum Policy_e
+   {
+      kLRU,        //!< least recently used first
+      kSize,       //!< largest age times size first
+      kAgePop      //!< largest age divided by number of accesses first
+   };
+
+   struct Victim
+   {
+      Victim(const std::string &p, long long n) : m_path(p), m_nBytes(n) {}
+      std::string m_path;               //!< path of the cinfo file
+      long long   m_nBytes;             //!< bytes on disk
+   };
+
+   PurgeIndex();
+   ~PurgeIndex();
+
+   //---------------------------------------------------------------------
+   //! Add or update the entry of a cinfo file.
+   //---------------------------------------------------------------------
+   void Update(const std::string &cinfoPath, time_t atime, long long nBytes, int nAccess, int tier,
+               bool complete);
+
+   //---------------------------------------------------------------------
+   //! Remove the entry of a purged file.
+   //---------------------------------------------------------------------
+   void Remove(const std::string &cinfoPath);
+
+   //---------------------------------------------------------------------
+   //! Record that the data file of an entry was moved to another tier.
+   //---------------------------------------------------------------------
+   void SetTier(const std::string &cinfoPath, int tier);
+
+   //---------------------------------------------------------------------
+   //! Select files of the given tier to purge until at least nBytes are
+   //! covered, best candidates first. LRU selection is O(k); other
+   //! policies have to score every entry.
+   //---------------------------------------------------------------------
+   void GetVictims(Policy_e policy, long long nBytes, int tier, std::vector<Victim> &victims);
+
+   //---------------------------------------------------------------------
+   //! Select files of the fast tier to move out of it, least recently used
+   //! first: all those last accessed before t and then more until at least
+   //! nBytes are covered.
+   //---------------------------------------------------------------------
+   void GetDemoteCandidates(time_t t, long long nBytes, std::vector<Victim> &victims);
+
+   //---------------------------------------------------------------------
+   //! Select files of the bulk tier accessed since t with at least
+   //! minAccess accesses in total, most recently used first.
+   //---------------------------------------------------------------------
+   void GetPromoteCandidates(time_t t, int minAccess, std::vector<Victim> &victims);
+
+   //---------------------------------------------------------------------
+   //! Number of files in the index.
+   //---------------------------------------------------------------------
+   int  Size();
+
+   //---------------------------------------------------------------------
+   //! Replace the index with the result of a scan of the cache namespace
+   //! done by nThreads threads. Entries updated while the scan runs are
+   //! kept.
+   //---------------------------------------------------------------------
+   void Rebuild(XrdOss *oss, const char *user, int nThreads);
+
+   //---------------------------------------------------------------------
+   //! Load the index saved in path. On success saveTime is the time the
+   //! index was saved.
+   //---------------------------------------------------------------------
+   bool Load(XrdOss *oss, const char *user, const std::string &path, time_t &saveTime);
+
+   //---------------------------------------------------------------------
+   //! Save the index to path if it changed since the last Load or Save.
+   //---------------------------------------------------------------------
+   bool Save(XrdOss *oss, const char *user, const std::string &path);
+
+   //---------------------------------------------------------------------
+   //! Maintain a summary of the cached files from now on. Must be called
+   //! before the index is first filled.
+   //---------------------------------------------------------------------
+   void EnableSummary(int nBits, int nHash, bool hdfsmode);
+
+   //---------------------------------------------------------------------
+   //! Write the summary to path if it changed since the last write.
+   //---------------------------------------------------------------------
+   bool WriteSummary(const std::string &path);
+
+   static bool        ParsePolicy(const char *name, Policy_e &policy);
+   static const char* PolicyName(Policy_e policy);
+
+   struct Entry
+   {
+      Entry() : m_atime(0), m_nBytes(0), m_nAccess(0), m_tier(0), m_complete(false) {}
+      time_t    m_atime;
+      long long m_nBytes;
+      int       m_nAccess;
+      int       m_tier;                 //!< 0 for the data space, 1 for the fast space
+      bool      m_complete;             //!< all blocks are on disk
+   };
+
+   typedef std::map<std::string, Entry> EntryMap_t;
+
+private:
+   typedef std::pair<time_t, const std::string*> TimeKey_t;
+   typedef std::set<TimeKey_t>                    TimeSet_t;
+
+   void insert(const std::string &path, const Entry &e);
+   void clear();
+
+   XrdSysMutex m_mutex;
+   EntryMap_t  m_entries;               //!< entries by cinfo path
+   TimeSet_t   m_byTime;                //!< entries by access time
+   long long   m_nChanges;              //!< changes since last Load or Save
+   Summary    *m_summary;               //!< summary of cached files, if enabled
+};
+}
+
+#endif
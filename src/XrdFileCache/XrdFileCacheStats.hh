@@ -56,6 +56,25 @@ public:
 private:
    XrdSysMutex m_MutexXfc;
 };
+
+//----------------------------------------------------------------------------
+//! Statistics of the RAM block pool, see BlockPool.
+//----------------------------------------------------------------------------
+struct BlockPoolStats
+{
+   BlockPoolStats() :
+      m_nAlloc(0), m_nAllocHeap(0), m_nFirstTouch(0),
+      m_nMinorFaults(0), m_nMajorFaults(0), m_nFree(0), m_nSlots(0)
+   {}
+
+   long long m_nAlloc;            //!< buffers taken from the pool
+   long long m_nAllocHeap;        //!< buffers allocated outside the pool (too large or pool empty)
+   long long m_nFirstTouch;       //!< pool slots used for the first time, i.e. faulted in
+   long long m_nMinorFaults;      //!< minor page faults of the process
+   long long m_nMajorFaults;      //!< major page faults of the process
+   int       m_nFree;             //!< free pool slots
+   int       m_nSlots;            //!< total pool slots
+};
 }
 
 #endif
@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "XrdFileCacheSummary.hh"
+#include "XrdFileCacheInfo.hh"
+
+using namespace XrdFileCache;
+
+//______________________________________________________________________________
+
+Summary::Summary(int nBits, int nHash, bool hdfsmode) :
+   m_any(nBits, nHash),
+   m_complete(nBits, nHash),
+   m_hdfsmode(hdfsmode),
+   m_nChanges(1),
+   m_generation(time(0))
+{}
+
+//______________________________________________________________________________
+
+std::string Summary::lfn(const std::string &cinfoPath) const
+{
+   // Managers test the path the client asked for, so strip the cinfo
+   // extension and, in hdfs mode, the block suffix <path>___<size>_<offset>.
+   size_t len = cinfoPath.size() - strlen(Info::m_infoExtension);
+   if (m_hdfsmode)
+   {
+      size_t pos = cinfoPath.rfind("___", len);
+      if (pos != std::string::npos) len = pos;
+   }
+
+   size_t beg = cinfoPath.find_first_not_of('/');
+   if (beg == std::string::npos || beg > len) return "/";
+   return "/" + cinfoPath.substr(beg, len - beg);
+}
+
+//______________________________________________________________________________
+
+void Summary::Add(const std::string &cinfoPath, bool complete)
+{
+   std::string key = lfn(cinfoPath);
+   m_any.Add(key.c_str());
+   if (complete && ! m_hdfsmode) m_complete.Add(key.c_str());
+   ++m_nChanges;
+}
+
+//______________________________________________________________________________
+
+void Summary::Remove(const std::string &cinfoPath, bool complete)
+{
+   std::string key = lfn(cinfoPath);
+   m_any.Del(key.c_str());
+   if (complete && ! m_hdfsmode) m_complete.Del(key.c_str());
+   ++m_nChanges;
+}
+
+//______________________________________________________________________________
+
+void Summary::SetComplete(const std::string &cinfoPath, bool complete)
+{
+   if (m_hdfsmode) return;
+
+   std::string key = lfn(cinfoPath);
+   if (complete) m_complete.Add(key.c_str());
+   else          m_complete.Del(key.c_str());
+   ++m_nChanges;
+}
+
+//______________________________________________________________________________
+
+void Summary::Clear()
+{
+   m_any.Clear();
+   m_complete.Clear();
+   ++m_nChanges;
+}
+
+//______________________________________________________________________________
+
+bool Summary::Export(std::string &data)
+{
+   if ( ! m_nChanges) return false;
+
+   char head[128];
+   int  hlen  = snprintf(head, sizeof(head), "pfc-summary 1 %u %d %d\n",
+                         ++m_generation, m_any.Bits(), m_any.Hashes());
+   int  nBytes = m_any.Bits() / 8;
+
+   data.assign(head, hlen);
+   data.resize(hlen + 2 * nBytes);
+   m_any.Export((unsigned char*) &data[hlen]);
+   m_complete.Export((unsigned char*) &data[hlen + nBytes]);
+   m_nChanges = 0;
+   return true;
+}
+
+//______________________________________________________________________________
+
+bool Summary::Write(const std::string &path, const std::string &data)
+{
+   // The summary is read by the cmsd, not through the oss, so it is written
+   // with plain file operations and renamed into place.
+   std::string tmp = path + ".tmp";
+   int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (fd < 0) return false;
+
+   const char *p = data.c_str();
+   size_t      left = data.size();
+   while (left > 0)
+   {
+      ssize_t n = write(fd, p, left);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) break;
+      p += n; left -= n;
+   }
+   if (close(fd) || left || rename(tmp.c_str(), path.c_str()))
+   {
+      unlink(tmp.c_str());
+      return false;
+   }
+   return true;
+}
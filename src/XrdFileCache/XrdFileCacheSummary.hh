@@ -0,0 +1,79 @@
+#ifndef __XRDFILECACHE_SUMMARY_HH__
+#define __XRDFILECACHE_SUMMARY_HH__
+
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <string>
+
+#include "XrdOuc/XrdOucBloom.hh"
+
+namespace XrdFileCache
+{
+//----------------------------------------------------------------------------
+//! Counting Bloom filters of the lfns of cached files, one of all files
+//! and one of complete files.
+//!
+//! The summary is kept up to date by the PurgeIndex and periodically
+//! written to a file from which the cmsd of the node forwards it to its
+//! managers, so they can prefer nodes that hold a file. In hdfs mode each
+//! block file counts towards the lfn it belongs to, and a file is never
+//! complete. Not thread safe; the PurgeIndex serializes access.
+//----------------------------------------------------------------------------
+class Summary
+{
+public:
+   Summary(int nBits, int nHash, bool hdfsmode);
+
+   //---------------------------------------------------------------------
+   //! Add or remove a cached file given the path of its cinfo file.
+   //---------------------------------------------------------------------
+   void Add(const std::string &cinfoPath, bool complete);
+   void Remove(const std::string &cinfoPath, bool complete);
+
+   //---------------------------------------------------------------------
+   //! Record that a cached file became complete or was truncated.
+   //---------------------------------------------------------------------
+   void SetComplete(const std::string &cinfoPath, bool complete);
+
+   void Clear();
+
+   //---------------------------------------------------------------------
+   //! Serialize the filters if they changed since the last call.
+   //! Format: header line "pfc-summary 1 <generation> <bits> <hashes>"
+   //! followed by the bit vector of all files and that of complete files.
+   //---------------------------------------------------------------------
+   bool Export(std::string &data);
+
+   //---------------------------------------------------------------------
+   //! Atomically replace the file at path with data.
+   //---------------------------------------------------------------------
+   static bool Write(const std::string &path, const std::string &data);
+
+private:
+   std::string lfn(const std::string &cinfoPath) const;
+
+   XrdOucBloom   m_any;            //!< all cached files
+   XrdOucBloom   m_complete;       //!< completely cached files
+   bool          m_hdfsmode;
+   long long     m_nChanges;       //!< changes since the last Export
+   unsigned int  m_generation;
+};
+}
+
+#endif
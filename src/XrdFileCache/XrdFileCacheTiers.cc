@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdFileCache.hh"
+#include "XrdFileCacheInfo.hh"
+#include "XrdFileCacheTrace.hh"
+
+using namespace XrdFileCache;
+
+//______________________________________________________________________________
+
+int Cache::GetTier(const std::string &dataPath)
+{
+   if (m_configuration.m_fast_space.empty()) return 0;
+
+   // The oss reports the space a file was allocated in as its cache group.
+   char buff[1024];
+   int  blen = sizeof(buff);
+   if (m_output_fs->StatXA(dataPath.c_str(), buff, blen) != XrdOssOK) return 0;
+
+   XrdOucEnv   env(buff, blen);
+   const char *cgroup = env.Get("oss.cgroup");
+   return (cgroup && m_configuration.m_fast_space == cgroup) ? 1 : 0;
+}
+
+//______________________________________________________________________________
+
+bool Cache::MoveToTier(const PurgeIndex::Victim &v, int tier, time_t hotSince)
+{
+   const char *user = m_configuration.m_username.c_str();
+   std::string dataPath = v.m_path.substr(0, v.m_path.size() - strlen(Info::m_infoExtension));
+
+   // Only complete files are moved. Their data file is never written again,
+   // so clients that still have the old copy open keep reading valid data.
+   XrdOucEnv env;
+   XrdOssDF *fh = m_output_fs->newFile(user);
+   Info      cinfo(m_trace);
+   bool      ok = fh->Open(v.m_path.c_str(), O_RDONLY, 0600, env) == XrdOssOK &&
+                  cinfo.Read(fh, v.m_path) && cinfo.IsComplete();
+   fh->Close();
+   delete fh;
+   if ( ! ok) return false;
+
+   if (tier == 1 && cinfo.GetNAccessesSince(hotSince) < m_configuration.m_tierHotAccesses)
+      return false;
+
+   const std::string &space = (tier == 1) ? m_configuration.m_fast_space : m_configuration.m_data_space;
+   int rc = m_output_fs->Reloc(user, dataPath.c_str(), space.c_str());
+   if (rc == -EEXIST)
+   {
+      // Already there, e.g. moved behind our back; fix the index.
+      m_purgeIndex.SetTier(v.m_path, tier);
+      return false;
+   }
+   if (rc != XrdOssOK)
+   {
+      TRACE(Warning, "Cache::MoveToTier() failed to move " << dataPath << " to space " << space
+            << ", err " << strerror(-rc));
+      return false;
+   }
+
+   m_purgeIndex.SetTier(v.m_path, tier);
+   TRACE(Info, "Cache::MoveToTier() moved " << dataPath << " size " << v.m_nBytes << " to space " << space);
+   return true;
+}
+
+//______________________________________________________________________________
+
+void Cache::BalanceTiers()
+{
+   if (m_configuration.m_fast_space.empty()) return;
+
+   XrdOssVSInfo sP;
+   if (m_output_fs->StatVS(&sP, m_configuration.m_fast_space.c_str(), 1) < 0)
+   {
+      TRACE(Error, "Cache::BalanceTiers() can't get statvs for oss space " << m_configuration.m_fast_space);
+      return;
+   }
+   long long used  = sP.Total - sP.Free;
+   time_t    since = time(0) - m_configuration.m_tierWindow;
+   int       nDemoted = 0, nPromoted = 0;
+
+   // Demote files not accessed within the window and, when above the high
+   // water mark, least recently used ones until below the low water mark.
+   std::vector<PurgeIndex::Victim> cands;
+   long long bytesToFree = (used > m_configuration.m_fastUsageHWM) ? used - m_configuration.m_fastUsageLWM : 0;
+   m_purgeIndex.GetDemoteCandidates(since, bytesToFree, cands);
+   for (std::vector<PurgeIndex::Victim>::iterator it = cands.begin(); it != cands.end(); ++it)
+   {
+      if (MoveToTier(*it, 0, since))
+      {
+         used -= it->m_nBytes;
+         ++nDemoted;
+      }
+   }
+
+   // Promote hot files as long as they fit below the low water mark, so a
+   // promotion never triggers a demotion on the next pass.
+   cands.clear();
+   m_purgeIndex.GetPromoteCandidates(since, m_configuration.m_tierHotAccesses, cands);
+   for (std::vector<PurgeIndex::Victim>::iterator it = cands.begin(); it != cands.end(); ++it)
+   {
+      if (used + it->m_nBytes > m_configuration.m_fastUsageLWM) continue;
+
+      if (MoveToTier(*it, 1, since))
+      {
+         used += it->m_nBytes;
+         ++nPromoted;
+      }
+   }
+
+   TRACE(Info, "Cache::BalanceTiers() fast space used " << used << " bytes, promoted " << nPromoted
+         << " demoted " << nDemoted << " files.");
+}
@@ -7,11 +7,14 @@
 #include "XrdFileCacheIO.hh"
 
 #include "XrdOss/XrdOss.hh"
+#include "XrdSys/XrdSysPthread.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClFile.hh"
 #include "XrdCl/XrdClXRootDResponses.hh"
 #include "XrdPosix/XrdPosixFile.hh"
 
+#include <algorithm>
+
 namespace XrdFileCache
 {
 // a list of IOVec chuncks that match a given block index
@@ -72,17 +75,161 @@ struct ReadVBlockListDisk
       bv.back().arr.push_back(chunkIdx);
    }
 };
+
+struct ReadVDiskRead;
+
+// Part of the disk segments of a readv.
+struct ReadVDiskPart
+{
+   ReadVDiskPart() : m_rd(0), m_vec(0), m_n(0), m_next(0) {}
+
+   ReadVDiskRead *m_rd;
+   XrdOucIOVec   *m_vec;
+   int            m_n;
+   ReadVDiskPart *m_next;
+
+   void Run();
+};
+
+// Threads of the cache that read disk parts. The callers are server threads,
+// so the parts must not be queued to the server scheduler they would then be
+// waiting on. A part is only handed over when a thread is free to read it,
+// otherwise the caller reads it itself.
+class ReadVDiskPool
+{
+public:
+   static bool Post(ReadVDiskPart *part)
+   {
+      pthread_t tid;
+
+      XrdSysCondVarHelper _lck(s_cond);
+      if (s_idle > 0)
+         --s_idle;
+      else if (s_threads < s_maxThreads &&
+               XrdSysThread::Run(&tid, Worker, 0, 0, "XrdFileCache ReadV") == 0)
+         ++s_threads;
+      else
+         return false;
+
+      part->m_next = s_queue;
+      s_queue      = part;
+      s_cond.Signal();
+      return true;
+   }
+
+private:
+   static void* Worker(void*)
+   {
+      XrdSysCondVarHelper _lck(s_cond);
+      while (true)
+      {
+         while ( ! s_queue)
+            s_cond.Wait();
+         ReadVDiskPart *part = s_queue;
+         s_queue = part->m_next;
+         s_cond.UnLock();
+         part->Run();
+         s_cond.Lock();
+         ++s_idle;
+      }
+      return 0;
+   }
+
+   static const int      s_maxThreads = 16;
+   static XrdSysCondVar  s_cond;
+   static ReadVDiskPart *s_queue;
+   static int            s_idle;
+   static int            s_threads;
+};
+
+XrdSysCondVar  ReadVDiskPool::s_cond(0);
+ReadVDiskPart *ReadVDiskPool::s_queue   = 0;
+int            ReadVDiskPool::s_idle    = 0;
+int            ReadVDiskPool::s_threads = 0;
+
+// Disk segments of a readv, read in parts that run in parallel on the pool
+// while the caller copies RAM blocks.
+struct ReadVDiskRead
+{
+   XrdOssDF                   *m_oss;
+   std::vector<XrdOucIOVec>    m_segs;
+   std::vector<ReadVDiskPart>  m_parts;
+   XrdSysCondVar               m_cond;
+   int                         m_to_wait;
+   int                         m_errno;
+   long long                   m_bytes;
+
+   ReadVDiskRead(XrdOssDF *oss) : m_oss(oss), m_cond(0), m_to_wait(0), m_errno(0), m_bytes(0) {}
+
+   void Done(ssize_t rc)
+   {
+      XrdSysCondVarHelper _lck(m_cond);
+      if (rc < 0) { if ( ! m_errno) m_errno = (int) -rc; }
+      else          m_bytes += rc;
+      if (--m_to_wait == 0) m_cond.Signal();
+   }
+
+   // Split the segments into parts of about equal size and start them. Parts
+   // the pool can not take are read inline, as is the last part when the
+   // caller has nothing else to do.
+   void Start(int maxParts, int minPart, bool runLastInline)
+   {
+      if (m_segs.empty()) return;
+
+      long long total = 0;
+      for (std::vector<XrdOucIOVec>::iterator i = m_segs.begin(); i != m_segs.end(); ++i)
+         total += i->size;
+
+      int nParts = std::min((long long) maxParts, std::max(1LL, total / minPart));
+      nParts = std::min(nParts, (int) m_segs.size());
+
+      m_parts.resize(nParts);
+      m_to_wait = nParts;
+
+      int       s    = 0;
+      long long done = 0;
+      for (int p = 0; p < nParts; ++p)
+      {
+         long long goal = total * (p + 1) / nParts;
+         m_parts[p].m_rd  = this;
+         m_parts[p].m_vec = &m_segs[s];
+         while (s < (int) m_segs.size() && (done < goal || p == nParts - 1))
+            done += m_segs[s++].size;
+         m_parts[p].m_n = &m_segs[0] + s - m_parts[p].m_vec;
+      }
+
+      int nPost = runLastInline ? nParts - 1 : nParts;
+      for (int p = 0; p < nPost; ++p)
+      {
+         if ( ! ReadVDiskPool::Post(&m_parts[p]))
+            m_parts[p].Run();
+      }
+      if (runLastInline) m_parts.back().Run();
+   }
+
+   void Wait()
+   {
+      XrdSysCondVarHelper _lck(m_cond);
+      while (m_to_wait > 0)
+         m_cond.Wait();
+   }
+};
+
+void ReadVDiskPart::Run()
+{
+   m_rd->Done(m_rd->m_oss->ReadV(m_vec, m_n));
+}
 }
 
 using namespace XrdFileCache;
 
 //------------------------------------------------------------------------------
 
-int File::ReadV(const XrdOucIOVec *readV, int n)
+int File::ReadV(IO *io, const XrdOucIOVec *readV, int n)
 {
    if ( ! isOpen())
    {
-      return m_io->GetInput()->ReadV(readV, n);
+      return io->GetInput()->ReadV(readV, n);
    }
 
    TRACEF(Dump, "ReadV for " << n << " chunks.");
@@ -98,39 +245,40 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
    ReadVBlockListRAM blocks_to_process;
    std::vector<ReadVChunkListRAM> blks_processed;
    ReadVBlockListDisk blocks_on_disk;
+   BlockList_t                    blks_to_request;
    std::vector<XrdOucIOVec>       chunkVec;
    DirectResponseHandler         *direct_handler = 0;
+   ReadVDiskRead                  disk_read(m_output);
 
    // TODO The following call never fails (other than with out of mem exception).
    // This should be implemented in PrepareBlockRequest().
-   if ( ! VReadPreProcess(readV, n, blocks_to_process, blocks_on_disk, chunkVec))
+   if ( ! VReadPreProcess(readV, n, blocks_to_process, blocks_on_disk, blks_to_request, chunkVec))
    {
       bytesRead = -1;
       errno = ENOMEM;
    }
 
-   // issue a client read
+   // All sources are started before waiting for any of them, so the readv
+   // completes when its slowest segment arrives. Remote requests go out
+   // first as they have the longest latency.
 
-   if (bytesRead >= 0)
+   if (bytesRead >= 0 && ! chunkVec.empty())
    {
-      if ( ! chunkVec.empty())
-      {
-         direct_handler = new DirectResponseHandler(1);
-         m_io->GetInput()->ReadV(*direct_handler, &chunkVec[0], chunkVec.size());
-      }
+      direct_handler = new DirectResponseHandler(1);
+      io->GetInput()->ReadV(*direct_handler, &chunkVec[0], chunkVec.size());
    }
 
-   // disk read
+   // Blocks that were inserted into the map must be requested even if
+   // preprocessing failed, other readers may already be waiting for them.
+   ProcessBlockRequests(blks_to_request, io);
+
    if (bytesRead >= 0)
    {
-      int dr = VReadFromDisk(readV, n, blocks_on_disk);
-      if (dr < 0)
-         bytesRead = dr;
-      else
-         bytesRead += dr;
+      VReadDiskSegments(readV, n, blocks_on_disk, disk_read.m_segs);
+      disk_read.Start(s_vreadDiskParts, s_vreadDiskMinPart, blocks_to_process.bv.empty());
    }
 
-   // read from cached blocks
+   // Copy RAM blocks in the order they arrive while the disk reads run.
    if (bytesRead >= 0)
    {
       int br = VReadProcessBlocks(readV, n, blocks_to_process.bv, blks_processed);
@@ -140,8 +288,22 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
          bytesRead += br;
    }
 
-   // check direct requests have arrived, get bytes read from read handle
-   if (bytesRead >= 0 && direct_handler != 0)
+   // Disk parts and the direct request write into the user buffers, they
+   // have to finish even when an error has already been seen.
+   disk_read.Wait();
+   if (disk_read.m_errno)
+   {
+      TRACEF(Error, "ReadV disk read failed " << strerror(disk_read.m_errno));
+      if (bytesRead >= 0) errno = disk_read.m_errno;
+      bytesRead = -1;
+   }
+   else if (bytesRead >= 0)
+   {
+      bytesRead           += disk_read.m_bytes;
+      m_stats.m_BytesDisk += disk_read.m_bytes;
+   }
+
+   if (direct_handler != 0)
    {
       XrdSysCondVarHelper _lck(direct_handler->m_cond);
 
@@ -150,7 +312,7 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
          direct_handler->m_cond.Wait();
       }
 
-      if (direct_handler->m_errno == 0)
+      if (bytesRead >= 0 && direct_handler->m_errno == 0)
       {
          for (std::vector<XrdOucIOVec>::iterator i = chunkVec.begin(); i != chunkVec.end(); ++i)
          {
@@ -158,7 +320,7 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
             m_stats.m_BytesMissed += i->size;
          }
       }
-      else
+      else if (bytesRead >= 0)
       {
          errno = -direct_handler->m_errno;
          bytesRead = -1;
@@ -166,15 +328,41 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
    }
 
    {
+      const long long BS = m_cfi.GetBufferSize();
+      int first = n > 0 ? readV[0].offset / BS : 0, last = first;
+      for (int i = 0; i < n; ++i)
+      {
+         first = std::min(first, (int) (readV[i].offset / BS));
+         last  = std::max(last,  (int) ((readV[i].offset + std::max(readV[i].size, 1) - 1) / BS));
+      }
+
       XrdSysCondVarHelper _lck(m_downloadCond);
 
+      // update prefetch score, the blocks are still referenced here
+      for (std::vector<ReadVChunkListRAM>::iterator i = blks_processed.begin(); i != blks_processed.end(); ++i)
+      {
+         if (i->block->m_prefetch)
+            m_prefetchHitCnt++;
+      }
+      for (std::vector<ReadVChunkListDisk>::iterator i = blocks_on_disk.bv.begin(); i != blocks_on_disk.bv.end(); ++i)
+      {
+         if (m_cfi.TestPrefetchBit(offsetIdx(i->block_idx)))
+            m_prefetchHitCnt++;
+      }
+      if (m_prefetchReadCnt)
+         m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
+
+      if (n > 0) m_prefetcher->Access(first, last, n);
+   }
+
+   {
       // decrease ref count on the remaining blocks
       // this happens in case read process has been broke due to previous errors
       for (std::vector<ReadVChunkListRAM>::iterator i = blocks_to_process.bv.begin(); i != blocks_to_process.bv.end(); ++i)
-         dec_ref_count(i->block);
+         release_block(i->block);
 
       for (std::vector<ReadVChunkListRAM>::iterator i = blks_processed.begin(); i != blks_processed.end(); ++i)
-         dec_ref_count(i->block);
+         release_block(i->block);
    }
 
    // remove objects on heap
@@ -208,12 +396,9 @@ bool File::VReadValidate(const XrdOucIOVec *vr, int n)
 bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
                            ReadVBlockListRAM        &blocks_to_process,
                            ReadVBlockListDisk       &blocks_on_disk,
+                           BlockList_t              &blks_to_request,
                            std::vector<XrdOucIOVec> &chunkVec)
 {
-   BlockList_t blks_to_request;
-
-   m_downloadCond.Lock();
-
    for (int iov_idx = 0; iov_idx < n; iov_idx++)
    {
       const int blck_idx_first =  readV[iov_idx].offset / m_cfi.GetBufferSize();
@@ -223,8 +408,10 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
       {
          TRACEF(Dump, "VReadPreProcess chunk "<<  readV[iov_idx].size << "@"<< readV[iov_idx].offset);
 
-         BlockMap_i bi = m_block_map.find(block_idx);
-         if (bi != m_block_map.end())
+         BlockShard &shd = shard(block_idx);
+         lock_shard(shd);
+         BlockMap_i bi = shd.m_map.find(block_idx);
+         if (bi != shd.m_map.end())
          {
             if (blocks_to_process.AddEntry(bi->second, iov_idx))
                inc_ref_count(bi->second);
@@ -243,7 +430,11 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
             {
                Block *b = PrepareBlockRequest(block_idx, false);
                // TODO this can not fail (other than out of memory which we don't handle).
-               if (! b) return false;
+               if (! b)
+               {
+                  shd.m_cond.UnLock();
+                  return false;
+               }
                inc_ref_count(b);
                blocks_to_process.AddEntry(b, iov_idx);
                blks_to_request.push_back(b);
@@ -262,21 +453,25 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
                TRACEF(Dump, "VReadPreProcess direct read " << block_idx);
             }
          }
+         shd.m_cond.UnLock();
       }
    }
 
-   m_downloadCond.UnLock();
-
-   ProcessBlockRequests(blks_to_request);
-
    return true;
 }
 
 //------------------------------------------------------------------------------
 
-int File::VReadFromDisk(const XrdOucIOVec *readV, int n, ReadVBlockListDisk& blocks_on_disk)
+namespace
 {
-   int bytes_read = 0;
+bool segment_less(const XrdOucIOVec &a, const XrdOucIOVec &b) { return a.offset < b.offset; }
+}
+
+void File::VReadDiskSegments(const XrdOucIOVec *readV, int n, ReadVBlockListDisk& blocks_on_disk,
+                             std::vector<XrdOucIOVec> &segs)
+{
+   const long long BS = m_cfi.GetBufferSize();
+
    for (std::vector<ReadVChunkListDisk>::iterator bit = blocks_on_disk.bv.begin(); bit != blocks_on_disk.bv.end(); ++bit )
    {
       int blockIdx = bit->block_idx;
@@ -288,27 +483,33 @@ int File::VReadFromDisk(const XrdOucIOVec *readV, int n, ReadVBlockListDisk& blo
          long long blk_off;    // offset in block
          long long size;    // size to copy
 
-         TRACEF(Dump, "VReadFromDisk block= " << blockIdx <<" chunk=" << chunkIdx);
+         TRACEF(Dump, "VReadDiskSegments block= " << blockIdx <<" chunk=" << chunkIdx);
 
-         overlap(blockIdx, m_cfi.GetBufferSize(), readV[chunkIdx].offset, readV[chunkIdx].size, off, blk_off, size);
+         overlap(blockIdx, BS, readV[chunkIdx].offset, readV[chunkIdx].size, off, blk_off, size);
+         segs.push_back(XrdOucIOVec2(readV[chunkIdx].data + off, blockIdx*BS + blk_off - m_offset, size));
+      }
+   }
 
-         int rs = m_output->Read(readV[chunkIdx].data + off,  blockIdx*m_cfi.GetBufferSize() + blk_off - m_offset, size);
-         if (rs >=0)
-         {
-            bytes_read += rs;
-            m_stats.m_BytesDisk += rs;
-         }
-         else
-         {
-            // ofs read should set the errno
-            TRACEF(Error, "VReadFromDisk FAILED block=" << blockIdx << " chunk=" << chunkIdx << " off= " << off  << " blk_off=" <<  blk_off << " size = " << size <<  "chunOff " << readV[chunkIdx].offset);
+   // Read in file order and merge the pieces of a chunk that spans several
+   // blocks, they are contiguous both on disk and in the user buffer. Merged
+   // segments are kept within a block size so large reads can still be split
+   // into parallel parts.
+   std::sort(segs.begin(), segs.end(), segment_less);
 
-            return -1;
-         }
+   std::vector<XrdOucIOVec>::iterator out = segs.begin();
+   for (std::vector<XrdOucIOVec>::iterator i = segs.begin(); i != segs.end(); ++i)
+   {
+      if (i != segs.begin() && out->offset + out->size == i->offset &&
+          out->data + out->size == i->data && (long long) out->size + i->size <= BS)
+      {
+         out->size += i->size;
+      }
+      else if (i != segs.begin())
+      {
+         *(++out) = *i;
       }
    }
-
-   return bytes_read;
+   if ( ! segs.empty()) segs.erase(++out, segs.end());
 }
 
 //------------------------------------------------------------------------------
@@ -322,11 +523,10 @@ int File::VReadProcessBlocks(const XrdOucIOVec *readV, int n,
    {
       std::vector<ReadVChunkListRAM> finished;
       {
-         XrdSysCondVarHelper _lck(m_downloadCond);
          std::vector<ReadVChunkListRAM>::iterator bi = blocks_to_process.begin();
          while (bi != blocks_to_process.end())
          {
-            if (bi->block->is_finished())
+            if (block_finished(bi->block))
             {
                finished.push_back(ReadVChunkListRAM(bi->block, bi->arr));
                // Here we rely on the fact that std::vector does not reallocate on erase!
@@ -340,7 +540,7 @@ int File::VReadProcessBlocks(const XrdOucIOVec *readV, int n,
 
          if (finished.empty())
          {
-            m_downloadCond.Wait();
+            wait_for_block(blocks_to_process.front().block);
             continue;
          }
       }
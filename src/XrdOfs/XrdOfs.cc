@@ -58,6 +58,7 @@
 #include "XrdOfs/XrdOfsSecurity.hh"
 #include "XrdOfs/XrdOfsStats.hh"
 #include "XrdOfs/XrdOfsTPC.hh"
+#include "XrdOfs/XrdOfsWrCks.hh"
 
 #include "XrdCms/XrdCmsClient.hh"
 
@@ -74,11 +75,13 @@
 #include "XrdOuc/XrdOucERoute.hh"
 #include "XrdOuc/XrdOucLock.hh"
 #include "XrdOuc/XrdOucMsubs.hh"
+#include "XrdOuc/XrdOucSFVec.hh"
 #include "XrdOuc/XrdOucTList.hh"
 #include "XrdOuc/XrdOucTPC.hh"
 #include "XrdOuc/XrdOucTrace.hh"
 #include "XrdSec/XrdSecEntity.hh"
 #include "XrdSfs/XrdSfsAio.hh"
+#include "XrdSfs/XrdSfsDio.hh"
 #include "XrdSfs/XrdSfsFlags.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
 
@@ -635,6 +638,11 @@ int XrdOfsFile::open(const char          *path,      // In
        dorawio = (open_mode & SFS_O_RAWIO ? 1 : 0);
       }
    oP.hP->Activate(oP.fP);
+
+// If the file starts out empty we can compute its checksums as it is written
+//
+   if (open_flag & (O_CREAT | O_TRUNC) && !oP.hP->isCompressed)
+      oP.hP->WrCks = XrdOfsWrCks::Alloc();
    oP.hP->UnLock();
 
 // Send an open event if we must
@@ -733,6 +741,12 @@ int XrdOfsFile::close()  // In
                }
       }
 
+// If this is the final close of a file whose checksums were computed as it
+// was written, record them now.
+//
+   if (hP->WrCks && hP->Usage() == 1)
+      {hP->WrCks->Done(hP); delete hP->WrCks; hP->WrCks = 0;}
+
 // We need to handle the cunudrum that an event may have to be sent upon
 // the final close. However, that would cause the path name to be destroyed.
 // So, we have two modes of logic where we copy out the pathname if a final
@@ -769,7 +783,10 @@ int            XrdOfsFile::fctl(const int               cmd,
 // See if we can do this
 //
    if (cmd == SFS_FCTL_GETFD)
-      {out_error.setErrCode(oh->Select().getFD());
+      {int fd = oh->Select().getFD();
+       if (fd < 0 && !dorawio && !oh->Select().Fctl(XRDOSS_FCTL_SFVEC, 0, 0))
+          fd = (int)SFS_SFIO_FDVAL;
+       out_error.setErrCode(fd);
        return SFS_OK;
       }
 
@@ -897,6 +914,50 @@ XrdSfsXferSize XrdOfsFile::read(XrdSfsFileOffset  offset,    // In
    return nbytes;
 }
 
+/******************************************************************************/
+/*                              S e n d D a t a                               */
+/******************************************************************************/
+
+int XrdOfsFile::SendData(XrdSfsDio         *sfDio,     // In
+                         XrdSfsFileOffset   offset,    // In
+                         XrdSfsXferSize     size)      // In
+/*
+  Function: Send `size' bytes at `offset' to the client using sendfile() when
+            the underlying storage holds all of them in local files (e.g. a
+            caching proxy).
+
+  Input:    sfDio     - The object used to send the data.
+            offset    - The absolute byte offset at which to start.
+            size      - The number of bytes to send.
+
+  Output:   Returns SFS_OK upon success or when nothing was sent, in which
+            case the caller must read the data. Returns SFS_ERROR o/w.
+*/
+{
+   EPNAME("SendData");
+   XrdOucSFVec sfVec[XrdOucSFVec::sfMax];
+   int sfNum, rc;
+
+// Perform required tracing
+//
+   FTRACE(read, size <<"@" <<offset <<" sendfile");
+
+// Find out where the data is. The first element belongs to the caller. A
+// failure here is left for the read() that follows to report.
+//
+   sfVec[1].offset = offset;
+   sfVec[1].sendsz = size;
+   sfNum = oh->Select().Fctl(XRDOSS_FCTL_SFVEC, XrdOucSFVec::sfMax-1,
+                             (const char *)&sfVec[1]);
+   if (sfNum <= 0) return SFS_OK;
+
+// Send the data
+//
+   if ((rc = sfDio->SendFile(sfVec, sfNum+1)) < 0)
+      return XrdOfsFS->Emsg(epname, error, EIO, "sendfile", oh->Name());
+   return SFS_OK;
+}
+
 /******************************************************************************/
 /*                                  r e a d v                                 */
 /******************************************************************************/
@@ -1023,6 +1084,7 @@ XrdSfsXferSize XrdOfsFile::write(XrdSfsFileOffset  offset,    // In
                             (off_t)offset, (size_t)blen));
    if (nbytes < 0)
       return XrdOfsFS->Emsg(epname, error, (int)nbytes, "write", oh);
+   if (oh->WrCks) oh->WrCks->Update(offset, buff, nbytes);
 
 // Return number of bytes written
 //
@@ -1046,8 +1108,9 @@ int XrdOfsFile::write(XrdSfsAio *aiop)
 
 // If this is a POSC file, we must convert the async call to a sync call as we
 // must trap any errors that unpersist the file. We can't do that via aio i/f.
+// The same applies when checksums are computed as the data is written.
 //
-   if (oh->isRW == XrdOfsHandle::opPC)
+   if (oh->isRW == XrdOfsHandle::opPC || oh->WrCks)
       {aiop->Result = this->write(aiop->sfsAio.aio_offset,
                                   (const char *)aiop->sfsAio.aio_buf,
                                   aiop->sfsAio.aio_nbytes);
@@ -1078,6 +1141,58 @@ int XrdOfsFile::write(XrdSfsAio *aiop)
    return SFS_OK;
 }
 
+/******************************************************************************/
+/*                                w r i t e v                                 */
+/******************************************************************************/
+
+XrdSfsXferSize XrdOfsFile::writev(XrdOucIOVec     *writeV,     // In
+                                  int              writeCount) // In
+/*
+  Function: Perform all the writes specified in the writeV vector.
+
+  Input:    writeV    - A description of the writes to perform; includes the
+                        absolute offset, the size of the write, and the buffer
+                        holding the data.
+            writeCount- The size of the writeV vector.
+
+  Output:   Returns the number of bytes written upon success and SFS_ERROR o/w.
+            If the number of bytes written is less than requested, it is
+            considered an error.
+*/
+{
+   EPNAME("writev");
+   XrdSfsXferSize nbytes;
+
+// Perform any required tracing
+//
+   FTRACE(write, writeCount <<" segments");
+
+// Make sure no offset is too large
+//
+#if _FILE_OFFSET_BITS!=64
+   for (int i = 0; i < writeCount; i++)
+       if (writeV[i].offset+writeV[i].size > 0x000000007fffffff)
+          return  XrdOfsFS->Emsg(epname, error, EFBIG, "write", oh);
+#endif
+
+// Silly Castor stuff
+//
+   if (XrdOfsFS->evsObject && !(oh->isChanged)
+   &&  XrdOfsFS->evsObject->Enabled(XrdOfsEvs::Fwrite)) GenFWEvent();
+
+// Write the requested segments
+//
+   oh->isPending = 1;
+   nbytes = (XrdSfsXferSize)(oh->Select().WriteV(writeV, writeCount));
+   if (nbytes < 0)
+      return XrdOfsFS->Emsg(epname, error, (int)nbytes, "writev", oh);
+   if (oh->WrCks) oh->WrCks->Update(writeV, writeCount);
+
+// Return number of bytes written
+//
+   return nbytes;
+}
+
 /******************************************************************************/
 /*                               g e t M m a p                                */
 /******************************************************************************/
@@ -1229,6 +1344,7 @@ int XrdOfsFile::truncate(XrdSfsFileOffset  flen)  // In
    oh->isPending = 1;
    if ((retc = oh->Select().Ftruncate(flen)))
       return XrdOfsFS->Emsg(epname, error, retc, "truncate", oh);
+   if (oh->WrCks) oh->WrCks->Truncate(flen);
 
 // Indicate Success
 //
@@ -138,12 +138,19 @@ public:
 
         int            read(XrdSfsAio *aioparm);
 
+        int            SendData(XrdSfsDio         *sfDio,
+                                XrdSfsFileOffset   offset,
+                                XrdSfsXferSize     size);
+
         XrdSfsXferSize write(XrdSfsFileOffset   fileOffset,
                              const char        *buffer,
                              XrdSfsXferSize     buffer_size);
 
         int            write(XrdSfsAio *aioparm);
 
+        XrdSfsXferSize writev(XrdOucIOVec      *writeV,
+                              int               writeCount);
+
         int            sync();
 
         int            sync(XrdSfsAio *aiop);
@@ -408,7 +415,9 @@ int           Forward(int &Result, XrdOucErrInfo &Resp, struct fwdOpt &Fwd,
                       XrdOucEnv  *Env1=0, XrdOucEnv  *Env2=0);
 int           Reformat(XrdOucErrInfo &);
 const char   *theRole(int opts);
+int           xccalc(XrdOucStream &, XrdSysError &);
 int           xcrds(XrdOucStream &, XrdSysError &);
+int           xcwrt(XrdOucStream &, XrdSysError &);
 int           xexp(XrdOucStream &, XrdSysError &, bool);
 int           xforward(XrdOucStream &, XrdSysError &);
 int           xmaxd(XrdOucStream &, XrdSysError &);
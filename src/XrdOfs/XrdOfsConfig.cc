@@ -42,6 +42,7 @@
 #include "XrdVersion.hh"
 
 #include "XrdCks/XrdCks.hh"
+#include "XrdCks/XrdCksManager.hh"
 
 #include "XrdOfs/XrdOfs.hh"
 #include "XrdOfs/XrdOfsConfigPI.hh"
@@ -50,6 +51,7 @@
 #include "XrdOfs/XrdOfsStats.hh"
 #include "XrdOfs/XrdOfsTPC.hh"
 #include "XrdOfs/XrdOfsTrace.hh"
+#include "XrdOfs/XrdOfsWrCks.hh"
 
 #include "XrdOss/XrdOss.hh"
 
@@ -250,6 +252,7 @@ int XrdOfs::Configure(XrdSysError &Eroute, XrdOucEnv *EnvInfo) {
       else {ofsConfig->Plugin(XrdOfsOss);
             ofsConfig->Plugin(Cks);
             CksPfn = !ofsConfig->OssCks();
+            if (!XrdOfsWrCks::Init(Eroute, Cks, CksPfn)) NoGo = 1;
             if (Options & Authorize)
                {ofsConfig->Plugin(Authorization);
                 XrdOfsTPC::Init(Authorization);
@@ -576,7 +579,9 @@ int XrdOfs::ConfigXeq(char *var, XrdOucStream &Config,
     //
     TS_Bit("authorize",     Options, Authorize);
     TS_XPI("authlib",       theAutLib);
+    TS_Xeq("ckscalc",       xccalc);
     TS_XPI("ckslib",        theCksLib);
+    TS_Xeq("ckswrite",      xcwrt);
     TS_Xeq("cksrdsz",       xcrds);
     TS_XPI("cmslib",        theCmsLib);
     TS_Xeq("forward",       xforward);
@@ -607,6 +612,94 @@ int XrdOfs::ConfigXeq(char *var, XrdOucStream &Config,
     return 0;
 }
 
+/******************************************************************************/
+/*                                x c c a l c                                 */
+/******************************************************************************/
+
+/* Function: xccalc
+
+   Purpose:  To parse the directive: ckscalc [parallel <n>] [maxthreads <n>]
+                                             [minrange <sz>] [[no]pipeline]
+
+             parallel   the maximum number of ranges of a file that may be
+                        checksummed in parallel. This only applies to
+                        checksums that can be combined (adler32, crc32, and
+                        crc32c). The default is 4, 1 turns this off.
+             maxthreads the maximum number of threads that may be used for
+                        parallel ranges and read-ahead across all checksum
+                        calculations. The default is 32.
+             minrange   the minimum size of a range. Can be suffixed by k,m,g.
+                        The default is 256m, the minimum is 1m.
+             pipeline   overlap reads with the checksum calculation (default).
+             nopipeline reads are done inline with the calculation.
+
+  Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdOfs::xccalc(XrdOucStream &Config, XrdSysError &Eroute)
+{
+   char *val, opt[16];
+   long long minR = 0;
+   int nPar = 0, maxT = -1;
+   bool pipe = true;
+
+   while((val = Config.GetWord()))
+        {if (!strcmp(val, "pipeline"))   {pipe = true;  continue;}
+         if (!strcmp(val, "nopipeline")) {pipe = false; continue;}
+         strlcpy(opt, val, sizeof(opt));
+         if (!(val = Config.GetWord()))
+            {Eroute.Emsg("Config", "ckscalc", opt, "value not specified");
+             return 1;
+            }
+              if (!strcmp(opt, "parallel"))
+                 {if (XrdOuca2x::a2i(Eroute, "ckscalc parallel", val,
+                                     &nPar, 1, 64)) return 1;
+                 }
+         else if (!strcmp(opt, "maxthreads"))
+                 {if (XrdOuca2x::a2i(Eroute, "ckscalc maxthreads", val,
+                                     &maxT, 0, 1024)) return 1;
+                 }
+         else if (!strcmp(opt, "minrange"))
+                 {if (XrdOuca2x::a2sz(Eroute, "ckscalc minrange", val,
+                                      &minR, 1048576)) return 1;
+                 }
+         else {Eroute.Emsg("Config", "invalid ckscalc option -", opt); return 1;}
+        }
+
+   XrdCksManager::SetCalc(nPar, maxT, minR, pipe);
+   return 0;
+}
+
+/******************************************************************************/
+/*                                 x c w r t                                  */
+/******************************************************************************/
+
+/* Function: xcwrt
+
+   Purpose:  To parse the directive: ckswrite <digest> [<digest> ...]
+
+             <digest>  the name of a checksum to compute as a file is being
+                       written. This is only done for files that are created
+                       or truncated when opened and only while the data is
+                       written in order. The result is recorded when the file
+                       is closed; otherwise, the checksum is computed from
+                       the file when it is requested.
+
+  Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdOfs::xcwrt(XrdOucStream &Config, XrdSysError &Eroute)
+{
+   char *val;
+
+   if (!(val = Config.GetWord()) || !val[0])
+      {Eroute.Emsg("Config", "ckswrite checksum not specified"); return 1;}
+
+   do {if (!XrdOfsWrCks::Config(Eroute, val)) return 1;
+      } while((val = Config.GetWord()) && val[0]);
+   return 0;
+}
+
 /******************************************************************************/
 /*                                 x c r d s                                  */
 /******************************************************************************/
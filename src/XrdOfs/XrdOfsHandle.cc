@@ -35,6 +35,7 @@
 
 #include "XrdOfs/XrdOfsHandle.hh"
 #include "XrdOfs/XrdOfsStats.hh"
+#include "XrdOfs/XrdOfsWrCks.hh"
 #include "XrdOss/XrdOss.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
@@ -256,6 +257,7 @@ int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle)
        hP->isRW         = (Opts & opPC);           // File mode
        hP->ssi          = ossDF;                   // No storage system yet
        hP->Posc         = 0;                       // No creator
+       hP->WrCks        = 0;                       // No write checksums
        hP->Lock();                                 // Wait is not possible
        *Handle = hP;
        return 0;
@@ -393,6 +395,7 @@ int XrdOfsHandle::Retire(int &retc, long long *retsz, char *buff, int blen)
        if ( (isRW ? rwTable.Remove(this) : roTable.Remove(this)) )
          {Next = Free; Free = this;
           if (Posc) {Posc->Recycle(); Posc = 0;}
+          if (WrCks) {delete WrCks; WrCks = 0;}
           if (Path.Val) {free((void *)Path.Val); Path.Val = (char *)"";}
           Path.Len = 0;
           if ((mySSI = ssi) && ssi != ossDF)
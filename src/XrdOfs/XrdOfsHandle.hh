@@ -117,6 +117,7 @@ int              Threshold;
 /******************************************************************************/
   
 class XrdOssDF;
+class XrdOfsWrCks;
 class XrdOfsHanCB;
 class XrdOfsHanPsc;
 
@@ -130,6 +131,7 @@ char                isPending;    // 1-> File  is pending sync()
 char                isChanged;    // 1-> File was modified
 char                isCompressed; // 1-> File  is compressed
 char                isRW;         // T-> File  is open in r/w mode
+XrdOfsWrCks        *WrCks;        // -> Checksums computed as file is written
 
 void                Activate(XrdOssDF *ssP) {ssi = ssP;}
 
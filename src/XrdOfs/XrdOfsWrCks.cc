@@ -0,0 +1,219 @@
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d O f s W r C k s . c c                          */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+
+#include "XrdCks/XrdCks.hh"
+#include "XrdCks/XrdCksCalc.hh"
+#include "XrdCks/XrdCksData.hh"
+#include "XrdOfs/XrdOfsHandle.hh"
+#include "XrdOfs/XrdOfsWrCks.hh"
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSys/XrdSysError.hh"
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+extern XrdSysError  OfsEroute;
+
+extern XrdOss      *XrdOfsOss;
+
+/******************************************************************************/
+/*                               S t a t i c s                                */
+/******************************************************************************/
+
+XrdCks *XrdOfsWrCks::Cks = 0;
+char   *XrdOfsWrCks::csName[XrdOfsWrCks::csMax] = {0};
+int     XrdOfsWrCks::csNum = 0;
+bool    XrdOfsWrCks::csPfn = true;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdOfsWrCks::XrdOfsWrCks() : nextOffs(0), isBad(false)
+{
+   for (int i = 0; i < csNum; i++)
+       if (!(csCalc[i] = Cks->Object(csName[i]))) isBad = true;
+}
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdOfsWrCks::~XrdOfsWrCks()
+{
+   for (int i = 0; i < csNum; i++) if (csCalc[i]) csCalc[i]->Recycle();
+}
+
+/******************************************************************************/
+/*                                 A l l o c                                  */
+/******************************************************************************/
+
+XrdOfsWrCks *XrdOfsWrCks::Alloc()
+{
+   return (Cks && csNum ? new XrdOfsWrCks : 0);
+}
+
+/******************************************************************************/
+/*                                C o n f i g                                 */
+/******************************************************************************/
+
+bool XrdOfsWrCks::Config(XrdSysError &eDest, const char *Name)
+{
+   XrdCksData csData;
+
+// Validate the name and ignore duplicates
+//
+   if (!csData.Set(Name))
+      {eDest.Emsg("Config", "ckswrite checksum name too long -", Name);
+       return false;
+      }
+   for (int i = 0; i < csNum; i++) if (!strcmp(Name, csName[i])) return true;
+
+// Add it to the list
+//
+   if (csNum >= csMax)
+      {eDest.Emsg("Config", "too many ckswrite checksums specified");
+       return false;
+      }
+   csName[csNum++] = strdup(Name);
+   return true;
+}
+
+/******************************************************************************/
+/*                                  D o n e                                   */
+/******************************************************************************/
+
+void XrdOfsWrCks::Done(XrdOfsHandle *hP)
+{
+   XrdCksData csData;
+   struct stat Stat;
+   const char *Path = hP->Name();
+   char pBuff[MAXPATHLEN+8];
+   int csLen, rc;
+
+// If all of the file was seen in order then we can record the checksums.
+// Otherwise, they will be computed when someone asks for them.
+//
+   if (isBad || hP->Select().Fstat(&Stat) || Stat.st_size != nextOffs) return;
+
+// Convert the lfn to a pfn if the checksum manager needs it
+//
+   if (csPfn && !(Path = XrdOfsOss->Lfn2Pfn(Path, pBuff, MAXPATHLEN, rc)))
+      {OfsEroute.Emsg("ckswrite", abs(rc), "get pfn for", hP->Name());
+       return;
+      }
+
+// Set each checksum
+//
+   for (int i = 0; i < csNum; i++)
+       {csData.Set(csName[i]);
+        csCalc[i]->Type(csLen);
+        if (csLen > XrdCksData::ValuSize) continue;
+        memcpy(csData.Value, csCalc[i]->Final(), csLen);
+        csData.Length = csLen;
+        if ((rc = Cks->Set(Path, csData)))
+           OfsEroute.Emsg("ckswrite", abs(rc), "set checksum for", hP->Name());
+       }
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdOfsWrCks::Init(XrdSysError &eDest, XrdCks *cksP, bool needPfn)
+{
+   XrdCksCalc *csP;
+   bool aOK = true;
+
+// Nothing to do if no checksums were specified
+//
+   if (!csNum) return true;
+   if (!cksP)
+      {eDest.Emsg("Config", "ckswrite requires a checksum manager");
+       return false;
+      }
+
+// Verify that each checksum can actually be computed
+//
+   for (int i = 0; i < csNum; i++)
+       {if ((csP = cksP->Object(csName[i]))) csP->Recycle();
+           else {eDest.Emsg("Config", "ckswrite checksum", csName[i],
+                            "is not supported");
+                 aOK = false;
+                }
+       }
+
+// Record the parameters
+//
+   Cks   = cksP;
+   csPfn = needPfn;
+   return aOK;
+}
+
+/******************************************************************************/
+/*                              T r u n c a t e                               */
+/******************************************************************************/
+
+void XrdOfsWrCks::Truncate(long long flen)
+{
+   XrdSysMutexHelper mHelp(wcMutex);
+
+   if (flen != nextOffs) isBad = true;
+}
+
+/******************************************************************************/
+/*                                U p d a t e                                 */
+/******************************************************************************/
+
+void XrdOfsWrCks::Update(long long offs, const char *buff, int blen)
+{
+   XrdSysMutexHelper mHelp(wcMutex);
+
+// The write must immediately follow the previous one. Otherwise, we give up.
+//
+   if (isBad || blen <= 0) return;
+   if (offs != nextOffs) {isBad = true; return;}
+
+// Add the data to each checksum
+//
+   for (int i = 0; i < csNum; i++) csCalc[i]->Update(buff, blen);
+   nextOffs += blen;
+}
+
+/******************************************************************************/
+
+void XrdOfsWrCks::Update(XrdOucIOVec *ioV, int ioN)
+{
+   for (int i = 0; i < ioN; i++)
+       Update(ioV[i].offset, ioV[i].data, ioV[i].size);
+}
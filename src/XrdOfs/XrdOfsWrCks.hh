@@ -0,0 +1,90 @@
+#ifndef __XRDOFSWRCKS_HH__
+#define __XRDOFSWRCKS_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d O f s W r C k s . h h                          */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdCks;
+class XrdCksCalc;
+class XrdOfsHandle;
+class XrdSysError;
+struct XrdOucIOVec;
+
+// The XrdOfsWrCks object computes the configured checksums of a file as it is
+// being written. This only works while the data arrives in order. Should a
+// write not follow the previous one, the object gives up and the checksum is
+// computed the normal way when it is asked for. Upon the final close, Done()
+// records the checksums via the checksum manager.
+//
+class XrdOfsWrCks
+{
+public:
+
+// Alloc() returns a new object or nil if no checksums are to be computed.
+//
+static XrdOfsWrCks *Alloc();
+
+// Add the named checksum to the list of those to compute.
+//
+static bool         Config(XrdSysError &eDest, const char *csName);
+
+// Record the checksums for the file associated with hP, provided that all of
+// its data was seen. The handle must be locked.
+//
+       void         Done(XrdOfsHandle *hP);
+
+// Initialize the checksum objects. Returns false if any cannot be obtained.
+//
+static bool         Init(XrdSysError &eDest, XrdCks *cksP, bool needPfn);
+
+// Truncate() must be called whenever the file is truncated.
+//
+       void         Truncate(long long flen);
+
+// Update() must be called after each successful write.
+//
+       void         Update(long long offs, const char *buff, int blen);
+
+       void         Update(XrdOucIOVec *ioV, int ioN);
+
+                    XrdOfsWrCks();
+                   ~XrdOfsWrCks();
+
+private:
+
+static const int csMax = 4;
+
+static XrdCks     *Cks;
+static char       *csName[csMax];
+static int         csNum;
+static bool        csPfn;
+
+XrdSysMutex        wcMutex;
+XrdCksCalc        *csCalc[csMax];
+long long          nextOffs;
+bool               isBad;
+};
+#endif
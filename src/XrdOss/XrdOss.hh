@@ -145,6 +145,15 @@ int     fd;      // The associated file descriptor.
 #define XRDOSS_isMIG   0x20
 #define XRDOSS_setnoxa 0x40
 
+// Commands that can be passed to XrdOssDF::Fctl()
+//
+#define XRDOSS_FCTL_SFVEC 1 // args -> XrdOucSFVec[alen]; on entry element 0
+                            // holds the offset and length of the data. Upon
+                            // return the elements describe local file ranges
+                            // holding it; returns the number of elements, 0
+                            // if not possible and -errno on failure. With
+                            // alen zero returns 0 if this is ever possible.
+
 // Options that can be passed to Stat()
 //
 #define XRDOSS_resonly 0x0001
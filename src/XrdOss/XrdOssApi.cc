@@ -41,6 +41,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/param.h>
+#include <sys/uio.h>
+#include <limits.h>
 #ifdef __solaris__
 #include <sys/vnode.h>
 #endif
@@ -1000,6 +1002,88 @@ ssize_t XrdOssFile::Write(const void *buff, off_t offset, size_t blen)
      return retval;
 }
 
+/******************************************************************************/
+/*                                w r i t e v                                 */
+/******************************************************************************/
+
+/*
+  Function: Perform all the writes specified in the writeV vector.
+
+  Input:    writeV    - A description of the writes to perform; includes the
+                        absolute offset, the size of the write, and the buffer
+                        holding the data.
+            n         - The size of the writeV vector.
+
+  Output:   Returns the number of bytes written upon success and -errno o/w.
+            If the number of bytes written is less than requested, it is
+            considered an error.
+
+  Notes:    Runs of segments that are contiguous in the file are written with a
+            single pwritev() where the platform supports it.
+*/
+
+ssize_t XrdOssFile::WriteV(XrdOucIOVec *writeV, int n)
+{
+#if defined(__linux__)
+   static const int iovMax = (IOV_MAX > 256 ? 256 : IOV_MAX);
+#else
+   static const int iovMax = 1;
+#endif
+   struct iovec iov[iovMax];
+   long long wrBeg, wrEnd;
+   ssize_t retval, totBytes = 0;
+   int i, k, done;
+
+// Make sure the file is actually open
+//
+   if (fd < 0) return (ssize_t)-XRDOSS_E8004;
+
+// Go through the vector writing each run of contiguous segments
+//
+   for (i = 0; i < n; i = k)
+       {wrBeg = wrEnd = writeV[i].offset;
+        for (k = i; k < n && k-i < iovMax && writeV[k].offset == wrEnd; k++)
+            {iov[k-i].iov_base = writeV[k].data;
+             iov[k-i].iov_len  = writeV[k].size;
+             wrEnd += writeV[k].size;
+            }
+
+        if (XrdOssSS->MaxSize && wrEnd > XrdOssSS->MaxSize)
+           return (ssize_t)-XRDOSS_E8007;
+
+#if defined(__linux__)
+        if (k - i > 1)
+           do {retval = pwritev(fd, iov, k-i, wrBeg);}
+              while(retval < 0 && errno == EINTR);
+           else
+#endif
+           do {retval = pwrite(fd, iov[0].iov_base, iov[0].iov_len, wrBeg);}
+              while(retval < 0 && errno == EINTR);
+
+        if (retval < 0)
+           return (errno == EBADF && cxobj ? -XRDOSS_E8022 : -errno);
+
+    // A short write is finished off segment by segment
+    //
+        if (retval != wrEnd - wrBeg)
+           {done = static_cast<int>(retval);
+            for (int j = i; j < k; j++)
+                {if (done >= writeV[j].size) {done -= writeV[j].size; continue;}
+                 retval = Write(writeV[j].data + done, writeV[j].offset + done,
+                                writeV[j].size - done);
+                 if (retval != writeV[j].size - done)
+                    return (retval < 0 ? retval : (ssize_t)-ESPIPE);
+                 done = 0;
+                }
+           }
+        totBytes += wrEnd - wrBeg;
+       }
+
+// All done
+//
+   return totBytes;
+}
+
 /******************************************************************************/
 /*                                F c h m o d                                 */
 /******************************************************************************/
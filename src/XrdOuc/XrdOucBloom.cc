@@ -0,0 +1,142 @@
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O u c B l o o m . c c                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <string.h>
+
+#include "XrdOuc/XrdOucBloom.hh"
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdOucBloom::XrdOucBloom(int nbits, int nhash)
+{
+   nBits = 64;
+   while(nBits < nbits && nBits < (1 << 30)) nBits <<= 1;
+   nHash = (nhash < 1 ? 1 : nhash);
+   Count = new unsigned char[nBits];
+   memset(Count, 0, nBits);
+}
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdOucBloom::~XrdOucBloom() {delete [] Count;}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+
+void XrdOucBloom::Add(const char *key)
+{
+   uint64_t h1, h2, mask = nBits - 1;
+
+   Hash(key, h1, h2);
+   for (int i = 0; i < nHash; i++, h1 += h2)
+       {unsigned char &cnt = Count[h1 & mask];
+        if (cnt != 255) cnt++;
+       }
+}
+
+/******************************************************************************/
+/*                                 C l e a r                                  */
+/******************************************************************************/
+
+void XrdOucBloom::Clear() {memset(Count, 0, nBits);}
+
+/******************************************************************************/
+/*                                   D e l                                    */
+/******************************************************************************/
+
+void XrdOucBloom::Del(const char *key)
+{
+   uint64_t h1, h2, mask = nBits - 1;
+
+   Hash(key, h1, h2);
+   for (int i = 0; i < nHash; i++, h1 += h2)
+       {unsigned char &cnt = Count[h1 & mask];
+        if (cnt && cnt != 255) cnt--;
+       }
+}
+
+/******************************************************************************/
+/*                                E x p o r t                                 */
+/******************************************************************************/
+
+void XrdOucBloom::Export(unsigned char *bits) const
+{
+   memset(bits, 0, nBits/8);
+   for (int i = 0; i < nBits; i++)
+       if (Count[i]) bits[i >> 3] |= static_cast<unsigned char>(1 << (i & 7));
+}
+
+/******************************************************************************/
+/*                                  H a s h                                   */
+/******************************************************************************/
+
+// The first hash is 64 bit FNV-1a, the second a mix of it. The probe positions
+// are h1 + i*h2 (double hashing), h2 is odd so they never all coincide.
+//
+void XrdOucBloom::Hash(const char *key, uint64_t &h1, uint64_t &h2)
+{
+   uint64_t h = 0xcbf29ce484222325ULL;
+
+   while(*key) {h ^= static_cast<unsigned char>(*key++); h *= 0x100000001b3ULL;}
+   h1 = h;
+
+   h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+   h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+   h ^= h >> 33;
+   h2 = h | 1;
+}
+
+/******************************************************************************/
+/*                                  T e s t                                   */
+/******************************************************************************/
+
+bool XrdOucBloom::Test(const char *key) const
+{
+   uint64_t h1, h2, mask = nBits - 1;
+
+   Hash(key, h1, h2);
+   for (int i = 0; i < nHash; i++, h1 += h2)
+       if (!Count[h1 & mask]) return false;
+   return true;
+}
+
+/******************************************************************************/
+
+bool XrdOucBloom::Test(const unsigned char *bits, int nbits, int nhash,
+                       uint64_t h1, uint64_t h2)
+{
+   uint64_t pos, mask = nbits - 1;
+
+   for (int i = 0; i < nhash; i++, h1 += h2)
+       {pos = h1 & mask;
+        if (!(bits[pos >> 3] & (1 << (pos & 7)))) return false;
+       }
+   return true;
+}
@@ -0,0 +1,95 @@
+#ifndef __XRDOUCBLOOM_HH__
+#define __XRDOUCBLOOM_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O u c B l o o m . h h                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/*                       C l a s s   X r d O u c B l o o m                    */
+/******************************************************************************/
+
+// A counting Bloom filter over strings. Each of the nBits positions holds a
+// one byte count so keys can be deleted as well as added; a count that reaches
+// 255 is never decremented again. Export() produces the plain bit vector that
+// the static Test() methods query, which is what gets shipped to others. The
+// hash functions are fixed so that a bit vector exported on one host can be
+// tested on another.
+//
+class XrdOucBloom
+{
+public:
+
+// Add and delete a key. A key must only be deleted as often as it was added.
+//
+void         Add(const char *key);
+
+void         Del(const char *key);
+
+// Test whether a key may have been added; false means it surely was not.
+//
+bool         Test(const char *key) const;
+
+// Place the nBits/8 byte bit vector of the filter in bits. Bit i is the bit
+// (i & 7) of byte (i >> 3).
+//
+void         Export(unsigned char *bits) const;
+
+// Remove all keys.
+//
+void         Clear();
+
+int          Bits()   const {return nBits;}
+int          Hashes() const {return nHash;}
+
+// Compute the hash pair for a key and test it against an exported bit vector.
+// Computing the hash once allows testing several vectors of the same shape.
+//
+static void  Hash(const char *key, uint64_t &h1, uint64_t &h2);
+
+static bool  Test(const unsigned char *bits, int nbits, int nhash,
+                  uint64_t h1, uint64_t h2);
+
+static bool  Test(const unsigned char *bits, int nbits, int nhash,
+                  const char *key)
+                 {uint64_t h1, h2;
+                  Hash(key, h1, h2);
+                  return Test(bits, nbits, nhash, h1, h2);
+                 }
+
+// The number of bits is rounded up to a power of two of at least 64.
+//
+             XrdOucBloom(int nbits, int nhash);
+            ~XrdOucBloom();
+
+private:
+             XrdOucBloom(const XrdOucBloom&);
+XrdOucBloom &operator=(const XrdOucBloom&);
+
+unsigned char *Count;
+int            nBits;
+int            nHash;
+};
+#endif
@@ -44,6 +44,12 @@
    Status:
       Public Domain
 */
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#endif
+
 #include "XrdOucCRC.hh"
 
 /*****************************************************************/
@@ -138,6 +144,62 @@ unsigned int XrdOucCRC::crctable[256] =
 /*                   End of CRC Lookup Table                     */
 /*****************************************************************/
 
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+// Lookup tables for a reflected CRC sliced eight ways so that eight bytes can
+// be processed per step. Slice zero is the classic byte table.
+//
+class crcSlices
+{
+public:
+
+uint32_t T[8][256];
+
+         crcSlices(uint32_t poly, const unsigned int *tab0=0)
+            {uint32_t crc;
+             for (int i = 0; i < 256; i++)
+                 {if (tab0) crc = tab0[i];
+                     else {crc = i;
+                           for (int j = 0; j < 8; j++)
+                               crc = (crc & 1 ? (crc >> 1) ^ poly : crc >> 1);
+                          }
+                  T[0][i] = crc;
+                 }
+             for (int i = 0; i < 256; i++)
+                 for (int k = 1; k < 8; k++)
+                     T[k][i] = (T[k-1][i] >> 8) ^ T[0][T[k-1][i] & 0xff];
+            }
+};
+
+uint32_t Slice8(const uint32_t (*T)[256], uint32_t crc,
+                const unsigned char *p, size_t n)
+{
+
+// Get to an 8-byte boundary, then do 8 bytes at a time (little endian only)
+//
+   while(n && ((uintptr_t)p & 7)) {crc = T[0][(crc ^ *p++) & 0xff]^(crc >> 8); n--;}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+   uint64_t w;
+   while(n >= 8)
+        {memcpy(&w, p, 8); w ^= crc;
+         crc = T[7][ w        & 0xff] ^ T[6][(w >>  8) & 0xff]
+             ^ T[5][(w >> 16) & 0xff] ^ T[4][(w >> 24) & 0xff]
+             ^ T[3][(w >> 32) & 0xff] ^ T[2][(w >> 40) & 0xff]
+             ^ T[1][(w >> 48) & 0xff] ^ T[0][ w >> 56        ];
+         p += 8; n -= 8;
+        }
+#endif
+
+   while(n--) crc = T[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+   return crc;
+}
+}
+
 /* Calculate CRC-32 Checksum for NAACCR Record,
    skipping area of record containing checksum field.
 
@@ -166,13 +228,224 @@ unsigned int XrdOucCRC::CRC32(const unsigned char *p, int reclen)
 {
    const unsigned int CRC32_XINIT = 0xffffffff;
    const unsigned int CRC32_XOROT = 0xffffffff;
-   unsigned int crc = CRC32_XINIT;
+   static crcSlices   crcSlice(0xEDB88320, crctable);
 
-// Process each byte
+// Process the record eight bytes at a time
 //
-   while(reclen-- > 0) crc = crctable[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+   if (reclen <= 0) return 0;
+   return Slice8(crcSlice.T, CRC32_XINIT, p, reclen) ^ CRC32_XOROT;
+}
+
+/******************************************************************************/
+/*                               C a l c 3 2 C                                */
+/******************************************************************************/
+
+namespace
+{
+const uint32_t crc32cPoly = 0x82F63B78;
+
+uint32_t sw32C(uint32_t crc, const unsigned char *p, size_t n)
+{
+   static crcSlices crcSlice(crc32cPoly);
+
+   return Slice8(crcSlice.T, crc, p, n);
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+
+// The crc32 instruction has a latency of three cycles but can be issued every
+// cycle. So, long buffers are done as three interleaved streams whose results
+// are then combined by shifting the crc over the bytes that follow it, using
+// tables that apply the equivalent of that many zero bytes (see Mark Adler's
+// crc32c.c for the derivation).
+//
+const size_t crcLong  = 8192;
+const size_t crcShort = 256;
+
+class crcShift
+{
+public:
+
+uint32_t T[4][256];
+
+uint32_t Shift(uint32_t crc) const
+              {return T[0][crc & 0xff] ^ T[1][(crc >> 8) & 0xff]
+                    ^ T[2][(crc >> 16) & 0xff] ^ T[3][crc >> 24];
+              }
+
+         crcShift(size_t len)
+                 {uint32_t op[32], odd[32], row = 1;
+                  odd[0] = crc32cPoly;
+                  for (int n = 1; n < 32; n++) {odd[n] = row; row <<= 1;}
+                  Square(op, odd);   // 2 zero bits
+                  Square(odd, op);   // 4 zero bits
+                  do {Square(op, odd);
+                      if (!(len >>= 1)) break;
+                      Square(odd, op);
+                      if (!(len >>= 1)) {memcpy(op, odd, sizeof(op)); break;}
+                     } while(1);
+                  for (uint32_t n = 0; n < 256; n++)
+                      {T[0][n] = Times(op, n);
+                       T[1][n] = Times(op, n << 8);
+                       T[2][n] = Times(op, n << 16);
+                       T[3][n] = Times(op, n << 24);
+                      }
+                 }
+private:
+
+uint32_t Times(const uint32_t *mat, uint32_t vec)
+              {uint32_t sum = 0;
+               while(vec) {if (vec & 1) sum ^= *mat; vec >>= 1; mat++;}
+               return sum;
+              }
+
+void     Square(uint32_t *sq, const uint32_t *mat)
+               {for (int n = 0; n < 32; n++) sq[n] = Times(mat, mat[n]);}
+};
+
+__attribute__((target("sse4.2")))
+uint32_t hw32C(uint32_t crc, const unsigned char *p, size_t n)
+{
+   static crcShift shiftLong(crcLong), shiftShort(crcShort);
+   const unsigned char *end;
+   uint64_t crc0, crc1, crc2;
+
+   while(n && ((uintptr_t)p & 7)) {crc = _mm_crc32_u8(crc, *p++); n--;}
+   crc0 = crc;
+
+// Do as many long triplets as we can, then as many short ones as we can
+//
+   while(n >= crcLong*3)
+        {crc1 = crc2 = 0; end = p + crcLong;
+         do {crc0 = _mm_crc32_u64(crc0, *(const uint64_t *)p);
+             crc1 = _mm_crc32_u64(crc1, *(const uint64_t *)(p + crcLong));
+             crc2 = _mm_crc32_u64(crc2, *(const uint64_t *)(p + crcLong*2));
+             p += 8;
+            } while(p < end);
+         crc0 = shiftLong.Shift(static_cast<uint32_t>(crc0)) ^ crc1;
+         crc0 = shiftLong.Shift(static_cast<uint32_t>(crc0)) ^ crc2;
+         p += crcLong*2; n -= crcLong*3;
+        }
+
+   while(n >= crcShort*3)
+        {crc1 = crc2 = 0; end = p + crcShort;
+         do {crc0 = _mm_crc32_u64(crc0, *(const uint64_t *)p);
+             crc1 = _mm_crc32_u64(crc1, *(const uint64_t *)(p + crcShort));
+             crc2 = _mm_crc32_u64(crc2, *(const uint64_t *)(p + crcShort*2));
+             p += 8;
+            } while(p < end);
+         crc0 = shiftShort.Shift(static_cast<uint32_t>(crc0)) ^ crc1;
+         crc0 = shiftShort.Shift(static_cast<uint32_t>(crc0)) ^ crc2;
+         p += crcShort*2; n -= crcShort*3;
+        }
 
-// Return XOR out value
+// Finish up what is left
 //
-   return crc ^ CRC32_XOROT;
+   while(n >= 8) {crc0 = _mm_crc32_u64(crc0, *(const uint64_t *)p); p += 8; n -= 8;}
+   crc = static_cast<uint32_t>(crc0);
+   while(n--) crc = _mm_crc32_u8(crc, *p++);
+   return crc;
+}
+#endif
+
+// Select the best implementation the processor supports
+//
+typedef uint32_t (*crc32cFunc)(uint32_t, const unsigned char *, size_t);
+
+crc32cFunc Select32C()
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("sse4.2")) return hw32C;
+#endif
+   return sw32C;
+}
+
+uint32_t do32C(uint32_t crc, const unsigned char *p, size_t n)
+{
+   static crc32cFunc crcFunc = Select32C();
+
+   return crcFunc(crc, p, n);
+}
+}
+
+/******************************************************************************/
+
+uint32_t XrdOucCRC::Calc32C(const void *data, size_t count, uint32_t prevcs)
+{
+   return do32C(prevcs ^ 0xffffffff, (const unsigned char *)data, count)
+          ^ 0xffffffff;
+}
+
+/******************************************************************************/
+
+void XrdOucCRC::Calc32C(const void *data, size_t count, uint32_t *csval)
+{
+   const unsigned char *p = (const unsigned char *)data;
+   size_t plen;
+
+   while(count)
+        {plen = (count > (size_t)PageSize ? PageSize : count);
+         *csval++ = do32C(0xffffffff, p, plen) ^ 0xffffffff;
+         p += plen; count -= plen;
+        }
+}
+
+/******************************************************************************/
+
+bool XrdOucCRC::HW32C()
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("sse4.2");
+#else
+   return false;
+#endif
+}
+
+/******************************************************************************/
+/*                             C o m b i n e 3 2 C                            */
+/******************************************************************************/
+
+namespace
+{
+// Multiply a and b modulo the crc32c polynomial using the reflected bit order
+//
+uint32_t MultModP(uint32_t a, uint32_t b)
+{
+   uint32_t m = 0x80000000, p = 0;
+
+   while(a)
+        {if (a & m) {p ^= b; a ^= m;}
+         m >>= 1;
+         b = (b & 1 ? (b >> 1) ^ crc32cPoly : b >> 1);
+        }
+   return p;
+}
+
+// Compute x^(8*len) modulo the polynomial using a table of x^(2^n)
+//
+uint32_t X8nModP(unsigned long long len)
+{
+   static struct x2nTab
+         {uint32_t T[64];
+                   x2nTab() {T[0] = 0x40000000;
+                             for (int n = 1; n < 64; n++)
+                                 T[n] = MultModP(T[n-1], T[n-1]);
+                            }
+         } x2n;
+   uint32_t p = 0x80000000;
+   int k = 3;
+
+   while(len) {if (len & 1) p = MultModP(x2n.T[k & 63], p); len >>= 1; k++;}
+   return p;
+}
+}
+
+/******************************************************************************/
+
+uint32_t XrdOucCRC::Combine32C(uint32_t crc1, uint32_t crc2, long long len2)
+{
+   if (len2 <= 0) return crc1;
+   return MultModP(X8nModP(len2), crc1) ^ crc2;
 }
@@ -30,12 +30,38 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <stdint.h>
+#include <sys/types.h>
+
 class XrdOucCRC
 {
 public:
 
 static unsigned int CRC32(const unsigned char *rec, int reclen);
 
+// Calc32C() computes the CRC32C (Castagnoli) checksum of a buffer. The crc32
+// instruction is used when the processor supports it. To checksum data that
+// is not contiguous pass the value returned for the previous piece as prevcs.
+//
+static uint32_t     Calc32C(const void *data, size_t count, uint32_t prevcs=0);
+
+// This version computes the CRC32C of each PageSize page in the buffer and
+// places it in the corresponding element of csval. The last page may be short.
+//
+static void         Calc32C(const void *data, size_t count, uint32_t *csval);
+
+// Combine32C() returns the CRC32C of two pieces of data placed end to end given
+// the CRC32C of each piece and the length of the second piece. This allows
+// pieces to be checksummed independently of each other.
+//
+static uint32_t     Combine32C(uint32_t crc1, uint32_t crc2, long long len2);
+
+// Return true if Calc32C() uses the processor's crc32 instruction.
+//
+static bool         HW32C();
+
+static const int    PageSize = 4096;
+
                     XrdOucCRC() {}
                    ~XrdOucCRC() {}
 
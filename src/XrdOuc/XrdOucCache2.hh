@@ -31,6 +31,7 @@
 /******************************************************************************/
 
 #include "XrdOuc/XrdOucCache.hh"
+#include "XrdOuc/XrdOucSFVec.hh"
 
 //-----------------------------------------------------------------------------
 //! XrdOucCache2
@@ -138,6 +139,25 @@ using        XrdOucCacheIO::Sync;
 
 virtual void Sync(XrdOucCacheIOCB &iocb) {iocb.Done(Sync());}
 
+//------------------------------------------------------------------------------
+//! Describe data that is fully available in local files as file descriptor
+//! ranges so that it can be sent without being copied (e.g. via sendfile()).
+//! The descriptors remain valid as long as this object is not detached.
+//!
+//! @param sfv    pointer to the vector to be filled in, starting at sfv[0].
+//! @param sfvnum the number of elements available in sfv.
+//! @param offs   the offset into the file.
+//! @param rlen   the number of bytes wanted.
+//!
+//! @return < 0 - The request failed, value is -errno.
+//!         = 0 - Not all of the data is available locally, use Read().
+//!         > 0 - The number of elements filled in; together they describe
+//!               exactly rlen bytes.
+//------------------------------------------------------------------------------
+
+virtual int  SFVec(XrdOucSFVec *sfv, int sfvnum, long long offs, int rlen)
+                  {(void)sfv; (void)sfvnum; (void)offs; (void)rlen; return 0;}
+
 //------------------------------------------------------------------------------
 //! Update the originally passed XrdOucCacheIO2 object with the object passed.
 //! All future uses underlying XrdOucCacheIO2 object must now use this object.
@@ -1006,6 +1006,41 @@ void XrdPosixXrootd::Seekdir(DIR *dirp, long loc)
    dP->UnLock();
 }
 
+/******************************************************************************/
+/*                                 S F V e c                                  */
+/******************************************************************************/
+
+int XrdPosixXrootd::SFVec(int fildes, XrdOucSFVec *sfv, int sfvnum,
+                          off_t offset, size_t nbyte)
+{
+   XrdPosixFile *fp;
+   int rc;
+
+// Find the file object
+//
+   if (!(fp = XrdPosixObject::File(fildes))) return -1;
+
+// Only a cache can supply local file descriptors
+//
+   if (fp->XCio == (XrdOucCacheIO2 *)fp) return Fault(fp, ENOTSUP);
+   if (!sfvnum) {fp->UnLock(); return 0;}
+
+// Make sure the size is not too large
+//
+   if (nbyte > (size_t)0x7fffffff) return Fault(fp, EOVERFLOW);
+
+// Ask the cache where the data is
+//
+   rc = fp->XCio->SFVec(sfv, sfvnum, static_cast<long long>(offset),
+                        static_cast<int>(nbyte));
+   if (rc < 0) return Fault(fp, -rc);
+
+// All done
+//
+   fp->UnLock();
+   return rc;
+}
+
 /******************************************************************************/
 /*                                  S t a t                                   */
 /******************************************************************************/
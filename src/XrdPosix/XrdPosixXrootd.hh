@@ -48,6 +48,7 @@
 #include "XrdSys/XrdSysPthread.hh"
 
 struct XrdOucIOVec;
+struct XrdOucSFVec;
 
 class XrdScheduler;
 class XrdOucCache;
@@ -275,6 +276,25 @@ static int     Rmdir(const char *path);
 
 static void    Seekdir(DIR *dirp, long loc);
 
+//-----------------------------------------------------------------------------
+//! SFVec() describes data held by the cache as file descriptor ranges so that
+//! it can be sent using sendfile() (see XrdOucCacheIO2::SFVec()).
+//!
+//! @param  fildes  the file descriptor of the open file.
+//! @param  sfv     the vector to be filled in.
+//! @param  sfvnum  the number of elements in sfv. When zero, only checks
+//!                 whether the file is read through a cache.
+//! @param  offset  the offset of the data.
+//! @param  nbyte   the number of bytes of data.
+//!
+//! @return >0 the number of elements filled in, =0 the data is not available
+//!         locally and must be read. Otherwise, -1 is returned and errno is
+//!         appropriately set (ENOTSUP when there is no cache).
+//-----------------------------------------------------------------------------
+
+static int     SFVec(int fildes, XrdOucSFVec *sfv, int sfvnum,
+                     off_t offset, size_t nbyte);
+
 //-----------------------------------------------------------------------------
 //! Stat() conforms to POSIX.1-2001 stat()
 //-----------------------------------------------------------------------------
@@ -55,6 +55,7 @@
 #include "XrdOss/XrdOssError.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucExport.hh"
+#include "XrdOuc/XrdOucSFVec.hh"
 #include "XrdSec/XrdSecEntity.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysHeaders.hh"
@@ -824,6 +825,35 @@ ssize_t XrdPssFile::Write(const void *buff, off_t offset, size_t blen)
             ? (ssize_t)-errno : retval;
 }
 
+/******************************************************************************/
+/*                                  f c t l                                   */
+/******************************************************************************/
+
+/*
+  Function: Perform a special operation on the associated file.
+
+  Input:    cmd       - The operation, only XRDOSS_FCTL_SFVEC is supported.
+            alen      - Number of XrdOucSFVec elements args points to.
+            args      - Pointer to the XrdOucSFVec vector.
+            resp      - Not used.
+
+  Output:   Returns the number of elements filled in, zero if the data is not
+            held locally by the cache, and -errno upon failure.
+*/
+
+int XrdPssFile::Fctl(int cmd, int alen, const char *args, char **resp)
+{
+    XrdOucSFVec *sfv = (XrdOucSFVec *)args;
+    int rc;
+
+    if (fd < 0) return -XRDOSS_E8004;
+    if (cmd != XRDOSS_FCTL_SFVEC) return -ENOTSUP;
+
+    if (!alen) rc = XrdPosixXrootd::SFVec(fd, 0, 0, 0, 0);
+       else rc = XrdPosixXrootd::SFVec(fd, sfv, alen, sfv->offset, sfv->sendsz);
+    return (rc < 0 ? -errno : rc);
+}
+
 /******************************************************************************/
 /*                                 f s t a t                                  */
 /******************************************************************************/
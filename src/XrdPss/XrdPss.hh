@@ -76,6 +76,7 @@ public:
 virtual int     Close(long long *retsz=0);
 virtual int     Open(const char *, int, mode_t, XrdOucEnv &);
 
+int     Fctl(int cmd, int alen, const char *args, char **resp=0);
 int     Fstat(struct stat *);
 int     Fsync();
 int     Fsync(XrdSfsAio *aiop);
@@ -120,6 +120,8 @@ kXR_login,     kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signIgnore,
 kXR_mkdir,     kXR_signIgnore, kXR_signNeeded, kXR_signNeeded, kXR_signNeeded,
 kXR_mv,        kXR_signNeeded, kXR_signNeeded, kXR_signNeeded, kXR_signNeeded, 
 kXR_open,      kXR_signLikely, kXR_signNeeded, kXR_signNeeded, kXR_signNeeded, 
+kXR_pgread,    kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signNeeded,
+kXR_pgwrite,   kXR_signIgnore, kXR_signIgnore, kXR_signNeeded, kXR_signNeeded,
 kXR_ping,      kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, 
 kXR_prepare,   kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signNeeded,
 kXR_protocol,  kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, 
@@ -137,6 +139,7 @@ kXR_sync,      kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signNeeded,
 kXR_truncate,  kXR_signNeeded, kXR_signNeeded, kXR_signNeeded, kXR_signNeeded, 
 kXR_verifyw,   kXR_signIgnore, kXR_signIgnore, kXR_signNeeded, kXR_signNeeded,
 kXR_write,     kXR_signIgnore, kXR_signIgnore, kXR_signNeeded, kXR_signNeeded,
+kXR_writev,    kXR_signIgnore, kXR_signIgnore, kXR_signNeeded, kXR_signNeeded,
 0);
 }
 
@@ -259,7 +262,8 @@ int XrdSecProtect::Secure(SecurityRequest *&newreq,
       {kXR_unt16 reqid = htons(thereq.header.requestid);
        paysize = ntohl(thereq.header.dlen);
        if (!payload) payload = ((char *)&thereq) + sizeof(ClientRequest);
-       if (reqid == kXR_write || reqid == kXR_verifyw) n = (secVerData ? 3 : 2);
+       if (reqid == kXR_write || reqid == kXR_verifyw || reqid == kXR_pgwrite)
+          n = (secVerData ? 3 : 2);
           else n = 3;
       }   else n = 2;
 
@@ -37,6 +37,7 @@ add_library(
   XrdXrootd/XrdXrootdPio.cc             XrdXrootd/XrdXrootdPio.hh
   XrdXrootd/XrdXrootdPrepare.cc         XrdXrootd/XrdXrootdPrepare.hh
   XrdXrootd/XrdXrootdProtocol.cc        XrdXrootd/XrdXrootdProtocol.hh
+  XrdXrootd/XrdXrootdReadV.cc           XrdXrootd/XrdXrootdReadV.hh
   XrdXrootd/XrdXrootdResponse.cc        XrdXrootd/XrdXrootdResponse.hh
                                         XrdXrootd/XrdXrootdStat.icc
   XrdXrootd/XrdXrootdStats.cc           XrdXrootd/XrdXrootdStats.hh
@@ -69,6 +70,7 @@ add_library(
   XrdOfs/XrdOfsTPCJob.cc        XrdOfs/XrdOfsTPCJob.hh
   XrdOfs/XrdOfsTPCInfo.cc       XrdOfs/XrdOfsTPCInfo.hh
   XrdOfs/XrdOfsTPCProg.cc       XrdOfs/XrdOfsTPCProg.hh
+  XrdOfs/XrdOfsWrCks.cc         XrdOfs/XrdOfsWrCks.hh
 
   #-----------------------------------------------------------------------------
   # XrdSfs - Standard File System (basic)
@@ -54,6 +54,10 @@ class XrdSysCondVar
 {
 public:
 
+inline int   CondLock()       {if (pthread_mutex_trylock(&cmut)) return 0;
+                               return 1;
+                              }
+
 inline void  Lock()           {pthread_mutex_lock(&cmut);}
 
 inline void  Signal()         {if (relMutex) pthread_mutex_lock(&cmut);
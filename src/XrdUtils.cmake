@@ -61,6 +61,7 @@ add_library(
   XrdOuc/XrdOuca2x.cc           XrdOuc/XrdOuca2x.hh
   XrdOuc/XrdOucArgs.cc          XrdOuc/XrdOucArgs.hh
   XrdOuc/XrdOucBackTrace.cc     XrdOuc/XrdOucBackTrace.hh
+  XrdOuc/XrdOucBloom.cc         XrdOuc/XrdOucBloom.hh
   XrdOuc/XrdOucBuffer.cc        XrdOuc/XrdOucBuffer.hh
                                 XrdOuc/XrdOucCache.hh
                                 XrdOuc/XrdOucCache2.hh
@@ -162,6 +163,8 @@ add_library(
                                 Xrd/XrdPollE.icc
                                 Xrd/XrdPollPoll.hh
                                 Xrd/XrdPollPoll.icc
+                                Xrd/XrdPollU.hh
+                                Xrd/XrdPollU.icc
   Xrd/XrdProtocol.cc            Xrd/XrdProtocol.hh
   Xrd/XrdScheduler.cc           Xrd/XrdScheduler.hh
   Xrd/XrdSendQ.cc               Xrd/XrdSendQ.hh
@@ -171,13 +174,14 @@ add_library(
   # XrdCks
   #-----------------------------------------------------------------------------
   XrdCks/XrdCksAssist.cc           XrdCks/XrdCksAssist.hh
+  XrdCks/XrdCksCalcadler32.cc      XrdCks/XrdCksCalcadler32.hh
   XrdCks/XrdCksCalccrc32.cc        XrdCks/XrdCksCalccrc32.hh
   XrdCks/XrdCksCalcmd5.cc          XrdCks/XrdCksCalcmd5.hh
   XrdCks/XrdCksConfig.cc           XrdCks/XrdCksConfig.hh
   XrdCks/XrdCksLoader.cc           XrdCks/XrdCksLoader.hh
   XrdCks/XrdCksManager.cc          XrdCks/XrdCksManager.hh
   XrdCks/XrdCksManOss.cc           XrdCks/XrdCksManOss.hh
-                                   XrdCks/XrdCksCalcadler32.hh
+                                   XrdCks/XrdCksCalccrc32C.hh
                                    XrdCks/XrdCksCalc.hh
                                    XrdCks/XrdCksData.hh
                                    XrdCks/XrdCks.hh
@@ -71,6 +71,7 @@
 #include "XrdXrootd/XrdXrootdMonitor.hh"
 #include "XrdXrootd/XrdXrootdPrepare.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdReadV.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
 #include "XrdXrootd/XrdXrootdTransit.hh"
@@ -337,6 +338,10 @@ int XrdXrootdProtocol::Configure(char *parms, XrdProtocol_Config *pi)
    XrdXrootdFile::Init(Locker, as_nosf == 0);
    if (as_nosf) eDest.Say("Config warning: sendfile I/O has been disabled!");
 
+// Initialize the readv engine
+//
+   XrdXrootdReadV::Init(BPool);
+
 // Schedule protocol object cleanup (also advise the transit protocol)
 //
    ProtStack.Set(pi->Sched, XrdXrootdTrace, TRACE_MEM);
@@ -478,6 +483,7 @@ int XrdXrootdProtocol::Config(const char *ConfigFN)
              else if TS_Xeq("monitor",       xmon);
              else if TS_Xeq("pidpath",       xpidf);
              else if TS_Xeq("prep",          xprep);
+             else if TS_Xeq("readv",         xrdv);
              else if TS_Xeq("redirect",      xred);
              else if TS_Xeq("seclib",        xsecl);
              else if TS_Xeq("trace",         xtrace);
@@ -1295,6 +1301,96 @@ int XrdXrootdProtocol::xprep(XrdOucStream &Config)
    return 0;
 }
 
+/******************************************************************************/
+/*                                  x r d v                                   */
+/******************************************************************************/
+
+/* Function: xrdv
+
+   Purpose:  To parse the directive: readv [coalesce {<gap>|off}]
+                                           [maxread <rsz>] [parallel <n>]
+                                           [minpart <psz>] [threads <n>]
+
+             coalesce  readv segments separated by no more than <gap> bytes
+                       are read using a single read. Specify off to read each
+                       segment separately. The default is 16k.
+             maxread   the largest coalesced read that will be issued. The
+                       default is 512k.
+             parallel  the maximum number of parts of a readv response packet
+                       that are read in parallel. The default is 4.
+             minpart   the minimum number of bytes a part must have before
+                       another part is split off. The default is 64k.
+             threads   the maximum number of threads that read parts. A part
+                       no thread is free to read is read by the thread handling
+                       the request. Specify 0 to always do so. The default
+                       is 32.
+
+   Output: 0 upon success or 1 upon failure.
+*/
+
+int XrdXrootdProtocol::xrdv(XrdOucStream &Config)
+{
+    char *val;
+    long long llp;
+    int  ppp;
+
+    if (!(val = Config.GetWord()))
+       {eDest.Emsg("Config", "readv option not specified"); return 1;}
+
+    while (val)
+         {     if (!strcmp(val, "coalesce"))
+                  {if (!(val = Config.GetWord()))
+                      {eDest.Emsg("Config", "readv coalesce value not specified");
+                       return 1;
+                      }
+                   if (!strcmp(val, "off")) XrdXrootdReadV::rvGap = -1;
+                      else {if (XrdOuca2x::a2sz(eDest,"readv coalesce",val,&llp,
+                                                0, 1024*1024)) return 1;
+                            XrdXrootdReadV::rvGap = static_cast<int>(llp);
+                           }
+                  }
+          else if (!strcmp(val, "maxread"))
+                  {if (!(val = Config.GetWord()))
+                      {eDest.Emsg("Config", "readv maxread value not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2sz(eDest, "readv maxread", val, &llp,
+                                       4096, 16*1024*1024)) return 1;
+                   XrdXrootdReadV::rvMaxRd = static_cast<int>(llp);
+                  }
+          else if (!strcmp(val, "parallel"))
+                  {if (!(val = Config.GetWord()))
+                      {eDest.Emsg("Config", "readv parallel value not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2i(eDest,"readv parallel",val,&ppp,1,64))
+                      return 1;
+                   XrdXrootdReadV::rvPar = ppp;
+                  }
+          else if (!strcmp(val, "minpart"))
+                  {if (!(val = Config.GetWord()))
+                      {eDest.Emsg("Config", "readv minpart value not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2sz(eDest, "readv minpart", val, &llp,
+                                       1, 0x7fffffff)) return 1;
+                   XrdXrootdReadV::rvMinPart = static_cast<int>(llp);
+                  }
+          else if (!strcmp(val, "threads"))
+                  {if (!(val = Config.GetWord()))
+                      {eDest.Emsg("Config", "readv threads value not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2i(eDest,"readv threads",val,&ppp,0,1024))
+                      return 1;
+                   XrdXrootdReadV::rvThreads = ppp;
+                  }
+          else {eDest.Emsg("Config", "invalid readv option", val); return 1;}
+          val = Config.GetWord();
+         }
+   return 0;
+}
+
 /******************************************************************************/
 /*                                  x r e d                                   */
 /******************************************************************************/
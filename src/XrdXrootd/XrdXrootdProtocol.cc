@@ -44,6 +44,7 @@
 #include "XrdXrootd/XrdXrootdMonitor.hh"
 #include "XrdXrootd/XrdXrootdPio.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdReadV.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
 #include "XrdXrootd/XrdXrootdXPath.hh"
@@ -202,9 +203,29 @@ XrdXrootdProtocol::XrdXrootdProtocol()
                     : XrdProtocol("xrootd protocol handler"), ProtLink(this),
                       Entity("")
 {
+   rvEngine[0] = rvEngine[1] = 0;
+   wvSeg = 0; wvIOV = 0;
+   pgwBad = 0; pgwBadNum = 0;
    Reset();
 }
 
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdXrootdProtocol::~XrdXrootdProtocol()
+{
+   Cleanup();
+
+// Release what was created on demand and kept across recycling
+//
+   delete rvEngine[0];
+   delete rvEngine[1];
+   delete [] wvSeg;
+   delete [] wvIOV;
+   delete [] pgwBad;
+}
+
 /******************************************************************************/
 /*                   A s s i g n m e n t   O p e r a t o r                    */
 /******************************************************************************/
@@ -385,10 +406,11 @@ int XrdXrootdProtocol::Process(XrdLink *lp) // We ignore the argument here
 //
    if (reqID == kXR_sigver) return ProcSig();
 
-// Read any argument data at this point, except when the request is a write.
-// The argument may have to be segmented and we're not prepared to do that here.
+// Read any argument data at this point, except when the request is a write or
+// a pgwrite. The argument may have to be segmented and we're not prepared to do
+// that here.
 //
-   if (reqID != kXR_write && Request.header.dlen)
+   if (reqID != kXR_write && reqID != kXR_pgwrite && Request.header.dlen)
       {if (!argp || Request.header.dlen+1 > argp->bsize)
           {if (argp) BPool->Release(argp);
            if (!(argp = BPool->Obtain(Request.header.dlen+1)))
@@ -460,6 +482,9 @@ int XrdXrootdProtocol::Process2()
          {case kXR_read:     return do_Read();
           case kXR_readv:    return do_ReadV();
           case kXR_write:    return do_Write();
+          case kXR_writev:   return do_WriteV();
+          case kXR_pgread:   return do_PgRead();
+          case kXR_pgwrite:  return do_PgWrite();
           case kXR_sync:     ReqID.setID(Request.header.streamid);
                              return do_Sync();
           case kXR_close:    return do_Close();
@@ -672,6 +697,8 @@ int XrdXrootdProtocol::Stats(char *buff, int blen, int do_sync)
        cumReadV += numReadV; numReadV = 0;
        SI->rsegCnt += numSegsV;
        cumSegsV += numSegsV; numSegsV = 0;
+       SI->rvrdCnt += numSegsR; numSegsR = 0;
+       SI->rvptCnt += numSegsP; numSegsP = 0;
        SI->writeCnt += numWrites;
        cumWrites+= numWrites;numWrites = 0;
        SI->statsMutex.UnLock();
@@ -823,6 +850,8 @@ void XrdXrootdProtocol::Reset()
    numReadP           = 0;
    numReadV           = 0;
    numSegsV           = 0;
+   numSegsR           = 0;
+   numSegsP           = 0;
    numWrites          = 0;
    numFiles           = 0;
    cumReads           = 0;
@@ -72,6 +72,7 @@ class XrdOucStream;
 class XrdOucTList;
 class XrdOucTokenizer;
 class XrdOucTrace;
+struct XrdOucIOVec;
 class XrdSecProtect;
 class XrdSecProtector;
 class XrdSfsDirectory;
@@ -86,8 +87,10 @@ class XrdXrootdFileTable;
 class XrdXrootdJob;
 class XrdXrootdMonitor;
 class XrdXrootdPio;
+class XrdXrootdReadV;
 class XrdXrootdStats;
 class XrdXrootdXPath;
+struct XrdOucIOVec;
 
 class XrdXrootdProtocol : public XrdProtocol, public XrdSfsDio
 {
@@ -124,7 +127,7 @@ static int           StatGen(struct stat &buf, char *xxBuff);
 //            XrdXrootdProtocol operator =(const XrdXrootdProtocol &rhs) = delete;
               XrdXrootdProtocol operator =(const XrdXrootdProtocol &rhs);
               XrdXrootdProtocol();
-             ~XrdXrootdProtocol() {Cleanup();}
+             ~XrdXrootdProtocol();
 
 private:
 
@@ -153,6 +156,13 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Offload(int pathID, int isRead);
        int   do_OffloadIO();
        int   do_Open();
+       int   do_PgRead();
+       int   do_PgReadAll();
+       int   do_PgWrite();
+       int   do_PgWAll();
+       bool  do_PgWBuff(int blen);
+       int   do_PgWCont();
+       int   do_PgWDone();
        int   do_Ping();
        int   do_Prepare();
        int   do_Protocol(ServerResponseBody_Protocol *rsp=0);
@@ -165,6 +175,9 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Qxattr();
        int   do_Read();
        int   do_ReadV();
+       int   do_ReadVSend(int slot, XrdOucIOVec *rdVec, int vBeg, int vEnd,
+                          char *buff, int blen, bool isLast,
+                          XrdXrootdResponse &rvResp);
        int   do_ReadAll(int asyncOK=1);
        int   do_ReadNone(int &retc, int &pathID);
        int   do_Rm();
@@ -179,6 +192,11 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_WriteAll();
        int   do_WriteCont();
        int   do_WriteNone();
+       int   do_WriteV();
+       int   do_WriteVAll();
+       bool  do_WriteVBuff(char *buff, int blen);
+       int   do_WriteVCont();
+       int   do_WriteVDone();
 
        int   aio_Error(const char *op, int ecode);
        int   aio_Read();
@@ -217,6 +235,7 @@ static int   xpidf(XrdOucStream &Config);
 static int   xprep(XrdOucStream &Config);
 static int   xlog(XrdOucStream &Config);
 static int   xmon(XrdOucStream &Config);
+static int   xrdv(XrdOucStream &Config);
 static int   xred(XrdOucStream &Config);
 static void  xred_set(RD_func func, char *rHost[2], int rPort[2]);
 static bool  xred_xok(int     func, char *rHost[2], int rPort[2]);
@@ -301,6 +320,7 @@ static int                 as_syncw;     // writes to be synchronous
 static int                 maxBuffsz;    // Maximum buffer size we can have
 static int                 maxTransz;    // Maximum transfer size we can have
 static const int           maxRvecsz = 1024;   // Maximum read vector size
+static const int           maxWvecsz = 1024;   // Maximum write vector size
 
 // Statistical area
 //
@@ -309,6 +329,8 @@ int                        numReads;     // Count for kXR_read
 int                        numReadP;     // Count for kXR_read pre-preads
 int                        numReadV;     // Count for kR_readv
 int                        numSegsV;     // Count for kR_readv segmens
+int                        numSegsR;     // Count for kR_readv coalesced reads
+int                        numSegsP;     // Count for kR_readv parallel parts
 int                        numWrites;    // Count
 int                        numFiles;     // Count
 
@@ -389,6 +411,22 @@ short                      PathID;
 char                       doWrite;
 char                       doWriteC;
 char                       rvSeq;
+XrdXrootdReadV            *rvEngine[2];  // Pipelined readv, created on demand
+
+// This area is used for kXR_writev
+//
+struct WVSeg {XrdXrootdFile *fileP; long long offset; int size;};
+WVSeg                     *wvSeg;        // Segments, created on demand
+XrdOucIOVec               *wvIOV;        // Writes for one buffer of data
+int                        wvNum;        // Number of segments in wvSeg
+int                        wvCur;        // Segment receiving data
+int                        wvOff;        // Bytes of wvCur already written
+
+// This area is used for kXR_pgread and kXR_pgwrite
+//
+static const int           maxPgIO = 256; // Max pages per buffer
+long long                 *pgwBad;       // Offsets of pages with bad checksums
+int                        pgwBadNum;    // Number of entries in pgwBad
 
 // Track usage limts.
 //
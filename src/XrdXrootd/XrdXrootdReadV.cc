@@ -0,0 +1,308 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d X r o o t d R e a d V . c c                      */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <string.h>
+
+#include "Xrd/XrdBuffer.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdXrootd/XrdXrootdReadV.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+class XrdXrootdRVPart
+{
+public:
+
+void             DoIt() {Parent->Done(Run());}
+
+bool             Run();
+
+XrdXrootdRVPart *Next;    // Next part of the same packet
+XrdXrootdRVPart *qNext;   // Next part in the pool queue or deferred list
+XrdXrootdReadV  *Parent;
+XrdSfsFile      *fileP;
+int              rdBeg;
+int              rdNum;
+
+                 XrdXrootdRVPart(XrdXrootdReadV *pP)
+                                : Next(0), qNext(0), Parent(pP),
+                                  fileP(0), rdBeg(0), rdNum(0) {}
+                ~XrdXrootdRVPart() {}
+};
+
+/******************************************************************************/
+/*                               S t a t i c s                                */
+/******************************************************************************/
+
+XrdBuffManager  *XrdXrootdReadV::BPool     = 0;
+XrdSysCondVar    XrdXrootdReadV::poolCV(0, "readv pool");
+XrdXrootdRVPart *XrdXrootdReadV::poolQ     = 0;
+int              XrdXrootdReadV::poolIdle  = 0;
+int              XrdXrootdReadV::poolNum   = 0;
+int              XrdXrootdReadV::rvGap     = 16384;
+int              XrdXrootdReadV::rvMaxRd   = 524288;
+int              XrdXrootdReadV::rvPar     = 4;
+int              XrdXrootdReadV::rvMinPart = 65536;
+int              XrdXrootdReadV::rvThreads = 32;
+
+/******************************************************************************/
+/*                   X r d X r o o t d R V P a r t : : R u n                  */
+/******************************************************************************/
+
+bool XrdXrootdRVPart::Run()
+{
+   XrdXrootdReadV::rdInfo *rdP = &(Parent->rdTab[rdBeg]);
+   XrdOucIOVec *ioP = &(Parent->ioTab[rdBeg]), *segP;
+   XrdBuffer *bP = 0;
+   XrdSfsXferSize totSZ = 0, rdSZ;
+   char *sBuff = 0;
+   int i, k, sSize = 0;
+
+// Compute how much scratch space we need for the coalesced reads
+//
+   for (i = 0; i < rdNum; i++)
+       {if (rdP[i].segNum > 1) sSize += rdP[i].size;
+        totSZ += rdP[i].size;
+       }
+
+// If we can't get scratch space then simply read the segments as they are.
+// They are contiguous in the caller's vector.
+//
+   if (sSize)
+      {if (!(bP = Parent->BPool->Obtain(sSize)))
+          {for (i = 0, k = 0; i < rdNum; i++) k += rdP[i].segNum;
+           for (i = 0, totSZ = 0; i < k; i++) totSZ += rdP->segP[i].size;
+           return fileP->readv(rdP->segP, k) == totSZ;
+          }
+       sBuff = bP->buff;
+      }
+
+// Construct the vector of reads we will actually issue. Single segments are
+// read directly into their final location.
+//
+   for (i = 0; i < rdNum; i++)
+       {ioP[i].offset = rdP[i].offset;
+        ioP[i].size   = rdP[i].size;
+        ioP[i].info   = 0;
+        if (rdP[i].segNum > 1) {ioP[i].data = sBuff; sBuff += rdP[i].size;}
+           else ioP[i].data = rdP[i].segP->data;
+       }
+
+// Do the reads and scatter the coalesced data into the segments
+//
+   if ((rdSZ = fileP->readv(ioP, rdNum)) == totSZ)
+      for (i = 0; i < rdNum; i++)
+          {if (rdP[i].segNum < 2) continue;
+           segP = rdP[i].segP;
+           for (k = 0; k < rdP[i].segNum; k++, segP++)
+               memcpy(segP->data, ioP[i].data + (segP->offset - ioP[i].offset),
+                      segP->size);
+          }
+
+// All done
+//
+   if (bP) Parent->BPool->Release(bP);
+   return rdSZ == totSZ;
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdXrootdReadV::XrdXrootdReadV(int maxsegs) : rvDone(0)
+{
+   numParts = 0;
+   partFree = partBusy = partDefer = 0;
+   rdTab    = new rdInfo[maxsegs];
+   ioTab    = new XrdOucIOVec[maxsegs];
+   rdNext   = 0;
+   numPend  = 0;
+   rvOK     = true;
+}
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdXrootdReadV::~XrdXrootdReadV()
+{
+   XrdXrootdRVPart *pP;
+
+   Wait();
+   while((pP = partFree)) {partFree = pP->Next; delete pP;}
+   delete [] rdTab;
+   delete [] ioTab;
+}
+
+/******************************************************************************/
+/* Private                          D o n e                                   */
+/******************************************************************************/
+
+void XrdXrootdReadV::Done(bool isOK)
+{
+   if (!isOK) {rvMutex.Lock(); rvOK = false; rvMutex.UnLock();}
+   rvDone.Post();
+}
+
+/******************************************************************************/
+/* Private                          P o s t                                   */
+/******************************************************************************/
+
+// Hand a part to the pool. This only succeeds when a pool thread is idle or a
+// new one may be started, so a queued part never waits for a thread.
+//
+bool XrdXrootdReadV::Post(XrdXrootdRVPart *pP)
+{
+   pthread_t tid;
+
+   poolCV.Lock();
+        if (poolIdle) poolIdle--;
+   else if (poolNum < rvThreads
+        &&  !XrdSysThread::Run(&tid, Worker, 0, 0, "readv part")) poolNum++;
+   else {poolCV.UnLock(); return false;}
+
+   pP->qNext = poolQ; poolQ = pP;
+   poolCV.Signal();
+   poolCV.UnLock();
+   return true;
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+
+int XrdXrootdReadV::Start(XrdSfsFile *fP, XrdOucIOVec *rdVec, int rdNum,
+                          bool inLine)
+{
+   XrdXrootdRVPart *pP;
+   long long rdEnd, totSZ = 0, perPart, partSZ;
+   int i, rBeg = rdNext, numP, numRd;
+
+// Coalesce segments that follow each other closely enough. We only look at
+// segments in the order given; a client wanting coalescing sends them sorted.
+// The caller never passes more than maxsegs segments between Wait() calls.
+//
+   for (i = 0; i < rdNum; i++)
+       {totSZ += rdVec[i].size;
+        if (rdNext > rBeg && rvGap >= 0)
+           {rdInfo &rP = rdTab[rdNext-1];
+            rdEnd = rP.offset + rP.size;
+            if (rdVec[i].offset >= rdEnd && rdVec[i].offset - rdEnd <= rvGap
+            &&  rdVec[i].offset + rdVec[i].size - rP.offset <= rvMaxRd)
+               {totSZ += rdVec[i].offset - rdEnd;
+                rP.size = rdVec[i].offset + rdVec[i].size - rP.offset;
+                rP.segNum++;
+                continue;
+               }
+           }
+        rdTab[rdNext].offset = rdVec[i].offset;
+        rdTab[rdNext].size   = rdVec[i].size;
+        rdTab[rdNext].segP   = &rdVec[i];
+        rdTab[rdNext].segNum = 1;
+        rdNext++;
+       }
+   numRd = rdNext - rBeg;
+
+// Determine how many parts we will run in parallel
+//
+   numP = static_cast<int>(totSZ / (rvMinPart > 0 ? rvMinPart : 1));
+   if (numP > rvPar) numP = rvPar;
+   if (numP > numRd) numP = numRd;
+   if (numP < 1)     numP = 1;
+   perPart = totSZ / numP;
+
+// Create the parts, each taking roughly an equal share of the bytes
+//
+   i = rBeg;
+   while(i < rdNext)
+        {if ((pP = partFree)) partFree = pP->Next;
+            else pP = new XrdXrootdRVPart(this);
+         pP->fileP = fP;
+         pP->rdBeg = i;
+         partSZ = 0;
+         if (--numP <= 0) i = rdNext;
+            else while(i < rdNext && partSZ < perPart) partSZ += rdTab[i++].size;
+         pP->rdNum = i - pP->rdBeg;
+         pP->Next  = partBusy; partBusy = pP;
+         numPend++; numParts++;
+         if ((inLine && i >= rdNext && !partDefer) || !Post(pP))
+            {pP->qNext = partDefer; partDefer = pP;}
+        }
+
+// All done
+//
+   return numRd;
+}
+
+/******************************************************************************/
+/*                                  W a i t                                   */
+/******************************************************************************/
+
+bool XrdXrootdReadV::Wait()
+{
+   XrdXrootdRVPart *pP;
+   bool isOK;
+
+// Run the parts that were left for us to do, if any
+//
+   while((pP = partDefer)) {partDefer = pP->qNext; pP->DoIt();}
+
+// Wait for everything else to complete
+//
+   while(numPend) {rvDone.Wait(); numPend--;}
+
+// Recycle the parts and reset for the next packet
+//
+   while((pP = partBusy)) {partBusy = pP->Next; pP->Next = partFree; partFree = pP;}
+   rdNext = 0; numParts = 0;
+   isOK = rvOK; rvOK = true;
+   return isOK;
+}
+
+/******************************************************************************/
+/* Private                        W o r k e r                                 */
+/******************************************************************************/
+
+void *XrdXrootdReadV::Worker(void *carg)
+{
+   XrdXrootdRVPart *pP;
+
+// Run parts as they are posted. The thread counts as idle again only once
+// its part has been read.
+//
+   poolCV.Lock();
+   do {while(!(pP = poolQ)) poolCV.Wait();
+       poolQ = pP->qNext;
+       poolCV.UnLock();
+       pP->DoIt();
+       poolCV.Lock();
+       poolIdle++;
+      } while(1);
+
+   return (void *)0;
+}
@@ -0,0 +1,104 @@
+#ifndef __XRDXROOTDREADV__
+#define __XRDXROOTDREADV__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d X r o o t d R e a d V . h h                      */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdBuffManager;
+class XrdSfsFile;
+class XrdXrootdRVPart;
+struct XrdOucIOVec;
+
+// The XrdXrootdReadV object executes the file reads for one kXR_readv response
+// packet. Segments that are adjacent or close together are coalesced into a
+// single read and the resulting reads are split into parts that are run in
+// parallel by a pool of threads used only for this. A part that no pool thread
+// can take right away is read by the caller in Wait(), so the caller (itself a
+// scheduler thread) never waits for work that no thread is free to run.
+// Start() may be called once per file in the packet; Wait() then waits for all
+// of the reads to complete.
+//
+class XrdXrootdReadV
+{
+friend class XrdXrootdRVPart;
+public:
+
+static void  Init(XrdBuffManager *bP) {BPool = bP;}
+
+// Start reading segments rdVec[0..rdNum-1] of the file. The data member of each
+// segment must point to where the data is to be placed. When inLine is true
+// one of the parts is always left to be run by the caller in Wait(). Returns the
+// number of reads issued after coalescing.
+//
+       int   Start(XrdSfsFile *fP, XrdOucIOVec *rdVec, int rdNum, bool inLine);
+
+// Wait for all started reads. Returns true if all of them succeeded. Upon
+// failure the caller should redo the reads serially to obtain the error.
+//
+       bool  Wait();
+
+       int   numParts;   // Number of parts started since the last Wait()
+
+static int   rvGap;      // Max gap between coalesced segments
+static int   rvMaxRd;    // Max size of a coalesced read
+static int   rvPar;      // Max number of parallel parts per file
+static int   rvMinPart;  // Min bytes per part
+static int   rvThreads;  // Max threads in the pool, 0 reads everything inline
+
+             XrdXrootdReadV(int maxsegs);
+            ~XrdXrootdReadV();
+
+private:
+
+struct rdInfo
+      {long long    offset;
+       XrdOucIOVec *segP;
+       int          size;
+       int          segNum;
+      };
+
+void         Done(bool isOK);
+static bool  Post(XrdXrootdRVPart *pP);
+static void *Worker(void *carg);
+
+static XrdBuffManager  *BPool;
+static XrdSysCondVar    poolCV;
+static XrdXrootdRVPart *poolQ;
+static int              poolIdle;
+static int              poolNum;
+
+XrdSysMutex      rvMutex;
+XrdSysSemaphore  rvDone;
+XrdXrootdRVPart *partFree;
+XrdXrootdRVPart *partBusy;
+XrdXrootdRVPart *partDefer;   // Parts run by the caller in Wait()
+rdInfo          *rdTab;
+XrdOucIOVec     *ioTab;
+int              rdNext;
+int              numPend;
+bool             rvOK;
+};
+#endif
@@ -32,6 +32,7 @@
 #include <inttypes.h>
 #include <string.h>
 
+#include "Xrd/XrdBuffer.hh"
 #include "Xrd/XrdLink.hh"
 #include "XrdXrootd/XrdXrootdResponse.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
@@ -391,6 +392,33 @@ int XrdXrootdResponse::Send(XrdXrootdReqID &ReqID,
    return -1;
 }
   
+/******************************************************************************/
+/*                                S e n d Z C                                 */
+/******************************************************************************/
+
+int XrdXrootdResponse::SendZC(XResponseType rcode, XrdBuffer *bP, int dlen)
+{
+   XrdLink::sfVec myVec[2];
+
+   TRACES(RSP, "sending " <<dlen <<" zero-copy bytes; status=" <<rcode);
+
+// Large in-memory payloads go through the sendfile path which will use a
+// zero-copy send for the data segment. The link takes over the buffer.
+//
+   Resp.status     = static_cast<kXR_unt16>(htons(rcode));
+   Resp.dlen       = static_cast<kXR_int32>(htonl(dlen));
+   myVec[0].buffer = (char *)&Resp;
+   myVec[0].sendsz = sizeof(Resp);
+   myVec[0].fdnum  = -1;
+   myVec[1].buffer = bP->buff;
+   myVec[1].sendsz = dlen;
+   myVec[1].fdnum  = -1;
+
+   if (Link->Send(myVec, 2, bP) < 0)
+      return Link->setEtext("send failure");
+   return 0;
+}
+
 /******************************************************************************/
 /*                                   S e t                                    */
 /******************************************************************************/
@@ -413,3 +441,14 @@ void XrdXrootdResponse::Set(unsigned char *stream)
        *outbuff++ = ' '; *outbuff = '\0';
       }
 }
+
+/******************************************************************************/
+/*                                 u s e Z C                                  */
+/******************************************************************************/
+
+bool XrdXrootdResponse::useZC(int dlen)
+{
+// Bridged responses do not go out on our socket
+//
+   return !Bridge && Link->useZC(dlen);
+}
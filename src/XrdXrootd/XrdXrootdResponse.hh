@@ -41,6 +41,7 @@
 /*                       x r o o t d _ R e s p o n s e                        */
 /******************************************************************************/
   
+class XrdBuffer;
 class XrdLink;
 class XrdOucSFVec;
 class XrdXrootdTransit;
@@ -65,6 +66,13 @@ const  char *ID() {return (const char *)trsid;}
 static int   Send(XrdXrootdReqID &ReqID,  XResponseType Status,
                   struct iovec   *IOResp, int           iornum, int  iolen);
 
+// Send the first dlen bytes of a buffer using a zero-copy send. The buffer is
+// handed over to the link and must not be used afterwards. This may only be
+// done when useZC() says so.
+//
+       int   SendZC(XResponseType rcode, XrdBuffer *bP, int dlen);
+       bool  useZC(int dlen);
+
 inline void  Set(XrdLink *lp) {Link = lp;}
 inline void  Set(XrdXrootdTransit *tp) {Bridge = tp;}
        void  Set(kXR_char *stream);
@@ -50,6 +50,8 @@ long long        readCnt;      // Stats: Number of reads
 long long        prerCnt;      // Stats: Number of reads (pre)
 long long        rsegCnt;      // Stats: Number of readv segments
 long long        rvecCnt;      // Stats: Number of reads
+long long        rvrdCnt;      // Stats: Number of readv reads after coalescing
+long long        rvptCnt;      // Stats: Number of readv parallel parts
 long long        writeCnt;     // Stats: Number of writes
 int              syncCnt;      // Stats: Number of sync
 int              miscCnt;      // Stats: Number of miscellaneous
@@ -33,6 +33,7 @@
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysTimer.hh"
+#include "XrdOuc/XrdOucCRC.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucReqID.hh"
 #include "XrdOuc/XrdOucTList.hh"
@@ -53,6 +54,7 @@
 #include "XrdXrootd/XrdXrootdPio.hh"
 #include "XrdXrootd/XrdXrootdPrepare.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdReadV.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
 #include "XrdXrootd/XrdXrootdXPath.hh"
@@ -1384,6 +1386,292 @@ int XrdXrootdProtocol::do_Open()
       else       return Response.Send((void *)&myResp, resplen);
 }
 
+/******************************************************************************/
+/*                             d o _ P g R e a d                              */
+/******************************************************************************/
+  
+int XrdXrootdProtocol::do_PgRead()
+{
+   XrdXrootdFHandle fh(Request.pgread.fhandle);
+   numReads++;
+
+// Unmarshall the data
+//
+   myIOLen  = ntohl(Request.pgread.rlen);
+              n2hll(Request.pgread.offset, myOffset);
+
+// Find the file object
+//
+   if (!FTab || !(myFile = FTab->Get(fh.handle)))
+      return Response.Send(kXR_FileNotOpen,
+                           "pgread does not refer to an open file");
+
+// Trace and verify that the length and offset are not negative
+//
+   TRACEP(FS, "fh=" <<fh.handle <<" pgread " <<myIOLen <<'@' <<myOffset);
+   if (myIOLen < 0 || myOffset < 0)
+      return Response.Send(kXR_ArgInvalid, "pgread length or offset is negative");
+
+// If we are monitoring, insert a read entry
+//
+   if (Monitor.InOut())
+      Monitor.Agent->Add_rd(myFile->Stats.FileID, Request.pgread.rlen,
+                                                  Request.pgread.offset);
+
+// Short circuit processing if read length is zero
+//
+   if (!myIOLen) return Response.Send();
+
+// Now read all of the data
+//
+   return do_PgReadAll();
+}
+
+/******************************************************************************/
+/*                          d o _ P g R e a d A l l                           */
+/******************************************************************************/
+
+// myFile   = file to be read
+// myOffset = Offset at which to read
+// myIOLen  = Number of bytes to read from file and write to socket
+  
+int XrdXrootdProtocol::do_PgReadAll()
+{
+   struct iovec pgIOV[maxPgIO*2+1];
+   kXR_unt32    pgCS[maxPgIO];
+   char *buff, *bP;
+   int rc, xframt, rdLen, pgLen, iovNum, k;
+   int Quantum = (maxBuffsz & ~(kXR_pgPageSZ-1));
+
+// Each response packet holds at most maxPgIO pages and always ends on a page
+// boundary unless it is the last one or the file system returned less data.
+//
+   if (Quantum > maxPgIO*kXR_pgPageSZ) Quantum = maxPgIO*kXR_pgPageSZ;
+   if (Quantum < kXR_pgPageSZ) Quantum = kXR_pgPageSZ;
+
+// Make sure we have a large enough buffer
+//
+   if (!argp || Quantum < halfBSize || Quantum > argp->bsize)
+      {if ((rc = getBuff(1, Quantum)) <= 0) return rc;}
+      else if (hcNow < hcNext) hcNow++;
+   buff = argp->buff;
+
+// Now read all of the data, checksumming each page as we go along. The data is
+// sent straight out of the buffer with each page followed by its checksum.
+//
+   myFile->Stats.rdOps(myIOLen);
+   do {rdLen = Quantum - static_cast<int>(myOffset & (kXR_pgPageSZ-1));
+       if (rdLen > myIOLen) rdLen = myIOLen;
+       if ((xframt = myFile->XrdSfsp->read(myOffset, buff, rdLen)) <= 0) break;
+       pgLen = kXR_pgPageSZ - static_cast<int>(myOffset & (kXR_pgPageSZ-1));
+       bP = buff; rdLen = xframt; iovNum = 1; k = 0;
+       while(rdLen > 0)
+            {if (pgLen > rdLen) pgLen = rdLen;
+             pgCS[k] = htonl(XrdOucCRC::Calc32C(bP, pgLen));
+             pgIOV[iovNum].iov_base = bP;        pgIOV[iovNum++].iov_len = pgLen;
+             pgIOV[iovNum].iov_base = &pgCS[k++]; pgIOV[iovNum++].iov_len = 4;
+             bP += pgLen; rdLen -= pgLen; pgLen = kXR_pgPageSZ;
+            }
+       myOffset += xframt; myIOLen -= xframt;
+       if (myIOLen <= 0) return Response.Send(pgIOV, iovNum, xframt+k*4);
+       if (Response.Send(kXR_oksofar, pgIOV, iovNum, xframt+k*4) < 0) return -1;
+      } while(myIOLen);
+
+// Determine why we ended here
+//
+   if (xframt == 0) return Response.Send();
+   return fsError(xframt, 0, myFile->XrdSfsp->error, 0, 0);
+}
+
+/******************************************************************************/
+/*                            d o _ P g W r i t e                             */
+/******************************************************************************/
+  
+int XrdXrootdProtocol::do_PgWrite()
+{
+   XrdXrootdFHandle fh(Request.pgwrite.fhandle);
+   long long dataLen;
+   int fUnit, rest;
+   numWrites++;
+
+// Unmarshall the data
+//
+   myIOLen  = Request.header.dlen;
+              n2hll(Request.pgwrite.offset, myOffset);
+
+// Find the file object
+//
+   if (!FTab || !(myFile = FTab->Get(fh.handle)))
+      {if (argp) return do_WriteNone();
+       Response.Send(kXR_FileNotOpen,"pgwrite does not refer to an open file");
+       return Link->setEtext("pgwrite protcol violation");
+      }
+
+// Trace and verify that length is not negative
+//
+   TRACEP(FS, "fh=" <<fh.handle <<" pgwrite " <<myIOLen <<'@' <<myOffset);
+   if (myIOLen < 0 || myOffset < 0)
+      {Response.Send(kXR_ArgInvalid, "pgwrite length or offset is negative");
+       return Link->setEtext("pgwrite protcol violation");
+      }
+
+// Compute the amount of data being sent. The first unit holds whatever is
+// needed to get to a page boundary and the last unit must hold some data.
+//
+   fUnit = kXR_pgUnitSZ - static_cast<int>(myOffset & (kXR_pgPageSZ-1));
+   if (myIOLen <= fUnit) {rest = myIOLen; dataLen = myIOLen - 4;}
+      else {rest = (myIOLen - fUnit) % kXR_pgUnitSZ;
+            dataLen = (fUnit - 4) + (myIOLen - fUnit) / kXR_pgUnitSZ
+                    * static_cast<long long>(kXR_pgPageSZ) + (rest ? rest-4 : 0);
+           }
+   if (myIOLen && rest && rest <= 4)
+      {myEInfo[0] = SFS_ERROR;
+       myFile->XrdSfsp->error.setErrInfo(EINVAL, "pgwrite length is invalid");
+       return do_WriteNone();
+      }
+
+// If we are monitoring, insert a write entry
+//
+   if (Monitor.InOut())
+      Monitor.Agent->Add_wr(myFile->Stats.FileID, static_cast<int>(dataLen),
+                                                  Request.pgwrite.offset);
+
+// If zero length write, simply return
+//
+   if (!myIOLen) return Response.Send();
+
+// Get the table that records the pages that failed their checksum
+//
+   if (!pgwBad) pgwBad = new long long[kXR_pgMaxEpr];
+   pgwBadNum = 0;
+
+// Just do the i/o now
+//
+   myFile->Stats.wrOps(static_cast<int>(dataLen)); // Optimistically correct
+   return do_PgWAll();
+}
+
+/******************************************************************************/
+/*                             d o _ P g W A l l                              */
+/******************************************************************************/
+
+// myFile   = file to be written
+// myOffset = Offset at which to write the next page
+// myIOLen  = Number of bytes to read from socket, including checksums
+  
+int XrdXrootdProtocol::do_PgWAll()
+{
+   int rc, Quantum, maxUnits = maxBuffsz / kXR_pgUnitSZ;
+
+// Each buffer holds at most maxPgIO whole units
+//
+   if (maxUnits > maxPgIO) maxUnits = maxPgIO;
+   if (maxUnits < 1) maxUnits = 1;
+
+// Make sure we have a large enough buffer
+//
+   Quantum = maxUnits * kXR_pgUnitSZ;
+   if (!argp || Quantum < halfBSize || Quantum > argp->bsize)
+      {if ((rc = getBuff(0, Quantum)) <= 0) return rc;}
+      else if (hcNow < hcNext) hcNow++;
+
+// Now write all of the data, only the first buffer can start with a short page
+//
+   while(myIOLen > 0)
+        {Quantum = maxUnits * kXR_pgUnitSZ
+                 - static_cast<int>(myOffset & (kXR_pgPageSZ-1));
+         if (Quantum > myIOLen) Quantum = myIOLen;
+         if ((rc = getData("data", argp->buff, Quantum)))
+            {if (rc > 0)
+                {Resume = &XrdXrootdProtocol::do_PgWCont;
+                 myBlast = Quantum;
+                 myStalls++;
+                }
+             return rc;
+            }
+         if (!do_PgWBuff(Quantum)) return do_WriteNone();
+        }
+
+// All done
+//
+   return do_PgWDone();
+}
+
+/******************************************************************************/
+/*                            d o _ P g W B u f f                             */
+/******************************************************************************/
+
+// Verify and write the units in the buffer. Pages with a bad checksum are not
+// written but are remembered so that the client can resend them. Returns false
+// upon a write error or when too many pages are bad; myEInfo[0] has the error.
+  
+bool XrdXrootdProtocol::do_PgWBuff(int blen)
+{
+   XrdOucIOVec pgIOV[maxPgIO];
+   char *bP = argp->buff;
+   kXR_unt32 csVal;
+   int rc, pgLen, ioNum = 0;
+
+   myIOLen -= blen;
+   pgLen = kXR_pgPageSZ - static_cast<int>(myOffset & (kXR_pgPageSZ-1));
+   while(blen > 0)
+        {if (pgLen > blen - 4) pgLen = blen - 4;
+         memcpy(&csVal, bP+pgLen, sizeof(csVal));
+         if (XrdOucCRC::Calc32C(bP, pgLen) == ntohl(csVal))
+            {pgIOV[ioNum].offset = myOffset;
+             pgIOV[ioNum].size   = pgLen;
+             pgIOV[ioNum].info   = 0;
+             pgIOV[ioNum].data   = bP;
+             ioNum++;
+            } else {
+             if (pgwBadNum >= kXR_pgMaxEpr)
+                {myEInfo[0] = SFS_ERROR;
+                 myFile->XrdSfsp->error.setErrInfo(EDOM,
+                                        "pgwrite has too many checksum errors");
+                 return false;
+                }
+             pgwBad[pgwBadNum++] = myOffset;
+            }
+         myOffset += pgLen; bP += pgLen+4; blen -= pgLen+4;
+         pgLen = kXR_pgPageSZ;
+        }
+
+// Write the good pages, the file system sees contiguous runs as such
+//
+   if (ioNum && (rc = myFile->XrdSfsp->writev(pgIOV, ioNum)) < 0)
+      {myEInfo[0] = rc; return false;}
+   return true;
+}
+
+/******************************************************************************/
+/*                            d o _ P g W C o n t                             */
+/******************************************************************************/
+
+// myBlast  = Number of bytes in the buffer that has now been fully read
+  
+int XrdXrootdProtocol::do_PgWCont()
+{
+   if (!do_PgWBuff(myBlast)) return do_WriteNone();
+   if (myIOLen > 0) return do_PgWAll();
+   return do_PgWDone();
+}
+
+/******************************************************************************/
+/*                            d o _ P g W D o n e                             */
+/******************************************************************************/
+  
+int XrdXrootdProtocol::do_PgWDone()
+{
+   int i;
+
+// Report the pages that need to be resent, if any
+//
+   if (!pgwBadNum) return Response.Send();
+   TRACEP(FS, "pgwrite " <<pgwBadNum <<" pages have bad checksums");
+   for (i = 0; i < pgwBadNum; i++) pgwBad[i] = htonll(pgwBad[i]);
+   return Response.Send(pgwBad, pgwBadNum*sizeof(long long));
+}
+
 /******************************************************************************/
 /*                               d o _ P i n g                                */
 /******************************************************************************/
@@ -1942,6 +2230,7 @@ int XrdXrootdProtocol::do_Read()
   
 int XrdXrootdProtocol::do_ReadAll(int asyncOK)
 {
+   XrdBuffer *zcBuff;
    int rc, xframt, Quantum = (myIOLen > maxBuffsz ? maxBuffsz : myIOLen);
    char *buff;
 
@@ -1989,12 +2278,21 @@ int XrdXrootdProtocol::do_ReadAll(int asyncOK)
    buff = argp->buff;
 
 // Now read all of the data. For statistics, we need to record the orignal
-// amount of the request even if we really do not get to read that much!
+// amount of the request even if we really do not get to read that much! Data
+// sent using a zero-copy send takes the buffer with it so we switch to a new
+// one of the same size.
 //
    myFile->Stats.rdOps(myIOLen);
    do {if ((xframt = myFile->XrdSfsp->read(myOffset, buff, Quantum)) <= 0) break;
-       if (xframt >= myIOLen) return Response.Send(buff, xframt);
-       if (Response.Send(kXR_oksofar, buff, xframt) < 0) return -1;
+       if (Response.useZC(xframt) && (zcBuff = BPool->Obtain(argp->bsize)))
+          {XrdBuffer *bP = argp;
+           argp = zcBuff; buff = argp->buff;
+           if (xframt >= myIOLen) return Response.SendZC(kXR_ok, bP, xframt);
+           if (Response.SendZC(kXR_oksofar, bP, xframt) < 0) return -1;
+          } else {
+           if (xframt >= myIOLen) return Response.Send(buff, xframt);
+           if (Response.Send(kXR_oksofar, buff, xframt) < 0) return -1;
+          }
        myOffset += xframt; myIOLen -= xframt;
        if (myIOLen < Quantum) Quantum = myIOLen;
       } while(myIOLen);
@@ -2064,17 +2362,28 @@ int XrdXrootdProtocol::do_ReadV()
 // it and put all the individual buffers in a single one it's up to the
 // client to interpret it. Code originally developed by Leandro Franco, CERN.
 // The readv file system code originally added by Brian Bockelman, UNL.
+//
+// The reads for each response packet are coalesced and run in parallel by
+// XrdXrootdReadV. Packets are pipelined: the reads for a packet are started
+// before the previous packet is sent and the two use alternate buffers.
+// Should the client ask for it, the packets are sent through a bound path.
 //
    const int hdrSZ = sizeof(readahead_list);
-   struct XrdOucIOVec     rdVec[maxRvecsz+1];
+   struct XrdOucIOVec     rdVec[maxRvecsz];
    struct readahead_list *raVec, respHdr;
+   XrdXrootdResponse      pathResp, *rvResp = &Response;
+   XrdXrootdProtocol     *pp = 0;
+   kXR_char streamID[2];
+   XrdBuffer *rvBuff = 0;
+   char *buffp, *pBuff[2];
    long long totSZ;
-   XrdSfsXferSize rdVAmt, rdVXfr, xfrSZ = 0;
-   int rdVBeg, rdVBreak, rdVNow, rdVNum, rdVecNum;
-   int currFH, i, k, Quantum, Qleft, rdVecLen = Request.header.dlen;
+   XrdSfsXferSize rdVXfr;
+   int pBeg[2], pEnd[2], pLen[2];
+   int cur, prv, rc, rvDone, currFH, i, j, k, n, Quantum, Qleft, pathID;
+   int rdVecNum, rdVecLen = Request.header.dlen;
    int rvMon = Monitor.InOut();
    int ioMon = (rvMon > 1);
-   char *buffp, vType = (ioMon ? XROOTD_MON_READU : XROOTD_MON_READV);
+   char vType = (ioMon ? XROOTD_MON_READU : XROOTD_MON_READV);
 
 // Compute number of elements in the read vector and make sure we have no
 // partial elements.
@@ -2110,14 +2419,6 @@ int XrdXrootdProtocol::do_ReadV()
         memcpy(&rdVec[i].info, raVec[i].fhandle, sizeof(int));
        }
 
-// Now add an extra dummy element to force flushing of the read vector.
-//
-   rdVec[i].offset = -1;
-   rdVec[i].size   =  0;
-   rdVec[i].info   = -1;
-   rdVBreak = rdVecNum;
-   rdVecNum++;
-
 // We limit the total size of the read to be 2GB for convenience
 //
    if (totSZ > 0x7fffffffLL)
@@ -2140,77 +2441,166 @@ int XrdXrootdProtocol::do_ReadV()
    if (!FTab) return Response.Send(kXR_FileNotOpen,
                               "readv does not refer to an open file");
 
-// Preset the previous and current file handle to be the handle of the first
-// element and make sure the file is actually open.
-//
-   currFH = rdVec[0].info;
-   memcpy(respHdr.fhandle, &currFH, sizeof(respHdr.fhandle));
-   if (!(myFile = FTab->Get(currFH))) return Response.Send(kXR_FileNotOpen,
-                                      "readv does not refer to an open file");
-
-// Setup variables for running through the list.
-//
-   Qleft = Quantum; buffp = argp->buff; rvSeq++;
-   rdVBeg = rdVNow = 0; rdVXfr = rdVAmt = 0;
-
-// Now run through the elements
-//
-   for (i = 0; i < rdVecNum; i++)
-       {if (rdVec[i].info != currFH)
-           {xfrSZ = myFile->XrdSfsp->readv(&rdVec[rdVNow], i-rdVNow);
-            if (xfrSZ != rdVAmt) break;
-            rdVNum = i - rdVBeg; rdVXfr += rdVAmt;
-            myFile->Stats.rvOps(rdVXfr, rdVNum);
-            if (rvMon)
-               {Monitor.Agent->Add_rv(myFile->Stats.FileID, htonl(rdVXfr),
-                                              htons(rdVNum), rvSeq, vType);
-                if (ioMon) for (k = rdVBeg; k < i; k++)
-                    Monitor.Agent->Add_rd(myFile->Stats.FileID,
-                            htonl(rdVec[k].size), htonll(rdVec[k].offset));
-               }
-            rdVXfr = rdVAmt = 0;
-            if (i == rdVBreak) break;
-            rdVBeg = rdVNow = i; currFH = rdVec[i].info;
-            memcpy(respHdr.fhandle, &currFH, sizeof(respHdr.fhandle));
-            if (!(myFile = FTab->Get(currFH)))
-               return Response.Send(kXR_FileNotOpen,
-                                    "readv does not refer to an open file");
+// Make sure every file referenced in the vector is actually open. We do this
+// up front as reads will be in progress by the time we get to a later file.
+//
+   for (i = 0, currFH = rdVec[0].info; i < rdVecNum; i++)
+       if (!i || rdVec[i].info != currFH)
+          {currFH = rdVec[i].info;
+           if (!(myFile = FTab->Get(currFH)))
+              return Response.Send(kXR_FileNotOpen,
+                                   "readv does not refer to an open file");
+          }
+
+// See if the response is to go through another path. The path is verified
+// the same way as for an offloaded read and its link is held until all of
+// the packets have been sent.
+//
+   if ((pathID = static_cast<int>(Request.readv.pathid)) && Response.isOurs())
+      {if (pathID >= maxStreams || !(pp = Stream[pathID]))
+          return Response.Send(kXR_ArgInvalid, "invalid path ID");
+       pp->streamMutex.Lock();
+       if (pp->isDead || pp->isNOP)
+          {pp->streamMutex.UnLock();
+           return Response.Send(kXR_ArgInvalid,
+                  (pp->isDead ? "path ID is not functional"
+                              : "path ID is not connected"));
+          }
+       pp->Link->setRef(1);
+       pp->streamMutex.UnLock();
+       Response.StreamID(streamID);
+       pathResp.Set(pp->Link);
+       pathResp.Set(streamID);
+       rvResp = &pathResp;
+      }
+
+// If the response needs more than one packet then we need a second buffer in
+// order to pipeline the reads with the sends.
+//
+   pBuff[0] = argp->buff; pBuff[1] = 0;
+   if (totSZ > Quantum)
+      {if (!(rvBuff = BPool->Obtain(Quantum)))
+          {if (rvResp != &Response) pp->Link->setRef(-1);
+           return Response.Send(kXR_NoMemory, "insufficient memory for readv");
+          }
+       pBuff[1] = rvBuff->buff;
+      }
+   if (!rvEngine[0])
+      {rvEngine[0] = new XrdXrootdReadV(maxRvecsz);
+       rvEngine[1] = new XrdXrootdReadV(maxRvecsz);
+      }
+
+// Now run through the elements building each response packet and starting its
+// reads. The previous packet is sent while the reads are in progress. Reads
+// are done inline for the first packet as there is nothing else to do then.
+//
+   cur = 0; prv = -1; i = 0; rc = 0; rvDone = 0; rvSeq++;
+   while(i < rdVecNum)
+        {buffp = pBuff[cur]; Qleft = Quantum;
+         for (j = i; j < rdVecNum && Qleft >= rdVec[j].size + hdrSZ; j++)
+             {respHdr.rlen   = htonl(rdVec[j].size);
+              respHdr.offset = htonll(rdVec[j].offset);
+              memcpy(respHdr.fhandle, &rdVec[j].info, sizeof(respHdr.fhandle));
+              memcpy(buffp, &respHdr, hdrSZ);
+              rdVec[j].data = buffp + hdrSZ;
+              buffp += (rdVec[j].size+hdrSZ); Qleft -= (rdVec[j].size+hdrSZ);
+              TRACEP(FS,"fh=" <<rdVec[j].info <<" readV "
+                          <<rdVec[j].size <<'@' <<rdVec[j].offset);
+             }
+         for (k = i; k < j; k = n)
+             {currFH = rdVec[k].info;
+              for (n = k+1; n < j && rdVec[n].info == currFH; n++) {}
+              myFile = FTab->Get(currFH);
+              numSegsR += rvEngine[cur]->Start(myFile->XrdSfsp, &rdVec[k],
+                                               n-k, prv < 0);
+             }
+         numSegsP += rvEngine[cur]->numParts;
+         TRACEP(FS, "readV packet " <<j-i <<" segs in " <<rvEngine[cur]->numParts
+                    <<" parts");
+         pBeg[cur] = i; pEnd[cur] = j; pLen[cur] = Quantum - Qleft;
+         if (prv >= 0)
+            {if ((rc = do_ReadVSend(prv, rdVec, pBeg[prv], pEnd[prv],
+                                    pBuff[prv], pLen[prv], false, *rvResp)))
+                break;
+             rvDone = pEnd[prv];
             }
+         prv = cur; cur ^= 1; i = j;
+        }
 
-        if (Qleft < (rdVec[i].size + hdrSZ))
-           {if (rdVAmt)
-               {xfrSZ = myFile->XrdSfsp->readv(&rdVec[rdVNow], i-rdVNow);
-                if (xfrSZ != rdVAmt) break;
-               }
-            if (Response.Send(kXR_oksofar,argp->buff,Quantum-Qleft) < 0)
-               return -1;
-            Qleft = Quantum;
-            buffp = argp->buff;
-            rdVNow = i; rdVXfr += rdVAmt; rdVAmt = 0;
-           }
+// Send the last packet
+//
+   if (!rc)
+      {if (!(rc = do_ReadVSend(prv, rdVec, pBeg[prv], pEnd[prv],
+                               pBuff[prv], pLen[prv], true, *rvResp)))
+          rvDone = pEnd[prv];
+      }
 
-        xfrSZ = rdVec[i].size; rdVAmt += xfrSZ;
-        respHdr.rlen   = htonl(xfrSZ);
-        respHdr.offset = htonll(rdVec[i].offset);
-        memcpy(buffp, &respHdr, hdrSZ);
-        rdVec[i].data = buffp + hdrSZ;
-        buffp += (xfrSZ+hdrSZ); Qleft -= (xfrSZ+hdrSZ);
-        TRACEP(FS,"fh=" <<currFH <<" readV " << xfrSZ <<'@' <<rdVec[i].offset);
+// Make sure no reads are outstanding before we let go of the buffers
+//
+   rvEngine[0]->Wait(); rvEngine[1]->Wait();
+   if (rvBuff) BPool->Release(rvBuff);
+   if (rvResp != &Response) pp->Link->setRef(-1);
+
+// Account for what was sent on a per-file basis
+//
+   for (k = 0; k < rvDone; k = n)
+       {currFH = rdVec[k].info; rdVXfr = 0;
+        for (n = k; n < rvDone && rdVec[n].info == currFH; n++)
+            rdVXfr += rdVec[n].size;
+        if (!(myFile = FTab->Get(currFH))) continue;
+        myFile->Stats.rvOps(rdVXfr, n-k);
+        if (rvMon)
+           {Monitor.Agent->Add_rv(myFile->Stats.FileID, htonl(rdVXfr),
+                                          htons(n-k), rvSeq, vType);
+            if (ioMon) for (j = k; j < n; j++)
+                Monitor.Agent->Add_rd(myFile->Stats.FileID,
+                        htonl(rdVec[j].size), htonll(rdVec[j].offset));
+           }
        }
 
-// Check if we have an error here. This is indicated when rdVAmt is not zero.
+// All done
 //
-   if (rdVAmt)
-      {if (xfrSZ >= 0)
-          {xfrSZ = SFS_ERROR;
-           myFile->XrdSfsp->error.setErrInfo(-ENODATA,"readv past EOF");
+   return (rc < 0 ? -1 : 0);
+}
+
+/******************************************************************************/
+/*                          d o _ R e a d V S e n d                           */
+/******************************************************************************/
+
+int XrdXrootdProtocol::do_ReadVSend(int slot, XrdOucIOVec *rdVec,
+                                    int vBeg, int vEnd,
+                                    char *buff, int blen, bool isLast,
+                                    XrdXrootdResponse &rvResp)
+{
+   XrdXrootdFile *fP;
+   XrdSfsXferSize rdSZ, xfrSZ;
+   int i, k, n, rc;
+
+// Wait for the reads for this packet. Should any of them fail we redo them
+// serially so that the error is properly reflected in the file object.
+//
+   if (!rvEngine[slot]->Wait())
+      for (k = vBeg; k < vEnd; k = n)
+          {for (n = k+1; n < vEnd && rdVec[n].info == rdVec[k].info; n++) {}
+           fP = FTab->Get(rdVec[k].info);
+           for (rdSZ = 0, i = k; i < n; i++) rdSZ += rdVec[i].size;
+           if ((xfrSZ = fP->XrdSfsp->readv(&rdVec[k], n-k)) != rdSZ)
+              {if (xfrSZ >= 0)
+                  {xfrSZ = SFS_ERROR;
+                   fP->XrdSfsp->error.setErrInfo(-ENODATA,"readv past EOF");
+                  }
+               return (fsError(xfrSZ, 0, fP->XrdSfsp->error, 0, 0) < 0 ? -1:1);
+              }
           }
-       return fsError(xfrSZ, 0, myFile->XrdSfsp->error, 0, 0);
-      }
 
-// All done, return result of the last segment or just zero
+// Send off the packet. Should a bound path fail, the session is still fine
+// and the client learns about it through the session stream.
 //
-   return (Quantum != Qleft ? Response.Send(argp->buff, Quantum-Qleft) : 0);
+   if (isLast) rc = rvResp.Send(buff, blen);
+      else     rc = rvResp.Send(kXR_oksofar, buff, blen);
+   if (rc < 0 && &rvResp != &Response)
+      return (Response.Send(kXR_ServerError, "readv path failed") < 0 ? -1 : 1);
+   return rc;
 }
 
 /******************************************************************************/
@@ -2777,6 +3167,206 @@ int XrdXrootdProtocol::do_WriteSpan()
    return Response.Send();
 }
   
+/******************************************************************************/
+/*                             d o _ W r i t e V                              */
+/******************************************************************************/
+
+// The request argument is a list of write_list elements. The data for all of
+// the elements follows the argument, in list order, and is read a buffer at a
+// time. Each buffer is written using one writev() per run of same-file pieces.
+  
+int XrdXrootdProtocol::do_WriteV()
+{
+   const int hdrSZ = sizeof(write_list);
+   write_list *wlP;
+   XrdXrootdFile *fP = 0;
+   long long totSZ = 0;
+   kXR_int32 currFH = 0;
+   int i, wlen, wvLen = Request.header.dlen, wvCnt = wvLen / hdrSZ;
+   int wvMon = Monitor.InOut();
+   bool allOpen = true;
+
+// Make sure the write list is well formed. If it isn't we can't tell how much
+// data follows it, so the only thing we can do is to drop the link.
+//
+   if (wvLen <= 0 || wvCnt*hdrSZ != wvLen)
+      {Response.Send(kXR_ArgInvalid, "Write vector is invalid");
+       return Link->setEtext("writev protocol violation");
+      }
+   if (wvCnt > maxWvecsz)
+      {Response.Send(kXR_ArgTooLong, "Write vector is too long");
+       return Link->setEtext("writev protocol violation");
+      }
+   numWrites++;
+
+// Get the segment table if this is the first writev on this link
+//
+   if (!wvSeg)
+      {wvSeg = new WVSeg[maxWvecsz];
+       wvIOV = new XrdOucIOVec[maxWvecsz];
+      }
+
+// Run down the list copying it to the segment table as the argument buffer
+// will be used for the data. We also compute the total length.
+//
+   wlP = (write_list *)argp->buff; wvNum = 0;
+   for (i = 0; i < wvCnt; i++, wlP++)
+       {wlen = ntohl(wlP->wlen);
+        if (wlen < 0 || (totSZ += wlen) > 0x7fffffffLL)
+           {Response.Send(kXR_ArgInvalid, "Write vector length is invalid");
+            return Link->setEtext("writev protocol violation");
+           }
+        if (!wlen || !allOpen) continue;
+        XrdXrootdFHandle fh(wlP->fhandle);
+        if (!fP || fh.handle != currFH)
+           {currFH = fh.handle;
+            if (!FTab || !(fP = FTab->Get(currFH))) {allOpen = false; continue;}
+           }
+        if (wvMon) Monitor.Agent->Add_wr(fP->Stats.FileID, wlen, wlP->offset);
+        fP->Stats.wrOps(wlen); // Optimistically correct
+        wvSeg[wvNum].fileP  = fP;
+        wvSeg[wvNum].offset = ntohll(wlP->offset);
+        wvSeg[wvNum].size   = wlen;
+        wvNum++;
+       }
+   myIOLen = static_cast<int>(totSZ);
+   TRACEP(FS, "writev " <<wvCnt <<" segs " <<myIOLen <<" bytes");
+
+// If any file is not open we discard the data and report that fact
+//
+   if (!allOpen) {myFile = 0; return do_WriteNone();}
+
+// Now write all of the data
+//
+   wvCur = wvOff = 0;
+   if (myIOLen > 0) return do_WriteVAll();
+   return do_WriteVDone();
+}
+  
+/******************************************************************************/
+/*                          d o _ W r i t e V A l l                           */
+/******************************************************************************/
+
+// myIOLen  = Number of bytes to read from socket and write to the files
+// wvCur    = Segment receiving the next byte
+// wvOff    = Offset in wvCur of the next byte
+  
+int XrdXrootdProtocol::do_WriteVAll()
+{
+   int rc, Quantum = (myIOLen > maxBuffsz ? maxBuffsz : myIOLen);
+
+// Make sure we have a large enough buffer
+//
+   if (!argp || Quantum < halfBSize || Quantum > argp->bsize)
+      {if ((rc = getBuff(0, Quantum)) <= 0) return rc;}
+      else if (hcNow < hcNext) hcNow++;
+
+// Now write all of the data (XrdXrootdProtocol.C defines getData())
+//
+   while(myIOLen > 0)
+        {if ((rc = getData("data", argp->buff, Quantum)))
+            {if (rc > 0)
+                {Resume = &XrdXrootdProtocol::do_WriteVCont;
+                 myBlast = Quantum;
+                 myStalls++;
+                }
+             return rc;
+            }
+         if (!do_WriteVBuff(argp->buff, Quantum)) return do_WriteNone();
+         if (myIOLen < Quantum) Quantum = myIOLen;
+        }
+
+// All done
+//
+   return do_WriteVDone();
+}
+
+/******************************************************************************/
+/*                         d o _ W r i t e V B u f f                          */
+/******************************************************************************/
+
+// Write blen bytes from buff, which hold the data starting at segment wvCur
+// offset wvOff. Upon failure, myFile and myEInfo describe the error. A short
+// write is a failure as the client has no way of knowing what was written.
+  
+bool XrdXrootdProtocol::do_WriteVBuff(char *buff, int blen)
+{
+   XrdXrootdFile *fP;
+   int n, rc, wlen, rlen;
+
+// Account for the data and break it up into per-file runs of pieces
+//
+   myIOLen -= blen;
+   while(blen > 0)
+        {fP = wvSeg[wvCur].fileP; n = 0; rlen = 0;
+         do {wlen = wvSeg[wvCur].size - wvOff;
+             if (wlen > blen) wlen = blen;
+             wvIOV[n].offset = wvSeg[wvCur].offset + wvOff;
+             wvIOV[n].size   = wlen;
+             wvIOV[n].info   = 0;
+             wvIOV[n].data   = buff;
+             n++; buff += wlen; blen -= wlen; rlen += wlen;
+             if ((wvOff += wlen) >= wvSeg[wvCur].size) {wvCur++; wvOff = 0;}
+            } while(blen > 0 && wvSeg[wvCur].fileP == fP);
+         if ((rc = fP->XrdSfsp->writev(wvIOV, n)) < 0)
+            {myFile = fP; myEInfo[0] = rc;
+             return false;
+            }
+         if (rc != rlen)
+            {fP->XrdSfsp->error.setErrInfo(EIO, "writev was incomplete");
+             myFile = fP; myEInfo[0] = SFS_ERROR;
+             return false;
+            }
+        }
+   return true;
+}
+
+/******************************************************************************/
+/*                         d o _ W r i t e V C o n t                          */
+/******************************************************************************/
+
+// myBlast  = Number of bytes already read from the socket
+  
+int XrdXrootdProtocol::do_WriteVCont()
+{
+
+// Write data that was finaly finished comming in
+//
+   if (!do_WriteVBuff(argp->buff, myBlast)) return do_WriteNone();
+
+// See if we need to finish this request in the normal way
+//
+   if (myIOLen > 0) return do_WriteVAll();
+   return do_WriteVDone();
+}
+
+/******************************************************************************/
+/*                         d o _ W r i t e V D o n e                          */
+/******************************************************************************/
+  
+int XrdXrootdProtocol::do_WriteVDone()
+{
+   XrdXrootdFile *fP;
+   int i, j, rc;
+
+// If a sync was requested, sync each file that was written. The sync is
+// done in-line as the response covers the whole request.
+//
+   if (Request.writev.options & kXR_wvsync)
+      for (i = 0; i < wvNum; i++)
+          {fP = wvSeg[i].fileP;
+           for (j = 0; j < i && wvSeg[j].fileP != fP; j++) {}
+           if (j < i) continue;
+           fP->XrdSfsp->error.setErrCB(0);
+           if (SFS_OK != (rc = fP->XrdSfsp->sync()))
+              return fsError(rc, 0, fP->XrdSfsp->error, 0, 0);
+          }
+
+// All done
+//
+   return Response.Send();
+}
+  
 /******************************************************************************/
 /*                              S e n d F i l e                               */
 /******************************************************************************/
@@ -24,6 +24,7 @@
 #include "CppUnitXrdHelpers.hh"
 #include "XrdCl/XrdClFile.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
 #include "XrdCl/XrdClPlugInManager.hh"
 #include "XrdCl/XrdClMessage.hh"
 #include "XrdCl/XrdClSIDManager.hh"
@@ -47,6 +48,9 @@ class FileTest: public CppUnit::TestCase
       CPPUNIT_TEST( ReadTest );
       CPPUNIT_TEST( WriteTest );
       CPPUNIT_TEST( VectorReadTest );
+      CPPUNIT_TEST( VectorWriteTest );
+      CPPUNIT_TEST( ReadCacheTest );
+      CPPUNIT_TEST( PgReadWriteTest );
       CPPUNIT_TEST( VirtualRedirectorTest );
       CPPUNIT_TEST( PlugInTest );
     CPPUNIT_TEST_SUITE_END();
@@ -54,8 +58,13 @@ class FileTest: public CppUnit::TestCase
     void ReadTest();
     void WriteTest();
     void VectorReadTest();
+    void VectorWriteTest();
+    void ReadCacheTest();
+    void PgReadWriteTest();
     void VirtualRedirectorTest();
     void PlugInTest();
+  private:
+    void PgReadWrite( const std::string &address );
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( FileTest );
@@ -397,6 +406,262 @@ void FileTest::VectorReadTest()
   delete [] buffer2;
 }
 
+//------------------------------------------------------------------------------
+// Vector write test
+//------------------------------------------------------------------------------
+void FileTest::VectorWriteTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string filePath = dataPath + "/testVectorFile.dat";
+  std::string fileUrl = address + "/";
+  fileUrl += filePath;
+
+  //----------------------------------------------------------------------------
+  // Prepare the data, the chunks are out of order, of different sizes and
+  // spread so that the list spans several of the server's buffers
+  //----------------------------------------------------------------------------
+  const uint32_t MB     = 1024*1024;
+  const int      nbChnk = 50;
+  char *buffer1 = new char[nbChnk*MB];
+  char *buffer2 = new char[nbChnk*MB];
+  File f1, f2;
+
+  CPPUNIT_ASSERT( Utils::GetRandomBytes( buffer1, nbChnk*MB ) == nbChnk*MB );
+
+  ChunkList writeList;
+  ChunkList readList;
+  uint32_t  total = 0;
+  for( int i = 0; i < nbChnk; ++i )
+  {
+    int      n    = ( i * 7 ) % nbChnk;
+    uint32_t size = MB - n * 1000;
+    writeList.push_back( ChunkInfo( n*2*MB, size, buffer1 + total ) );
+    readList.push_back( ChunkInfo( n*2*MB, size ) );
+    total += size;
+  }
+
+  //----------------------------------------------------------------------------
+  // Write the chunks, the empty list and too many chunks are refused
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT_XRDST( f1.Open( fileUrl, OpenFlags::Delete | OpenFlags::Update,
+                                 Access::UR | Access::UW ) );
+  CPPUNIT_ASSERT_XRDST( f1.VectorWrite( writeList ) );
+
+  ChunkList tooLong( 1025, ChunkInfo( 0, 1, buffer1 ) );
+  CPPUNIT_ASSERT_XRDST_NOTOK( f1.VectorWrite( ChunkList() ), errInvalidArgs );
+  CPPUNIT_ASSERT_XRDST_NOTOK( f1.VectorWrite( tooLong ), errInvalidArgs );
+  CPPUNIT_ASSERT_XRDST( f1.Close() );
+
+  //----------------------------------------------------------------------------
+  // Read the chunks back and compare
+  //----------------------------------------------------------------------------
+  VectorReadInfo *info = 0;
+  CPPUNIT_ASSERT_XRDST( f2.Open( fileUrl, OpenFlags::Read ) );
+  CPPUNIT_ASSERT_XRDST( f2.VectorRead( readList, buffer2, info ) );
+  CPPUNIT_ASSERT( info->GetSize() == total );
+  CPPUNIT_ASSERT( memcmp( buffer1, buffer2, total ) == 0 );
+  delete info;
+  CPPUNIT_ASSERT_XRDST( f2.Close() );
+
+  FileSystem fs( url );
+  CPPUNIT_ASSERT_XRDST( fs.Rm( filePath ) );
+  delete [] buffer1;
+  delete [] buffer2;
+}
+
+//------------------------------------------------------------------------------
+// Read cache test
+//------------------------------------------------------------------------------
+void FileTest::ReadCacheTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+  Env *env     = DefaultEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string filePath = dataPath + "/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat";
+  std::string fileUrl = address + "/";
+  fileUrl += filePath;
+
+  //----------------------------------------------------------------------------
+  // Fetch the reference data with the cache disabled
+  //----------------------------------------------------------------------------
+  const uint32_t MB       = 1024*1024;
+  const uint64_t fileSize = 1048576000;
+  const uint64_t start    = 10*MB;
+  const uint32_t tailSize = 10000;
+  char *ref     = new char[4*MB];
+  char *refTail = new char[tailSize];
+  char  buffer[4096];
+  uint32_t bytesRead = 0;
+  File f1;
+
+  CPPUNIT_ASSERT_XRDST( f1.Open( fileUrl, OpenFlags::Read ) );
+  CPPUNIT_ASSERT_XRDST( f1.Read( start, 4*MB, ref, bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == 4*MB );
+  CPPUNIT_ASSERT_XRDST( f1.Read( fileSize-tailSize, tailSize, refTail,
+                                 bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == tailSize );
+  CPPUNIT_ASSERT_XRDST( f1.Close() );
+
+  //----------------------------------------------------------------------------
+  // Read through a cache smaller than the data, so that blocks get evicted,
+  // the cache is set up when the file object is created
+  //----------------------------------------------------------------------------
+  env->PutInt( "ReadCacheSize", MB );
+  File f2;
+  CPPUNIT_ASSERT_XRDST( f2.Open( fileUrl, OpenFlags::Read ) );
+
+  for( uint32_t off = 0; off < 4*MB; off += 4096 )
+  {
+    CPPUNIT_ASSERT_XRDST( f2.Read( start+off, 4096, buffer, bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == 4096 );
+    CPPUNIT_ASSERT( memcmp( buffer, ref+off, 4096 ) == 0 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Random reads, some of them spanning two blocks
+  //----------------------------------------------------------------------------
+  for( uint32_t i = 0; i < 1000; ++i )
+  {
+    uint32_t off = ( i * 37 * 4096 + i * 1234 ) % ( 4*MB - 3000 );
+    CPPUNIT_ASSERT_XRDST( f2.Read( start+off, 3000, buffer, bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == 3000 );
+    CPPUNIT_ASSERT( memcmp( buffer, ref+off, 3000 ) == 0 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Reads at the end of the file are short
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT_XRDST( f2.Read( fileSize-1000, 4096, buffer, bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == 1000 );
+  CPPUNIT_ASSERT( memcmp( buffer, refTail+tailSize-1000, 1000 ) == 0 );
+  CPPUNIT_ASSERT_XRDST( f2.Read( fileSize, 4096, buffer, bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == 0 );
+
+  CPPUNIT_ASSERT_XRDST( f2.Close() );
+  env->PutInt( "ReadCacheSize", DefaultReadCacheSize );
+
+  delete [] ref;
+  delete [] refTail;
+}
+
+//------------------------------------------------------------------------------
+// Page read/write test
+//------------------------------------------------------------------------------
+void FileTest::PgReadWriteTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Run the round trip against a plain server and against one that requires
+  // the requests to be signed
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string signedAddress;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "SignedServerURL", signedAddress ) );
+
+  PgReadWrite( address );
+  PgReadWrite( signedAddress );
+}
+
+void FileTest::PgReadWrite( const std::string &address )
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string dataPath;
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string filePath = dataPath + "/testPgFile.dat";
+  std::string fileUrl = address + "/";
+  fileUrl += filePath;
+
+  //----------------------------------------------------------------------------
+  // Prepare the data, neither the offset nor the size are page aligned
+  //----------------------------------------------------------------------------
+  const uint32_t MB     = 1024*1024;
+  const uint64_t offset = 100;
+  const uint32_t size   = 3*MB + 1234;
+  const uint32_t pages  = ( offset + size + kXR_pgPageSZ - 1 ) / kXR_pgPageSZ;
+  char *buffer1 = new char[size];
+  char *buffer2 = new char[size];
+  uint32_t bytesRead = 0;
+  std::vector<uint32_t> cksums;
+  File f1, f2;
+
+  CPPUNIT_ASSERT( Utils::GetRandomBytes( buffer1, size ) == size );
+  uint32_t crc1 = Utils::ComputeCRC32( buffer1, size );
+
+  //----------------------------------------------------------------------------
+  // Write the pages
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT_XRDST( f1.Open( fileUrl, OpenFlags::Delete | OpenFlags::Update,
+                                 Access::UR | Access::UW ) );
+  CPPUNIT_ASSERT_XRDST( f1.PgWrite( offset, size, buffer1, cksums ) );
+  CPPUNIT_ASSERT_XRDST( f1.Close() );
+
+  //----------------------------------------------------------------------------
+  // Read the pages back, both in one go and a small piece within a page
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT_XRDST( f2.Open( fileUrl, OpenFlags::Read ) );
+  CPPUNIT_ASSERT_XRDST( f2.PgRead( offset, size, buffer2, cksums, bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == size );
+  CPPUNIT_ASSERT( cksums.size() == pages );
+  CPPUNIT_ASSERT( Utils::ComputeCRC32( buffer2, size ) == crc1 );
+
+  cksums.clear();
+  CPPUNIT_ASSERT_XRDST( f2.PgRead( offset + 5000, 100, buffer2, cksums,
+                                   bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == 100 );
+  CPPUNIT_ASSERT( cksums.size() == 1 );
+  CPPUNIT_ASSERT( memcmp( buffer1 + 5000, buffer2, 100 ) == 0 );
+  CPPUNIT_ASSERT_XRDST( f2.Close() );
+
+  FileSystem fs( url );
+  CPPUNIT_ASSERT_XRDST( fs.Rm( filePath ) );
+  delete [] buffer1;
+  delete [] buffer2;
+}
+
 void FileTest::VirtualRedirectorTest()
 {
   using namespace XrdCl;
@@ -23,11 +23,16 @@
 //------------------------------------------------------------------------------
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <set>
+#include <cstring>
 #include "CppUnitXrdHelpers.hh"
 #include "XrdCl/XrdClURL.hh"
 #include "XrdCl/XrdClAnyObject.hh"
 #include "XrdCl/XrdClTaskManager.hh"
 #include "XrdCl/XrdClSIDManager.hh"
+#include "XrdCl/XrdClInQueue.hh"
+#include "XrdCl/XrdClMessage.hh"
+#include "XProtocol/XProtocol.hh"
 #include "XrdCl/XrdClPropertyList.hh"
 
 //------------------------------------------------------------------------------
@@ -41,12 +46,16 @@ class UtilsTest: public CppUnit::TestCase
       CPPUNIT_TEST( AnyTest );
       CPPUNIT_TEST( TaskManagerTest );
       CPPUNIT_TEST( SIDManagerTest );
+      CPPUNIT_TEST( SIDManagerReleaseTest );
+      CPPUNIT_TEST( InQueueTest );
       CPPUNIT_TEST( PropertyListTest );
     CPPUNIT_TEST_SUITE_END();
     void URLTest();
     void AnyTest();
     void TaskManagerTest();
     void SIDManagerTest();
+    void SIDManagerReleaseTest();
+    void InQueueTest();
     void PropertyListTest();
 };
 
@@ -408,6 +417,198 @@ void UtilsTest::SIDManagerTest()
   CPPUNIT_ASSERT( manager.NumberOfTimedOutSIDs() == 0 );
 }
 
+//------------------------------------------------------------------------------
+// SID Manager release test
+//------------------------------------------------------------------------------
+void UtilsTest::SIDManagerReleaseTest()
+{
+  using namespace XrdCl;
+  SIDManager manager;
+
+  //----------------------------------------------------------------------------
+  // Releasing twice or releasing a SID that is not allocated does nothing
+  //----------------------------------------------------------------------------
+  uint8_t sid1[2];
+  uint8_t sid2[2];
+  uint8_t none[2] = { 0xff, 0x7f };
+
+  CPPUNIT_ASSERT_XRDST( manager.AllocateSID( sid1 ) );
+  CPPUNIT_ASSERT_XRDST( manager.AllocateSID( sid2 ) );
+  CPPUNIT_ASSERT( manager.GetNumberOfAllocatedSIDs() == 2 );
+  manager.ReleaseSID( sid1 );
+  CPPUNIT_ASSERT( manager.GetNumberOfAllocatedSIDs() == 1 );
+  manager.ReleaseSID( sid1 );
+  manager.ReleaseSID( none );
+  CPPUNIT_ASSERT( manager.GetNumberOfAllocatedSIDs() == 1 );
+
+  //----------------------------------------------------------------------------
+  // A timed out SID can only be released as such, and only once
+  //----------------------------------------------------------------------------
+  manager.TimeOutSID( sid2 );
+  manager.TimeOutSID( sid2 );
+  CPPUNIT_ASSERT( manager.GetNumberOfAllocatedSIDs() == 0 );
+  CPPUNIT_ASSERT( manager.NumberOfTimedOutSIDs() == 1 );
+  manager.ReleaseSID( sid2 );
+  CPPUNIT_ASSERT( manager.IsTimedOut( sid2 ) == true );
+  CPPUNIT_ASSERT( manager.GetNumberOfAllocatedSIDs() == 0 );
+  manager.ReleaseTimedOut( sid2 );
+  manager.ReleaseTimedOut( sid2 );
+  CPPUNIT_ASSERT( manager.IsTimedOut( sid2 ) == false );
+  CPPUNIT_ASSERT( manager.NumberOfTimedOutSIDs() == 0 );
+  manager.TimeOutSID( sid1 );
+  CPPUNIT_ASSERT( manager.NumberOfTimedOutSIDs() == 0 );
+
+  //----------------------------------------------------------------------------
+  // All the SIDs in use are distinct and a released SID is not handed out
+  // again right away
+  //----------------------------------------------------------------------------
+  std::set<uint16_t> inUse;
+  uint16_t           sid;
+  uint8_t            raw[2];
+  for( int i = 0; i < 1000; ++i )
+  {
+    CPPUNIT_ASSERT_XRDST( manager.AllocateSID( raw ) );
+    memcpy( &sid, raw, 2 );
+    CPPUNIT_ASSERT( sid != 0 );
+    CPPUNIT_ASSERT( inUse.insert( sid ).second );
+  }
+  CPPUNIT_ASSERT( manager.GetNumberOfAllocatedSIDs() == 1000 );
+
+  std::set<uint16_t>::iterator it;
+  for( it = inUse.begin(); it != inUse.end(); ++it )
+  {
+    sid = *it;
+    memcpy( raw, &sid, 2 );
+    manager.ReleaseSID( raw );
+  }
+  CPPUNIT_ASSERT( manager.GetNumberOfAllocatedSIDs() == 0 );
+
+  uint16_t last = 0;
+  for( int i = 0; i < 2; ++i )
+  {
+    CPPUNIT_ASSERT_XRDST( manager.AllocateSID( raw ) );
+    memcpy( &sid, raw, 2 );
+    CPPUNIT_ASSERT( sid != last );
+    memcpy( raw, &sid, 2 );
+    manager.ReleaseSID( raw );
+    last = sid;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Message handler recording what the queue passes to it
+//------------------------------------------------------------------------------
+class RecordingHandler: public XrdCl::IncomingMsgHandler
+{
+  public:
+    RecordingHandler( uint16_t sid ):
+      sid( sid ), processed( 0 ), timedOut( false ) {}
+
+    virtual uint16_t Examine( XrdCl::Message *msg )
+    {
+      (void)msg;
+      return Take | RemoveHandler;
+    }
+
+    virtual uint16_t GetSid() const
+    {
+      return sid;
+    }
+
+    virtual void Process( XrdCl::Message *msg )
+    {
+      processed = msg;
+    }
+
+    virtual uint8_t OnStreamEvent( StreamEvent     event,
+                                   uint16_t        streamNum,
+                                   XrdCl::Status   status )
+    {
+      (void)streamNum; (void)status;
+      if( event == Timeout )
+        timedOut = true;
+      return RemoveHandler;
+    }
+
+    uint16_t        sid;
+    XrdCl::Message *processed;
+    bool            timedOut;
+};
+
+//------------------------------------------------------------------------------
+// Create a response for the given SID
+//------------------------------------------------------------------------------
+static XrdCl::Message *CreateResponse( uint16_t sid )
+{
+  XrdCl::Message *msg = new XrdCl::Message( 8 );
+  ServerResponseHeader *hdr = (ServerResponseHeader *)msg->GetBuffer();
+  hdr->streamid[0] = sid & 0xff;
+  hdr->streamid[1] = sid >> 8;
+  hdr->status      = kXR_ok;
+  hdr->dlen        = 0;
+  return msg;
+}
+
+//------------------------------------------------------------------------------
+// Incoming queue test
+//------------------------------------------------------------------------------
+void UtilsTest::InQueueTest()
+{
+  using namespace XrdCl;
+  InQueue queue;
+
+  //----------------------------------------------------------------------------
+  // A response goes to the handler waiting for its SID and nowhere else
+  //----------------------------------------------------------------------------
+  RecordingHandler h1( 5 ), h2( 261 );
+  Message *m1 = CreateResponse( 5 );
+  queue.AddMessageHandler( &h1, 1000 );
+  queue.AddMessageHandler( &h2, 1000 );
+  queue.AddMessage( m1 );
+  CPPUNIT_ASSERT( h1.processed == m1 );
+  CPPUNIT_ASSERT( h2.processed == 0 );
+
+  //----------------------------------------------------------------------------
+  // A response that arrives before its handler waits for it
+  //----------------------------------------------------------------------------
+  RecordingHandler h3( 40000 );
+  Message *m3 = CreateResponse( 40000 );
+  queue.AddMessage( m3 );
+  queue.AddMessageHandler( &h3, 1000 );
+  CPPUNIT_ASSERT( h3.processed == m3 );
+
+  //----------------------------------------------------------------------------
+  // Handlers expire on time, and only once
+  //----------------------------------------------------------------------------
+  RecordingHandler h4( 6 );
+  queue.AddMessageHandler( &h4, 500 );
+  queue.ReportTimeout( 499 );
+  CPPUNIT_ASSERT( !h4.timedOut );
+  CPPUNIT_ASSERT( !h2.timedOut );
+  queue.ReportTimeout( 500 );
+  CPPUNIT_ASSERT( h4.timedOut );
+  CPPUNIT_ASSERT( !h2.timedOut );
+  h4.timedOut = false;
+  queue.ReportTimeout( 600 );
+  CPPUNIT_ASSERT( !h4.timedOut );
+  queue.ReportTimeout( 1000 );
+  CPPUNIT_ASSERT( h2.timedOut );
+
+  //----------------------------------------------------------------------------
+  // A removed handler does not get the response
+  //----------------------------------------------------------------------------
+  RecordingHandler h5( 7 );
+  Message *m5 = CreateResponse( 7 );
+  queue.AddMessageHandler( &h5, 2000 );
+  queue.RemoveMessageHandler( &h5 );
+  queue.AddMessage( m5 );
+  CPPUNIT_ASSERT( h5.processed == 0 );
+
+  delete m1;
+  delete m3;
+  delete m5;
+}
+
 //------------------------------------------------------------------------------
 // SID Manager test
 //------------------------------------------------------------------------------
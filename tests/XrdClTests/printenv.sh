@@ -22,3 +22,4 @@ printEnv XRDTEST_DATAPATH
 printEnv XRDTEST_LOCALFILE
 printEnv XRDTEST_REMOTEFILE
 printEnv XRDTEST_MULTIIPSERVERURL
+printEnv XRDTEST_SIGNEDSERVERURL
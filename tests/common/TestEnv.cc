@@ -38,6 +38,7 @@ TestEnv::TestEnv()
   PutString( "RemoteFile",       "/data/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat" );
   PutString( "LocalFile",        "/data/testFile.dat" );
   PutString( "MultiIPServerURL", "multiip:1099" );
+  PutString( "SignedServerURL",  "localhost:1094" );
 
   ImportString( "MainServerURL",    "XRDTEST_MAINSERVERURL" );
   ImportString( "DiskServerURL",    "XRDTEST_DISKSERVERURL" );
@@ -47,6 +48,7 @@ TestEnv::TestEnv()
   ImportString( "LocalFile",        "XRDTEST_LOCALFILE" );
   ImportString( "RemoteFile",       "XRDTEST_REMOTEFILE" );
   ImportString( "MultiIPServerURL", "XRDTEST_MULTIIPSERVERURL" );
+  ImportString( "SignedServerURL",  "XRDTEST_SIGNEDSERVERURL" );
 }
 
 //------------------------------------------------------------------------------